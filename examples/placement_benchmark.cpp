@@ -0,0 +1,96 @@
+/// @file placement_benchmark.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Compares the placement policies of the threads, on a design with one partition per clock domain.
+/// @details Usage: placement_benchmark [threads] [time] [domains], each domain being a flip-flop toggling a long
+/// chain of inverters. On a machine with several NUMA nodes, placement_t::scatter spreads the partitions over the
+/// memory controllers, while placement_t::compact keeps them on as few nodes as possible.
+
+#include <digsim/digsim.hpp>
+
+#include "d_flip_flop.hpp"
+#include "gates/not_gate.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+/// @brief A clock, and a flip-flop toggling at each of its rising edges, followed by a chain of inverters.
+class ToggleChain : public digsim::module_t
+{
+public:
+    digsim::input_t<bool> enable;
+    digsim::input_t<bool> reset;
+
+    ToggleChain(const std::string &_name, std::size_t length, digsim::discrete_time_t period)
+        : digsim::module_t(_name)
+        , enable("enable", this)
+        , reset("reset", this)
+        , clock(_name + "_clock", period)
+        , clk_out(_name + "_clk")
+        , ff("ff", this)
+        , q(_name + "_q", false, 1)
+        , q_not(_name + "_q_not", true, 1)
+    {
+        clock.out(clk_out);
+        ff.clk(clk_out);
+        ff.d(q_not);
+        ff.enable(enable);
+        ff.reset(reset);
+        ff.q(q);
+        ff.q_not(q_not);
+        for (std::size_t index = 0; index < length; ++index) {
+            wires.emplace_back(std::make_unique<digsim::signal_t<bool>>(_name + "_w" + std::to_string(index)));
+            gates.emplace_back(std::make_unique<NotGate>("not" + std::to_string(index), this));
+            gates.back()->in((index == 0) ? q : *wires[index - 1]);
+            gates.back()->out(*wires.back());
+        }
+    }
+
+private:
+    digsim::clock_t clock;
+    digsim::signal_t<bool> clk_out;
+    DFlipFlop ff;
+    digsim::signal_t<bool> q;
+    digsim::signal_t<bool> q_not;
+    std::vector<std::unique_ptr<NotGate>> gates;
+    std::vector<std::unique_ptr<digsim::signal_t<bool>>> wires;
+};
+
+int main(int argc, char *argv[])
+{
+    const std::size_t threads = (argc > 1) ? std::stoul(argv[1]) : std::max(2U, std::thread::hardware_concurrency());
+    const digsim::discrete_time_t time = (argc > 2) ? std::stoull(argv[2]) : 2000;
+    const std::size_t domains          = (argc > 3) ? std::stoul(argv[3]) : threads;
+
+    // The gates log each evaluation.
+    digsim::logger.set_level(digsim::log_level_t::error);
+
+    digsim::signal_t<bool> enable("enable", true);
+    digsim::signal_t<bool> reset("reset", false);
+    std::vector<std::unique_ptr<ToggleChain>> chains;
+    for (std::size_t index = 0; index < domains; ++index) {
+        // Different periods, so that the domains are not all active at the same time.
+        chains.emplace_back(std::make_unique<ToggleChain>("chain" + std::to_string(index), 64, 2 + index % 3));
+        chains.back()->enable(enable);
+        chains.back()->reset(reset);
+    }
+
+    digsim::scheduler.set_partitioning(digsim::partitioning_t::clock_domains);
+    digsim::scheduler.set_num_threads(threads);
+    digsim::scheduler.initialize();
+
+    const auto topology = digsim::cpu_topology_t::detect();
+    std::cout << domains << " domains, " << digsim::scheduler.get_num_partitions() << " partitions, " << threads
+              << " threads, " << topology.num_cpus() << " CPUs on " << topology.nodes.size() << " node(s)\n";
+    for (auto placement : {digsim::placement_t::none, digsim::placement_t::compact, digsim::placement_t::scatter}) {
+        digsim::scheduler.set_placement(placement);
+        // Warm up, the threads are placed when the first parallel phase starts.
+        digsim::scheduler.run(time / 10);
+        const auto start = std::chrono::steady_clock::now();
+        digsim::scheduler.run(time);
+        const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        std::cout << "  " << digsim::to_string(placement) << ": " << elapsed.count() << " ms\n";
+    }
+    return 0;
+}
@@ -0,0 +1,142 @@
+/// @file activity.hpp
+/// @brief Switching activity of signals, exported in SAIF format for power estimation.
+/// @copyright
+/// This file is distributed under the terms of the MIT License.
+/// See the full license in the root directory at LICENSE.md.
+
+#pragma once
+
+#include "digsim/common.hpp"
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace digsim
+{
+
+/// @brief Accumulates, for every bit of every signal, the number of toggles (TC) and the time spent at 1 (T1).
+/// @details The counters are stored as structures of arrays: the per-signal arrays are indexed by slot, the per-bit
+/// arrays by the first bit of the signal plus the bit index. A change only adds the time elapsed since the previous
+/// change of the same signal, the time spent in the current value is added when the activity is exported, so that
+/// nothing is written while the simulation runs. The time at 0 (T0) is the remainder of the duration.
+///
+/// Signals whose type can be covered (see coverage_bits_t) register themselves on construction. While the activity is
+/// disabled they only store their current bits, so that a window opened mid-run starts from the actual values.
+class activity_t
+{
+public:
+    /// @brief Get the singleton instance of the activity.
+    /// @return A reference to the singleton instance of the activity.
+    static activity_t &instance();
+
+    /// @brief Enables or disables the accumulation, enabling it starts a new observation window.
+    /// @param _enabled true to accumulate the activity.
+    void enable(bool _enabled = true);
+
+    /// @brief Checks if the activity is being accumulated.
+    /// @return true if the activity is enabled, false otherwise.
+    bool is_enabled() const { return enabled; }
+
+    /// @brief Registers a signal, each signal gets its own counters.
+    /// @details Signals are keyed by their name, the ones sharing the name of a previous signal by the name followed
+    /// by `#` and their creation order among them, e.g., `count#1`.
+    /// @param name the name of the signal.
+    /// @param width the number of bits of the signal, at most 64.
+    /// @param bits the bits of the initial value.
+    /// @return the slot of the signal.
+    std::size_t add_signal(const std::string &name, std::size_t width, uint64_t bits);
+
+    /// @brief Sets the value of a signal without counting a toggle, e.g., when the signal is initialized.
+    /// @param slot the slot of the signal.
+    /// @param bits the bits of the new value.
+    void reset_value(std::size_t slot, uint64_t bits);
+
+    /// @brief Stores the bits of a signal which changed while the activity is disabled.
+    /// @param slot the slot of the signal.
+    /// @param bits the bits of the new value.
+    void sample(std::size_t slot, uint64_t bits) { values[slot] = bits; }
+
+    /// @brief Records a change of a signal at the current simulation time.
+    /// @param slot the slot of the signal.
+    /// @param old_bits the bits of the old value.
+    /// @param new_bits the bits of the new value.
+    void toggle(std::size_t slot, uint64_t old_bits, uint64_t new_bits);
+
+    /// @brief Clears the counters and starts a new observation window at the current simulation time.
+    void clear();
+
+    /// @brief Returns the number of toggles of a bit of a signal, up to now.
+    /// @param name the name of the signal.
+    /// @param bit the index of the bit.
+    /// @return the number of toggles.
+    uint64_t get_toggles(const std::string &name, std::size_t bit = 0) const;
+
+    /// @brief Returns the time a bit of a signal spent at 1, up to now.
+    /// @param name the name of the signal.
+    /// @param bit the index of the bit.
+    /// @return the time at 1.
+    discrete_time_t get_time_high(const std::string &name, std::size_t bit = 0) const;
+
+    /// @brief Returns the time a bit of a signal spent at 0, up to now.
+    /// @param name the name of the signal.
+    /// @param bit the index of the bit.
+    /// @return the time at 0.
+    discrete_time_t get_time_low(const std::string &name, std::size_t bit = 0) const;
+
+    /// @brief Writes the activity observed up to now in SAIF format.
+    /// @param os the output stream.
+    /// @param instance the name of the instance containing the nets.
+    /// @param timescale the duration of a simulation time unit, e.g., "1 ns".
+    void export_saif(
+        std::ostream &os,
+        const std::string &instance = "top",
+        const std::string &timescale = "1 ns") const;
+
+    /// @brief Writes the activity observed up to now to a SAIF file.
+    /// @param filename the name of the file.
+    /// @param instance the name of the instance containing the nets.
+    /// @param timescale the duration of a simulation time unit, e.g., "1 ns".
+    void export_saif(
+        const std::string &filename,
+        const std::string &instance = "top",
+        const std::string &timescale = "1 ns") const;
+
+private:
+    /// @brief Private constructor, for the singleton.
+    activity_t();
+
+    /// @brief Returns the position of a bit inside the per-bit arrays.
+    /// @param name the name of the signal.
+    /// @param bit the index of the bit.
+    /// @return the position.
+    std::size_t get_bit(const std::string &name, std::size_t bit) const;
+
+    /// @brief Whether the activity is being accumulated.
+    bool enabled;
+    /// @brief The start of the observation window.
+    discrete_time_t start;
+    /// @brief The keys of the signals, i.e., their names made unique, indexed by slot.
+    std::vector<std::string> names;
+    /// @brief The number of bits of the signals, indexed by slot.
+    std::vector<std::size_t> widths;
+    /// @brief The position of the first bit of the signals inside the per-bit arrays, indexed by slot.
+    std::vector<std::size_t> offsets;
+    /// @brief The current bits of the signals, indexed by slot.
+    std::vector<uint64_t> values;
+    /// @brief The time of the last change of the signals, indexed by slot.
+    std::vector<discrete_time_t> last_change;
+    /// @brief The number of toggles, indexed by bit.
+    std::vector<uint64_t> toggles;
+    /// @brief The time spent at 1 until the last change, indexed by bit.
+    std::vector<discrete_time_t> time_high;
+    /// @brief The slots of the signals, indexed by key.
+    std::unordered_map<std::string, std::size_t> slots;
+};
+
+/// @brief A reference to the singleton instance of the activity, for convenience.
+inline activity_t &activity = activity_t::instance();
+
+} // namespace digsim
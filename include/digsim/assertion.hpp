@@ -0,0 +1,203 @@
+/// @file assertion.hpp
+/// @brief Clocked temporal assertions, in the spirit of SystemVerilog Assertions.
+/// @copyright
+/// This file is distributed under the terms of the MIT License.
+/// See the full license in the root directory at LICENSE.md.
+
+#pragma once
+
+#include "digsim/module.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace digsim
+{
+
+/// @brief A boolean expression, sampled on the clock edges of an assertion.
+using condition_t = std::function<bool()>;
+
+/// @brief A sequence of conditions separated by clock delays, e.g., `a ##1 b ##[1:4] c`.
+class sequence_t
+{
+public:
+    /// @brief Creates a sequence starting with the given condition, i.e., `a`.
+    /// @param first the condition that must hold on the first cycle.
+    sequence_t(condition_t first);
+
+    /// @brief Creates a sequence starting after a delay, i.e., `##[min:max] a`.
+    /// @param min the minimum number of cycles before the condition.
+    /// @param max the maximum number of cycles before the condition.
+    /// @param first the condition.
+    /// @return the sequence.
+    static sequence_t after(std::size_t min, std::size_t max, condition_t first);
+
+    /// @brief Appends a condition on the next cycle, i.e., `##1 next`.
+    /// @param next the condition.
+    /// @return a reference to the sequence.
+    sequence_t &then(condition_t next);
+
+    /// @brief Appends a condition after a delay, i.e., `##[min:max] next`.
+    /// @param min the minimum number of cycles before the condition.
+    /// @param max the maximum number of cycles before the condition.
+    /// @param next the condition.
+    /// @return a reference to the sequence.
+    sequence_t &then(std::size_t min, std::size_t max, condition_t next);
+
+private:
+    /// @brief A step of the sequence.
+    struct step_t {
+        std::size_t min;       ///< Minimum delay from the previous step.
+        std::size_t max;       ///< Maximum delay from the previous step.
+        condition_t condition; ///< The condition that must hold.
+    };
+
+    /// @brief Creates an empty sequence.
+    sequence_t() = default;
+
+    /// @brief The steps of the sequence.
+    std::vector<step_t> steps;
+
+    friend class property_t;
+    friend class assertion_t;
+};
+
+/// @brief A property, i.e., a consequent sequence which must match every time the antecedent matches.
+class property_t
+{
+public:
+    /// @brief Creates an overlapping implication, i.e., `antecedent |-> consequent`.
+    /// @param antecedent the sequence that triggers the check.
+    /// @param consequent the sequence that must start on the cycle the antecedent ends.
+    /// @return the property.
+    static property_t implies(sequence_t antecedent, sequence_t consequent);
+
+    /// @brief Creates a non-overlapping implication, i.e., `antecedent |=> consequent`.
+    /// @param antecedent the sequence that triggers the check.
+    /// @param consequent the sequence that must start on the cycle after the antecedent ends.
+    /// @return the property.
+    static property_t implies_next(sequence_t antecedent, sequence_t consequent);
+
+    /// @brief Creates a property that must hold on every cycle, i.e., `always condition`.
+    /// @param condition the condition.
+    /// @return the property.
+    static property_t always(condition_t condition);
+
+private:
+    /// @brief Constructor.
+    /// @param _antecedent the sequence that triggers the check.
+    /// @param _consequent the sequence that must match.
+    property_t(sequence_t _antecedent, sequence_t _consequent);
+
+    /// @brief The sequence that triggers the check.
+    sequence_t antecedent;
+    /// @brief The sequence that must match.
+    sequence_t consequent;
+
+    friend class assertion_t;
+};
+
+/// @brief Checks a set of properties on the edges of a clock.
+/// @details Each sequence is compiled to a non-deterministic automaton whose active states fit a 64-bit mask, where
+/// every bit tracks a step of the sequence together with the cycles elapsed since the previous step. Each pending
+/// check of a consequent is a thread, stored as a mask in a flat array; threads in the same state are merged, and the
+/// conditions are only evaluated when a thread is waiting on them.
+///
+/// Values are sampled on the falling edges of the clock by default, when the logic triggered by the rising edges has
+/// settled, which mirrors the sampling of SystemVerilog assertions for designs clocked on the rising edges.
+class assertion_t : public module_t
+{
+public:
+    /// @brief The clock of the assertions.
+    input_t<bool> clk;
+
+    /// @brief Called when a property fails, with its name and the time at which the failing check started.
+    using failure_callback_t = std::function<void(const std::string &, discrete_time_t)>;
+
+    /// @brief Constructor.
+    /// @param _name the name of the module.
+    /// @param sample_on_rising_edge samples the conditions on the rising edges instead of the falling ones.
+    assertion_t(const std::string &_name, bool sample_on_rising_edge = false);
+
+    /// @brief Adds a property to check.
+    /// @param property_name the name of the property, used in the reports.
+    /// @param property the property.
+    /// @return the index of the property.
+    std::size_t add(const std::string &property_name, const property_t &property);
+
+    /// @brief Sets the function called when a property fails, by default the failure is logged as an error.
+    /// @details Checks which reached the same state are merged, and fail together: the function is called once for
+    /// all of them, with the time at which the oldest one started, while get_failures() counts each of them.
+    /// @param callback the function to call.
+    void on_failure(failure_callback_t callback);
+
+    /// @brief Returns the number of times a property failed, i.e., the number of failed checks.
+    /// @param index the index of the property.
+    /// @return the number of failures.
+    std::size_t get_failures(std::size_t index) const;
+
+    /// @brief Returns the number of times a property was checked successfully.
+    /// @param index the index of the property.
+    /// @return the number of successes.
+    std::size_t get_successes(std::size_t index) const;
+
+    /// @brief Returns the number of checks still in progress, over all properties.
+    /// @return the number of threads.
+    std::size_t get_pending() const;
+
+private:
+    /// @brief A sequence compiled to an automaton.
+    struct automaton_t {
+        /// @brief The conditions of the steps.
+        std::vector<condition_t> conditions;
+        /// @brief For each step, the states in which its condition is checked.
+        std::vector<uint64_t> windows;
+        /// @brief For each step, the state reached once the previous step matched.
+        std::vector<uint64_t> entries;
+        /// @brief The states which survive a clock edge, i.e., are still within their delay.
+        uint64_t keep = 0;
+    };
+
+    /// @brief A pending check of a consequent.
+    struct thread_t {
+        uint64_t states;       ///< The active states.
+        discrete_time_t start; ///< The time at which the oldest of the merged checks started.
+        std::size_t checks;    ///< The number of checks merged into this thread.
+    };
+
+    /// @brief A property, compiled.
+    struct compiled_property_t {
+        std::string name;              ///< The name of the property.
+        automaton_t antecedent;        ///< The antecedent automaton.
+        automaton_t consequent;        ///< The consequent automaton.
+        uint64_t antecedent_states;    ///< The active states of the antecedent.
+        std::vector<thread_t> threads; ///< The pending checks.
+        std::size_t failures;          ///< The number of failures.
+        std::size_t successes;         ///< The number of successes.
+    };
+
+    /// @brief Compiles a sequence to an automaton.
+    /// @param sequence the sequence.
+    /// @return the automaton.
+    static automaton_t compile(const sequence_t &sequence);
+
+    /// @brief Advances an automaton by one clock edge.
+    /// @param automaton the automaton.
+    /// @param states the active states, updated.
+    /// @param values the cached values of the conditions, -1 if not evaluated yet.
+    /// @return true if the sequence matched on this edge.
+    static bool advance(const automaton_t &automaton, uint64_t &states, std::vector<int8_t> &values);
+
+    /// @brief Checks all the properties.
+    void evaluate();
+
+    /// @brief The properties.
+    std::vector<compiled_property_t> properties;
+    /// @brief The function called when a property fails.
+    failure_callback_t failure_callback;
+    /// @brief Buffers for the values of the conditions, reused across edges.
+    std::vector<int8_t> antecedent_values, consequent_values;
+};
+
+} // namespace digsim
@@ -0,0 +1,173 @@
+/// @file bytecode_kernel.hpp
+/// @brief Simulation of frozen netlists by a bytecode interpreter.
+/// @copyright
+/// This file is distributed under the terms of the MIT License.
+/// See the full license in the root directory at LICENSE.md.
+
+#pragma once
+
+#include "digsim/netlist.hpp"
+
+#include <cstdint>
+#include <queue>
+#include <vector>
+
+namespace digsim
+{
+
+/// @brief Simulates a frozen netlist by translating it to bytecode, and interpreting it.
+/// @details The bytecode follows the structure of the code written by generate_cpp(), without the need of a compiler:
+/// the combinational gates become a straight-line program in level order, and each clock domain gets a program
+/// sampling its flip-flops, and one driving their outputs. Instructions read and write a dense array of values,
+/// which holds the nets, followed by constants, temporaries, and the samples of the flip-flops.
+///
+/// Gates with many inputs are split into chains of two-input instructions, while common patterns are fused into
+/// superinstructions, e.g., the sum and the carry of a full adder. With GCC and Clang, the interpreter dispatches
+/// with computed gotos, otherwise with a switch.
+///
+/// The values observed after each time step match the ones of netlist_kernel_t.
+class bytecode_kernel_t
+{
+public:
+    /// @brief The operations of the bytecode.
+    enum class opcode_t : uint8_t {
+        halt,            ///< Ends the program.
+        copy,            ///< dst = a.
+        not_,            ///< dst = ~a.
+        and_,            ///< dst = a & b.
+        or_,             ///< dst = a | b.
+        xor_,            ///< dst = a ^ b.
+        nand,            ///< dst = ~(a & b).
+        nor,             ///< dst = ~(a | b).
+        xnor,            ///< dst = ~(a ^ b).
+        and3,            ///< dst = a & b & c.
+        or3,             ///< dst = a | b | c.
+        xor3,            ///< dst = a ^ b ^ c.
+        maj,             ///< dst = majority of a, b, and c.
+        mux,             ///< dst = a ? c : b.
+        full_adder,      ///< dst = a ^ b ^ c, and d = majority of a, b, and c.
+        delayed,         ///< Queues a as the next value of the net dst, if the inputs of the gate b changed.
+        sample,          ///< dst = c ? 0 : (b ? a : d), i.e., the next state of a flip-flop.
+        sample_inverted, ///< dst = ~(c ? 0 : (b ? a : d)), the next output of a flip-flop driving its inverted state.
+        commit,          ///< dst = a.
+        commit_delayed,  ///< Queues a as the next value of the net dst.
+    };
+
+    /// @brief An instruction, operands are indexes in the array of values.
+    struct instruction_t {
+        opcode_t opcode; ///< The operation.
+        uint32_t dst;    ///< The written value, or the written net.
+        uint32_t a;      ///< The first operand.
+        uint32_t b;      ///< The second operand, or the gate for opcode_t::delayed.
+        uint32_t c;      ///< The third operand.
+        uint32_t d;      ///< The fourth operand, or the second written value.
+        uint64_t mask;   ///< The mask applied to the written values.
+    };
+
+    /// @brief Constructor, translates the netlist.
+    /// @param _netlist the netlist, which must outlive the kernel.
+    bytecode_kernel_t(const netlist_view_t &_netlist);
+
+    /// @brief Evaluates all the gates once, with the initial values of the nets, like scheduler_t::initialize().
+    void initialize();
+
+    /// @brief Runs the simulation, see scheduler_t::run().
+    /// @param simulation_time how long to run, 0 runs until there is nothing left to do.
+    void run(discrete_time_t simulation_time = 0);
+
+    /// @brief Returns the current simulation time.
+    /// @return the time of the last time step.
+    discrete_time_t time() const { return now; }
+
+    /// @brief Returns the value of a net.
+    /// @param net the index of the net.
+    /// @return the value.
+    uint64_t get(std::size_t net) const { return values[net]; }
+
+    /// @brief Sets the value of a net from outside the netlist, and settles the current time step.
+    /// @param net the index of the net.
+    /// @param value the value.
+    void set(std::size_t net, uint64_t value);
+
+    /// @brief Returns the bytecode.
+    /// @return the instructions of all the programs, each one ends with opcode_t::halt.
+    const std::vector<instruction_t> &get_code() const { return code; }
+
+private:
+    /// @brief A change of a net with a delay.
+    struct update_t {
+        discrete_time_t time; ///< When the change happens.
+        uint64_t sequence;    ///< Keeps the changes at the same time in the order they were queued.
+        uint32_t net;         ///< The net.
+        uint64_t value;       ///< The new value.
+
+        /// @brief Orders the changes from the latest, for the priority queue.
+        /// @param other the other change.
+        /// @return true if this change comes after the other one.
+        bool operator>(const update_t &other) const
+        {
+            return (time > other.time) || ((time == other.time) && (sequence > other.sequence));
+        }
+    };
+
+    /// @brief Adds a value to the array.
+    /// @param initial the initial value.
+    /// @return its index.
+    uint32_t add_value(uint64_t initial = 0);
+
+    /// @brief Appends an instruction, see instruction_t.
+    void emit(
+        opcode_t opcode,
+        uint32_t dst,
+        uint32_t a,
+        uint32_t b    = 0,
+        uint32_t c    = 0,
+        uint32_t d    = 0,
+        uint64_t mask = ~uint64_t{0});
+
+    /// @brief Translates a combinational gate.
+    /// @param gate the index of the gate.
+    /// @param dst where the result is written.
+    void translate(std::size_t gate, uint32_t dst);
+
+    /// @brief Executes a program.
+    /// @param pc the index of its first instruction.
+    /// @return true if a value changed.
+    bool execute(std::size_t pc);
+
+    /// @brief Evaluates the flip-flops woken up by their clocks, then the combinational gates, until nothing changes.
+    void settle();
+
+    /// @brief The netlist.
+    netlist_view_t netlist;
+    /// @brief The values of the nets, then the constants, the temporaries, and the samples of the flip-flops.
+    std::vector<uint64_t> values;
+    /// @brief The inputs of the combinational gates driving nets with a delay, when they last drove them.
+    std::vector<uint64_t> seen;
+    /// @brief The bytecode.
+    std::vector<instruction_t> code;
+    /// @brief The program evaluating the combinational gates.
+    std::size_t evaluate_program;
+    /// @brief The programs sampling and driving the flip-flops of each clock domain.
+    std::vector<std::size_t> sample_programs;
+    std::vector<std::size_t> commit_programs;
+    /// @brief The clock net of each domain, and its value when it was last sampled.
+    std::vector<uint32_t> domain_clocks;
+    std::vector<uint8_t> last_clock;
+    /// @brief Whether the clock of each domain rose in the current pass.
+    std::vector<uint8_t> rising;
+    /// @brief Whether the combinational gates contain loops, thus, must be evaluated until nothing changes.
+    bool has_loops;
+    /// @brief The time of the next edge of each clock.
+    std::vector<discrete_time_t> next_edge;
+    /// @brief The pending changes of nets with a delay.
+    std::priority_queue<update_t, std::vector<update_t>, std::greater<>> updates;
+    /// @brief The number of changes queued so far.
+    uint64_t sequence;
+    /// @brief The current simulation time.
+    discrete_time_t now;
+    /// @brief Whether the gates have been evaluated with the initial values.
+    bool initialized;
+};
+
+} // namespace digsim
@@ -7,13 +7,14 @@
 #pragma once
 
 #include "digsim/module.hpp"
+#include "digsim/netlist.hpp"
 #include "digsim/output.hpp"
 
 namespace digsim
 {
 
 /// @brief Clock module that generates a periodic signal.
-class clock_t : public module_t
+class clock_t : public module_t, public structural_t
 {
 public:
     /// @brief Output signal representing the clock.
@@ -32,6 +33,10 @@ public:
         discrete_time_t clk_start_time = 0,
         bool clk_posedge_first         = false);
 
+    /// @brief Adds the clock to the netlist.
+    /// @param netlist the netlist being built.
+    void describe(netlist_t &netlist) const override;
+
 private:
     /// @brief Evaluates the clock signal at the current simulation time.
     void evaluate();
@@ -40,6 +45,10 @@ private:
     discrete_time_t period;
     /// @brief The duty cycle of the clock signal, as a fraction of the period.
     double duty_cycle;
+    /// @brief The time of the first edge of the clock signal.
+    discrete_time_t first_edge;
+    /// @brief The process evaluating the clock signal.
+    process_info_t process;
 };
 
 } // namespace digsim
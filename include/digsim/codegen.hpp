@@ -0,0 +1,39 @@
+/// @file codegen.hpp
+/// @brief Generation of straight-line C++ from a frozen netlist.
+/// @copyright
+/// This file is distributed under the terms of the MIT License.
+/// See the full license in the root directory at LICENSE.md.
+
+#pragma once
+
+#include "digsim/netlist.hpp"
+
+#include <ostream>
+#include <string>
+
+namespace digsim
+{
+
+/// @brief Writes a self-contained C++ header with a class simulating a netlist, which only depends on the standard
+/// library and is compiled by the system compiler together with the testbench.
+/// @details The nets become members of the class, named after the signals, and the gates become statements:
+///  - each clock domain, i.e., the flip-flops sharing a clock net, gets a sample and a commit function, so that the
+///    flip-flops of all domains sample their inputs before any of them drives its output;
+///  - the combinational gates are evaluated in a single function, in level order, without checking what changed;
+///    if the netlist has combinational loops, the function is repeated until nothing changes.
+///
+/// Nets with a delay and clocks are handled as by netlist_kernel_t, and the generated class exposes the same
+/// interface: initialize(), run(), time(), get(), and set(), with the nets indexed as in the netlist. Thus, the
+/// values observed after each time step match the ones of the kernel, and of the event-driven simulation.
+/// @param netlist the netlist.
+/// @param os the output stream.
+/// @param class_name the name of the generated class, a valid C++ identifier.
+void generate_cpp(const netlist_view_t &netlist, std::ostream &os, const std::string &class_name);
+
+/// @brief Writes a self-contained C++ header with a class simulating a netlist to a file.
+/// @param netlist the netlist.
+/// @param filename the name of the file.
+/// @param class_name the name of the generated class, a valid C++ identifier.
+void generate_cpp(const netlist_view_t &netlist, const std::string &filename, const std::string &class_name);
+
+} // namespace digsim
@@ -11,7 +11,10 @@
 #include <cstdint>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace digsim
 {
@@ -19,6 +22,9 @@ namespace digsim
 /// @brief Type of the simulation time.
 using discrete_time_t = uint64_t;
 
+/// @brief A bitmask telling which sensitivity entries of a process changed.
+using sensitivity_mask_t = uint64_t;
+
 /// @brief The types of the processes.
 using process_t = std::function<void()>;
 
@@ -42,6 +48,7 @@ struct process_info_t {
     std::uintptr_t key;                 ///< A unique key for the process.
     object_ref_t owner;                 ///< The object instance that contains the method to be executed.
     std::string name;                   ///< The name of the process, typically in the format "obj.method".
+    std::size_t id;                     ///< The index of the process inside the process table.
 
     /// @brief Returns a string representation of the process information.
     /// @return A string containing the object's address, method name, and process name.
@@ -79,6 +86,47 @@ struct process_info_equal {
     bool operator()(const process_info_t &lhs, const process_info_t &rhs) const noexcept;
 };
 
+/// @brief Keeps track of all the processes created during elaboration, indexed by their id.
+class process_table_t
+{
+public:
+    /// @brief Get the singleton instance of the process table.
+    /// @return A reference to the singleton instance of the process table.
+    static process_table_t &instance();
+
+    /// @brief Adds a process to the table, and assigns it a unique id.
+    /// @param info the process to add, its id is updated with the assigned one.
+    void add(process_info_t &info);
+
+    /// @brief Returns the number of processes in the table.
+    /// @return the number of processes.
+    std::size_t size() const;
+
+    /// @brief Returns the process with the given id.
+    /// @param id the id of the process.
+    /// @return a reference to the process information.
+    const process_info_t &get(std::size_t id) const;
+
+    /// @brief Returns the processes owned by an object.
+    /// @param owner the object.
+    /// @return the ids of the processes, in creation order.
+    const std::vector<std::size_t> &get_owned(const named_object_t *owner) const;
+
+private:
+    /// @brief Private constructor for the singleton pattern.
+    process_table_t() = default;
+
+    /// @brief The list of processes, indexed by their id.
+    std::vector<process_info_t> processes;
+    /// @brief Maps each object to the ids of the processes it owns.
+    std::unordered_map<const named_object_t *, std::vector<std::size_t>> owned;
+    /// @brief Protects the table against concurrent insertions.
+    std::mutex mutex;
+};
+
+/// @brief A reference to the singleton instance of the process table, for convenience.
+inline process_table_t &process_table = process_table_t::instance();
+
 /// @brief Outputs the name of an object reference to a stream.
 /// @param os The output stream to write to.
 /// @param ref The object reference to output.
@@ -121,16 +169,19 @@ template <typename Object>
 process_info_t get_or_create_process(Object *obj, void (Object::*method)(), const std::string &name = "")
 {
     static std::unordered_map<std::uintptr_t, process_info_t> method_cache;
+    static std::mutex method_cache_mutex;
     auto key = digsim::get_method_key(obj, method);
     if (!key) {
         throw std::runtime_error("Failed to generate method key.");
     }
+    std::lock_guard<std::mutex> lock(method_cache_mutex);
     auto it = method_cache.find(key);
     if (it != method_cache.end()) {
         return it->second;
     }
     auto proc = std::make_shared<process_t>([obj, method]() { (obj->*method)(); });
-    process_info_t info{proc, key, object_ref_t(static_cast<const named_object_t *>(obj)), name};
+    process_info_t info{proc, key, object_ref_t(static_cast<const named_object_t *>(obj)), name, 0};
+    process_table.add(info);
     method_cache[key] = info;
     return info;
 }
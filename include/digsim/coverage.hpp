@@ -0,0 +1,235 @@
+/// @file coverage.hpp
+/// @brief Toggle coverage of signals, and coverage of user-defined points such as FSM states and opcodes.
+/// @copyright
+/// This file is distributed under the terms of the MIT License.
+/// See the full license in the root directory at LICENSE.md.
+
+#pragma once
+
+#include "digsim/common.hpp"
+
+#include <bitset>
+#include <cstdint>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace digsim
+{
+
+/// @brief Extracts the bits of a value, for the toggle coverage.
+/// @details Types which do not specialize it have a width of zero, and their signals are not covered.
+/// @tparam T the type of the signal value.
+template <typename T> struct coverage_bits_t {
+    /// @brief The number of bits covered.
+    static constexpr std::size_t width = 0;
+
+    /// @brief Returns the bits of the value.
+    /// @return the bits, packed in a word.
+    static uint64_t bits(const T &) { return 0; }
+};
+
+/// @brief Extracts the bits of booleans, integers, and enumerations.
+/// @tparam T the type of the signal value.
+template <typename T>
+    requires(std::is_integral_v<T> || std::is_enum_v<T>)
+struct coverage_bits_t<T> {
+    /// @brief The number of bits covered.
+    static constexpr std::size_t width = std::is_same_v<T, bool> ? 1 : sizeof(T) * 8;
+
+    /// @brief Returns the bits of the value.
+    /// @param value the value.
+    /// @return the bits, packed in a word.
+    static uint64_t bits(const T &value)
+    {
+        if constexpr (std::is_same_v<T, bool>) {
+            return value ? 1 : 0;
+        } else if constexpr (std::is_enum_v<T>) {
+            return static_cast<uint64_t>(static_cast<std::make_unsigned_t<std::underlying_type_t<T>>>(value));
+        } else {
+            return static_cast<uint64_t>(static_cast<std::make_unsigned_t<T>>(value));
+        }
+    }
+};
+
+/// @brief Extracts the bits of bitsets, up to 64 bits.
+/// @tparam N the number of bits of the bitset.
+template <std::size_t N>
+    requires(N <= 64)
+struct coverage_bits_t<std::bitset<N>> {
+    /// @brief The number of bits covered.
+    static constexpr std::size_t width = N;
+
+    /// @brief Returns the bits of the value.
+    /// @param value the value.
+    /// @return the bits, packed in a word.
+    static uint64_t bits(const std::bitset<N> &value) { return static_cast<uint64_t>(value.to_ullong()); }
+};
+
+/// @brief Collects the coverage of a simulation.
+/// @details Signals register themselves on construction and get a slot, i.e., the index of their counters. The toggle
+/// counters are bit-packed, one word per signal for each direction, and are only updated while the coverage is
+/// enabled, so that leaving it disabled costs a single branch per signal change.
+///
+/// Coverage points count the hits of a set of bins, e.g., the opcodes executed by a decoder, and optionally the
+/// transitions between consecutive samples, e.g., the arcs taken by an FSM. Results are saved in a binary database,
+/// which can be merged with the ones of other runs before writing the text report.
+class coverage_t
+{
+public:
+    /// @brief Get the singleton instance of the coverage.
+    /// @return A reference to the singleton instance of the coverage.
+    static coverage_t &instance();
+
+    /// @brief Value returned for objects which are not covered.
+    static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+    /// @brief Enables or disables the collection of the coverage.
+    /// @param _enabled true to collect the coverage.
+    void enable(bool _enabled = true) { enabled = _enabled; }
+
+    /// @brief Checks if the coverage is being collected.
+    /// @return true if the coverage is enabled, false otherwise.
+    bool is_enabled() const { return enabled; }
+
+    /// @brief Registers a signal for the toggle coverage, each signal gets its own counters.
+    /// @details Signals are keyed by their name, the ones sharing the name of a previous signal by the name followed
+    /// by `#` and their creation order among them, e.g., `count#1`, so that the databases of runs of the same design
+    /// are merged signal by signal.
+    /// @param name the name of the signal.
+    /// @param width the number of bits of the signal, at most 64.
+    /// @return the slot of the signal.
+    std::size_t add_signal(const std::string &name, std::size_t width);
+
+    /// @brief Records a change of a signal.
+    /// @param slot the slot of the signal.
+    /// @param old_bits the bits of the old value.
+    /// @param new_bits the bits of the new value.
+    void toggle(std::size_t slot, uint64_t old_bits, uint64_t new_bits)
+    {
+        rises[slot] |= ~old_bits & new_bits;
+        falls[slot] |= old_bits & ~new_bits;
+    }
+
+    /// @brief Registers a coverage point.
+    /// @param name the name of the point.
+    /// @param bins the names of the bins, indexed by the sampled value. Bins with an empty name are ignored.
+    /// @param transitions whether to also cover the transitions between consecutive samples.
+    /// @return the index of the point.
+    std::size_t add_point(const std::string &name, std::vector<std::string> bins, bool transitions = false);
+
+    /// @brief Registers a coverage point for the states of an FSM, including the transitions between them.
+    /// @param name the name of the FSM.
+    /// @param states the names of the states, indexed by their encoding.
+    /// @return the index of the point.
+    std::size_t add_fsm(const std::string &name, std::vector<std::string> states);
+
+    /// @brief Records a sample of a coverage point, does nothing if the coverage is disabled.
+    /// @param point the index of the point.
+    /// @param bin the sampled bin, values outside the bins are ignored.
+    void sample(std::size_t point, std::size_t bin);
+
+    /// @brief Returns the rising toggles of a signal.
+    /// @param name the name of the signal.
+    /// @return the bits which went from 0 to 1.
+    uint64_t get_rises(const std::string &name) const;
+
+    /// @brief Returns the falling toggles of a signal.
+    /// @param name the name of the signal.
+    /// @return the bits which went from 1 to 0.
+    uint64_t get_falls(const std::string &name) const;
+
+    /// @brief Checks if a bin of a coverage point was hit.
+    /// @param name the name of the point.
+    /// @param bin the bin.
+    /// @return true if the bin was hit, false otherwise.
+    bool is_hit(const std::string &name, std::size_t bin) const;
+
+    /// @brief Checks if a transition of a coverage point was taken.
+    /// @param name the name of the point.
+    /// @param from the source bin.
+    /// @param to the destination bin.
+    /// @return true if the transition was taken, false otherwise.
+    bool is_hit(const std::string &name, std::size_t from, std::size_t to) const;
+
+    /// @brief Returns the fraction of signal bits which toggled in both directions.
+    /// @return the toggle coverage, between 0 and 1.
+    double get_toggle_coverage() const;
+
+    /// @brief Returns the fraction of bins of a coverage point which were hit.
+    /// @param name the name of the point.
+    /// @return the coverage of the point, between 0 and 1.
+    double get_point_coverage(const std::string &name) const;
+
+    /// @brief Clears the counters, keeping the registered signals and points.
+    void clear();
+
+    /// @brief Saves the counters to a binary database.
+    /// @param filename the name of the file.
+    void save(const std::string &filename) const;
+
+    /// @brief Merges the counters of a binary database into the current ones.
+    /// @param filename the name of the file.
+    void merge(const std::string &filename);
+
+    /// @brief Writes a human-readable report.
+    /// @param os the output stream.
+    void report(std::ostream &os) const;
+
+private:
+    /// @brief A coverage point.
+    struct point_t {
+        std::string name;              ///< The name of the point.
+        std::vector<std::string> bins; ///< The names of the bins.
+        bool transitions;              ///< Whether transitions are covered.
+        std::vector<uint64_t> hits;    ///< The bins hit, bit-packed.
+        std::vector<uint64_t> arcs;    ///< The transitions taken, bit-packed as a matrix.
+        std::size_t last;              ///< The last sampled bin.
+    };
+
+    /// @brief Private constructor, for the singleton.
+    coverage_t();
+
+    /// @brief Returns the slot of a signal.
+    /// @param name the name of the signal.
+    /// @return the slot.
+    std::size_t get_slot(const std::string &name) const;
+
+    /// @brief Returns the slot with the given key, adding it if needed, e.g., while merging a database.
+    /// @param key the key of the signal.
+    /// @param width the number of bits of the signal, at most 64.
+    /// @return the slot.
+    std::size_t find_or_add_slot(const std::string &key, std::size_t width);
+
+    /// @brief Returns a coverage point.
+    /// @param name the name of the point.
+    /// @return a reference to the point.
+    const point_t &get_point(const std::string &name) const;
+
+    /// @brief Whether the coverage is being collected.
+    bool enabled;
+    /// @brief The keys of the signals, i.e., their names made unique, indexed by slot.
+    std::vector<std::string> names;
+    /// @brief The number of bits of the signals, indexed by slot.
+    std::vector<std::size_t> widths;
+    /// @brief The bits which went from 0 to 1, indexed by slot.
+    std::vector<uint64_t> rises;
+    /// @brief The bits which went from 1 to 0, indexed by slot.
+    std::vector<uint64_t> falls;
+    /// @brief The slots of the signals, indexed by key.
+    std::unordered_map<std::string, std::size_t> slots;
+    /// @brief Whether a signal was registered for each slot, the other ones only come from a database.
+    std::vector<std::uint8_t> registered;
+    /// @brief The coverage points.
+    std::vector<point_t> points;
+    /// @brief The indices of the coverage points, indexed by name.
+    std::unordered_map<std::string, std::size_t> point_indices;
+};
+
+/// @brief A reference to the singleton instance of the coverage, for convenience.
+inline coverage_t &coverage = coverage_t::instance();
+
+} // namespace digsim
@@ -20,6 +20,55 @@ class isignal_t; // Forward declare abstract signal.
 /// @brief Defines how a path is represented in the dependency graph.
 using path_t = std::vector<const isignal_t *>;
 
+/// @brief A clock domain, i.e., the set of processes driven by the same clock.
+struct clock_domain_t {
+    /// @brief The clock signal of the domain, nullptr for the default (unclocked) domain.
+    const isignal_t *clock = nullptr;
+    /// @brief The module generating the clock, nullptr for the default (unclocked) domain.
+    const module_t *source = nullptr;
+    /// @brief The processes belonging to the domain.
+    std::vector<process_info_t> processes;
+    /// @brief The signals produced in another domain, and consumed or also produced by this one.
+    std::vector<const isignal_t *> crossings;
+    /// @brief The minimum delay among the crossing signals, i.e., how far ahead the domain can safely run.
+    discrete_time_t lookahead = 0;
+};
+
+/// @brief A signal going from the process producing it to a process consuming it.
+struct process_edge_t {
+    /// @brief The id of the producer.
+    std::size_t producer = 0;
+    /// @brief The id of the consumer.
+    std::size_t consumer = 0;
+    /// @brief The signal.
+    const isignal_t *signal = nullptr;
+};
+
+/// @brief A timing path, i.e., a chain of signals, each one produced by a process consuming the previous one.
+struct timing_path_t {
+    /// @brief The signals, from the start point to the end point.
+    path_t signals;
+    /// @brief The sum of the delays of the signals.
+    discrete_time_t delay = 0;
+    /// @brief The number of signals without delay, i.e., the delta cycles spent along the path.
+    std::size_t deltas = 0;
+};
+
+/// @brief The results of the static timing analysis, see dependency_graph_t::compute_timing().
+struct timing_report_t {
+    /// @brief The longest paths, sorted by decreasing delay.
+    std::vector<timing_path_t> critical_paths;
+    /// @brief The shortest path.
+    timing_path_t shortest_path;
+    /// @brief The longest chain of signals without delay woken up by each clock, i.e., its delta-cycle depth.
+    std::vector<std::pair<const isignal_t *, std::size_t>> delta_depth;
+    /// @brief For each partition, the minimum delay of the signals it produces for other partitions.
+    /// @details The maximum discrete_time_t if the partition produces nothing for the others.
+    std::vector<discrete_time_t> lookahead;
+    /// @brief The number of loops, each one is cut where the search first closes it.
+    std::size_t loops = 0;
+};
+
 /// @brief Process information structure that contains details about the process
 /// that produces or consumes a signal.
 class dependency_graph_t
@@ -63,6 +112,65 @@ public:
     /// @return true if the cycle is a bad cycle, false otherwise.
     bool is_bad_cycle(const path_t &cycle) const;
 
+    /// @brief Infers the clock domains, i.e., which processes are sensitive to which clock.
+    /// @details The first domain is the default one, containing all the processes that are not driven by a clock_t.
+    /// Combinational processes are assigned to the domain of the processes producing their inputs. Signals connecting
+    /// different domains, including signals driven from more than one domain, are marked as crossing.
+    void compute_clock_domains();
+
+    /// @brief Returns the clock domains computed by compute_clock_domains().
+    /// @return the list of clock domains.
+    const std::vector<clock_domain_t> &get_clock_domains() const;
+
+    /// @brief Returns the clock domain of a process.
+    /// @param proc_info the process.
+    /// @return the index of the clock domain, 0 if the process is not driven by any clock.
+    std::size_t get_clock_domain(const process_info_t &proc_info) const;
+
+    /// @brief Prints a report of the clock domains and their crossing signals.
+    void print_clock_domain_report() const;
+
+    /// @brief Restores the clock domains computed by a previous run, instead of inferring them again.
+    /// @details The processes of each domain, the clocks, and the crossing signals are rebuilt from the domain of each
+    /// process, which only takes a pass over the producers and consumers.
+    /// @param domains the index of the clock domain of each process, indexed by process id.
+    void restore_clock_domains(const std::vector<std::size_t> &domains);
+
+    /// @brief Computes a fingerprint of the design, i.e., of its processes and of how ports are bound to signals.
+    /// @details Two runs elaborating the same design get the same fingerprint, so the results of the analyses can
+    /// be reused (see elaboration_cache_t). The fingerprint does not depend on memory layout, and it tells apart
+    /// ports sharing a signal from ports bound to distinct signals with the same name.
+    /// @return the fingerprint.
+    std::uint64_t compute_fingerprint() const;
+
+    /// @brief Sorts the processes by their topological level, i.e., the longest chain of producers feeding them.
+    /// @details Processes with the same level are sorted by id. Processes belonging to a cycle come after all the
+    /// others, since they have no well-defined level.
+    /// @return the ids of all the processes in the process table, in topological order.
+    std::vector<std::size_t> compute_topological_order() const;
+
+    /// @brief Returns the edges between the processes, i.e., which signals each process sends to the others.
+    /// @details Processes owned by a signal, e.g., its delayed updates, consume the signal as well. The edges are
+    /// sorted by producer, consumer, and name of the signal, so that they do not depend on memory layout. A process
+    /// consuming its own signal gets no edge.
+    /// @return the edges.
+    std::vector<process_edge_t> get_process_edges() const;
+
+    /// @brief Computes the timing of the design, from the delays of the signals.
+    /// @details Paths start from the signals nobody produces, and from the outputs of sequential processes, i.e., of
+    /// the processes consuming a clock. They end at the signals nobody consumes, and at the data inputs of sequential
+    /// processes. Each signal along a path adds its delay, and, if it has none, a delta cycle. Loops are cut, see
+    /// compute_cycles() for the bad ones.
+    /// @param top_k how many critical paths to report.
+    /// @param partitions the partition of each process, indexed by process id. If empty, the clock domains computed
+    /// by compute_clock_domains() are used.
+    /// @return the report.
+    timing_report_t compute_timing(std::size_t top_k = 5, const std::vector<std::size_t> &partitions = {}) const;
+
+    /// @brief Prints a report of the timing analysis, with the hierarchical names of the signals.
+    /// @param report the report returned by compute_timing().
+    void print_timing_report(const timing_report_t &report) const;
+
 private:
     dependency_graph_t()                                      = default;
     ~dependency_graph_t()                                     = default;
@@ -104,6 +212,20 @@ private:
     /// @return A vector of pointers to all signal interfaces in the graph.
     std::vector<const isignal_t *> get_all_signals() const;
 
+    /// @brief Resolves the producers and consumers of each signal, through the ports bound to it.
+    /// @param producers_of filled with the producers of each signal.
+    /// @param consumers_of filled with the consumers of each signal, sorted by id.
+    void resolve_signals(
+        std::unordered_map<const isignal_t *, std::vector<process_info_t>> &producers_of,
+        std::unordered_map<const isignal_t *, std::vector<process_info_t>> &consumers_of) const;
+
+    /// @brief Marks the signals connecting different clock domains, and computes the lookahead of the domains.
+    /// @param producers_of the producers of each signal.
+    /// @param consumers_of the consumers of each signal.
+    void mark_crossings(
+        const std::unordered_map<const isignal_t *, std::vector<process_info_t>> &producers_of,
+        const std::unordered_map<const isignal_t *, std::vector<process_info_t>> &consumers_of);
+
     /// @brief Updates the signal graph based on the current state of the dependency graph.
     void update_signal_graph();
 
@@ -125,6 +247,10 @@ private:
     std::unordered_map<const isignal_t *, std::vector<const isignal_t *>> signal_graph;
     /// @brief A vector of cycles detected in the dependency graph.
     std::vector<path_t> cycles;
+    /// @brief The clock domains.
+    std::vector<clock_domain_t> clock_domains;
+    /// @brief Maps each process id to the index of its clock domain.
+    std::vector<std::size_t> process_domain;
 };
 
 /// @brief A reference to the singleton instance of the scheduler, for convenience.
@@ -25,8 +25,24 @@ enum : unsigned char {
 #include "digsim/module.hpp"
 #include "digsim/output.hpp"
 #include "digsim/scheduler.hpp"
+#include "digsim/sensitivity.hpp"
 #include "digsim/signal.hpp"
 
 // Simulation components
+#include "digsim/activity.hpp"
+#include "digsim/assertion.hpp"
+#include "digsim/bytecode_kernel.hpp"
 #include "digsim/clock.hpp"
+#include "digsim/codegen.hpp"
+#include "digsim/coverage.hpp"
+#include "digsim/distributed.hpp"
+#include "digsim/elaboration_cache.hpp"
+#include "digsim/jit_kernel.hpp"
+#include "digsim/netlist.hpp"
+#include "digsim/netlist_kernel.hpp"
+#include "digsim/partitioner.hpp"
+#include "digsim/placement.hpp"
 #include "digsim/probe.hpp"
+#include "digsim/quantum_keeper.hpp"
+#include "digsim/state_log.hpp"
+#include "digsim/static_netlist.hpp"
@@ -0,0 +1,322 @@
+/// @file distributed.hpp
+/// @brief Simulation of a design split across several processes, exchanging the boundary signals over sockets.
+/// @copyright
+/// This file is distributed under the terms of the MIT License.
+/// See the full license in the root directory at LICENSE.md.
+
+#pragma once
+
+#include "digsim/named_object.hpp"
+#include "digsim/signal.hpp"
+#include "digsim/static_netlist.hpp"
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace digsim
+{
+
+/// @brief A connected stream socket, carrying length-prefixed frames.
+/// @details While a send waits for room in the socket, the channel receives what the other side sends, and keeps it
+/// for the following receives, so that two processes sending to each other at once cannot block each other.
+class channel_t
+{
+public:
+    /// @brief Constructor, the channel is not connected.
+    channel_t();
+
+    /// @brief Constructor, taking ownership of a connected socket.
+    /// @param _fd the file descriptor of the socket.
+    explicit channel_t(int _fd);
+
+    /// @brief Destructor, closes the socket.
+    ~channel_t();
+
+    channel_t(const channel_t &)            = delete;
+    channel_t &operator=(const channel_t &) = delete;
+    channel_t(channel_t &&other) noexcept;
+    channel_t &operator=(channel_t &&other) noexcept;
+
+    /// @brief Creates two connected channels, e.g., to be shared with a child process by fork().
+    /// @return the two ends of the connection.
+    static std::pair<channel_t, channel_t> make_pair();
+
+    /// @brief Waits for a connection on a Unix-domain socket.
+    /// @param path the path of the socket, which is removed once connected.
+    /// @return the connected channel.
+    static channel_t listen_unix(const std::string &path);
+
+    /// @brief Connects to a Unix-domain socket, waiting for the other side to listen.
+    /// @param path the path of the socket.
+    /// @param timeout_ms how long to wait for the other side, in milliseconds.
+    /// @return the connected channel.
+    static channel_t connect_unix(const std::string &path, unsigned timeout_ms = 5000);
+
+    /// @brief Waits for a TCP connection on all the interfaces.
+    /// @param port the port.
+    /// @return the connected channel.
+    static channel_t listen_tcp(std::uint16_t port);
+
+    /// @brief Connects to a TCP port, waiting for the other side to listen.
+    /// @param host the name or the address of the host.
+    /// @param port the port.
+    /// @param timeout_ms how long to wait for the other side, in milliseconds.
+    /// @return the connected channel.
+    static channel_t connect_tcp(const std::string &host, std::uint16_t port, unsigned timeout_ms = 5000);
+
+    /// @brief Sends a frame, which is dropped if the other side closed the connection.
+    /// @param frame the content of the frame.
+    void send(const std::string &frame);
+
+    /// @brief Sends several frames at once, which are dropped if the other side closed the connection.
+    /// @param frames the contents of the frames.
+    void send(const std::vector<std::string> &frames);
+
+    /// @brief Receives a frame, waiting for it.
+    /// @param frame where the content of the frame is stored.
+    /// @return true if a frame was received, false if the other side closed the connection.
+    bool receive(std::string &frame);
+
+    /// @brief Waits until one of the channels has something to receive, or was closed by the other side.
+    /// @param channels the channels.
+    /// @param timeout_ms how long to wait, in milliseconds, -1 waits forever.
+    /// @return the index of a ready channel, or the number of channels if none is ready before the timeout.
+    static std::size_t wait_any(const std::vector<const channel_t *> &channels, int timeout_ms = -1);
+
+    /// @brief Checks if the channel is connected.
+    /// @return true if the channel owns a socket.
+    bool is_open() const { return fd >= 0; }
+
+private:
+    /// @brief Receives what is available without waiting, and keeps it for the following receives.
+    /// @return false if the other side closed the connection.
+    bool buffer_input();
+
+    /// @brief The file descriptor of the socket, -1 if not connected.
+    int fd;
+    /// @brief The bytes received while sending, not yet returned by receive().
+    std::string input;
+    /// @brief The position of the first byte of input not yet returned by receive().
+    std::size_t input_offset;
+};
+
+/// @brief One end of the connection with another simulator process, running another part of the design.
+/// @details Each signal at the boundary is produced on one side, where it is sent, and is replicated on the other
+/// side, where it is received: each change of the original signal at time t is applied to the replica at time t plus
+/// the lookahead, i.e., the delay of the connection. Values travel as 64-bit words, see coverage_bits_t and
+/// from_bits(). The processes run either in lockstep with conservative synchronization, see run_distributed(), or
+/// optimistically, see run_optimistic(); all the processes of a simulation must use the same one.
+class peer_t : public named_object_t
+{
+public:
+    /// @brief Constructor.
+    /// @param _name the name of the peer, used in the messages.
+    /// @param _channel the connection with the other process.
+    /// @param _lookahead the delay of the signals sent to the other process, it must be at least 1.
+    peer_t(const std::string &_name, channel_t _channel, discrete_time_t _lookahead);
+
+    /// @brief Destructor, stops watching the signals sent to the other process.
+    ~peer_t() override;
+
+    /// @brief Sends the changes of a signal to the other process.
+    /// @details The changes are collected by a watchpoint on the signal, removed when the peer is destroyed, thus, the
+    /// signal must outlive the peer.
+    /// @param signal_name the name of the signal, shared by the two processes.
+    /// @param signal the signal.
+    template <typename T> void send_signal(const std::string &signal_name, signal_t<T> &signal);
+
+    /// @brief Drives a signal with the changes sent by the other process.
+    /// @details The received values are written with signal_t::set(), thus, the delay of the signal adds up to the
+    /// lookahead of the other process.
+    /// @param signal_name the name of the signal, shared by the two processes.
+    /// @param signal the replica of the signal.
+    template <typename T> void receive_signal(const std::string &signal_name, signal_t<T> &signal);
+
+    /// @brief Returns the delay of the signals sent to the other process.
+    /// @return the lookahead.
+    discrete_time_t get_lookahead() const { return lookahead; }
+
+    /// @brief Returns how many messages were sent, i.e., values, time promises, anti-messages, and reports.
+    /// @return the number of messages.
+    std::uint64_t get_messages_sent() const { return messages_sent; }
+
+    /// @brief Returns how many times a value received from the other process arrived too late, or was cancelled
+    /// too late, so that the optimistic simulation had to go back in time.
+    /// @return the number of rollbacks.
+    std::uint64_t get_rollbacks() const { return rollbacks; }
+
+    /// @brief Returns how many values sent to the other process were cancelled by an anti-message.
+    /// @return the number of anti-messages.
+    std::uint64_t get_anti_messages() const { return anti_messages; }
+
+private:
+    friend void run_distributed(const std::vector<peer_t *> &peers, discrete_time_t end_time);
+    friend void run_optimistic(const std::vector<peer_t *> &peers, discrete_time_t end_time, discrete_time_t window);
+
+    /// @brief A change of a signal, sent or received.
+    struct update_t {
+        discrete_time_t time; ///< The time the value is applied by the receiver.
+        std::size_t index;    ///< The index of the signal, among the ones sent by the sender.
+        std::uint64_t bits;   ///< The value.
+    };
+
+    /// @brief Sends the names of the signals sent from here, and matches the ones sent by the other process.
+    void handshake();
+
+    /// @brief Sends the changes recorded so far, an optimistic simulation keeps them until they are committed.
+    void flush();
+
+    /// @brief Sends an anti-message for each value sent by the time steps being executed again.
+    /// @param step the first time step executed again.
+    void cancel(discrete_time_t step);
+
+    /// @brief Tells the other process how far this one got, and how many messages it received, if it changed.
+    /// @param floor the earliest time this process might still execute, or send a value for.
+    void report(discrete_time_t floor);
+
+    /// @brief Returns the earliest time of the values and anti-messages the other process did not receive yet.
+    /// @return the time, or the largest time if they were all received.
+    discrete_time_t unacknowledged() const;
+
+    /// @brief Drops the values sent and received before a time, which can no longer be cancelled.
+    /// @param time the global virtual time.
+    void commit(discrete_time_t time);
+
+    /// @brief Waits for a message of the optimistic synchronization, and handles the reports.
+    /// @param update where a value, or the value cancelled by an anti-message, is stored, with its local index.
+    /// @return the kind of message, or 0 if the other process closed the connection.
+    char read(update_t &update);
+
+    /// @brief Promises the other process that no value will be sent for a time before the given one.
+    /// @param time the time, only sent if later than the last promise.
+    void promise(discrete_time_t time);
+
+    /// @brief Waits for a message, and handles it.
+    void receive();
+
+    /// @brief Applies the values received for the current time, it is the process driving the replicas.
+    void apply();
+
+    /// @brief Schedules again the application of the values received for the given time, or later, after a rollback.
+    /// @details The times already held by the restored events, i.e., those of the values which arrived before the
+    /// copy was taken, are not scheduled twice.
+    /// @param time the time.
+    /// @param restored the copy of the pending events the scheduler was restored to.
+    void schedule_incoming(discrete_time_t time, const scheduler_state_t &restored);
+
+    /// @brief The connection with the other process.
+    channel_t channel;
+    /// @brief The delay of the signals sent to the other process.
+    discrete_time_t lookahead;
+    /// @brief The names of the signals sent to the other process, in order.
+    std::vector<std::string> sent_names;
+    /// @brief Removes the watchpoints collecting the changes of the signals sent, one for each signal.
+    std::vector<std::function<void()>> unwatchers;
+    /// @brief The names of the signals received from the other process, with the functions writing the replicas.
+    std::vector<std::pair<std::string, std::function<void(std::uint64_t)>>> received;
+    /// @brief Maps the index of a signal sent by the other process to the index in received.
+    std::vector<std::size_t> remote_to_local;
+    /// @brief The changes to send, the signals might be written by several threads.
+    std::vector<update_t> outgoing;
+    /// @brief Protects the changes to send.
+    std::mutex outgoing_mutex;
+    /// @brief The values received, waiting for their time, with the index in received.
+    std::multimap<discrete_time_t, std::pair<std::size_t, std::uint64_t>> incoming;
+    /// @brief The last time promised to the other process.
+    discrete_time_t promised;
+    /// @brief The time before which the other process sends nothing more.
+    discrete_time_t safe_time;
+    /// @brief Whether the names of the signals were exchanged.
+    bool connected;
+    /// @brief The number of messages sent.
+    std::uint64_t messages_sent;
+    /// @brief Whether the simulation is optimistic, i.e., the values are kept until they are committed.
+    bool optimistic;
+    /// @brief The values sent and not yet committed, oldest first, for the anti-messages.
+    std::deque<update_t> sent;
+    /// @brief The number of values and anti-messages sent, i.e., the sequence number of the last one.
+    std::uint64_t sent_count;
+    /// @brief The number of values and anti-messages received.
+    std::uint64_t received_count;
+    /// @brief The sequence numbers and the times of the values and anti-messages the other process did not receive
+    /// yet, oldest first.
+    std::deque<std::pair<std::uint64_t, discrete_time_t>> in_flight;
+    /// @brief The earliest time the other process might still execute, or send a value for, as last reported.
+    discrete_time_t remote_floor;
+    /// @brief The floor and the number of messages received in the last report, so that it is not sent again.
+    std::pair<discrete_time_t, std::uint64_t> last_report;
+    /// @brief Whether the other process closed the connection.
+    bool closed;
+    /// @brief The number of rollbacks caused by the messages of the other process.
+    std::uint64_t rollbacks;
+    /// @brief The number of anti-messages sent.
+    std::uint64_t anti_messages;
+    /// @brief The process applying the received values.
+    process_info_t apply_process;
+};
+
+/// @brief Runs the local part of the design in lockstep with the other processes.
+/// @details The synchronization is conservative (Chandy-Misra-Bryant): the local events are executed only up to the
+/// earliest time a peer might still send a value for, and each peer is told, after each step, the earliest time of
+/// the values it might still receive, i.e., the next local event plus the lookahead. Since the lookahead is at least
+/// one, the processes never deadlock, and the results do not depend on the speed of each process.
+/// The processes may have executed their last events at different times, thus, they agree on an absolute time
+/// rather than on a duration.
+/// @param peers the connections with the other processes.
+/// @param end_time the time of the last events to execute, as for scheduler_t::run_until(), the same for all the
+/// processes.
+void run_distributed(const std::vector<peer_t *> &peers, discrete_time_t end_time);
+
+/// @brief Runs the local part of the design ahead of the other processes, going back in time when needed (Time Warp).
+/// @details Each time step is executed as soon as it is the next local event, without waiting for the peers. Before
+/// the step, the pending events and the disabled processes are copied (see scheduler_t::save_state()) and the state
+/// log is marked, then the signals, the models, and the modules enabled or disabled (see module_t::set_enabled())
+/// record their changes in the state log (see state_log_t). A value received for a time step
+/// already executed, or an anti-message cancelling one, is a straggler: the steps from its time on are undone, and the
+/// values they sent are cancelled by anti-messages, which might undo steps of the peers in turn.
+///
+/// The peer periodically reports the earliest time it might still execute, or send a value for, and which messages
+/// it received. The minimum of the report and of the local values is the global virtual time (GVT): nothing before
+/// it can be undone anymore, so the copies, the state log, and the messages before it are dropped (fossil collection).
+/// Only two processes are supported: with more, the reports of the peers are taken at different moments, and a stale
+/// one combined with a fresh one would commit steps still to be undone.
+/// The function returns once the GVT is beyond the end time, the steps up to it being committed. The watchpoints, the
+/// history, the coverage, and the activity of the signals also see the steps which are later undone.
+/// @param peers the connection with the other process, at most one.
+/// @param end_time the time of the last events to execute, the same for all the processes.
+/// @param window how far beyond the GVT a step can be executed, 0 (the default) does not limit it. A window bounds
+/// the memory held by the copies, and the work lost by a rollback.
+void run_optimistic(const std::vector<peer_t *> &peers, discrete_time_t end_time, discrete_time_t window = 0);
+
+template <typename T> void peer_t::send_signal(const std::string &signal_name, signal_t<T> &signal)
+{
+    static_assert(coverage_bits_t<T>::width > 0, "Only the values which fit in a 64-bit word can be sent.");
+    if (connected) {
+        throw std::runtime_error("Signal `" + signal_name + "` must be sent before running the simulation.");
+    }
+    const std::size_t index = sent_names.size();
+    sent_names.push_back(signal_name);
+    const std::size_t id = signal.watch(nullptr, [this, index, &signal]() {
+        std::lock_guard<std::mutex> lock(outgoing_mutex);
+        outgoing.push_back(
+            update_t{digsim::scheduler.time() + lookahead, index, coverage_bits_t<T>::bits(signal.get())});
+    });
+    unwatchers.emplace_back([&signal, id]() { signal.unwatch(id); });
+}
+
+template <typename T> void peer_t::receive_signal(const std::string &signal_name, signal_t<T> &signal)
+{
+    static_assert(coverage_bits_t<T>::width > 0, "Only the values which fit in a 64-bit word can be received.");
+    if (connected) {
+        throw std::runtime_error("Signal `" + signal_name + "` must be received before running the simulation.");
+    }
+    received.emplace_back(signal_name, [&signal](std::uint64_t bits) { signal.set(from_bits<T>(bits)); });
+}
+
+} // namespace digsim
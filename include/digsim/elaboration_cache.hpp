@@ -0,0 +1,42 @@
+/// @file elaboration_cache.hpp
+/// @brief On-disk cache of the results of the elaboration analyses.
+/// @copyright
+/// This file is distributed under the terms of the MIT License.
+/// See the full license in the root directory at LICENSE.md.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace digsim
+{
+
+/// @brief The results of the analyses run when the scheduler is initialized, keyed by the fingerprint of the design.
+/// @details The cycle check, the topological order, and the clock domains only depend on the processes and on how
+/// ports are bound to signals, which the fingerprint describes (see dependency_graph_t::compute_fingerprint()). The
+/// outcome of the cycle check is stored as well, and a cache is only loaded if the design passed it, in which case the
+/// cycles themselves are not computed.
+struct elaboration_cache_t {
+    /// @brief The fingerprint of the design the results belong to.
+    std::uint64_t fingerprint = 0;
+    /// @brief Whether the design passed the cycle check, i.e., it has no bad cycles.
+    bool cycles_checked = false;
+    /// @brief The processes, sorted by topological level.
+    std::vector<std::size_t> topological_order;
+    /// @brief The clock domain of each process, indexed by process id, empty if the domains were not computed.
+    std::vector<std::size_t> process_domain;
+
+    /// @brief Loads the cache from a file.
+    /// @param filename the name of the file.
+    /// @param expected the fingerprint of the current design.
+    /// @return true if the file exists, matches the fingerprint, and the design passed the cycle check.
+    bool load(const std::string &filename, std::uint64_t expected);
+
+    /// @brief Saves the cache to a file.
+    /// @param filename the name of the file.
+    void save(const std::string &filename) const;
+};
+
+} // namespace digsim
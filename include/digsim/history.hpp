@@ -0,0 +1,123 @@
+/// @file history.hpp
+/// @brief A ring buffer keeping the past values of a signal.
+/// @copyright
+/// This file is distributed under the terms of the MIT License.
+/// See the full license in the root directory at LICENSE.md.
+
+#pragma once
+
+#include "digsim/common.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace digsim
+{
+
+/// @brief Keeps the last values of a signal, together with the time at which they were set.
+/// @details Only the final value of each time step is kept, i.e., all the changes happening in the delta cycles of the
+/// same time step overwrite the same entry.
+/// @tparam T the type of the signal value.
+template <typename T> class history_t
+{
+public:
+    /// @brief Constructor for the history.
+    /// @param _depth the maximum number of entries kept.
+    /// @param time the current time.
+    /// @param value the current value of the signal.
+    history_t(std::size_t _depth, discrete_time_t time, const T &value);
+
+    /// @brief Records a new value.
+    /// @param time the time of the change.
+    /// @param value the new value.
+    void push(discrete_time_t time, const T &value);
+
+    /// @brief Returns the number of entries in the history.
+    /// @return the number of entries.
+    std::size_t size() const { return count; }
+
+    /// @brief Returns the maximum number of entries kept.
+    /// @return the depth of the history.
+    std::size_t depth() const { return times.size(); }
+
+    /// @brief Returns the value of the k-th most recent entry.
+    /// @param k the index of the entry, 0 is the current value.
+    /// @return a reference to the value.
+    const T &value(std::size_t k) const;
+
+    /// @brief Returns the time of the k-th most recent entry.
+    /// @param k the index of the entry, 0 is the current value.
+    /// @return the time at which the value was set.
+    discrete_time_t time(std::size_t k) const;
+
+    /// @brief Returns the value held at the given time.
+    /// @param t the time.
+    /// @return a pointer to the value, nullptr if the time is older than the history.
+    const T *find(discrete_time_t t) const;
+
+private:
+    /// @brief Returns the position of the k-th most recent entry inside the buffers.
+    /// @param k the index of the entry.
+    /// @return the position.
+    std::size_t position(std::size_t k) const;
+
+    /// @brief The times of the entries.
+    std::vector<discrete_time_t> times;
+    /// @brief The values of the entries.
+    std::vector<T> values;
+    /// @brief The position of the most recent entry.
+    std::size_t head;
+    /// @brief The number of entries.
+    std::size_t count;
+};
+
+template <typename T>
+history_t<T>::history_t(std::size_t _depth, discrete_time_t time, const T &value)
+    : times(std::max<std::size_t>(_depth, 1), 0)
+    , values(std::max<std::size_t>(_depth, 1))
+    , head(0)
+    , count(1)
+{
+    times[0]  = time;
+    values[0] = value;
+}
+
+template <typename T> void history_t<T>::push(discrete_time_t time, const T &value)
+{
+    // Changes in the same time step overwrite the same entry.
+    if (times[head] != time) {
+        head  = (head + 1) % times.size();
+        count = std::min(count + 1, times.size());
+    }
+    times[head]  = time;
+    values[head] = value;
+}
+
+template <typename T> const T &history_t<T>::value(std::size_t k) const { return values[this->position(k)]; }
+
+template <typename T> discrete_time_t history_t<T>::time(std::size_t k) const { return times[this->position(k)]; }
+
+template <typename T> const T *history_t<T>::find(discrete_time_t t) const
+{
+    for (std::size_t k = 0; k < count; ++k) {
+        std::size_t pos = this->position(k);
+        if (times[pos] <= t) {
+            return &values[pos];
+        }
+    }
+    return nullptr;
+}
+
+template <typename T> std::size_t history_t<T>::position(std::size_t k) const
+{
+    if (k >= count) {
+        throw std::runtime_error(
+            "History entry " + std::to_string(k) + " is not available, only " + std::to_string(count) +
+            " entries are recorded.");
+    }
+    return (head + times.size() - k) % times.size();
+}
+
+} // namespace digsim
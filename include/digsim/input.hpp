@@ -4,6 +4,11 @@
 #pragma once
 
 #include "digsim/isignal.hpp"
+#include "digsim/logger.hpp"
+#include "digsim/scheduler.hpp"
+#include "digsim/sensitivity.hpp"
+
+#include <unordered_set>
 
 namespace digsim
 {
@@ -22,12 +27,28 @@ public:
     module_t *get_owner() const override { return sig_owner; }
 
     /// @brief Gets the current value of the signal.
-    /// @return the current value of the signal.
-    T get() const;
+    /// @details The reference points into the bound signal, with the same lifetime as signal_t::get().
+    /// @return a reference to the current value of the signal, which is such only until the signal changes.
+    const T &get() const;
+
+    /// @brief Returns the value the bound signal had k changes ago, its history must be enabled.
+    /// @param k the number of changes to go back, 0 is the current value.
+    /// @return a reference to the value.
+    const T &history(std::size_t k) const;
+
+    /// @brief Returns the value the bound signal held at the given time, its history must be enabled.
+    /// @param t the time, it must be within the recorded history.
+    /// @return a reference to the value.
+    const T &value_at(discrete_time_t t) const;
 
     void operator()(isignal_t &_signal) override;
 
-    void subscribe(const process_info_t &proc_info) override;
+    void subscribe(const process_info_t &proc_info, sensitivity_mask_t mask) override;
+
+    /// @brief Add the process to the list of processes that should be notified when the signal changes.
+    /// @param proc_info the process information containing the process to be executed when the signal changes.
+    /// @param subscription the sensitivity mask of the process, and the predicate guarding its activation.
+    void subscribe(const process_info_t &proc_info, const subscription_t<T> &subscription);
 
     /// @brief Returns true on a rising edge (value transition).
     /// - For bool: returns true when signal goes from false to true.
@@ -52,14 +73,17 @@ public:
     const char *get_type_name() const override;
 
 private:
+    /// @brief Reports a read of the bound signal to the race detection, if it is enabled.
+    void record_read() const;
+
     /// @brief The module that owns this signal.
     module_t *sig_owner                         = nullptr;
     /// @brief The signal this input or output is bound to.
-    isignal_t *bound_signal                     = nullptr;
+    signal_t<T> *bound_signal                   = nullptr;
     /// @brief List of sub-inputs that are bound to this input.
     std::unordered_set<input_t<T> *> sub_inputs = {};
-    /// @brief A set of processes that are registered to be notified when the signal changes.
-    std::unordered_set<process_info_t, process_info_hash, process_info_equal> processes;
+    /// @brief The processes that are registered to be notified when the signal changes, with their subscription.
+    std::unordered_map<process_info_t, subscription_t<T>, process_info_hash, process_info_equal> processes;
 };
 
 template <typename T>
@@ -73,16 +97,38 @@ input_t<T>::input_t(const std::string &_name, module_t *_sig_owner)
     // Nothing to do here.
 }
 
-template <typename T> T input_t<T>::get() const
+template <typename T> const T &input_t<T>::get() const
+{
+    if (!bound_signal) {
+        throw std::runtime_error("Input not bound: " + get_signal_location_string(this));
+    }
+    this->record_read();
+    return bound_signal->get();
+}
+
+template <typename T> const T &input_t<T>::history(std::size_t k) const
+{
+    if (!bound_signal) {
+        throw std::runtime_error("Input not bound: " + get_signal_location_string(this));
+    }
+    return bound_signal->history(k);
+}
+
+template <typename T> const T &input_t<T>::value_at(discrete_time_t t) const
 {
-    auto signal = dynamic_cast<signal_t<T> *>(bound_signal);
-    if (!signal) {
+    if (!bound_signal) {
         throw std::runtime_error("Input not bound: " + get_signal_location_string(this));
     }
-    return signal->get();
+    return bound_signal->value_at(t);
 }
 
-template <typename T> inline void input_t<T>::subscribe(const process_info_t &proc_info)
+template <typename T> inline void input_t<T>::subscribe(const process_info_t &proc_info, sensitivity_mask_t mask)
+{
+    this->subscribe(proc_info, subscription_t<T>{mask, value_predicate_t<T>{}});
+}
+
+template <typename T>
+inline void input_t<T>::subscribe(const process_info_t &proc_info, const subscription_t<T> &subscription)
 {
     if (!proc_info.process) {
         throw std::runtime_error("Cannot subscribe an invalid process to input `" + get_name() + "`.");
@@ -92,10 +138,11 @@ template <typename T> inline void input_t<T>::subscribe(const process_info_t &pr
     }
     if (processes.find(proc_info) != processes.end()) {
         digsim::trace("input_t", "Process already subscribed for input `{}`", get_name());
+        processes[proc_info].merge(subscription);
         return;
     }
     digsim::trace("input_t", "Subscribing process `{}` for input `{}`", proc_info.to_string(), get_name());
-    processes.insert(proc_info);
+    processes.emplace(proc_info, subscription);
 }
 
 template <typename T> void input_t<T>::operator()(isignal_t &binding)
@@ -112,7 +159,9 @@ template <typename T> void input_t<T>::operator()(isignal_t &binding)
         // Set the bound signal.
         bound_signal = signal;
         // Share subscriptions.
-        signal->processes.insert(processes.begin(), processes.end());
+        for (const auto &[proc_info, subscription] : processes) {
+            signal->subscribe(proc_info, subscription);
+        }
         // Propagate signal binding to all children.
         for (auto *sub_input : sub_inputs) {
             (*sub_input)(*signal);
@@ -124,29 +173,52 @@ template <typename T> void input_t<T>::operator()(isignal_t &binding)
 
 template <typename T> template <typename U> std::enable_if_t<std::is_same_v<U, bool>, bool> input_t<T>::posedge() const
 {
-    auto signal = dynamic_cast<signal_t<T> *>(bound_signal);
-    if (!signal) {
+    if (!bound_signal) {
         throw std::runtime_error("Input not bound: " + get_signal_location_string(this));
     }
-    return signal->value && !signal->last_value;
+    this->record_read();
+    return bound_signal->get() && !bound_signal->get_last();
 }
 
 template <typename T> template <typename U> std::enable_if_t<std::is_same_v<U, bool>, bool> input_t<T>::negedge() const
 {
-    auto signal = dynamic_cast<signal_t<T> *>(bound_signal);
-    if (!signal) {
+    if (!bound_signal) {
         throw std::runtime_error("Input not bound: " + get_signal_location_string(this));
     }
-    return !signal->value && signal->last_value;
+    this->record_read();
+    return !bound_signal->get() && bound_signal->get_last();
 }
 
 template <typename T> discrete_time_t input_t<T>::get_delay() const
 {
-    auto signal = dynamic_cast<signal_t<T> *>(bound_signal);
-    if (!signal) {
+    if (!bound_signal) {
         throw std::runtime_error("Input not bound: " + get_signal_location_string(this));
     }
-    return signal->get_delay();
+    return bound_signal->get_delay();
+}
+
+template <typename T> inline void input_t<T>::record_read() const
+{
+    if (!digsim::scheduler.is_race_detection_enabled()) {
+        return;
+    }
+    // The reader is woken up again if it is sensitive to the signal, through any input, and the value written
+    // satisfies its predicate, which is only known once the delta cycle is complete.
+    const std::size_t reader = digsim::scheduler.get_current_process();
+    for (const auto &[proc_info, subscription] : bound_signal->processes) {
+        if (proc_info.id != reader) {
+            continue;
+        }
+        if (subscription.predicate.kind == predicate_kind_t::always) {
+            digsim::scheduler.record_read(bound_signal, true);
+        } else {
+            digsim::scheduler.record_read(
+                bound_signal,
+                [signal = bound_signal, predicate = subscription.predicate] { return predicate(signal->get()); });
+        }
+        return;
+    }
+    digsim::scheduler.record_read(bound_signal, false);
 }
 
 template <typename T> bool input_t<T>::bound() const { return bound_signal != nullptr; }
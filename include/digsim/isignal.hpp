@@ -38,7 +38,8 @@ public:
 
     /// @brief Add the process to the list of processes that should be notified when the signal changes.
     /// @param proc_info the process information containing the process to be executed when the signal changes.
-    virtual void subscribe(const process_info_t &proc_info) = 0;
+    /// @param mask the sensitivity entries of the process reported as changed when the signal changes.
+    virtual void subscribe(const process_info_t &proc_info, sensitivity_mask_t mask) = 0;
 
     /// @brief Gets the default delay for this signal.
     /// @return the default delay for this signal.
@@ -51,6 +52,26 @@ public:
     /// @brief Returns the type name of the signal (e.g., "bool", "int").
     /// @return the type name of the signal.
     virtual const char *get_type_name() const = 0;
+
+    /// @brief Returns the number of bits of the value, for the types that can be covered (see coverage_bits_t).
+    /// @return the number of bits, 0 if the value cannot be represented as a word, or if this is not a signal.
+    virtual std::size_t get_width() const { return 0; }
+
+    /// @brief Returns the bits of the current value, for the types that can be covered (see coverage_bits_t).
+    /// @return the bits, packed in a word.
+    virtual uint64_t get_bits() const { return 0; }
+
+    /// @brief Marks the signal as crossing between two scheduler partitions.
+    /// @param _crossing true if the signal connects processes belonging to different partitions.
+    void set_crossing(bool _crossing) { crossing = _crossing; }
+
+    /// @brief Checks if the signal crosses between two scheduler partitions.
+    /// @return true if the signal connects processes belonging to different partitions, false otherwise.
+    bool is_crossing() const { return crossing; }
+
+private:
+    /// @brief Whether the signal connects processes belonging to different partitions.
+    bool crossing = false;
 };
 
 /// @brief Returns a string representation of the binding chain.
@@ -0,0 +1,129 @@
+/// @file jit_kernel.hpp
+/// @brief Simulation of frozen netlists by code generated, compiled, and loaded at run time.
+/// @copyright
+/// This file is distributed under the terms of the MIT License.
+/// See the full license in the root directory at LICENSE.md.
+
+#pragma once
+
+#include "digsim/netlist_kernel.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace digsim
+{
+
+/// @brief Simulates a frozen netlist with the code written by generate_cpp(), compiled into a shared library by the
+/// system compiler, and loaded in the running process.
+/// @details At initialize(), the generated code is written to the cache directory, together with a small C interface,
+/// and compiled with `-O2 -shared -fPIC`. The name of the library is a hash of the code and of the compiler command,
+/// thus, an unchanged design reuses the library compiled by a previous run, and a changed one is compiled again.
+///
+/// When the compiler is not available, or the compilation fails, the reason is logged and the netlist is simulated
+/// by a netlist_kernel_t instead, so that the results do not depend on the machine, only the speed does.
+class jit_kernel_t
+{
+public:
+    /// @brief Constructor.
+    /// @param _netlist the netlist, which must outlive the kernel.
+    /// @param _cache_directory where the generated code and the compiled libraries are kept, created if needed.
+    jit_kernel_t(const netlist_view_t &_netlist, const std::string &_cache_directory);
+
+    /// @brief Unloads the library.
+    ~jit_kernel_t();
+
+    jit_kernel_t(const jit_kernel_t &)            = delete;
+    jit_kernel_t &operator=(const jit_kernel_t &) = delete;
+
+    /// @brief Sets the compiler of the generated code, by default, `$CXX` or `c++`.
+    /// @param _compiler the compiler, possibly followed by extra flags, e.g., `clang++ -march=native`.
+    void set_compiler(const std::string &_compiler) { compiler = _compiler; }
+
+    /// @brief Compiles and loads the generated code, or falls back to the compact kernel, then evaluates all the
+    /// gates once, with the initial values of the nets.
+    void initialize();
+
+    /// @brief Runs the simulation, see scheduler_t::run().
+    /// @param simulation_time how long to run, 0 runs until there is nothing left to do.
+    void run(discrete_time_t simulation_time = 0);
+
+    /// @brief Returns the current simulation time.
+    /// @return the time of the last time step.
+    discrete_time_t time() const;
+
+    /// @brief Returns the value of a net.
+    /// @param net the index of the net.
+    /// @return the value.
+    uint64_t get(std::size_t net) const;
+
+    /// @brief Sets the value of a net from outside the netlist, and settles the current time step.
+    /// @param net the index of the net.
+    /// @param value the value.
+    void set(std::size_t net, uint64_t value);
+
+    /// @brief Checks if the netlist is simulated by the compiled code.
+    /// @return true if it is, false if it is simulated by the compact kernel.
+    bool is_compiled() const { return model != nullptr; }
+
+    /// @brief Checks if the library was compiled by a previous run.
+    /// @return true if it was found in the cache directory, false otherwise.
+    bool is_cached() const { return cached; }
+
+    /// @brief Returns the path of the library.
+    /// @return the path, empty before initialize().
+    const std::string &get_library() const { return library_path; }
+
+private:
+    /// @brief The functions of the C interface of the library.
+    struct interface_t {
+        void *(*create)();
+        void (*destroy)(void *);
+        const char *(*initialize)(void *);
+        const char *(*run)(void *, uint64_t);
+        const char *(*set)(void *, std::size_t, uint64_t);
+        uint64_t (*time)(const void *);
+        uint64_t (*get)(const void *, std::size_t);
+    };
+
+    /// @brief Writes, compiles, and loads the generated code.
+    /// @return true on success, false if the compact kernel must be used instead.
+    bool load();
+
+    /// @brief Compiles the generated code into the cached library, using temporary files private to this process.
+    /// @param header the generated model.
+    /// @param name the name of the library, without extension.
+    /// @return true if the library is now in the cache.
+    bool compile(const std::string &header, const std::string &name);
+
+    /// @brief Opens the library, and finds its functions.
+    /// @return true on success, false if the library cannot be used.
+    bool open();
+
+    /// @brief Throws if a call to the library failed.
+    /// @param message the message returned by the call, nullptr on success.
+    static void check(const char *message);
+
+    /// @brief The netlist.
+    netlist_view_t netlist;
+    /// @brief Where the generated code and the compiled libraries are kept.
+    std::string cache_directory;
+    /// @brief The command compiling the generated code.
+    std::string compiler;
+    /// @brief The path of the library.
+    std::string library_path;
+    /// @brief The handle of the library, and the model it created.
+    void *library;
+    void *model;
+    /// @brief The functions of the library.
+    interface_t functions;
+    /// @brief The compact kernel, used when the code cannot be compiled.
+    std::unique_ptr<netlist_kernel_t> fallback;
+    /// @brief Whether the library was compiled by a previous run.
+    bool cached;
+    /// @brief Whether initialize() has been called.
+    bool initialized;
+};
+
+} // namespace digsim
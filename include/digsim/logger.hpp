@@ -8,6 +8,7 @@
 
 #include <bitset>
 #include <format>
+#include <mutex>
 #include <string>
 
 namespace std
@@ -76,6 +77,8 @@ private:
 
     /// @brief The current global log level.
     log_level_t global_level;
+    /// @brief Prevents messages logged from different threads from being interleaved.
+    std::mutex mutex;
 };
 
 /// @brief Global logger instance for easy access.
@@ -7,6 +7,7 @@
 #pragma once
 
 #include "digsim/common.hpp"
+#include "digsim/input.hpp"
 #include "digsim/signal.hpp"
 
 namespace digsim
@@ -21,14 +22,43 @@ public:
     /// @param _parent_module the parent module of this module.
     module_t(const std::string &_name, module_t *_parent_module = nullptr);
 
+    /// @brief Destructor, detaches the module from the hierarchy.
+    ~module_t() override;
+
     /// @brief Sets the parent module of this module.
     /// @param _parent_module the parent module to set.
-    void set_parent(module_t *_parent_module) { parent_module = _parent_module; }
+    void set_parent(module_t *_parent_module);
 
     /// @brief Returns the parent module of this module.
     /// @return a pointer to the parent module.
     module_t *get_parent() const { return parent_module; }
 
+    /// @brief Returns the modules having this module as parent.
+    /// @return the list of child modules.
+    const std::vector<module_t *> &get_children() const { return children; }
+
+    /// @brief Enables or disables the activity of this module, and of all its submodules.
+    /// @details While disabled, the scheduler suppresses the activations of the processes of the subtree, and only
+    /// records when they were woken up. Once enabled again, only those processes are re-evaluated: the activations they
+    /// missed are replayed at the current time, while those still in the future keep their time.
+    /// @param _enabled true to enable the module, false to disable it.
+    void set_enabled(bool _enabled);
+
+    /// @brief Checks if the module is enabled, i.e., if it and all its ancestors are enabled.
+    /// @return true if the module is enabled, false otherwise.
+    bool is_enabled() const;
+
+    /// @brief Returns which inputs changed since the last activation of the running process.
+    /// @details Each input the module is sensitive to owns one bit of the mask, so that processes can skip the work
+    /// related to inputs that did not change.
+    /// @return the changed mask, 0 if the process was not woken up by an input (e.g., during initialization).
+    sensitivity_mask_t changed_mask() const;
+
+    /// @brief Checks if the given input is among the ones which woke up the running process.
+    /// @param port the input, it must be in the sensitivity list of the running process.
+    /// @return true if the input changed since the last activation, false otherwise.
+    bool triggered_by(const isignal_t &port) const;
+
     /// @brief Adds a signal to the process sensitivity list.
     /// @tparam Module the module type that contains the method.
     /// @param method the method to be called when the signal changes.
@@ -59,6 +89,29 @@ public:
         (add_sensitivity(method, _name, rest), ...);
     }
 
+    /// @brief Adds an input to the process sensitivity list, waking up the process only when the predicate holds.
+    /// @tparam Module the module type that contains the method.
+    /// @tparam T the type of the input.
+    /// @param method the method to be called when the input changes to a value satisfying the predicate.
+    /// @param _name the name of the process.
+    /// @param port the input that is going to trigger the process.
+    /// @param predicate the predicate on the new value of the input, see when_equals() and when_matches().
+    template <typename Module, typename T>
+    void add_sensitivity_when(
+        void (Module::*method)(),
+        const std::string _name,
+        input_t<T> &port,
+        const value_predicate_t<T> &predicate)
+    {
+        // Get the process information for the method.
+        auto proc_info = digsim::get_or_create_process<Module>(static_cast<Module *>(this), method, _name);
+        // Adds the input to the process sensitivity list, guarded by the predicate.
+        port.subscribe(proc_info, subscription_t<T>{this->get_sensitivity_mask(port), predicate});
+        scheduler.register_initializer(proc_info);
+        // Registers the process as a consumer of the input.
+        add_consumer(proc_info, port);
+    }
+
     /// @brief Registers the process as a consumer of the signal.
     /// @tparam Module the module type that contains the method.
     /// @param method the method that consumes the signal.
@@ -121,6 +174,11 @@ protected:
     /// @param signal the signal that is going to trigger the process.
     void add_sensitivity(const process_info_t &proc_info, isignal_t &signal);
 
+    /// @brief Returns the bit of the changed mask associated with the given input, and assigns one if needed.
+    /// @param port the input.
+    /// @return the mask with only the bit of the input set, all bits are set beyond the 64th input.
+    sensitivity_mask_t get_sensitivity_mask(const isignal_t &port);
+
     /// @brief Just Adds the process as a consumer of the signal, but do not register it in the scheduler.
     /// @param proc_info the process that consumes the signal.
     /// @param signal the signal that is going to be consumed.
@@ -136,6 +194,12 @@ protected:
 private:
     /// @brief Pointer to the parent module.
     module_t *parent_module = nullptr;
+    /// @brief The modules having this module as parent.
+    std::vector<module_t *> children;
+    /// @brief Whether the module itself is enabled, regardless of its ancestors.
+    bool enabled = true;
+    /// @brief The inputs the processes of this module are sensitive to, the index is the bit in the changed mask.
+    std::vector<const isignal_t *> sensitivity_ports;
 };
 
 } // namespace digsim
@@ -143,6 +207,10 @@ private:
 /// @brief Helper macro to add a sensitivity to a process.
 #define ADD_SENSITIVITY(object, method, ...) add_sensitivity(&object::method, #method, __VA_ARGS__)
 
+/// @brief Helper macro to add a sensitivity, guarded by a predicate, to a process.
+#define ADD_SENSITIVITY_WHEN(object, method, port, predicate) \
+    add_sensitivity_when(&object::method, #method, port, predicate)
+
 /// @brief Helper macro to add a consumer to a process.
 #define ADD_CONSUMER(object, method, ...) add_consumer(&object::method, #method, __VA_ARGS__)
 
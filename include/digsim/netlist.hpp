@@ -0,0 +1,246 @@
+/// @file netlist.hpp
+/// @brief Flat, frozen representation of a structural design, which can be saved to and mapped from a binary image.
+/// @copyright
+/// This file is distributed under the terms of the MIT License.
+/// See the full license in the root directory at LICENSE.md.
+
+#pragma once
+
+#include "digsim/common.hpp"
+
+#include <cstdint>
+#include <initializer_list>
+#include <limits>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace digsim
+{
+
+class isignal_t;
+class netlist_t;
+
+/// @brief The operations of the gates of a netlist, all of them operate bitwise on words.
+enum class gate_op_t : uint8_t {
+    buf,  ///< Copies its input.
+    not_, ///< Negates its input.
+    and_, ///< AND of its inputs.
+    or_,  ///< OR of its inputs.
+    xor_, ///< XOR of its inputs.
+    nand, ///< Negated AND of its inputs.
+    nor,  ///< Negated OR of its inputs.
+    xnor, ///< Negated XOR of its inputs.
+    maj,  ///< Majority of three inputs, e.g., the carry of a full adder.
+    mux,  ///< Inputs (sel, a, b), returns b if sel is not zero, a otherwise.
+    dff,  ///< Inputs (clk, d, [enable, [reset, [state]]]), samples d on the rising edges of clk.
+    dffn, ///< Same as dff, but drives the inverted state.
+};
+
+/// @brief Checks if a gate only reacts to the edges of its first input, i.e., its clock.
+/// @param op the operation of the gate.
+/// @return true for flip-flops, false for combinational gates.
+constexpr bool is_sequential(gate_op_t op) { return (op == gate_op_t::dff) || (op == gate_op_t::dffn); }
+
+/// @brief Returns the name of an operation.
+/// @param op the operation.
+/// @return the name.
+const char *to_string(gate_op_t op);
+
+/// @brief Read-only arrays describing a frozen netlist, which do not own their memory.
+/// @details Nets are indexed from 0 to num_nets() - 1, and gates from 0 to num_gates() - 1. The inputs of the gates and
+/// the fanout of the nets are stored in compressed sparse rows: the inputs of gate g are inputs[input_offsets[g]] up to
+/// inputs[input_offsets[g + 1]], and so are the gates woken up by a net. The arrays point either to a netlist_t or to a
+/// mapped image (see netlist_image_t), and the kernels do not tell the two apart.
+struct netlist_view_t {
+    /// @brief The number of bits of each net.
+    std::span<const uint32_t> net_widths;
+    /// @brief The delay of each net.
+    std::span<const uint64_t> net_delays;
+    /// @brief The initial value of each net.
+    std::span<const uint64_t> net_initial;
+    /// @brief Where the name of each net starts inside name_chars, one more entry than the nets.
+    std::span<const uint64_t> name_offsets;
+    /// @brief The names of the nets, one after the other.
+    std::span<const char> name_chars;
+    /// @brief The operation of each gate, see gate_op_t.
+    std::span<const uint8_t> gate_ops;
+    /// @brief The net driven by each gate.
+    std::span<const uint32_t> gate_outputs;
+    /// @brief The level of each gate, 0 for flip-flops, then increasing along the combinational paths.
+    std::span<const uint32_t> gate_levels;
+    /// @brief Where the inputs of each gate start inside inputs, one more entry than the gates.
+    std::span<const uint32_t> input_offsets;
+    /// @brief The input nets of the gates.
+    std::span<const uint32_t> inputs;
+    /// @brief Where the fanout of each net starts inside fanout, one more entry than the nets.
+    std::span<const uint32_t> fanout_offsets;
+    /// @brief The gates woken up by a change of the nets.
+    std::span<const uint32_t> fanout;
+    /// @brief The net driven by each clock.
+    std::span<const uint32_t> clock_nets;
+    /// @brief The time of the first edge of each clock.
+    std::span<const uint64_t> clock_first;
+    /// @brief How long each clock stays high.
+    std::span<const uint64_t> clock_high;
+    /// @brief How long each clock stays low.
+    std::span<const uint64_t> clock_low;
+
+    /// @brief Value returned when a net is not found.
+    static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+    /// @brief Returns the number of nets.
+    /// @return the number of nets.
+    std::size_t num_nets() const { return net_widths.size(); }
+
+    /// @brief Returns the number of gates.
+    /// @return the number of gates.
+    std::size_t num_gates() const { return gate_ops.size(); }
+
+    /// @brief Returns the number of clocks.
+    /// @return the number of clocks.
+    std::size_t num_clocks() const { return clock_nets.size(); }
+
+    /// @brief Returns the name of a net.
+    /// @param net the index of the net.
+    /// @return the name.
+    std::string_view get_name(std::size_t net) const;
+
+    /// @brief Finds a net by name.
+    /// @param name the name of the net.
+    /// @return the index of the net, npos if there is no such net.
+    std::size_t find(std::string_view name) const;
+
+    /// @brief Saves the netlist to a binary image, which can be mapped by netlist_image_t.
+    /// @param filename the name of the file.
+    void save(const std::string &filename) const;
+};
+
+/// @brief Implemented by the modules which can describe themselves as gates, so that they can be part of a netlist.
+class structural_t
+{
+public:
+    /// @brief Destructor.
+    virtual ~structural_t() = default;
+
+    /// @brief Adds the gates implementing the module to the netlist.
+    /// @param netlist the netlist being built.
+    virtual void describe(netlist_t &netlist) const = 0;
+};
+
+/// @brief A netlist being built, then frozen.
+/// @details A netlist is usually extracted from an elaborated design, whose modules must all implement structural_t,
+/// and whose signals become the nets. Once frozen, the netlist computes the fanout and the levels of the gates, and can
+/// be simulated by netlist_kernel_t or saved to an image, which skips the elaboration in later runs.
+class netlist_t
+{
+public:
+    /// @brief Creates an empty netlist.
+    netlist_t();
+
+    /// @brief Builds and freezes the netlist of the elaborated design, with the current values of its signals.
+    /// @return the netlist.
+    static netlist_t extract();
+
+    /// @brief Adds a net.
+    /// @param name the name of the net.
+    /// @param width the number of bits of the net, at most 64.
+    /// @param initial the initial value of the net.
+    /// @param delay the delay applied to the changes of the net.
+    /// @return the index of the net.
+    std::size_t add_net(const std::string &name, std::size_t width, uint64_t initial = 0, discrete_time_t delay = 0);
+
+    /// @brief Returns the net of the signal a port is bound to, and adds it the first time.
+    /// @param port the port, or the signal itself.
+    /// @return the index of the net.
+    std::size_t get_net(const isignal_t &port);
+
+    /// @brief Adds a gate.
+    /// @param op the operation of the gate.
+    /// @param gate_inputs the input nets.
+    /// @param output the net driven by the gate, it must not have another driver.
+    /// @return the index of the gate.
+    std::size_t add_gate(gate_op_t op, const std::vector<std::size_t> &gate_inputs, std::size_t output);
+
+    /// @brief Adds a gate connected to the signals bound to the given ports.
+    /// @param op the operation of the gate.
+    /// @param gate_inputs the input ports.
+    /// @param output the output port.
+    /// @return the index of the gate.
+    std::size_t add_gate(gate_op_t op, std::initializer_list<const isignal_t *> gate_inputs, const isignal_t &output);
+
+    /// @brief Adds a clock, which toggles its net forever.
+    /// @param net the net driven by the clock.
+    /// @param first the time of the first edge.
+    /// @param high how long the clock stays high.
+    /// @param low how long the clock stays low.
+    void add_clock(std::size_t net, discrete_time_t first, discrete_time_t high, discrete_time_t low);
+
+    /// @brief Computes the fanout of the nets and the levels of the gates, no gate can be added afterwards.
+    void freeze();
+
+    /// @brief Returns the arrays of the frozen netlist, valid as long as the netlist.
+    /// @return the view.
+    netlist_view_t view() const;
+
+private:
+    /// @brief Checks that the netlist can still be modified.
+    void check_not_frozen() const;
+
+    /// @brief Whether the netlist is frozen.
+    bool frozen;
+    std::vector<uint32_t> net_widths;
+    std::vector<uint64_t> net_delays;
+    std::vector<uint64_t> net_initial;
+    std::vector<uint64_t> name_offsets;
+    std::vector<char> name_chars;
+    std::vector<uint8_t> gate_ops;
+    std::vector<uint32_t> gate_outputs;
+    std::vector<uint32_t> gate_levels;
+    std::vector<uint32_t> input_offsets;
+    std::vector<uint32_t> inputs;
+    std::vector<uint32_t> fanout_offsets;
+    std::vector<uint32_t> fanout;
+    std::vector<uint32_t> clock_nets;
+    std::vector<uint64_t> clock_first;
+    std::vector<uint64_t> clock_high;
+    std::vector<uint64_t> clock_low;
+    /// @brief The gate driving each net, npos for the nets without a driver.
+    std::vector<std::size_t> drivers;
+    /// @brief The nets of the signals, indexed by signal.
+    std::unordered_map<const isignal_t *, std::size_t> nets;
+};
+
+/// @brief A netlist image mapped in memory, read-only.
+/// @details The image is not copied nor parsed: the arrays of the view point directly into the mapping. Opening it
+/// validates the indices, opcodes, and offsets of every array, thus, the whole image is read once at open, and the
+/// simulation then runs on pages already loaded.
+class netlist_image_t
+{
+public:
+    /// @brief Maps an image, and validates it.
+    /// @param filename the name of the file, written by netlist_view_t::save().
+    netlist_image_t(const std::string &filename);
+
+    /// @brief Unmaps the image.
+    ~netlist_image_t();
+
+    netlist_image_t(const netlist_image_t &)            = delete;
+    netlist_image_t &operator=(const netlist_image_t &) = delete;
+
+    /// @brief Returns the arrays of the netlist, valid as long as the image.
+    /// @return the view.
+    const netlist_view_t &view() const { return netlist; }
+
+private:
+    /// @brief The start of the mapping.
+    void *data;
+    /// @brief The size of the mapping.
+    std::size_t size;
+    /// @brief The arrays, pointing into the mapping.
+    netlist_view_t netlist;
+};
+
+} // namespace digsim
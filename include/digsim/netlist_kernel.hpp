@@ -0,0 +1,122 @@
+/// @file netlist_kernel.hpp
+/// @brief Compact simulation kernel for frozen netlists.
+/// @copyright
+/// This file is distributed under the terms of the MIT License.
+/// See the full license in the root directory at LICENSE.md.
+
+#pragma once
+
+#include "digsim/netlist.hpp"
+
+#include <cstdint>
+#include <queue>
+#include <vector>
+
+namespace digsim
+{
+
+/// @brief Simulates a frozen netlist, without modules, processes, nor the scheduler.
+/// @details The values of the nets live in a dense array, and each time step is settled level by level: first the
+/// flip-flops woken up by their clock sample their inputs all together, then the combinational gates are evaluated in
+/// increasing level, so that each gate of an acyclic path is evaluated at most once. Changes of nets with a delay are
+/// queued, as are the edges of the clocks.
+///
+/// The values observed after each time step match the ones of the event-driven simulation of the same design.
+class netlist_kernel_t
+{
+public:
+    /// @brief Constructor.
+    /// @param _netlist the netlist, which must outlive the kernel.
+    netlist_kernel_t(const netlist_view_t &_netlist);
+
+    /// @brief Evaluates all the gates once, with the initial values of the nets, like scheduler_t::initialize().
+    void initialize();
+
+    /// @brief Runs the simulation, see scheduler_t::run().
+    /// @param simulation_time how long to run, 0 runs until there is nothing left to do.
+    void run(discrete_time_t simulation_time = 0);
+
+    /// @brief Returns the current simulation time.
+    /// @return the time of the last time step.
+    discrete_time_t time() const { return now; }
+
+    /// @brief Returns the value of a net.
+    /// @param net the index of the net.
+    /// @return the value.
+    uint64_t get(std::size_t net) const { return values[net]; }
+
+    /// @brief Sets the value of a net from outside the netlist, and settles the current time step.
+    /// @param net the index of the net.
+    /// @param value the value.
+    void set(std::size_t net, uint64_t value);
+
+private:
+    /// @brief A change of a net with a delay.
+    struct update_t {
+        discrete_time_t time; ///< When the change happens.
+        uint64_t sequence;    ///< Keeps the changes at the same time in the order they were queued.
+        uint32_t net;         ///< The net.
+        uint64_t value;       ///< The new value.
+
+        /// @brief Orders the changes from the latest, for the priority queue.
+        /// @param other the other change.
+        /// @return true if this change comes after the other one.
+        bool operator>(const update_t &other) const
+        {
+            return (time > other.time) || ((time == other.time) && (sequence > other.sequence));
+        }
+    };
+
+    /// @brief Computes the output of a gate.
+    /// @param gate the index of the gate.
+    /// @param value the output value, set only if the gate drives its output.
+    /// @return true if the gate drives its output, flip-flops only do on the rising edges of their clock.
+    bool evaluate(std::size_t gate, uint64_t &value);
+
+    /// @brief Drives the output of a gate, immediately or after the delay of the net.
+    /// @param gate the index of the gate.
+    /// @param value the value.
+    void drive(std::size_t gate, uint64_t value);
+
+    /// @brief Changes the value of a net, and wakes up its fanout.
+    /// @param net the index of the net.
+    /// @param value the value.
+    void assign(std::size_t net, uint64_t value);
+
+    /// @brief Marks a gate for evaluation in the current time step.
+    /// @param gate the index of the gate.
+    void wake(std::size_t gate);
+
+    /// @brief Evaluates the woken gates, level by level, until nothing changes.
+    void settle();
+
+    /// @brief The netlist.
+    netlist_view_t netlist;
+    /// @brief The current value of each net.
+    std::vector<uint64_t> values;
+    /// @brief The mask of the bits of each net.
+    std::vector<uint64_t> masks;
+    /// @brief The value of the clock seen by each flip-flop at its last evaluation.
+    std::vector<uint8_t> last_clock;
+    /// @brief Whether each gate is waiting to be evaluated.
+    std::vector<uint8_t> woken;
+    /// @brief The woken gates, by level.
+    std::vector<std::vector<uint32_t>> levels;
+    /// @brief The lowest level with woken gates.
+    std::size_t first_level;
+    /// @brief The gates being evaluated, and the values sampled by the flip-flops.
+    std::vector<uint32_t> batch;
+    std::vector<std::pair<uint32_t, uint64_t>> sampled;
+    /// @brief The time of the next edge of each clock.
+    std::vector<discrete_time_t> next_edge;
+    /// @brief The pending changes of nets with a delay.
+    std::priority_queue<update_t, std::vector<update_t>, std::greater<>> updates;
+    /// @brief The number of changes queued so far.
+    uint64_t sequence;
+    /// @brief The current simulation time.
+    discrete_time_t now;
+    /// @brief Whether the gates have been evaluated with the initial values.
+    bool initialized;
+};
+
+} // namespace digsim
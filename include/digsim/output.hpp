@@ -5,6 +5,8 @@
 
 #include "digsim/isignal.hpp"
 
+#include <utility>
+
 namespace digsim
 {
 
@@ -22,16 +24,17 @@ public:
     module_t *get_owner() const override { return sig_owner; }
 
     /// @brief Sets the value of the signal.
-    /// @param new_value the new value to set the signal to.
+    /// @param new_value the new value to set the signal to, moved into the signal.
     void set(T new_value);
 
     /// @brief Gets the current value of the signal.
-    /// @return the current value of the signal.
-    T get() const;
+    /// @details The reference points into the bound signal, with the same lifetime as signal_t::get().
+    /// @return a reference to the current value of the signal, which is such only until the signal changes.
+    const T &get() const;
 
     void operator()(isignal_t &_signal) override;
 
-    void subscribe(const process_info_t &proc_info) override;
+    void subscribe(const process_info_t &proc_info, sensitivity_mask_t mask) override;
 
     discrete_time_t get_delay() const override;
 
@@ -45,7 +48,7 @@ private:
     /// @brief The module that owns this signal.
     module_t *sig_owner                           = nullptr;
     /// @brief The signal this input or output is bound to.
-    isignal_t *bound_signal                       = nullptr;
+    signal_t<T> *bound_signal                     = nullptr;
     /// @brief List of sub-outputs that are bound to this output.
     std::unordered_set<output_t<T> *> sub_outputs = {};
 };
@@ -62,20 +65,18 @@ output_t<T>::output_t(const std::string &_name, module_t *_sig_owner)
 
 template <typename T> void output_t<T>::set(T new_value)
 {
-    auto signal = dynamic_cast<signal_t<T> *>(bound_signal);
-    if (!signal) {
+    if (!bound_signal) {
         throw std::runtime_error("Output not bound: " + get_signal_location_string(this));
     }
-    signal->set(new_value);
+    bound_signal->set(std::move(new_value));
 }
 
-template <typename T> T output_t<T>::get() const
+template <typename T> const T &output_t<T>::get() const
 {
-    auto signal = dynamic_cast<signal_t<T> *>(bound_signal);
-    if (!signal) {
+    if (!bound_signal) {
         throw std::runtime_error("Output not bound: " + get_signal_location_string(this));
     }
-    return signal->get();
+    return bound_signal->get();
 }
 
 template <typename T> void output_t<T>::operator()(isignal_t &binding)
@@ -101,18 +102,17 @@ template <typename T> void output_t<T>::operator()(isignal_t &binding)
     }
 }
 
-template <typename T> inline void output_t<T>::subscribe(const process_info_t &)
+template <typename T> inline void output_t<T>::subscribe(const process_info_t &, sensitivity_mask_t)
 {
     throw std::runtime_error("Cannot use an output to subscribe a process to be notified.");
 }
 
 template <typename T> discrete_time_t output_t<T>::get_delay() const
 {
-    auto signal = dynamic_cast<signal_t<T> *>(bound_signal);
-    if (!signal) {
+    if (!bound_signal) {
         throw std::runtime_error("Output not bound: " + get_signal_location_string(this));
     }
-    return signal->get_delay();
+    return bound_signal->get_delay();
 }
 
 template <typename T> bool output_t<T>::bound() const { return bound_signal != nullptr; }
@@ -0,0 +1,102 @@
+/// @file partitioner.hpp
+/// @brief Multilevel partitioning of the processes, for the parallel engines.
+/// @copyright
+/// This file is distributed under the terms of the MIT License.
+/// See the full license in the root directory at LICENSE.md.
+
+#pragma once
+
+#include "digsim/common.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace digsim
+{
+
+/// @brief Assigns each process to a partition, the map can be stored and reused by the following runs of the design.
+struct partition_map_t {
+    /// @brief The fingerprint of the design the map belongs to, see dependency_graph_t::compute_fingerprint().
+    std::uint64_t fingerprint = 0;
+    /// @brief The number of partitions.
+    std::size_t num_partitions = 1;
+    /// @brief The partition of each process, indexed by process id.
+    std::vector<std::size_t> process_partition;
+
+    /// @brief Loads the map from a file.
+    /// @param filename the name of the file.
+    /// @param expected the fingerprint of the current design.
+    /// @return true if the file exists and matches the fingerprint, false otherwise.
+    bool load(const std::string &filename, std::uint64_t expected);
+
+    /// @brief Saves the map to a file, as text, one process per line.
+    /// @param filename the name of the file.
+    void save(const std::string &filename) const;
+};
+
+/// @brief Splits the processes into balanced partitions, cutting as few signals as possible.
+/// @details The partitioner works like METIS, on the graph whose vertices are the processes, and whose edges are the
+/// signals connecting them (see dependency_graph_t::get_process_edges()):
+///  1. the graph is coarsened, by repeatedly merging each vertex with the neighbour it shares the heaviest edge with;
+///  2. the coarsest graph is partitioned by growing each partition from a seed, through the vertices most connected
+///     to it, a few times from different seeds, keeping the smallest cut;
+///  3. the partition is projected back to the finer graphs, moving the vertices on the boundary whenever it reduces
+///     the weight of the cut, or improves the balance without increasing it.
+///
+/// A process weighs one plus its activations times its cost. A signal weighs one plus the activations of its
+/// producer, multiplied by a bonus which is highest without delay, so that the cut goes where the lookahead is large.
+/// Processes owned by a signal (e.g., its delayed updates) go with the producer of the signal. The result only depends
+/// on the design, the weights, and the seed.
+class partitioner_t
+{
+public:
+    /// @brief Constructor, all processes weigh the same.
+    partitioner_t();
+
+    /// @brief Sets how many times each process was activated, e.g., from scheduler_t::get_activations().
+    /// @param _activations the activations, indexed by process id.
+    void set_activations(const std::vector<std::uint64_t> &_activations);
+
+    /// @brief Sets the cost of an activation of a process, 1 by default.
+    /// @param proc_info the process.
+    /// @param cost the cost.
+    void set_cost(const process_info_t &proc_info, std::uint64_t cost);
+
+    /// @brief Sets how much heavier than the average a partition can be.
+    /// @param _imbalance the tolerance, e.g., 0.05 allows partitions 5% heavier than the average.
+    void set_imbalance(double _imbalance);
+
+    /// @brief Sets the seed used to visit the vertices while coarsening, and to pick the seeds of the partitions.
+    /// @param _seed the seed.
+    void set_seed(std::uint64_t _seed);
+
+    /// @brief Partitions the processes registered so far.
+    /// @param num_partitions the number of partitions.
+    /// @return the partition map.
+    partition_map_t partition(std::size_t num_partitions);
+
+    /// @brief Returns the total weight of the signals cut by the last partitioning.
+    /// @return the weight of the cut.
+    std::uint64_t get_cut() const { return cut; }
+
+    /// @brief Returns the weight of each partition, computed by the last partitioning.
+    /// @return the weights, indexed by partition.
+    const std::vector<std::uint64_t> &get_loads() const { return loads; }
+
+private:
+    /// @brief The activations of each process, indexed by process id.
+    std::vector<std::uint64_t> activations;
+    /// @brief The cost of each process, indexed by process id.
+    std::vector<std::uint64_t> costs;
+    /// @brief How much heavier than the average a partition can be.
+    double imbalance;
+    /// @brief The seed used to visit the vertices while coarsening.
+    std::uint64_t seed;
+    /// @brief The weight of the cut of the last partitioning.
+    std::uint64_t cut;
+    /// @brief The weight of each partition of the last partitioning.
+    std::vector<std::uint64_t> loads;
+};
+
+} // namespace digsim
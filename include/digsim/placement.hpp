@@ -0,0 +1,80 @@
+/// @file placement.hpp
+/// @brief Placement of the worker threads on the cores and NUMA nodes of the machine.
+/// @copyright
+/// This file is distributed under the terms of the MIT License.
+/// See the full license in the root directory at LICENSE.md.
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace digsim
+{
+
+/// @brief Defines where the threads running the partitions are placed.
+enum class placement_t {
+    none,    ///< The threads are left to the operating system, and the partitions to whichever thread is free.
+    compact, ///< The threads are pinned to consecutive cores, filling a NUMA node before the next one.
+    scatter, ///< The threads are pinned to the NUMA nodes in turn, spreading them over all the memory controllers.
+};
+
+/// @brief Parses the name of a placement policy, as used by the DIGSIM_PLACEMENT environment variable.
+/// @param text the name, i.e., "none", "compact", or "scatter".
+/// @param placement where the policy is stored.
+/// @return true if the name is valid, false otherwise.
+bool parse_placement(const std::string &text, placement_t &placement);
+
+/// @brief Returns the name of a placement policy.
+/// @param placement the policy.
+/// @return the name.
+const char *to_string(placement_t placement);
+
+/// @brief Parses a list of CPUs in the format used by Linux, e.g., "0-3,8,10-11".
+/// @param list the list.
+/// @return the CPUs, in the order they are listed.
+std::vector<int> parse_cpu_list(const std::string &list);
+
+/// @brief The CPUs the process can run on, grouped by NUMA node.
+struct cpu_topology_t {
+    /// @brief The CPUs of each node, nodes without usable CPUs are left out.
+    std::vector<std::vector<int>> nodes;
+
+    /// @brief Reads the topology from sysfs, restricted to the CPUs the process is allowed to run on.
+    /// @details Without NUMA information, all the CPUs belong to a single node.
+    /// @return the topology.
+    static cpu_topology_t detect();
+
+    /// @brief Returns the number of CPUs.
+    /// @return the number of CPUs, over all the nodes.
+    std::size_t num_cpus() const;
+
+    /// @brief Returns the CPU given to a thread.
+    /// @param placement the placement policy.
+    /// @param slot the index of the thread, 0 being the thread calling scheduler_t::run().
+    /// @return the CPU, or -1 if the thread is not pinned.
+    int cpu_of(placement_t placement, std::size_t slot) const;
+
+    /// @brief Returns the node given to a thread.
+    /// @param placement the placement policy.
+    /// @param slot the index of the thread.
+    /// @return the node, in the order of cpu_topology_t::nodes, or -1 if the thread is not pinned.
+    int node_of(placement_t placement, std::size_t slot) const;
+};
+
+/// @brief Pins the calling thread to a single CPU.
+/// @param cpu the CPU.
+/// @return true on success, false if the system refused it.
+bool pin_thread(int cpu);
+
+/// @brief Returns the CPUs the calling thread is allowed to run on.
+/// @return the CPUs.
+std::vector<int> get_thread_cpus();
+
+/// @brief Allows the calling thread to run on the given CPUs.
+/// @param cpus the CPUs.
+/// @return true on success, false if the system refused it.
+bool set_thread_cpus(const std::vector<int> &cpus);
+
+} // namespace digsim
@@ -0,0 +1,68 @@
+/// @file quantum_keeper.hpp
+/// @brief Quantum keeper used to temporally decouple a process from the scheduler.
+/// @copyright
+/// This file is distributed under the terms of the MIT License.
+/// See the full license in the root directory at LICENSE.md.
+
+#pragma once
+
+#include "digsim/common.hpp"
+
+namespace digsim
+{
+
+/// @brief Keeps track of the local time offset of a temporally decoupled process.
+/// @details A loosely-timed process (e.g., a fast CPU model) can execute many operations within a single activation,
+/// accumulating their cost as a local time offset on top of the scheduler time. The process only needs to
+/// synchronize with the scheduler when the global quantum (see scheduler_t::set_global_quantum) is exhausted, or at
+/// explicit synchronization points (e.g., before interacting with a peripheral).
+class quantum_keeper_t
+{
+public:
+    /// @brief Constructor for the quantum keeper.
+    quantum_keeper_t();
+
+    /// @brief Increments the local time offset.
+    /// @param t the amount of time to add to the local time offset.
+    void inc(discrete_time_t t);
+
+    /// @brief Sets the local time offset.
+    /// @param t the new local time offset.
+    void set(discrete_time_t t);
+
+    /// @brief Gets the local time offset.
+    /// @return the local time offset, relative to the scheduler time.
+    discrete_time_t get_local_time() const;
+
+    /// @brief Gets the current time as seen by the decoupled process.
+    /// @return the scheduler time plus the local time offset.
+    discrete_time_t get_current_time() const;
+
+    /// @brief Checks if the process has exhausted its quantum.
+    /// @return true if the process must synchronize with the scheduler, false otherwise.
+    bool need_sync() const;
+
+    /// @brief Synchronizes the process with the scheduler.
+    /// @details The given process is scheduled to resume after the local time offset, which is then cleared. The
+    /// caller is expected to return right after calling this function. A process which did not run ahead is already
+    /// in sync: nothing is scheduled, since resuming it in the same time step would not make any progress.
+    /// @param resume the process to execute once the scheduler reaches the local time.
+    /// @return true if the process was scheduled to resume, false if it was already in sync and can go on.
+    bool sync(const process_info_t &resume);
+
+    /// @brief Clears the local time offset and computes the next synchronization point.
+    void reset();
+
+private:
+    /// @brief Computes the next quantum boundary after the given time.
+    /// @param time the time from which to compute the boundary.
+    /// @return the next synchronization point.
+    static discrete_time_t compute_next_sync_point(discrete_time_t time);
+
+    /// @brief The local time offset.
+    discrete_time_t local_time;
+    /// @brief The time at which the process must synchronize.
+    discrete_time_t next_sync_point;
+};
+
+} // namespace digsim
@@ -7,14 +7,25 @@
 #pragma once
 
 #include "digsim/common.hpp"
+#include "digsim/elaboration_cache.hpp"
 #include "digsim/event.hpp"
+#include "digsim/partitioner.hpp"
+#include "digsim/placement.hpp"
 
+#include <atomic>
+#include <cstdint>
+#include <condition_variable>
+#include <deque>
+#include <functional>
 #include <iomanip>
 #include <iostream>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <queue>
 #include <set>
 #include <sstream>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -22,6 +33,75 @@
 namespace digsim
 {
 
+class isignal_t; // Forward declare abstract signal.
+
+/// @brief Defines how the processes are split among the scheduler partitions.
+enum class partitioning_t {
+    none,          ///< All processes belong to a single partition.
+    clock_domains, ///< One partition per clock domain, inferred from the dependency graph.
+    custom,        ///< As given by the partition map passed to scheduler_t::set_partition_map().
+};
+
+/// @brief Defines the order in which the processes of a delta cycle are executed.
+/// @details Whatever the order, it is the same across runs, and between the serial and the parallel execution.
+enum class ordering_t {
+    registration, ///< By process id, i.e., in the order the processes were registered.
+    topological,  ///< By topological level in the dependency graph, then by process id.
+    shuffled,     ///< In a pseudo-random order drawn from a seed, to expose models that depend on the order.
+};
+
+/// @brief The kinds of order-dependent accesses to a signal.
+enum class race_kind_t {
+    write_write, ///< Two processes wrote the signal in the same delta cycle, the last one wins.
+    read_write,  ///< A process read the signal in the delta cycle another one wrote it, without being woken up by it.
+};
+
+/// @brief An order-dependent access to a signal, found by the race detection.
+struct race_t {
+    discrete_time_t time; ///< The time of the delta cycle.
+    race_kind_t kind;     ///< The kind of race.
+    std::string signal;   ///< The name of the signal.
+    std::string first;    ///< The name of the process writing the signal.
+    std::string second;   ///< The name of the other process accessing the signal.
+};
+
+/// @brief What the scheduler does when a time step exceeds the delta cycle limit.
+enum class delta_policy_t {
+    abort, ///< Throw an exception out of run().
+    pause, ///< Return from run(), as if a stop was requested, so that the simulation can be inspected and resumed.
+};
+
+/// @brief The report of a time step which exceeded the delta cycle limit.
+struct delta_storm_t {
+    discrete_time_t time = 0;           ///< The time step.
+    std::size_t deltas   = 0;           ///< The number of delta cycles executed in the time step.
+    std::vector<std::string> processes; ///< The hierarchical names of the processes executed in the last deltas.
+    std::vector<std::string> signals;   ///< The names of the signals written in the last deltas.
+};
+
+/// @brief The state of the scheduler between two time steps, see scheduler_t::save_state().
+struct scheduler_state_t {
+    discrete_time_t time = 0;    ///< The time of the last time step.
+    std::vector<event_t> events; ///< The pending events, of all partitions.
+    /// @brief Whether each process is disabled, see scheduler_t::set_process_enabled().
+    std::vector<std::uint8_t> process_disabled;
+    /// @brief The activations dropped while each process was disabled.
+    std::vector<std::set<discrete_time_t>> process_pending;
+};
+
+/// @brief A partition of the scheduler, i.e., a set of processes with their own event queue.
+struct partition_t {
+    /// @brief The priority queue of events, ordered by their scheduled time.
+    std::priority_queue<event_t, std::vector<event_t>, std::greater<>> event_queue;
+    /// @brief The processes to execute in the current delta cycle, indexed by their rank in the execution order,
+    /// together with their id.
+    std::map<std::size_t, std::pair<std::size_t, std::shared_ptr<process_t>>> batch;
+    /// @brief Events targeting other partitions, produced while running in parallel.
+    std::vector<event_t> outbox;
+    /// @brief Updates of crossing signals, produced while running in parallel.
+    std::vector<std::function<void()>> updates;
+};
+
 /// @brief The scheduler class is responsible for managing the simulation time and scheduling events.
 class scheduler_t
 {
@@ -34,6 +114,9 @@ public:
         return s;
     }
 
+    /// @brief Destructor, stops the worker threads.
+    ~scheduler_t();
+
     /// @brief Get the current simulation time.
     /// @return The current simulation time as a discrete_time_t value.
     discrete_time_t time() const;
@@ -46,6 +129,15 @@ public:
     /// @param proc_info Information about the process to be executed.
     void schedule_now(const process_info_t &proc_info);
 
+    /// @brief Schedule a process to be executed immediately, because some of its inputs changed.
+    /// @param proc_info Information about the process to be executed.
+    /// @param mask the sensitivity entries of the process that changed, accumulated until the process runs.
+    void schedule_now(const process_info_t &proc_info, sensitivity_mask_t mask);
+
+    /// @brief Returns which sensitivity entries of the running process changed since its last activation.
+    /// @return the changed mask, 0 if the process was not woken up by a signal (e.g., during initialization).
+    sensitivity_mask_t get_changed_mask() const;
+
     /// @brief Schedule a process to be executed after a specified delay.
     /// @param proc_info Information about the process to be executed.
     /// @param delay the delay after which the process should be executed.
@@ -58,26 +150,416 @@ public:
     /// @brief Initializes the scheduler and all registered processes.
     void initialize();
 
+    /// @brief Checks if the scheduler was initialized.
+    /// @return true if initialize() was called.
+    bool is_initialized() const { return initialized; }
+
     /// @brief Runs the simulation for a specified amount of time.
     /// @param simulation_time the total time to run the simulation, defaults to 0 which means run until all events are
     /// processed.
     void run(discrete_time_t simulation_time = 0);
 
+    /// @brief Runs the simulation until the given time, included.
+    /// @param end_time the time of the last events to execute.
+    void run_until(discrete_time_t end_time);
+
+    /// @brief Asks the scheduler to return from run() once the current delta cycle is complete.
+    /// @details It can be called from within a process, e.g., by a watchpoint, also while running in parallel. A
+    /// request made while the simulation is not running is discarded by the next run().
+    void request_stop();
+
+    /// @brief Checks if the last call to run() returned because a stop was requested.
+    /// @return true if the simulation was paused by request_stop(), false otherwise.
+    bool stopped() const;
+
     /// @brief Prints the current state of the event queue for debugging purposes.
     void print_event_queue() const;
 
+    /// @brief Sets the global time quantum used by temporally decoupled processes.
+    /// @param quantum the maximum amount of time a process can run ahead of the scheduler, 0 disables decoupling.
+    void set_global_quantum(discrete_time_t quantum);
+
+    /// @brief Gets the global time quantum used by temporally decoupled processes.
+    /// @return the global time quantum.
+    discrete_time_t get_global_quantum() const;
+
+    /// @brief Sets how processes are split among partitions, must be called before initialize().
+    /// @param mode the partitioning mode.
+    void set_partitioning(partitioning_t mode);
+
+    /// @brief Splits the processes as given by a partition map, must be called before initialize().
+    /// @details It sets the partitioning to partitioning_t::custom. The map is installed as the clock domains of the
+    /// dependency graph, so that the signals going from a partition to another are marked as crossing. A map whose
+    /// fingerprint differs from the one of the design is rejected, with an exception.
+    /// @param map the partition map, e.g., computed by partitioner_t, or loaded from a file.
+    void set_partition_map(const partition_map_t &map);
+
+    /// @brief Enables or disables counting the activations of each process, enabling it clears the counters.
+    /// @param enabled true to count the activations.
+    void set_profiling(bool enabled);
+
+    /// @brief Returns how many times each process was activated while profiling, e.g., for partitioner_t.
+    /// @return the activations, indexed by process id.
+    const std::vector<std::uint64_t> &get_activations() const { return activations; }
+
+    /// @brief Enables the migration of processes between partitions, as their activity changes.
+    /// @details Every given number of time steps, between two time steps, the activations of each partition since
+    /// the last check are compared. If the busiest partition is beyond the average by more than the tolerance, the
+    /// processes most connected to the idlest partition are moved to it, until they carry half the difference. Only
+    /// the partition of the processes, the crossing signals, and the pending events are updated. A process owned by a
+    /// signal (e.g., its delayed update) moves along with the producer of the signal.
+    /// @param interval the number of time steps between two checks, 0 (the default) disables the migrations.
+    /// @param tolerance how much busier than the average a partition can be, e.g., 0.25 allows 25% more activations.
+    void set_rebalancing(std::size_t interval, double tolerance = 0.25);
+
+    /// @brief Returns how many processes were moved to another partition, see set_rebalancing().
+    /// @return the number of migrations.
+    std::size_t get_migrations() const { return migrations; }
+
+    /// @brief Sets the number of threads used to run the partitions.
+    /// @param threads the number of threads, 1 (the default) runs all the partitions on the calling thread.
+    void set_num_threads(std::size_t threads);
+
+    /// @brief Sets where the threads running the partitions are placed.
+    /// @details With a policy other than placement_t::none, each thread is pinned to a core, and runs the partitions
+    /// whose index modulo the number of threads is its own. The storage the scheduler keeps for a partition, i.e., its
+    /// event queue, its outgoing events, and its crossing updates, is allocated again by its thread, which places it
+    /// on the node of the thread, as memory goes to the node that first touches it. The outgoing events belong to the
+    /// producing partition, and are pushed into the event queue of the consumer by the thread committing the delta
+    /// cycle: they land in the storage placed by the consumer's thread only while the queue does not outgrow it, any
+    /// growth being allocated on the node of the committing thread. The signals and the processes are not moved:
+    /// they belong to the design, which allocates them while elaborating, usually from the main thread, so they stay
+    /// on the node of that thread. The default policy is read from the DIGSIM_PLACEMENT environment variable, see
+    /// parse_placement().
+    /// @param _placement the placement policy.
+    void set_placement(placement_t _placement);
+
+    /// @brief Returns where the threads running the partitions are placed.
+    /// @return the placement policy.
+    placement_t get_placement() const { return placement; }
+
+    /// @brief Returns the number of partitions.
+    /// @return the number of partitions.
+    std::size_t get_num_partitions() const;
+
+    /// @brief Returns the partition the given process belongs to.
+    /// @param proc_info the process.
+    /// @return the index of the partition.
+    std::size_t get_partition(const process_info_t &proc_info) const;
+
+    /// @brief Checks if the calling thread is running a partition whose updates to crossing signals are deferred.
+    /// @details With more than one partition, this holds both when the partitions run concurrently and when they run
+    /// one after the other, so that the two produce the same results.
+    /// @return true if the calling thread is executing a batch of a partition, false otherwise.
+    bool in_parallel_phase() const;
+
+    /// @brief Defers an update until all partitions have completed the current delta cycle.
+    /// @param update the update to apply, it must be called from within a parallel phase.
+    void defer_update(std::function<void()> update);
+
+    /// @brief Enables or disables the activations of a process.
+    /// @details The activations of a disabled process are dropped, and only their times are recorded as pending. When
+    /// the process is enabled again, the pending activations are scheduled again: those in the past are merged into a
+    /// single one at the current time, those in the future keep their time.
+    /// @param proc_info the process.
+    /// @param enabled true to enable the process, false to disable it.
+    void set_process_enabled(const process_info_t &proc_info, bool enabled);
+
+    /// @brief Checks if a process is enabled.
+    /// @param proc_info the process.
+    /// @return true if the process is enabled, false otherwise.
+    bool is_process_enabled(const process_info_t &proc_info) const;
+
+    /// @brief Sets the order in which the processes of a delta cycle are executed, must be called before initialize().
+    /// @param mode the ordering mode.
+    /// @param seed the seed of the shuffled ordering, ignored by the other modes.
+    void set_ordering(ordering_t mode, std::uint64_t seed = 0);
+
+    /// @brief Returns the order in which the processes of a delta cycle are executed.
+    /// @return the ordering mode.
+    ordering_t get_ordering() const;
+
+    /// @brief Sets the file caching the results of the elaboration analyses, must be called before initialize().
+    /// @details When the file matches the fingerprint of the design, the cycle check, the topological order, and the
+    /// clock domains are taken from it instead of being computed again; otherwise, they are computed and the file is
+    /// rewritten. An empty name disables the cache.
+    /// @param filename the name of the file.
+    void set_elaboration_cache(const std::string &filename);
+
+    /// @brief Checks if the last initialization reused the results stored in the elaboration cache.
+    /// @return true if the cache matched the design, false otherwise.
+    bool is_elaboration_cached() const;
+
+    /// @brief Enables or disables the detection of order-dependent accesses to signals.
+    /// @details Within each delta cycle, the detector records which processes write each signal, and which processes
+    /// read it through an input they are not sensitive to. A signal written by two processes, or written by one and
+    /// read by another, gives results that depend on the order of the processes. Combine it with the shuffled
+    /// ordering to check that the outputs of a model do not change.
+    /// @param enabled true to enable the detection.
+    void set_race_detection(bool enabled);
+
+    /// @brief Checks if the detection of order-dependent accesses is enabled.
+    /// @return true if the detection is enabled, false otherwise.
+    bool is_race_detection_enabled() const { return race_detection; }
+
+    /// @brief Sets the maximum number of delta cycles executed within a single time step.
+    /// @details A zero-delay loop, or a model toggling its outputs within a time step, would otherwise keep run()
+    /// spinning at the same time forever. The processes and signals involved in the last delta cycles before the limit
+    /// are reported.
+    /// @param limit the maximum number of delta cycles, 0 disables the check.
+    /// @param policy what to do when the limit is exceeded.
+    void set_delta_limit(std::size_t limit, delta_policy_t policy = delta_policy_t::abort);
+
+    /// @brief Returns the maximum number of delta cycles executed within a single time step.
+    /// @return the limit, 0 if the check is disabled.
+    std::size_t get_delta_limit() const;
+
+    /// @brief Returns the report of the last time step which exceeded the delta cycle limit.
+    /// @return the report, with no deltas if the limit was never exceeded.
+    const delta_storm_t &get_delta_storm() const;
+
+    /// @brief Checks if the writes to signals must be reported through record_write().
+    /// @return true if the race detection is enabled, or the delta cycle limit is about to be exceeded.
+    bool is_recording_writes() const { return race_detection || storm_tracing; }
+
+    /// @brief Records a read of a signal by the running process, used by the race detection.
+    /// @param signal the signal.
+    /// @param woken true if the reader is woken up when the signal changes.
+    void record_read(const isignal_t *signal, bool woken);
+
+    /// @brief Records a read of a signal by the running process, which is woken up only by some of its changes.
+    /// @param signal the signal.
+    /// @param woken evaluated once the delta cycle is complete, checks if the value written wakes up the reader.
+    void record_read(const isignal_t *signal, std::function<bool()> woken);
+
+    /// @brief Records a write of a signal by the running process, used by the race detection and the delta storm
+    /// report.
+    /// @param signal the signal.
+    void record_write(const isignal_t *signal);
+
+    /// @brief Returns the races found so far.
+    /// @return the list of races.
+    const std::vector<race_t> &get_races() const;
+
+    /// @brief Returns the id of the process being executed by the calling thread.
+    /// @return the id of the process, std::numeric_limits<std::size_t>::max() outside of a delta cycle.
+    std::size_t get_current_process() const;
+
+    /// @brief Returns the number of events waiting in the queues.
+    /// @return the number of pending events, only the ones of the current partition during a parallel phase.
+    std::size_t pending_events() const;
+
+    /// @brief Returns the time of the next event, among all partitions.
+    /// @return the time, or the largest time if there are no events.
+    discrete_time_t next_event_time() const;
+
+    /// @brief Copies the current time, the pending events, and which processes are disabled, it must be called between
+    /// two time steps.
+    /// @details Together with the state_log_t, which undoes the changes of the signals and of the models, it allows
+    /// an optimistic simulation to go back to the time of the copy.
+    /// @return the state of the scheduler.
+    scheduler_state_t save_state() const;
+
+    /// @brief Goes back to a state copied by save_state(), dropping the pending events, and disabling again the
+    /// processes disabled at the time of the copy.
+    /// @param state the state of the scheduler.
+    void restore_state(const scheduler_state_t &state);
+
 private:
     /// @brief Private constructor for the singleton pattern.
     scheduler_t();
 
+    /// @brief Drops the activation of a disabled process, and records its time as pending.
+    /// @param proc_info the process.
+    /// @param time the time of the activation.
+    /// @return true if the activation was dropped, false if the process is enabled.
+    bool suppress(const process_info_t &proc_info, discrete_time_t time);
+
+    /// @brief Assigns the processes to the partitions, and moves the pending events accordingly.
+    void assign_partitions();
+
+    /// @brief Executes the current batch of a partition.
+    /// @param index the index of the partition.
+    void run_partition(std::size_t index);
+
+    /// @brief Moves processes from the busiest partitions to the idlest ones, see set_rebalancing().
+    void rebalance();
+
+    /// @brief Groups the processes which must stay together, and connects the groups, for rebalance().
+    void build_migration_units();
+
+    /// @brief Computes the rank of each process in the execution order.
+    void compute_ranks();
+
+    /// @brief Returns the rank of a process in the execution order.
+    /// @param id the id of the process.
+    /// @return the rank, processes created after the initialization come last, by id.
+    std::size_t get_rank(std::size_t id) const;
+
+    /// @brief Checks the accesses recorded during the last delta cycle, and clears them.
+    void check_races();
+
+    /// @brief Counts a delta cycle at the given time, and records the batches of the last ones before the limit.
+    /// @param time the time of the delta cycle.
+    /// @return true if the delta cycle limit is exceeded.
+    bool count_delta(discrete_time_t time);
+
+    /// @brief Records the processes of the batches about to be executed, for the delta storm report.
+    void trace_batches();
+
+    /// @brief Builds and logs the report of the current time step, which exceeded the delta cycle limit.
+    void report_delta_storm();
+
+    /// @brief Executes the batches of the given partitions one after the other, deferring the crossing updates.
+    /// @param active the indices of the partitions that have a batch to execute.
+    void run_serial(const std::vector<std::size_t> &active);
+
+    /// @brief Forwards the events targeting other partitions, and commits the updates of crossing signals.
+    /// @param active the indices of the partitions that executed a batch.
+    void commit(const std::vector<std::size_t> &active);
+
+    /// @brief Executes the batches of the given partitions on the worker threads.
+    /// @param active the indices of the partitions that have a batch to execute.
+    void run_parallel(const std::vector<std::size_t> &active);
+
+    /// @brief Starts the worker threads.
+    void start_workers();
+
+    /// @brief Stops the worker threads.
+    void stop_workers();
+
+    /// @brief The main loop of a worker thread.
+    /// @param slot the index of the thread, 0 being the thread calling run().
+    /// @param last_generation the generation of the last parallel phase before the worker was started.
+    void worker_loop(std::size_t slot, std::size_t last_generation);
+
+    /// @brief Executes batches until there is none left in the current parallel phase.
+    /// @param slot the index of the calling thread.
+    void drain_tasks(std::size_t slot);
+
+    /// @brief Pins the calling thread as given by the placement policy, and allocates again the storage the scheduler
+    /// keeps for its partitions, from the calling thread. The signals and the processes are left where the design
+    /// allocated them.
+    /// @param slot the index of the calling thread.
+    void place_thread(std::size_t slot);
+
     /// @brief Check if the scheduler is initialized.
     bool initialized;
     /// @brief The current simulation time.
     discrete_time_t now;
-    /// @brief The priority queue of events, ordered by their scheduled time.
-    std::priority_queue<event_t, std::vector<event_t>, std::greater<>> event_queue;
+    /// @brief The global time quantum for temporally decoupled processes.
+    discrete_time_t global_quantum;
+    /// @brief The partitions, each with its own event queue.
+    std::vector<partition_t> partitions;
+    /// @brief Maps each process id to the index of its partition.
+    std::vector<std::size_t> process_partition;
+    /// @brief Maps each process id to the sensitivity entries that changed since its last activation.
+    std::vector<sensitivity_mask_t> process_changed;
+    /// @brief Maps each process id to whether the process is disabled.
+    std::vector<std::uint8_t> process_disabled;
+    /// @brief Maps each process id to the times of the activations dropped while it was disabled, those in the past
+    /// are merged into the earliest one.
+    std::vector<std::set<discrete_time_t>> process_pending;
+    /// @brief How processes are split among partitions.
+    partitioning_t partitioning;
+    /// @brief The partition map used by partitioning_t::custom.
+    partition_map_t partition_map;
+    /// @brief Whether the activations of the processes are counted.
+    bool profiling;
+    /// @brief The activations of each process, indexed by process id.
+    std::vector<std::uint64_t> activations;
+    /// @brief The number of time steps between two checks of the balance, 0 if disabled.
+    std::size_t rebalance_interval;
+    /// @brief How much busier than the average a partition can be, before processes are moved away from it.
+    double rebalance_tolerance;
+    /// @brief The number of time steps since the last check of the balance.
+    std::size_t rebalance_steps;
+    /// @brief The activations of each process at the last check of the balance.
+    std::vector<std::uint64_t> rebalance_base;
+    /// @brief Maps each process id to the unit it migrates with, i.e., the process it must stay with.
+    std::vector<std::size_t> migration_unit;
+    /// @brief The processes of each unit.
+    std::vector<std::vector<std::size_t>> unit_processes;
+    /// @brief The units connected to each unit by a signal, once per signal.
+    std::vector<std::vector<std::size_t>> unit_neighbours;
+    /// @brief The number of processes moved to another partition so far.
+    std::size_t migrations;
+    /// @brief The number of threads used to run the partitions.
+    std::size_t num_threads;
+    /// @brief Where the threads running the partitions are placed.
+    placement_t placement;
+    /// @brief The CPUs and NUMA nodes available to the threads, detected when the threads are first placed.
+    cpu_topology_t topology;
+    /// @brief The CPUs the thread calling run() was allowed to run on, before being pinned.
+    std::vector<int> caller_cpus;
+    /// @brief Set by request_stop(), cleared by run() when it honours the request.
+    std::atomic<bool> stop_requested;
+    /// @brief Whether the last call to run() was interrupted by a stop request.
+    bool stop_honoured;
+    /// @brief The order in which the processes of a delta cycle are executed.
+    ordering_t ordering;
+    /// @brief The seed of the shuffled ordering.
+    std::uint64_t ordering_seed;
+    /// @brief Maps each process id to its rank in the execution order.
+    std::vector<std::size_t> process_rank;
+    /// @brief The file caching the results of the elaboration analyses, empty if disabled.
+    std::string elaboration_cache_file;
+    /// @brief The results of the elaboration analyses, loaded from or saved to the cache file.
+    elaboration_cache_t elaboration_cache;
+    /// @brief Whether the elaboration cache matched the design.
+    bool elaboration_cached;
+    /// @brief Whether the detection of order-dependent accesses is enabled.
+    bool race_detection;
+    /// @brief The accesses to a signal during a delta cycle.
+    struct access_t {
+        std::vector<std::size_t> writers; ///< The processes which wrote the signal.
+        std::vector<std::size_t> readers; ///< The processes which read the signal, without being sensitive to it.
+        /// @brief The processes which read the signal, and are only woken up by some of its values.
+        std::vector<std::pair<std::size_t, std::function<bool()>>> guarded_readers;
+    };
+    /// @brief The accesses recorded during the current delta cycle.
+    std::unordered_map<const isignal_t *, access_t> accesses;
+    /// @brief Protects the recorded accesses, which can come from different threads.
+    std::mutex accesses_mutex;
+    /// @brief The races found so far.
+    std::vector<race_t> races;
+    /// @brief The maximum number of delta cycles within a time step, 0 disables the check.
+    std::size_t delta_limit;
+    /// @brief What to do when the delta cycle limit is exceeded.
+    delta_policy_t delta_policy;
+    /// @brief The time step of the delta cycles being counted.
+    discrete_time_t delta_time;
+    /// @brief The number of delta cycles executed in the current time step.
+    std::size_t delta_count;
+    /// @brief Whether the last delta cycles before the limit are being recorded.
+    bool storm_tracing;
+    /// @brief The processes executed in the last delta cycles, oldest first.
+    std::deque<std::vector<std::size_t>> storm_processes;
+    /// @brief The signals written in the last delta cycles, oldest first.
+    std::deque<std::vector<const isignal_t *>> storm_signals;
+    /// @brief The report of the last time step which exceeded the delta cycle limit.
+    delta_storm_t delta_storm;
     /// @brief The list of function to call during initialization.
     std::unordered_set<process_info_t, process_info_hash, process_info_equal> initializer_queue;
+
+    /// @brief The worker threads.
+    std::vector<std::thread> workers;
+    /// @brief Protects the state shared with the worker threads.
+    std::mutex workers_mutex;
+    /// @brief Wakes up the workers when a new parallel phase starts.
+    std::condition_variable workers_start;
+    /// @brief Wakes up the scheduler when the workers are done.
+    std::condition_variable workers_done;
+    /// @brief Incremented each time a new parallel phase starts.
+    std::size_t generation;
+    /// @brief Number of workers still running in the current parallel phase.
+    std::size_t busy_workers;
+    /// @brief Tells the workers to terminate.
+    bool stopping;
+    /// @brief The partitions to execute in the current parallel phase.
+    std::vector<std::size_t> tasks;
+    /// @brief The index of the next task to execute.
+    std::atomic<std::size_t> next_task;
 };
 
 /// @brief A reference to the singleton instance of the scheduler, for convenience.
@@ -0,0 +1,127 @@
+/// @file sensitivity.hpp
+/// @brief Sensitivity entries, i.e., the subscriptions of processes to signals.
+/// @copyright
+/// This file is distributed under the terms of the MIT License.
+/// See the full license in the root directory at LICENSE.md.
+
+#pragma once
+
+#include "digsim/common.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <concepts>
+#include <limits>
+#include <type_traits>
+
+namespace digsim
+{
+
+/// @brief The kinds of predicates a sensitivity entry can be guarded by.
+enum class predicate_kind_t {
+    always,     ///< Every change wakes up the process.
+    equals,     ///< Only changes to a given value wake up the process.
+    mask_match, ///< Only changes to a value matching a given value, under a mask, wake up the process.
+};
+
+/// @brief A predicate on the new value of a signal, deciding if a change wakes up a process.
+/// @tparam T the type of the signal value.
+template <typename T> struct value_predicate_t {
+    /// @brief The kind of predicate.
+    predicate_kind_t kind = predicate_kind_t::always;
+    /// @brief The value to compare against.
+    T value{};
+    /// @brief The mask applied to the new value, only used by mask_match.
+    T mask{};
+
+    /// @brief Checks if the new value of the signal satisfies the predicate.
+    /// @param new_value the new value of the signal.
+    /// @return true if the process must be woken up, false otherwise.
+    bool operator()(const T &new_value) const
+    {
+        switch (kind) {
+        case predicate_kind_t::equals:
+            return same_value(new_value, value);
+        case predicate_kind_t::mask_match:
+            // Only when_matches() creates this kind, and it rejects the types without a bitwise AND.
+            if constexpr (requires(const T &x) { static_cast<T>(x & x) == x; }) {
+                return static_cast<T>(new_value & mask) == value;
+            }
+            return true;
+        default:
+            return true;
+        }
+    }
+
+    /// @brief Compares two predicates.
+    /// @param other the other predicate.
+    /// @return true if the two predicates are the same, false otherwise.
+    bool operator==(const value_predicate_t &other) const
+    {
+        if (kind != other.kind) {
+            return false;
+        }
+        return (kind == predicate_kind_t::always) || (same_value(value, other.value) && same_value(mask, other.mask));
+    }
+
+    /// @brief Compares two values, using the same tolerance as signals for floating point types.
+    /// @param lhs the first value.
+    /// @param rhs the second value.
+    /// @return true if the two values are the same, false otherwise.
+    static bool same_value(const T &lhs, const T &rhs)
+    {
+        if constexpr (std::is_floating_point_v<T>) {
+            T scale = std::max(std::abs(lhs), std::abs(rhs));
+            return std::abs(lhs - rhs) <= std::numeric_limits<T>::epsilon() * (scale > 0 ? scale : 1);
+        } else if constexpr (std::equality_comparable<T>) {
+            return lhs == rhs;
+        } else {
+            return false;
+        }
+    }
+};
+
+/// @brief Creates a predicate satisfied when the signal changes to the given value.
+/// @tparam T the type of the signal value.
+/// @param value the value.
+/// @return the predicate.
+template <typename T> value_predicate_t<T> when_equals(const T &value)
+{
+    return value_predicate_t<T>{predicate_kind_t::equals, value, T{}};
+}
+
+/// @brief Creates a predicate satisfied when the signal changes to a value whose masked bits match the given ones.
+/// @tparam T the type of the signal value, which must support the bitwise AND.
+/// @param mask the bits to check.
+/// @param value the expected value of the masked bits.
+/// @return the predicate.
+template <typename T> value_predicate_t<T> when_matches(const T &mask, const T &value)
+{
+    static_assert(
+        requires(const T &x) { static_cast<T>(x & x) == x; },
+        "Matching a mask requires a type supporting the bitwise AND and the comparison.");
+    return value_predicate_t<T>{predicate_kind_t::mask_match, value, mask};
+}
+
+/// @brief The subscription of a process to a signal.
+/// @tparam T the type of the signal value.
+template <typename T> struct subscription_t {
+    /// @brief The sensitivity entries of the process reported as changed when the subscription fires.
+    sensitivity_mask_t mask = 0;
+    /// @brief The predicate the new value must satisfy to wake up the process.
+    value_predicate_t<T> predicate{};
+
+    /// @brief Merges another subscription of the same process into this one.
+    /// @details The process is woken up if any of the two would have woken it up. Since there is only one predicate
+    /// per process, different predicates fall back to waking up the process on every change.
+    /// @param other the other subscription.
+    void merge(const subscription_t &other)
+    {
+        mask |= other.mask;
+        if (!(predicate == other.predicate)) {
+            predicate = value_predicate_t<T>{};
+        }
+    }
+};
+
+} // namespace digsim
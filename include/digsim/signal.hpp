@@ -6,18 +6,52 @@
 
 #pragma once
 
+#include "digsim/activity.hpp"
+#include "digsim/coverage.hpp"
+#include "digsim/history.hpp"
 #include "digsim/isignal.hpp"
 #include "digsim/logger.hpp"
 #include "digsim/scheduler.hpp"
+#include "digsim/sensitivity.hpp"
+#include "digsim/state_log.hpp"
+#include "digsim/watchpoint.hpp"
 
+#include <algorithm>
+#include <array>
 #include <cmath>
+#include <cstdint>
 #include <limits>
+#include <memory>
 #include <type_traits>
-#include <unordered_set>
+#include <unordered_map>
+#include <utility>
 
 namespace digsim
 {
 
+/// @brief Decides if a new value of a signal is a change, which wakes up the processes sensitive to the signal.
+/// @details Specialize it to customize the change detection of heavy types. For instance, a policy that always
+/// returns true skips the comparison entirely, and readers can then rely on signal_t::get_version() to tell updates
+/// apart; a policy comparing a user-supplied hash avoids a deep comparison.
+/// @tparam T the type of the signal value.
+template <typename T> struct change_policy_t {
+    /// @brief Checks if the new value differs from the old one.
+    /// @param old_value the current value of the signal.
+    /// @param new_value the value being written.
+    /// @return true if the value changed, false otherwise.
+    static bool changed(const T &old_value, const T &new_value)
+    {
+        if constexpr (std::is_floating_point_v<T>) {
+            // For floating point types, use epsilon-based comparison to avoid precision issues
+            T diff  = std::abs(new_value - old_value);
+            T scale = std::max(std::abs(old_value), std::abs(new_value));
+            return diff > std::numeric_limits<T>::epsilon() * (scale > 0 ? scale : 1);
+        } else {
+            return new_value != old_value;
+        }
+    }
+};
+
 /// @brief The signal_t class represents a signal in a digital simulation.
 /// @tparam T the type of the signal value.
 template <typename T> class signal_t : public isignal_t
@@ -31,19 +65,58 @@ public:
 
     /// @brief Initializes the signal with a value.
     /// @param _value the value to initialize the signal with.
-    void initialize(T _value);
+    void initialize(const T &_value);
 
     /// @brief Sets the default delay for this signal.
     /// @param _delay the default delay to set for this signal.
     void set_delay(discrete_time_t _delay);
 
     /// @brief Sets the value of the signal.
-    /// @param new_value the new value to set the signal to.
+    /// @param new_value the new value to set the signal to, moved into the signal.
     void set(T new_value);
 
     /// @brief Gets the current value of the signal.
-    /// @return the current value of the signal.
-    T get() const;
+    /// @details The signal keeps its current and last values in two slots, and swaps their roles at each change
+    /// instead of copying the value. The returned reference stays bound to its slot: after the next change it refers
+    /// to the last value, and the change after that overwrites it. Copy the value to keep it across changes, e.g.,
+    /// `const T value = signal.get();`.
+    /// @return a reference to the current value of the signal, which is such only until the signal changes.
+    const T &get() const;
+
+    /// @brief Gets the value the signal had before the last change.
+    /// @details The reference is bound to a slot which the next change overwrites, see get().
+    /// @return a reference to the last value of the signal, valid until the signal changes.
+    const T &get_last() const;
+
+    /// @brief Returns how many times the signal changed, to cheaply tell updates of heavy values apart.
+    /// @return the number of changes since the construction of the signal.
+    std::uint64_t get_version() const;
+
+    /// @brief Starts recording the past values of the signal.
+    /// @param depth the number of time steps to keep, including the current one, 0 stops recording.
+    void enable_history(std::size_t depth);
+
+    /// @brief Returns the value the signal had k changes ago, changes in the same time step count as one.
+    /// @param k the number of changes to go back, 0 is the current value.
+    /// @return a reference to the value.
+    const T &history(std::size_t k) const;
+
+    /// @brief Returns the value the signal held at the given time.
+    /// @param t the time, it must be within the recorded history.
+    /// @return a reference to the value.
+    const T &value_at(discrete_time_t t) const;
+
+    /// @brief Arms a watchpoint, checked every time the signal changes.
+    /// @details Signals without watchpoints do not pay for them, besides checking a null pointer.
+    /// @param condition the condition on the new value (e.g., when_equals()), an empty condition matches any change.
+    /// @param action the action to execute when the condition holds, an empty action pauses the simulation once the
+    /// current delta cycle is complete.
+    /// @return the identifier of the watchpoint.
+    std::size_t watch(std::function<bool(const T &)> condition = nullptr, std::function<void()> action = nullptr);
+
+    /// @brief Disarms a watchpoint.
+    /// @param id the identifier returned by watch().
+    void unwatch(std::size_t id);
 
     /// @brief Checks if the signal has changed since the last time it was checked.
     /// @return true if the signal has changed, false otherwise.
@@ -55,7 +128,12 @@ public:
 
     void operator()(isignal_t &_signal) override;
 
-    void subscribe(const process_info_t &proc_info) override;
+    void subscribe(const process_info_t &proc_info, sensitivity_mask_t mask) override;
+
+    /// @brief Add the process to the list of processes that should be notified when the signal changes.
+    /// @param proc_info the process information containing the process to be executed when the signal changes.
+    /// @param subscription the sensitivity mask of the process, and the predicate guarding its activation.
+    void subscribe(const process_info_t &proc_info, const subscription_t<T> &subscription);
 
     discrete_time_t get_delay() const override;
 
@@ -65,6 +143,10 @@ public:
 
     const char *get_type_name() const override;
 
+    std::size_t get_width() const override { return coverage_bits_t<T>::width; }
+
+    uint64_t get_bits() const override { return coverage_bits_t<T>::bits(this->get()); }
+
 private:
     /// @brief Sets the value of the signal immediately.
     /// @param new_value the new value to set the signal to.
@@ -78,16 +160,31 @@ private:
     /// @brief Applies the stored value to the signal.
     void apply_stored();
 
-    /// @brief The current value of the signal.
-    T value;
-    /// @brief The last value of the signal, used to detect changes.
-    T last_value;
+    /// @brief The current and the last value of the signal. A change overwrites the last value and swaps the two, so
+    /// that the current value never needs to be copied.
+    std::array<T, 2> values;
+    /// @brief The index of the current value inside values.
+    std::size_t current;
+    /// @brief The number of changes of the signal.
+    std::uint64_t version;
+    /// @brief The past values of the signal, only allocated if the history is enabled.
+    std::unique_ptr<history_t<T>> history_buffer;
+    /// @brief The armed watchpoints, only allocated if there is at least one.
+    std::unique_ptr<watchpoint_list_t<T>> watchpoints;
+    /// @brief The slot of the signal in the toggle coverage, coverage_t::npos if its type is not covered.
+    std::size_t coverage_slot;
+    /// @brief The slot of the signal in the switching activity, coverage_t::npos if its type is not covered.
+    std::size_t activity_slot;
     /// @brief The value to be stored for delayed application.
     T stored_value;
+    /// @brief The number of pending applications of the stored value, the last one moves it into the signal.
+    std::size_t stored_pending;
     /// @brief The default delay for this signal.
     discrete_time_t delay;
-    /// @brief A set of processes that are registered to be notified when the signal changes.
-    std::unordered_set<process_info_t, process_info_hash, process_info_equal> processes;
+    /// @brief The process applying the stored value after a delay.
+    process_info_t delayed_process;
+    /// @brief The processes that are registered to be notified when the signal changes, with their subscription.
+    std::unordered_map<process_info_t, subscription_t<T>, process_info_hash, process_info_equal> processes;
 
     friend class input_t<T>;
     friend class output_t<T>;
@@ -96,19 +193,38 @@ private:
 template <typename T>
 signal_t<T>::signal_t(const std::string &_name, T _initial, discrete_time_t _delay)
     : isignal_t(_name)
-    , value(_initial)
-    , last_value(_initial)
+    , values{_initial, _initial}
+    , current(0)
+    , version(0)
+    , history_buffer()
+    , watchpoints()
+    , coverage_slot(
+          coverage_bits_t<T>::width ? coverage_t::instance().add_signal(_name, coverage_bits_t<T>::width)
+                                    : coverage_t::npos)
+    , activity_slot(
+          coverage_bits_t<T>::width ? activity_t::instance().add_signal(
+                                          _name, coverage_bits_t<T>::width, coverage_bits_t<T>::bits(_initial))
+                                    : coverage_t::npos)
     , stored_value(T{})
+    , stored_pending(0)
     , delay(_delay)
+    , delayed_process(digsim::get_or_create_process(this, &signal_t::apply_stored, "delayed"))
 {
     // Nothing to do here.
 }
 
-template <typename T> inline void signal_t<T>::initialize(T _value)
+template <typename T> inline void signal_t<T>::initialize(const T &_value)
 {
-    value        = _value;
-    last_value   = _value;
+    values[0]    = _value;
+    values[1]    = _value;
     stored_value = T{};
+    if constexpr (coverage_bits_t<T>::width > 0) {
+        digsim::activity.reset_value(activity_slot, coverage_bits_t<T>::bits(_value));
+    }
+    // Restart the history from the new value.
+    if (history_buffer) {
+        this->enable_history(history_buffer->depth());
+    }
 }
 
 template <typename T> inline void signal_t<T>::set_delay(discrete_time_t _delay) { delay = _delay; }
@@ -116,23 +232,67 @@ template <typename T> inline void signal_t<T>::set_delay(discrete_time_t _delay)
 template <typename T> inline void signal_t<T>::set(T new_value)
 {
     if (delay > 0) {
-        this->set_delayed(new_value, delay);
+        this->set_delayed(std::move(new_value), delay);
     } else {
-        this->set_now(new_value);
+        this->set_now(std::move(new_value));
     }
 }
 
-template <typename T> inline T signal_t<T>::get() const { return value; }
+template <typename T> inline const T &signal_t<T>::get() const { return values[current]; }
 
-template <typename T> inline bool signal_t<T>::has_changed() const
+template <typename T> inline const T &signal_t<T>::get_last() const { return values[current ^ 1]; }
+
+template <typename T> inline std::uint64_t signal_t<T>::get_version() const { return version; }
+
+template <typename T> inline void signal_t<T>::enable_history(std::size_t depth)
 {
-    if constexpr (std::is_floating_point_v<T>) {
-        T diff = std::abs(value - last_value);
-        T scale = std::max(std::abs(value), std::abs(last_value));
-        return diff > std::numeric_limits<T>::epsilon() * (scale > 0 ? scale : 1);
+    if (depth == 0) {
+        history_buffer.reset();
     } else {
-        return value != last_value;
+        history_buffer = std::make_unique<history_t<T>>(depth, digsim::scheduler.time(), this->get());
+    }
+}
+
+template <typename T> inline const T &signal_t<T>::history(std::size_t k) const
+{
+    if (!history_buffer) {
+        throw std::runtime_error("The history of signal `" + get_name() + "` is not enabled.");
+    }
+    return history_buffer->value(k);
+}
+
+template <typename T> inline const T &signal_t<T>::value_at(discrete_time_t t) const
+{
+    if (!history_buffer) {
+        throw std::runtime_error("The history of signal `" + get_name() + "` is not enabled.");
+    }
+    const T *past = history_buffer->find(t);
+    if (!past) {
+        throw std::runtime_error(
+            "The value of signal `" + get_name() + "` at time " + std::to_string(t) + " is older than its history.");
+    }
+    return *past;
+}
+
+template <typename T>
+inline std::size_t signal_t<T>::watch(std::function<bool(const T &)> condition, std::function<void()> action)
+{
+    if (!watchpoints) {
+        watchpoints = std::make_unique<watchpoint_list_t<T>>();
     }
+    return watchpoints->add(std::move(condition), std::move(action));
+}
+
+template <typename T> inline void signal_t<T>::unwatch(std::size_t id)
+{
+    if (!watchpoints || !watchpoints->remove(id)) {
+        throw std::runtime_error("Signal `" + get_name() + "` has no watchpoint " + std::to_string(id) + ".");
+    }
+}
+
+template <typename T> inline bool signal_t<T>::has_changed() const
+{
+    return change_policy_t<T>::changed(this->get_last(), this->get());
 }
 
 template <typename T> inline void signal_t<T>::operator()(isignal_t &_signal)
@@ -143,7 +303,13 @@ template <typename T> inline void signal_t<T>::operator()(isignal_t &_signal)
         "Use input_t or output_t to bind signals.");
 }
 
-template <typename T> inline void signal_t<T>::subscribe(const process_info_t &proc_info)
+template <typename T> inline void signal_t<T>::subscribe(const process_info_t &proc_info, sensitivity_mask_t mask)
+{
+    this->subscribe(proc_info, subscription_t<T>{mask, value_predicate_t<T>{}});
+}
+
+template <typename T>
+inline void signal_t<T>::subscribe(const process_info_t &proc_info, const subscription_t<T> &subscription)
 {
     if (!proc_info.process) {
         throw std::runtime_error("Cannot subscribe an invalid process to signal `" + get_name() + "`.");
@@ -153,10 +319,11 @@ template <typename T> inline void signal_t<T>::subscribe(const process_info_t &p
     }
     if (processes.find(proc_info) != processes.end()) {
         digsim::trace("input_t", "Process already subscribed for signal `{}`", get_name());
+        processes[proc_info].merge(subscription);
         return;
     }
     digsim::trace("signal_t", "Subscribing process `{}` for signal `{}`", proc_info.to_string(), get_name());
-    processes.insert(proc_info);
+    processes.emplace(proc_info, subscription);
 }
 
 template <typename T> inline discrete_time_t signal_t<T>::get_delay() const { return delay; }
@@ -169,40 +336,87 @@ template <typename T> inline const char *signal_t<T>::get_type_name() const { re
 
 template <typename T> inline void signal_t<T>::set_now(T new_value)
 {
-    bool has_changed = false;
-    if constexpr (std::is_floating_point_v<T>) {
-        // For floating point types, use epsilon-based comparison to avoid precision issues
-        T diff = std::abs(new_value - value);
-        T scale = std::max(std::abs(value), std::abs(new_value));
-        has_changed = diff > std::numeric_limits<T>::epsilon() * (scale > 0 ? scale : 1);
-    } else {
-        has_changed = (new_value != value);
-    }
-
-    if (has_changed) {
-        // Update the last value to the current value before changing it.
-        last_value = value;
-        // Update the value to the new value.
-        value      = new_value;
-        digsim::trace("signal_t", "{}: {} -> {} (now)", get_name(), last_value, value);
-        for (auto &proc_info : processes) {
-            // Schedule the process to be executed immediately.
-            digsim::scheduler.schedule_now(proc_info);
+    // Record the writer now, deferred updates are applied outside of any process.
+    if (digsim::scheduler.is_recording_writes()) {
+        digsim::scheduler.record_write(this);
+    }
+    // Signals crossing partitions are updated once all partitions completed the delta cycle.
+    if (this->is_crossing() && digsim::scheduler.in_parallel_phase()) {
+        digsim::scheduler.defer_update([this, v = std::move(new_value)]() mutable { this->set_now(std::move(v)); });
+        return;
+    }
+    if (change_policy_t<T>::changed(this->get(), new_value)) {
+        // Keep the value about to be overwritten, an optimistic simulation might have to go back to it.
+        if (digsim::state_log.is_enabled()) {
+            digsim::state_log.record([this, last = values[current ^ 1]]() {
+                current ^= 1;
+                values[current ^ 1] = last;
+                --version;
+            });
+        }
+        // Overwrite the last value, and make it the current one. The old current value becomes the last one.
+        values[current ^ 1] = std::move(new_value);
+        current ^= 1;
+        ++version;
+        if (history_buffer) {
+            history_buffer->push(digsim::scheduler.time(), this->get());
+        }
+        if (watchpoints) {
+            watchpoints->check(this->get(), [] { digsim::scheduler.request_stop(); });
+        }
+        if constexpr (coverage_bits_t<T>::width > 0) {
+            if (digsim::coverage.is_enabled()) {
+                digsim::coverage.toggle(
+                    coverage_slot, coverage_bits_t<T>::bits(this->get_last()), coverage_bits_t<T>::bits(this->get()));
+            }
+            if (digsim::activity.is_enabled()) {
+                digsim::activity.toggle(
+                    activity_slot, coverage_bits_t<T>::bits(this->get_last()), coverage_bits_t<T>::bits(this->get()));
+            } else {
+                digsim::activity.sample(activity_slot, coverage_bits_t<T>::bits(this->get()));
+            }
+        }
+        digsim::trace("signal_t", "{}: {} -> {} (now)", get_name(), this->get_last(), this->get());
+        for (const auto &[proc_info, subscription] : processes) {
+            // Skip the processes waiting for a different value.
+            if (!subscription.predicate(this->get())) {
+                continue;
+            }
+            // Schedule the process to be executed immediately, telling it which of its inputs changed.
+            digsim::scheduler.schedule_now(proc_info, subscription.mask);
         }
     }
 }
 
 template <typename T> inline void signal_t<T>::set_delayed(T new_value, discrete_time_t _delay)
 {
-    digsim::trace("signal_t", "{}: {} -> {} (delayed by {})", get_name(), value, new_value, _delay);
-    // Store the new value to be applied after the delay.
-    stored_value = new_value;
-    // Create a process that will apply the stored value after the delay.
-    auto process = digsim::get_or_create_process(this, &signal_t::apply_stored, "delayed");
-    // Schedule the process to be executed after the specified delay.
-    digsim::scheduler.schedule_after(process, _delay);
+    digsim::trace("signal_t", "{}: {} -> {} (delayed by {})", get_name(), this->get(), new_value, _delay);
+    // Store the new value to be applied after the delay, the pending update might be restored by a rollback.
+    if (digsim::state_log.is_enabled()) {
+        digsim::state_log.record([this, stored = stored_value, pending = stored_pending]() {
+            stored_value   = stored;
+            stored_pending = pending;
+        });
+    }
+    stored_value = std::move(new_value);
+    ++stored_pending;
+    // Schedule the process applying the stored value after the specified delay.
+    digsim::scheduler.schedule_after(delayed_process, _delay);
 }
 
-template <typename T> inline void signal_t<T>::apply_stored() { this->set_now(stored_value); }
+template <typename T> inline void signal_t<T>::apply_stored()
+{
+    // An application undone by a rollback is executed again, thus, the stored value is kept while the log records.
+    if (digsim::state_log.is_enabled()) {
+        digsim::state_log.record([this, pending = stored_pending]() { stored_pending = pending; });
+    }
+    stored_pending -= (stored_pending > 0) ? 1 : 0;
+    if ((stored_pending == 0) && !digsim::state_log.is_enabled()) {
+        // Nothing else applies the stored value, move it.
+        this->set_now(std::move(stored_value));
+    } else {
+        this->set_now(stored_value);
+    }
+}
 
 } // namespace digsim
@@ -0,0 +1,96 @@
+/// @file state_log.hpp
+/// @brief Incremental saving of the simulation state, so that an optimistic simulation can go back in time.
+/// @copyright
+/// This file is distributed under the terms of the MIT License.
+/// See the full license in the root directory at LICENSE.md.
+
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <utility>
+
+namespace digsim
+{
+
+/// @brief Records how to undo each change of the simulation state, while it is enabled.
+/// @details Signals record their old value when they change, and models record a copy of their own state the first
+/// time they modify it after each mark, by calling save() before writing, e.g., `digsim::state_log.save(memory[i])`.
+/// Nothing is recorded while the log is disabled, so that the models pay a single branch for it.
+///
+/// Positions in the log only grow: mark() returns the current one, rollback() undoes the changes recorded after a
+/// position, newest first, and forget() drops the changes which will never be undone.
+class state_log_t
+{
+public:
+    /// @brief Get the singleton instance of the state log.
+    /// @return A reference to the singleton instance of the state log.
+    static state_log_t &instance();
+
+    /// @brief Enables or disables the recording, either way the log is cleared.
+    /// @param _enabled true to record the changes.
+    void enable(bool _enabled = true);
+
+    /// @brief Checks if the changes are being recorded.
+    /// @return true if the log is enabled, false otherwise.
+    bool is_enabled() const { return enabled; }
+
+    /// @brief Records how to undo a change, it can be called from several threads.
+    /// @param undo the function restoring the state before the change.
+    void record(std::function<void()> undo);
+
+    /// @brief Saves a copy of an object before a model modifies it, once per object between two marks.
+    /// @param object the object, which must be copy-assignable.
+    template <typename T> void save(T &object);
+
+    /// @brief Marks the current position, e.g., before a time step, and starts saving the objects again.
+    /// @return the position.
+    std::size_t mark();
+
+    /// @brief Undoes the changes recorded after a position, newest first.
+    /// @param position a position returned by mark(), not yet forgotten.
+    void rollback(std::size_t position);
+
+    /// @brief Drops the changes recorded before a position, which can no longer be undone.
+    /// @param position a position returned by mark().
+    void forget(std::size_t position);
+
+    /// @brief Returns the number of changes which can still be undone.
+    /// @return the number of changes.
+    std::size_t size() const { return entries.size(); }
+
+private:
+    /// @brief Private constructor, for the singleton.
+    state_log_t();
+
+    /// @brief Whether the changes are being recorded.
+    bool enabled;
+    /// @brief The position of the first entry, i.e., the number of changes forgotten so far.
+    std::size_t base;
+    /// @brief The functions undoing the changes, oldest first.
+    std::deque<std::function<void()>> entries;
+    /// @brief The objects saved since the last mark, with their size, since an object and its first member share
+    /// their address.
+    std::set<std::pair<const void *, std::size_t>> saved;
+    /// @brief Protects the log, the signals of different partitions change from different threads.
+    std::mutex mutex;
+};
+
+/// @brief A reference to the singleton instance of the state log, for convenience.
+inline state_log_t &state_log = state_log_t::instance();
+
+template <typename T> void state_log_t::save(T &object)
+{
+    if (!enabled) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    if (saved.emplace(&object, sizeof(T)).second) {
+        entries.emplace_back([&object, copy = object]() { object = copy; });
+    }
+}
+
+} // namespace digsim
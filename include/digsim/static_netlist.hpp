@@ -0,0 +1,233 @@
+/// @file static_netlist.hpp
+/// @brief Netlists described as types, which the compiler turns into straight-line code.
+/// @copyright
+/// This file is distributed under the terms of the MIT License.
+/// See the full license in the root directory at LICENSE.md.
+
+#pragma once
+
+#include "digsim/coverage.hpp"
+#include "digsim/input.hpp"
+#include "digsim/output.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace digsim
+{
+
+/// @brief The number of inputs and wires read by an expression, as one past the highest index read.
+/// @details Expressions are types with a static constexpr eval(in, w), which returns their value from the inputs and
+/// the wires of the netlist, and with the members of operands_t, which check the netlist at compile time.
+/// @tparam Operands the operands of the expression.
+template <typename... Operands> struct operands_t {
+    /// @brief One past the highest input read.
+    static constexpr std::size_t inputs = std::max({std::size_t{0}, Operands::inputs...});
+    /// @brief One past the highest wire read.
+    static constexpr std::size_t wires = std::max({std::size_t{0}, Operands::wires...});
+};
+
+/// @brief Reads an input of the netlist.
+/// @tparam I the index of the input.
+template <std::size_t I> struct input_ref_t {
+    static constexpr std::size_t inputs = I + 1;
+    static constexpr std::size_t wires  = 0;
+
+    template <typename In, typename Wires> static constexpr uint64_t eval(const In &in, const Wires &) { return in[I]; }
+};
+
+/// @brief Reads a wire of the netlist, which must be assigned before the wire reading it.
+/// @tparam K the index of the wire.
+template <std::size_t K> struct wire_ref_t {
+    static constexpr std::size_t inputs = 0;
+    static constexpr std::size_t wires  = K + 1;
+
+    template <typename In, typename Wires> static constexpr uint64_t eval(const In &, const Wires &w) { return w[K]; }
+};
+
+/// @brief A constant.
+/// @tparam V the value.
+template <uint64_t V> struct constant_t : operands_t<> {
+    template <typename In, typename Wires> static constexpr uint64_t eval(const In &, const Wires &) { return V; }
+};
+
+/// @brief Selects a bit of a word.
+/// @tparam E the word.
+/// @tparam B the index of the bit.
+template <typename E, std::size_t B> struct bit_t : operands_t<E> {
+    static_assert(B < 64, "Words have 64 bits at most.");
+
+    template <typename In, typename Wires> static constexpr uint64_t eval(const In &in, const Wires &w)
+    {
+        return (E::eval(in, w) >> B) & 1U;
+    }
+};
+
+/// @brief Packs single bits into a word, the first one being the least significant.
+/// @tparam Bits the bits, only their least significant bit is used.
+template <typename... Bits> struct pack_t : operands_t<Bits...> {
+    static_assert(sizeof...(Bits) <= 64, "Words have 64 bits at most.");
+
+    template <typename In, typename Wires> static constexpr uint64_t eval(const In &in, const Wires &w)
+    {
+        uint64_t result = 0;
+        std::size_t bit = 0;
+        ((result |= (Bits::eval(in, w) & 1U) << bit++), ...);
+        return result;
+    }
+};
+
+/// @brief Bitwise negation.
+template <typename E> struct not_t : operands_t<E> {
+    template <typename In, typename Wires> static constexpr uint64_t eval(const In &in, const Wires &w)
+    {
+        return ~E::eval(in, w);
+    }
+};
+
+/// @brief Bitwise AND of the operands.
+template <typename... E> struct and_t : operands_t<E...> {
+    template <typename In, typename Wires> static constexpr uint64_t eval(const In &in, const Wires &w)
+    {
+        return (E::eval(in, w) & ...);
+    }
+};
+
+/// @brief Bitwise OR of the operands.
+template <typename... E> struct or_t : operands_t<E...> {
+    template <typename In, typename Wires> static constexpr uint64_t eval(const In &in, const Wires &w)
+    {
+        return (E::eval(in, w) | ...);
+    }
+};
+
+/// @brief Bitwise XOR of the operands.
+template <typename... E> struct xor_t : operands_t<E...> {
+    template <typename In, typename Wires> static constexpr uint64_t eval(const In &in, const Wires &w)
+    {
+        return (E::eval(in, w) ^ ...);
+    }
+};
+
+/// @brief Negated AND of the operands.
+template <typename... E> using nand_t = not_t<and_t<E...>>;
+
+/// @brief Negated OR of the operands.
+template <typename... E> using nor_t = not_t<or_t<E...>>;
+
+/// @brief Negated XOR of the operands.
+template <typename... E> using xnor_t = not_t<xor_t<E...>>;
+
+/// @brief Bitwise majority of three operands.
+template <typename A, typename B, typename C> struct maj_t : operands_t<A, B, C> {
+    template <typename In, typename Wires> static constexpr uint64_t eval(const In &in, const Wires &w)
+    {
+        const uint64_t a = A::eval(in, w), b = B::eval(in, w), c = C::eval(in, w);
+        return (a & b) | (a & c) | (b & c);
+    }
+};
+
+/// @brief Returns b if the selector is not zero, a otherwise, like gate_op_t::mux.
+template <typename S, typename A, typename B> struct mux_t : operands_t<S, A, B> {
+    template <typename In, typename Wires> static constexpr uint64_t eval(const In &in, const Wires &w)
+    {
+        return S::eval(in, w) ? B::eval(in, w) : A::eval(in, w);
+    }
+};
+
+/// @brief The sum of a full adder, like FullAdder.
+template <typename A, typename B, typename C> using full_adder_sum_t = xor_t<A, B, C>;
+
+/// @brief The carry of a full adder, like FullAdder.
+template <typename A, typename B, typename C> using full_adder_carry_t = maj_t<A, B, C>;
+
+/// @brief Assigns an expression to a wire.
+/// @tparam K the index of the wire.
+/// @tparam E the expression.
+template <std::size_t K, typename E> struct assign_t {
+    static_assert(E::wires <= K, "A wire can only read the wires assigned before it.");
+
+    static constexpr std::size_t inputs = E::inputs;
+    static constexpr std::size_t wire   = K;
+
+    template <typename In, typename Wires> static constexpr void apply(const In &in, Wires &w)
+    {
+        w[K] = E::eval(in, w);
+    }
+};
+
+/// @brief A netlist described as a type: a list of assignments, executed in order, each one computing a wire from the
+/// inputs and the wires assigned before it.
+/// @details The i-th assignment must write the i-th wire, so that each wire is assigned exactly once, and a wire only
+/// reads the ones assigned before it (see assign_t). Everything is known at compile time, thus, evaluate() has no
+/// loops, no branches, and no lookups: the compiler inlines the expressions, and shares the common parts. It is also
+/// constexpr, so that the netlist can be checked with static_assert.
+/// @tparam Inputs the number of inputs.
+/// @tparam Wires the number of wires.
+/// @tparam Assignments the assignments, see assign_t.
+template <std::size_t Inputs, std::size_t Wires, typename... Assignments> struct static_netlist_t {
+    static_assert(((Assignments::inputs <= Inputs) && ...), "An assignment reads an input that does not exist.");
+    static_assert(((Assignments::wire < Wires) && ...), "An assignment writes a wire that does not exist.");
+    static_assert(sizeof...(Assignments) == Wires, "Each wire must be assigned exactly once.");
+    static_assert(
+        []<std::size_t... P>(std::index_sequence<P...>) {
+            return ((Assignments::wire == P) && ...);
+        }(std::index_sequence_for<Assignments...>{}),
+        "The assignments must write the wires in order, starting from the first one.");
+
+    static constexpr std::size_t num_inputs = Inputs;
+    static constexpr std::size_t num_wires  = Wires;
+
+    /// @brief Computes the wires.
+    /// @param in the values of the inputs.
+    /// @return the values of the wires.
+    static constexpr std::array<uint64_t, Wires> evaluate(const std::array<uint64_t, Inputs> &in)
+    {
+        std::array<uint64_t, Wires> w{};
+        (Assignments::apply(in, w), ...);
+        return w;
+    }
+};
+
+/// @brief Converts a word back to the value of a port, see coverage_bits_t for the other direction.
+/// @tparam T the type of the value.
+/// @param bits the word.
+/// @return the value.
+template <typename T> constexpr T from_bits(uint64_t bits)
+{
+    if constexpr (std::is_same_v<T, bool>) {
+        return (bits & 1U) != 0;
+    } else if constexpr (std::is_enum_v<T>) {
+        return static_cast<T>(bits);
+    } else if constexpr (std::is_integral_v<T>) {
+        return static_cast<T>(bits);
+    } else {
+        return T(bits);
+    }
+}
+
+/// @brief Evaluates a static netlist from the input ports of a module, and drives its output ports, see
+/// StaticAdder for an example.
+/// @details The inputs of the netlist are the input ports, in order, and the outputs are its last wires.
+/// @tparam Netlist the static netlist.
+/// @param inputs the input ports, e.g., std::tie(a, b).
+/// @param outputs the output ports, e.g., std::tie(sum).
+template <typename Netlist, typename... In, typename... Out>
+void evaluate_static(std::tuple<input_t<In> &...> inputs, std::tuple<output_t<Out> &...> outputs)
+{
+    static_assert(sizeof...(In) == Netlist::num_inputs, "The netlist reads one input per input port.");
+    static_assert(sizeof...(Out) <= Netlist::num_wires, "The netlist drives the output ports with its last wires.");
+    const auto wires = [&inputs]<std::size_t... I>(std::index_sequence<I...>) {
+        return Netlist::evaluate({coverage_bits_t<In>::bits(std::get<I>(inputs).get())...});
+    }(std::index_sequence_for<In...>{});
+    [&outputs, &wires]<std::size_t... J>(std::index_sequence<J...>) {
+        (std::get<J>(outputs).set(from_bits<Out>(wires[Netlist::num_wires - sizeof...(Out) + J])), ...);
+    }(std::index_sequence_for<Out...>{});
+}
+
+} // namespace digsim
@@ -0,0 +1,111 @@
+/// @file watchpoint.hpp
+/// @brief Watchpoints on the values of signals.
+/// @copyright
+/// This file is distributed under the terms of the MIT License.
+/// See the full license in the root directory at LICENSE.md.
+
+#pragma once
+
+#include "digsim/common.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+namespace digsim
+{
+
+/// @brief A condition on the value of a signal, checked every time the signal changes.
+/// @tparam T the type of the signal value.
+template <typename T> struct watchpoint_t {
+    /// @brief The identifier of the watchpoint, unique within its signal.
+    std::size_t id;
+    /// @brief The condition on the new value, an empty condition matches any change.
+    std::function<bool(const T &)> condition;
+    /// @brief The action to execute when the condition holds, an empty action pauses the simulation.
+    std::function<void()> action;
+    /// @brief Whether the watchpoint is armed, disarmed ones are only erased once no check is running.
+    bool armed;
+};
+
+/// @brief The watchpoints armed on a signal.
+/// @tparam T the type of the signal value.
+template <typename T> class watchpoint_list_t
+{
+public:
+    /// @brief Arms a new watchpoint.
+    /// @param condition the condition on the new value, an empty condition matches any change.
+    /// @param action the action to execute when the condition holds, an empty action pauses the simulation.
+    /// @return the identifier of the watchpoint.
+    std::size_t add(std::function<bool(const T &)> condition, std::function<void()> action)
+    {
+        watchpoints.push_back(watchpoint_t<T>{next_id, std::move(condition), std::move(action), true});
+        return next_id++;
+    }
+
+    /// @brief Disarms a watchpoint.
+    /// @param id the identifier of the watchpoint.
+    /// @return true if the watchpoint was found, false otherwise.
+    bool remove(std::size_t id)
+    {
+        for (auto it = watchpoints.begin(); it != watchpoints.end(); ++it) {
+            if ((it->id == id) && it->armed) {
+                // An action is disarming a watchpoint, erasing it would shift the ones still to be checked.
+                if (checking > 0) {
+                    it->armed = false;
+                } else {
+                    watchpoints.erase(it);
+                }
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// @brief Checks if there are no watchpoints armed.
+    /// @return true if the list is empty, false otherwise.
+    bool empty() const
+    {
+        return std::none_of(
+            watchpoints.begin(), watchpoints.end(), [](const auto &watchpoint) { return watchpoint.armed; });
+    }
+
+    /// @brief Checks the watchpoints against the new value of the signal.
+    /// @param value the new value.
+    /// @param stop the function to call for the watchpoints without an action.
+    template <typename Stop> void check(const T &value, Stop &&stop)
+    {
+        // Actions might arm or disarm watchpoints, thus, do not rely on iterators. The watchpoints armed by an action
+        // are checked from the next change, the disarmed ones are erased once the outermost check is complete.
+        const std::size_t count = watchpoints.size();
+        ++checking;
+        for (std::size_t index = 0; index < count; ++index) {
+            const auto &watchpoint = watchpoints[index];
+            if (!watchpoint.armed) {
+                continue;
+            }
+            if (!watchpoint.condition || watchpoint.condition(value)) {
+                if (watchpoint.action) {
+                    // The action might disarm its own watchpoint, keep it alive while it runs.
+                    auto action = watchpoint.action;
+                    action();
+                } else {
+                    stop();
+                }
+            }
+        }
+        if (--checking == 0) {
+            std::erase_if(watchpoints, [](const auto &watchpoint) { return !watchpoint.armed; });
+        }
+    }
+
+private:
+    /// @brief The armed watchpoints.
+    std::vector<watchpoint_t<T>> watchpoints;
+    /// @brief The identifier of the next watchpoint.
+    std::size_t next_id = 0;
+    /// @brief The number of checks running, more than one if an action changes the signal again.
+    std::size_t checking = 0;
+};
+
+} // namespace digsim
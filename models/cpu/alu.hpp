@@ -38,7 +38,8 @@ public:
         , remainder("remainder", this)
         , status("status", this)
     {
-        ADD_SENSITIVITY(alu_t, evaluate, clk, reset);
+        ADD_SENSITIVITY_WHEN(alu_t, evaluate, clk, digsim::when_equals(true));
+        ADD_SENSITIVITY(alu_t, evaluate, reset);
         ADD_PRODUCER(alu_t, evaluate, out, remainder, status);
     }
 
@@ -29,12 +29,29 @@ public:
         , rs("rs", this)
         , rt("rt", this)
         , flag("flag", this)
+        , opcode_coverage(digsim::coverage.add_point(_name + ".opcode", opcode_bins()))
     {
-        ADD_SENSITIVITY(decoder_t, evaluate, instruction, phase);
+        ADD_SENSITIVITY(decoder_t, evaluate, instruction);
+        ADD_SENSITIVITY_WHEN(decoder_t, evaluate, phase, digsim::when_equals(bs_phase_t(phase_t::DECODE)));
         ADD_PRODUCER(decoder_t, evaluate, opcode, rs, rt, flag);
     }
 
 private:
+    std::size_t opcode_coverage; ///< The coverage point of the decoded opcodes.
+
+    /// @brief Returns the names of the opcodes, indexed by their encoding, unused and reserved encodings are left empty.
+    static std::vector<std::string> opcode_bins()
+    {
+        std::vector<std::string> bins(1U << OPCODE_WIDTH);
+        for (std::size_t op = 0; op < bins.size(); ++op) {
+            std::string name = opcode_to_string(static_cast<uint8_t>(op));
+            if ((name != "UNKNOWN") && (name.rfind("RESERVED", 0) != 0)) {
+                bins[op] = name;
+            }
+        }
+        return bins;
+    }
+
     void evaluate()
     {
         // [15:09] opcode
@@ -58,6 +75,7 @@ private:
         rs.set(rs_val);
         rt.set(rt_val);
         flag.set(flag_val);
+        digsim::coverage.sample(opcode_coverage, opcode_val);
 
         digsim::debug(
             get_name(),
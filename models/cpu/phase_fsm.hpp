@@ -24,25 +24,32 @@ public:
         , reset("reset", this)
         , phase("phase", this)
         , state(phase_t::FETCH)
+        , state_coverage(digsim::coverage.add_fsm(
+              _name + ".state", {phase_to_string(phase_t::FETCH), phase_to_string(phase_t::DECODE),
+                                 phase_to_string(phase_t::EXECUTE), phase_to_string(phase_t::WRITEBACK)}))
     {
-        ADD_SENSITIVITY(phase_fsm_t, evaluate, clk, reset);
+        ADD_SENSITIVITY_WHEN(phase_fsm_t, evaluate, clk, digsim::when_equals(true));
+        ADD_SENSITIVITY(phase_fsm_t, evaluate, reset);
         ADD_PRODUCER(phase_fsm_t, evaluate, phase);
     }
 
 private:
     phase_t state;
+    std::size_t state_coverage; ///< The coverage point of the states.
 
     void evaluate()
     {
         if (!clk.posedge()) {
             return;
         }
+        digsim::state_log.save(state);
         if (reset.get()) {
             state = phase_t::FETCH;
         } else {
             state = static_cast<phase_t>((state + 1) % NUM_PHASES);
         }
         phase.set(state);
+        digsim::coverage.sample(state_coverage, state);
         digsim::debug(get_name(), "Phase changed to [{:2}] {:10}", static_cast<uint8_t>(state), phase_to_string(state));
     }
 };
\ No newline at end of file
@@ -41,7 +41,8 @@ public:
         , addr("addr", this)
         , pc(0)
     {
-        ADD_SENSITIVITY(program_counter_t, evaluate, clk, reset);
+        ADD_SENSITIVITY_WHEN(program_counter_t, evaluate, clk, digsim::when_equals(true));
+        ADD_SENSITIVITY(program_counter_t, evaluate, reset);
         ADD_PRODUCER(program_counter_t, evaluate, addr);
     }
 
@@ -53,6 +54,7 @@ private:
         if (!clk.posedge()) {
             return;
         }
+        digsim::state_log.save(pc);
 
         if (reset.get()) {
             pc = 0;
@@ -9,8 +9,10 @@
 #include "cpu_defines.hpp"
 
 #include <bitset>
+#include <functional>
 #include <iomanip>
 #include <sstream>
+#include <unordered_map>
 
 class ram_t : public digsim::module_t
 {
@@ -35,7 +37,8 @@ public:
     {
         memory.fill(0);
 
-        ADD_SENSITIVITY(ram_t, evaluate, clk, reset, addr, data_in, write_enable, phase);
+        ADD_SENSITIVITY_WHEN(ram_t, evaluate, clk, digsim::when_equals(true));
+        ADD_SENSITIVITY(ram_t, evaluate, reset, addr, data_in, write_enable, phase);
         ADD_PRODUCER(ram_t, evaluate, data_out);
     }
 
@@ -64,8 +67,25 @@ public:
         digsim::debug(get_name(), "debug_write: memory[{}] = 0x{:04X}", index, value);
     }
 
+    /// @brief Arms a watchpoint on a memory word, triggered when a write changes its value.
+    /// @param index The index of the word.
+    /// @param action The action to execute, by default the simulation is paused.
+    void watch(std::size_t index, std::function<void()> action = nullptr)
+    {
+        if (index >= memory.size()) {
+            digsim::error(get_name(), "watch: out-of-bounds access to memory {}", index);
+            return;
+        }
+        watched[index] = std::move(action);
+    }
+
+    /// @brief Disarms the watchpoint on a memory word.
+    /// @param index The index of the word.
+    void unwatch(std::size_t index) { watched.erase(index); }
+
 private:
     std::array<bs_data_t, RAM_SIZE> memory;
+    std::unordered_map<std::size_t, std::function<void()>> watched; ///< Watched words, with their action.
 
     void evaluate()
     {
@@ -75,6 +95,7 @@ private:
 
         if (reset.get()) {
             digsim::debug(get_name(), "Resetting RAM...");
+            digsim::state_log.save(memory);
             memory.fill(0);
             data_out.set(0);
             return;
@@ -95,7 +116,12 @@ private:
         // Perform the read or write operation.
         if (write) {
             if (index < RAM_SIZE) {
+                const bool changed = (memory[index] != wdata);
+                digsim::state_log.save(memory[index]);
                 memory[index] = wdata;
+                if (changed && !watched.empty()) {
+                    this->check_watch(index);
+                }
             }
         }
         if (index < RAM_SIZE) {
@@ -106,4 +132,21 @@ private:
 
         digsim::debug(get_name(), "[{:5}] address: 0x{:04X}, data_in : 0x{:04X}, data_out : 0x{:04X}", (write ? "WR/RD" : "READ"), index, wdata.to_ulong(), rdata.to_ulong());
     }
+
+    /// @brief Triggers the watchpoint of a memory word, if any.
+    /// @param index The index of the word which changed.
+    void check_watch(std::size_t index)
+    {
+        auto it = watched.find(index);
+        if (it == watched.end()) {
+            return;
+        }
+        digsim::debug(get_name(), "Watchpoint hit: memory[{}] = 0x{:04X}", index, memory[index].to_ulong());
+        if (it->second) {
+            auto action = it->second;
+            action();
+        } else {
+            digsim::scheduler.request_stop();
+        }
+    }
 };
\ No newline at end of file
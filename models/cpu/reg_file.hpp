@@ -40,7 +40,8 @@ public:
         , data_a("data_a", this)
         , data_b("data_b", this)
     {
-        ADD_SENSITIVITY(reg_file_t, evaluate, clk, reset);
+        ADD_SENSITIVITY_WHEN(reg_file_t, evaluate, clk, digsim::when_equals(true));
+        ADD_SENSITIVITY(reg_file_t, evaluate, reset);
         ADD_PRODUCER(reg_file_t, evaluate, data_a, data_b);
     }
 
@@ -80,6 +81,7 @@ private:
         // Handle reset
         if (reset.get()) {
             digsim::debug(get_name(), "Resetting registers...");
+            digsim::state_log.save(regs);
             for (auto &reg : regs) {
                 reg.reset();
             }
@@ -113,6 +115,7 @@ private:
 
         // Only perform write during WRITEBACK phase
         if (current_phase == phase_t::WRITEBACK && write_enable.get()) {
+            digsim::state_log.save(regs[u_addr_w]);
             regs[u_addr_w] = data_in.get();
         }
 
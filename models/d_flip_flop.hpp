@@ -9,7 +9,7 @@
 #include <iomanip>
 #include <sstream>
 
-class DFlipFlop : public digsim::module_t
+class DFlipFlop : public digsim::module_t, public digsim::structural_t
 {
 public:
     digsim::input_t<bool> clk;
@@ -33,6 +33,13 @@ public:
         ADD_PRODUCER(DFlipFlop, evaluate, q, q_not);
     }
 
+    void describe(digsim::netlist_t &netlist) const override
+    {
+        netlist.add_gate(digsim::gate_op_t::dff, {&clk, &d, &enable, &reset}, q);
+        // The inverted output holds the same state, i.e., q.
+        netlist.add_gate(digsim::gate_op_t::dffn, {&clk, &d, &enable, &reset, &q}, q_not);
+    }
+
 private:
     void evaluate()
     {
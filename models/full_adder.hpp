@@ -9,7 +9,7 @@
 #include <iomanip>
 #include <sstream>
 
-class FullAdder : public digsim::module_t
+class FullAdder : public digsim::module_t, public digsim::structural_t
 {
 public:
     digsim::input_t<bool> a;
@@ -30,6 +30,12 @@ public:
         ADD_PRODUCER(FullAdder, evaluate, sum, cout);
     }
 
+    void describe(digsim::netlist_t &netlist) const override
+    {
+        netlist.add_gate(digsim::gate_op_t::xor_, {&a, &b, &cin}, sum);
+        netlist.add_gate(digsim::gate_op_t::maj, {&a, &b, &cin}, cout);
+    }
+
 private:
     void evaluate()
     {
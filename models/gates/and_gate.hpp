@@ -9,7 +9,7 @@
 #include <iomanip>
 #include <sstream>
 
-class AndGate : public digsim::module_t
+class AndGate : public digsim::module_t, public digsim::structural_t
 {
 public:
     digsim::input_t<bool> a;
@@ -26,6 +26,11 @@ public:
         ADD_PRODUCER(AndGate, evaluate, out);
     }
 
+    void describe(digsim::netlist_t &netlist) const override
+    {
+        netlist.add_gate(digsim::gate_op_t::and_, {&a, &b}, out);
+    }
+
 private:
     void evaluate()
     {
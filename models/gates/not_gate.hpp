@@ -9,7 +9,7 @@
 #include <iomanip>
 #include <sstream>
 
-class NotGate : public digsim::module_t
+class NotGate : public digsim::module_t, public digsim::structural_t
 {
 public:
     digsim::input_t<bool> in;
@@ -24,6 +24,11 @@ public:
         ADD_PRODUCER(NotGate, evaluate, out);
     }
 
+    void describe(digsim::netlist_t &netlist) const override
+    {
+        netlist.add_gate(digsim::gate_op_t::not_, {&in}, out);
+    }
+
     void evaluate()
     {
         bool result = !in.get();
@@ -9,7 +9,7 @@
 #include <iomanip>
 #include <sstream>
 
-class XorGate : public digsim::module_t
+class XorGate : public digsim::module_t, public digsim::structural_t
 {
 public:
     digsim::input_t<bool> a;
@@ -26,6 +26,11 @@ public:
         ADD_PRODUCER(XorGate, evaluate, out);
     }
 
+    void describe(digsim::netlist_t &netlist) const override
+    {
+        netlist.add_gate(digsim::gate_op_t::xor_, {&a, &b}, out);
+    }
+
 private:
     void evaluate()
     {
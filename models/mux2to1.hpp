@@ -9,7 +9,7 @@
 #include <iomanip>
 #include <sstream>
 
-template <typename T> class Mux2to1 : public digsim::module_t
+template <typename T> class Mux2to1 : public digsim::module_t, public digsim::structural_t
 {
 public:
     digsim::input_t<T> a;
@@ -28,6 +28,11 @@ public:
         ADD_PRODUCER(Mux2to1, evaluate, out);
     }
 
+    void describe(digsim::netlist_t &netlist) const override
+    {
+        netlist.add_gate(digsim::gate_op_t::mux, {&sel, &a, &b}, out);
+    }
+
 private:
     void evaluate()
     {
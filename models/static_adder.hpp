@@ -0,0 +1,68 @@
+/// @file static_adder.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief An N-bit ripple-carry adder, made of full adders described as a static netlist.
+
+#pragma once
+
+#include <digsim/digsim.hpp>
+
+/// @brief The netlist of an N-bit ripple-carry adder.
+/// @details Inputs are (a, b, cin), wire i is the carry out of bit i, then come the sum and the carry out.
+/// @tparam N the number of bits.
+template <std::size_t N> struct ripple_adder_netlist_t {
+    static_assert((N > 0) && (N <= 64), "The adder has from 1 to 64 bits.");
+
+    template <std::size_t I> using a_t = digsim::bit_t<digsim::input_ref_t<0>, I>;
+    template <std::size_t I> using b_t = digsim::bit_t<digsim::input_ref_t<1>, I>;
+
+    /// @brief The carry into bit I, the carry in for the first bit, the carry out of the previous one otherwise.
+    template <std::size_t I> struct carry_in {
+        using type = digsim::wire_ref_t<I - 1>;
+    };
+    template <std::size_t I>
+        requires(I == 0)
+    struct carry_in<I> {
+        using type = digsim::bit_t<digsim::input_ref_t<2>, 0>;
+    };
+    template <std::size_t I> using carry_in_t = typename carry_in<I>::type;
+
+    template <std::size_t... I>
+    static auto make(std::index_sequence<I...>) -> digsim::static_netlist_t<
+        3,
+        N + 2,
+        digsim::assign_t<I, digsim::full_adder_carry_t<a_t<I>, b_t<I>, carry_in_t<I>>>...,
+        digsim::assign_t<N, digsim::pack_t<digsim::full_adder_sum_t<a_t<I>, b_t<I>, carry_in_t<I>>...>>,
+        digsim::assign_t<N + 1, digsim::wire_ref_t<N - 1>>>;
+
+    using type = decltype(make(std::make_index_sequence<N>{}));
+};
+
+/// @brief An N-bit adder, which evaluates its full adders as straight-line code.
+/// @tparam N the number of bits.
+template <std::size_t N> class StaticAdder : public digsim::module_t
+{
+public:
+    digsim::input_t<uint64_t> a;
+    digsim::input_t<uint64_t> b;
+    digsim::input_t<bool> cin;
+    digsim::output_t<uint64_t> sum;
+    digsim::output_t<bool> cout;
+
+    StaticAdder(const std::string &_name, digsim::module_t *_parent = nullptr)
+        : digsim::module_t(_name, _parent)
+        , a("a", this)
+        , b("b", this)
+        , cin("cin", this)
+        , sum("sum", this)
+        , cout("cout", this)
+    {
+        ADD_SENSITIVITY(StaticAdder, evaluate, a, b, cin);
+        ADD_PRODUCER(StaticAdder, evaluate, sum, cout);
+    }
+
+private:
+    void evaluate()
+    {
+        digsim::evaluate_static<typename ripple_adder_netlist_t<N>::type>(std::tie(a, b, cin), std::tie(sum, cout));
+    }
+};
@@ -0,0 +1,38 @@
+/// @file static_mux2to1.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief A 2-to-1 multiplexer, described as a static netlist.
+
+#pragma once
+
+#include <digsim/digsim.hpp>
+
+/// @brief The netlist of a 2-to-1 multiplexer, with inputs (a, b, sel).
+using mux2to1_netlist_t = digsim::static_netlist_t<
+    3,
+    1,
+    digsim::assign_t<0, digsim::mux_t<digsim::input_ref_t<2>, digsim::input_ref_t<0>, digsim::input_ref_t<1>>>>;
+
+/// @brief A 2-to-1 multiplexer, like Mux2to1, without the logging.
+/// @tparam T the type of the data.
+template <typename T> class StaticMux2to1 : public digsim::module_t
+{
+public:
+    digsim::input_t<T> a;
+    digsim::input_t<T> b;
+    digsim::input_t<bool> sel;
+    digsim::output_t<T> out;
+
+    StaticMux2to1(const std::string &_name, digsim::module_t *_parent = nullptr)
+        : digsim::module_t(_name, _parent)
+        , a("a", this)
+        , b("b", this)
+        , sel("sel", this)
+        , out("out", this)
+    {
+        ADD_SENSITIVITY(StaticMux2to1, evaluate, a, b, sel);
+        ADD_PRODUCER(StaticMux2to1, evaluate, out);
+    }
+
+private:
+    void evaluate() { digsim::evaluate_static<mux2to1_netlist_t>(std::tie(a, b, sel), std::tie(out)); }
+};
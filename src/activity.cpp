@@ -0,0 +1,201 @@
+/// @file activity.cpp
+/// @brief Implementation of the switching activity accumulation and of the SAIF export.
+/// @copyright
+/// This file is distributed under the terms of the MIT License.
+/// See the full license in the root directory at LICENSE.md.
+
+#include "digsim/activity.hpp"
+
+#include "digsim/scheduler.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cctype>
+#include <fstream>
+#include <stdexcept>
+
+namespace digsim
+{
+
+namespace
+{
+
+/// @brief Escapes the characters which are not allowed in SAIF identifiers.
+/// @param name the name.
+/// @return the escaped name.
+std::string escape_saif(const std::string &name)
+{
+    std::string escaped;
+    escaped.reserve(name.size());
+    for (char c : name) {
+        if (!std::isalnum(static_cast<unsigned char>(c)) && (c != '_')) {
+            escaped.push_back('\\');
+        }
+        escaped.push_back(c);
+    }
+    return escaped;
+}
+
+} // namespace
+
+activity_t &activity_t::instance()
+{
+    static activity_t instance;
+    return instance;
+}
+
+activity_t::activity_t()
+    : enabled(false)
+    , start(0)
+    , names()
+    , widths()
+    , offsets()
+    , values()
+    , last_change()
+    , toggles()
+    , time_high()
+    , slots()
+{
+    // Nothing to do here.
+}
+
+void activity_t::enable(bool _enabled)
+{
+    if (_enabled && !enabled) {
+        this->clear();
+    }
+    enabled = _enabled;
+}
+
+std::size_t activity_t::add_signal(const std::string &name, std::size_t width, uint64_t bits)
+{
+    if (width > 64) {
+        throw std::runtime_error("Signal `" + name + "` is too wide for the switching activity.");
+    }
+    // Signals sharing a name are told apart by their creation order.
+    std::string key = name;
+    for (std::size_t index = 1; slots.count(key); ++index) {
+        key = name + "#" + std::to_string(index);
+    }
+    names.push_back(key);
+    widths.push_back(width);
+    offsets.push_back(toggles.size());
+    values.push_back(bits);
+    last_change.push_back(start);
+    toggles.resize(toggles.size() + width, 0);
+    time_high.resize(time_high.size() + width, 0);
+    slots.emplace(key, names.size() - 1);
+    return names.size() - 1;
+}
+
+void activity_t::reset_value(std::size_t slot, uint64_t bits)
+{
+    if (enabled) {
+        // Account for the time spent in the previous value.
+        this->toggle(slot, values[slot], values[slot]);
+    }
+    values[slot] = bits;
+}
+
+void activity_t::toggle(std::size_t slot, uint64_t old_bits, uint64_t new_bits)
+{
+    const discrete_time_t now     = scheduler.time();
+    const discrete_time_t elapsed = now - last_change[slot];
+    const std::size_t offset      = offsets[slot];
+    // Only visit the bits which were at 1, and the ones which changed.
+    for (uint64_t high = old_bits; high; high &= high - 1) {
+        time_high[offset + static_cast<std::size_t>(std::countr_zero(high))] += elapsed;
+    }
+    for (uint64_t changed = old_bits ^ new_bits; changed; changed &= changed - 1) {
+        ++toggles[offset + static_cast<std::size_t>(std::countr_zero(changed))];
+    }
+    values[slot]      = new_bits;
+    last_change[slot] = now;
+}
+
+void activity_t::clear()
+{
+    start = scheduler.time();
+    std::fill(last_change.begin(), last_change.end(), start);
+    std::fill(toggles.begin(), toggles.end(), 0);
+    std::fill(time_high.begin(), time_high.end(), 0);
+}
+
+uint64_t activity_t::get_toggles(const std::string &name, std::size_t bit) const
+{
+    return toggles[this->get_bit(name, bit)];
+}
+
+discrete_time_t activity_t::get_time_high(const std::string &name, std::size_t bit) const
+{
+    const std::size_t slot = slots.at(name);
+    discrete_time_t high   = time_high[this->get_bit(name, bit)];
+    // Add the time spent in the current value.
+    if ((values[slot] >> bit) & 1U) {
+        high += scheduler.time() - last_change[slot];
+    }
+    return high;
+}
+
+discrete_time_t activity_t::get_time_low(const std::string &name, std::size_t bit) const
+{
+    return (scheduler.time() - start) - this->get_time_high(name, bit);
+}
+
+void activity_t::export_saif(std::ostream &os, const std::string &instance, const std::string &timescale) const
+{
+    const discrete_time_t now = scheduler.time();
+    os << "(SAIFILE\n";
+    os << "  (SAIFVERSION \"2.0\")\n";
+    os << "  (DIRECTION \"backward\")\n";
+    os << "  (DESIGN )\n";
+    os << "  (VENDOR \"digsim\")\n";
+    os << "  (PROGRAM_NAME \"digsim\")\n";
+    os << "  (DIVIDER / )\n";
+    os << "  (TIMESCALE " << timescale << ")\n";
+    os << "  (DURATION " << (now - start) << ")\n";
+    os << "  (INSTANCE " << escape_saif(instance) << "\n";
+    os << "    (NET\n";
+    for (std::size_t slot = 0; slot < names.size(); ++slot) {
+        const discrete_time_t tail = now - last_change[slot];
+        for (std::size_t bit = 0; bit < widths[slot]; ++bit) {
+            const std::size_t index = offsets[slot] + bit;
+            discrete_time_t high    = time_high[index] + (((values[slot] >> bit) & 1U) ? tail : 0);
+            os << "      (" << escape_saif(names[slot]);
+            if (widths[slot] > 1) {
+                os << "\\[" << bit << "\\]";
+            }
+            os << "\n";
+            os << "        (T0 " << ((now - start) - high) << ") (T1 " << high << ") (TX 0)\n";
+            os << "        (TC " << toggles[index] << ") (IG 0)\n";
+            os << "      )\n";
+        }
+    }
+    os << "    )\n";
+    os << "  )\n";
+    os << ")\n";
+}
+
+void activity_t::export_saif(const std::string &filename, const std::string &instance, const std::string &timescale)
+    const
+{
+    std::ofstream os(filename);
+    if (!os) {
+        throw std::runtime_error("Cannot open `" + filename + "` for writing.");
+    }
+    this->export_saif(static_cast<std::ostream &>(os), instance, timescale);
+}
+
+std::size_t activity_t::get_bit(const std::string &name, std::size_t bit) const
+{
+    auto it = slots.find(name);
+    if (it == slots.end()) {
+        throw std::runtime_error("Signal `" + name + "` has no switching activity.");
+    }
+    if (bit >= widths[it->second]) {
+        throw std::runtime_error("Signal `" + name + "` has no bit " + std::to_string(bit) + ".");
+    }
+    return offsets[it->second] + bit;
+}
+
+} // namespace digsim
@@ -0,0 +1,208 @@
+/// @file assertion.cpp
+/// @brief Implementation of the clocked temporal assertions.
+/// @copyright
+/// This file is distributed under the terms of the MIT License.
+/// See the full license in the root directory at LICENSE.md.
+
+#include "digsim/assertion.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace digsim
+{
+
+sequence_t::sequence_t(condition_t first)
+    : steps{step_t{0, 0, std::move(first)}}
+{
+    // Nothing to do here.
+}
+
+sequence_t sequence_t::after(std::size_t min, std::size_t max, condition_t first)
+{
+    sequence_t sequence;
+    sequence.then(min, max, std::move(first));
+    return sequence;
+}
+
+sequence_t &sequence_t::then(condition_t next) { return this->then(1, 1, std::move(next)); }
+
+sequence_t &sequence_t::then(std::size_t min, std::size_t max, condition_t next)
+{
+    if (min > max) {
+        throw std::runtime_error("Invalid delay range [" + std::to_string(min) + ":" + std::to_string(max) + "].");
+    }
+    steps.push_back(step_t{min, max, std::move(next)});
+    return *this;
+}
+
+property_t::property_t(sequence_t _antecedent, sequence_t _consequent)
+    : antecedent(std::move(_antecedent))
+    , consequent(std::move(_consequent))
+{
+    // Nothing to do here.
+}
+
+property_t property_t::implies(sequence_t antecedent, sequence_t consequent)
+{
+    return property_t(std::move(antecedent), std::move(consequent));
+}
+
+property_t property_t::implies_next(sequence_t antecedent, sequence_t consequent)
+{
+    // The consequent starts one cycle later.
+    consequent.steps.front().min += 1;
+    consequent.steps.front().max += 1;
+    return property_t(std::move(antecedent), std::move(consequent));
+}
+
+property_t property_t::always(condition_t condition)
+{
+    return property_t(sequence_t([] { return true; }), sequence_t(std::move(condition)));
+}
+
+assertion_t::assertion_t(const std::string &_name, bool sample_on_rising_edge)
+    : module_t(_name)
+    , clk("clk", this)
+    , properties()
+    , failure_callback()
+    , antecedent_values()
+    , consequent_values()
+{
+    ADD_SENSITIVITY_WHEN(assertion_t, evaluate, clk, when_equals(sample_on_rising_edge));
+}
+
+std::size_t assertion_t::add(const std::string &property_name, const property_t &property)
+{
+    compiled_property_t compiled{
+        property_name,
+        compile(property.antecedent),
+        compile(property.consequent),
+        0,
+        {},
+        0,
+        0,
+    };
+    properties.push_back(std::move(compiled));
+    return properties.size() - 1;
+}
+
+void assertion_t::on_failure(failure_callback_t callback) { failure_callback = std::move(callback); }
+
+std::size_t assertion_t::get_failures(std::size_t index) const { return properties.at(index).failures; }
+
+std::size_t assertion_t::get_successes(std::size_t index) const { return properties.at(index).successes; }
+
+std::size_t assertion_t::get_pending() const
+{
+    std::size_t pending = 0;
+    for (const auto &property : properties) {
+        pending += property.threads.size();
+    }
+    return pending;
+}
+
+assertion_t::automaton_t assertion_t::compile(const sequence_t &sequence)
+{
+    automaton_t automaton;
+    std::size_t offset = 0;
+    for (const auto &step : sequence.steps) {
+        // Each step needs one state for every cycle it can wait.
+        if (offset + step.max + 1 > std::numeric_limits<uint64_t>::digits) {
+            throw std::runtime_error("The sequence is too long, at most 64 states are supported.");
+        }
+        uint64_t window = 0;
+        for (std::size_t wait = 0; wait <= step.max; ++wait) {
+            if (wait >= step.min) {
+                window |= uint64_t{1} << (offset + wait);
+            }
+            if (wait < step.max) {
+                automaton.keep |= uint64_t{1} << (offset + wait);
+            }
+        }
+        automaton.conditions.push_back(step.condition);
+        automaton.windows.push_back(window);
+        automaton.entries.push_back(uint64_t{1} << offset);
+        offset += step.max + 1;
+    }
+    return automaton;
+}
+
+bool assertion_t::advance(const automaton_t &automaton, uint64_t &states, std::vector<int8_t> &values)
+{
+    bool matched           = false;
+    const std::size_t last = automaton.conditions.size() - 1;
+    // Steps are visited in order, so that a step entered with no delay is checked on the same edge.
+    for (std::size_t index = 0; index <= last; ++index) {
+        if (!(states & automaton.windows[index])) {
+            continue;
+        }
+        if (values[index] < 0) {
+            values[index] = automaton.conditions[index]() ? 1 : 0;
+        }
+        if (values[index]) {
+            if (index == last) {
+                matched = true;
+            } else {
+                states |= automaton.entries[index + 1];
+            }
+        }
+    }
+    // Move to the next cycle, dropping the states which reached the end of their delay.
+    states = (states & automaton.keep) << 1;
+    return matched;
+}
+
+void assertion_t::evaluate()
+{
+    // The initialization is not a clock edge, nothing is sampled.
+    if (!this->triggered_by(clk)) {
+        return;
+    }
+    const discrete_time_t now = scheduler.time();
+    for (auto &property : properties) {
+        antecedent_values.assign(property.antecedent.conditions.size(), -1);
+        consequent_values.assign(property.consequent.conditions.size(), -1);
+        // Start a new check if the antecedent matches, then advance all the pending checks.
+        property.antecedent_states |= property.antecedent.entries.front();
+        if (advance(property.antecedent, property.antecedent_states, antecedent_values)) {
+            property.threads.push_back(thread_t{property.consequent.entries.front(), now, 1});
+        }
+        std::size_t alive = 0;
+        for (std::size_t index = 0; index < property.threads.size(); ++index) {
+            thread_t thread = property.threads[index];
+            if (advance(property.consequent, thread.states, consequent_values)) {
+                property.successes += thread.checks;
+            } else if (thread.states == 0) {
+                // The merged checks fail together, count all of them but only report the oldest one.
+                property.failures += thread.checks;
+                if (failure_callback) {
+                    failure_callback(property.name, thread.start);
+                } else {
+                    digsim::error(
+                        get_name(), "Property `{}` started at {} failed at {}", property.name, thread.start, now);
+                }
+            } else {
+                property.threads[alive++] = thread;
+            }
+        }
+        property.threads.resize(alive);
+        // Threads in the same states behave the same from now on, merge them into the oldest one.
+        if (alive > 1) {
+            std::sort(property.threads.begin(), property.threads.end(), [](const thread_t &lhs, const thread_t &rhs) {
+                return (lhs.states < rhs.states) || ((lhs.states == rhs.states) && (lhs.start < rhs.start));
+            });
+            std::size_t merged = 0;
+            for (std::size_t index = 1; index < alive; ++index) {
+                if (property.threads[index].states == property.threads[merged].states) {
+                    property.threads[merged].checks += property.threads[index].checks;
+                } else {
+                    property.threads[++merged] = property.threads[index];
+                }
+            }
+            property.threads.resize(merged + 1);
+        }
+    }
+}
+
+} // namespace digsim
@@ -0,0 +1,481 @@
+/// @file bytecode_kernel.cpp
+/// @brief Implementation of the simulation of frozen netlists by a bytecode interpreter.
+/// @copyright
+/// This file is distributed under the terms of the MIT License.
+/// See the full license in the root directory at LICENSE.md.
+
+#include "digsim/bytecode_kernel.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+// GCC and Clang can jump to the address of a label, which gives each instruction its own indirect branch.
+#if defined(__GNUC__)
+#define DIGSIM_COMPUTED_GOTO
+#endif
+
+namespace digsim
+{
+
+namespace
+{
+
+/// @brief How many times a time step is re-evaluated before giving up.
+constexpr std::size_t settle_limit = 1000;
+
+/// @brief Returns the mask of the bits of a net.
+/// @param netlist the netlist.
+/// @param net the index of the net.
+/// @return the mask.
+uint64_t mask_of(const netlist_view_t &netlist, std::size_t net)
+{
+    return (netlist.net_widths[net] >= 64) ? ~uint64_t{0} : (uint64_t{1} << netlist.net_widths[net]) - 1;
+}
+
+} // namespace
+
+bytecode_kernel_t::bytecode_kernel_t(const netlist_view_t &_netlist)
+    : netlist(_netlist)
+    , values(_netlist.net_initial.begin(), _netlist.net_initial.end())
+    , seen(_netlist.inputs.size(), 0)
+    , code()
+    , evaluate_program(0)
+    , sample_programs()
+    , commit_programs()
+    , domain_clocks()
+    , last_clock()
+    , rising()
+    , has_loops(false)
+    , next_edge(_netlist.clock_first.begin(), _netlist.clock_first.end())
+    , updates()
+    , sequence(0)
+    , now(0)
+    , initialized(false)
+{
+    std::vector<std::size_t> drivers(netlist.num_nets(), netlist_view_t::npos);
+    std::vector<std::size_t> combinational;
+    std::vector<std::vector<std::size_t>> domains;
+    for (std::size_t gate = 0; gate < netlist.num_gates(); ++gate) {
+        drivers[netlist.gate_outputs[gate]] = gate;
+        if (!is_sequential(static_cast<gate_op_t>(netlist.gate_ops[gate]))) {
+            combinational.push_back(gate);
+            continue;
+        }
+        const uint32_t clock = netlist.inputs[netlist.input_offsets[gate]];
+        auto it              = std::find(domain_clocks.begin(), domain_clocks.end(), clock);
+        if (it == domain_clocks.end()) {
+            domain_clocks.push_back(clock);
+            domains.emplace_back();
+            it = domain_clocks.end() - 1;
+        }
+        domains[static_cast<std::size_t>(it - domain_clocks.begin())].push_back(gate);
+    }
+    last_clock.resize(domain_clocks.size(), 0);
+    rising.resize(domain_clocks.size(), 0);
+    std::stable_sort(combinational.begin(), combinational.end(), [this](std::size_t lhs, std::size_t rhs) {
+        return netlist.gate_levels[lhs] < netlist.gate_levels[rhs];
+    });
+    // A gate fed by a combinational gate which is not at a lower level closes a loop.
+    for (std::size_t gate : combinational) {
+        for (uint32_t index = netlist.input_offsets[gate]; index < netlist.input_offsets[gate + 1]; ++index) {
+            const std::size_t driver = drivers[netlist.inputs[index]];
+            if ((driver != netlist_view_t::npos) &&
+                !is_sequential(static_cast<gate_op_t>(netlist.gate_ops[driver])) &&
+                (netlist.gate_levels[driver] >= netlist.gate_levels[gate])) {
+                has_loops = true;
+            }
+        }
+    }
+
+    // Flip-flops without enable nor reset read constants.
+    const uint32_t one  = this->add_value(1);
+    const uint32_t zero = this->add_value(0);
+    std::vector<std::vector<std::pair<uint32_t, uint32_t>>> samples(domains.size());
+    for (std::size_t domain = 0; domain < domains.size(); ++domain) {
+        sample_programs.push_back(code.size());
+        for (std::size_t gate : domains[domain]) {
+            const uint32_t *in      = netlist.inputs.data() + netlist.input_offsets[gate];
+            const std::size_t count = netlist.input_offsets[gate + 1] - netlist.input_offsets[gate];
+            const uint32_t output   = netlist.gate_outputs[gate];
+            const bool inverted     = static_cast<gate_op_t>(netlist.gate_ops[gate]) == gate_op_t::dffn;
+            uint32_t state          = (count > 4) ? in[4] : output;
+            if (inverted && (count <= 4)) {
+                // The held state is the non-inverted output.
+                state = this->add_value();
+                this->emit(opcode_t::not_, state, output);
+            }
+            const uint32_t sample = this->add_value();
+            this->emit(
+                inverted ? opcode_t::sample_inverted : opcode_t::sample, sample, in[1], (count > 2) ? in[2] : one,
+                (count > 3) ? in[3] : zero, state, mask_of(netlist, output));
+            samples[domain].emplace_back(output, sample);
+        }
+        this->emit(opcode_t::halt, 0, 0);
+    }
+    for (std::size_t domain = 0; domain < domains.size(); ++domain) {
+        commit_programs.push_back(code.size());
+        for (const auto &[output, sample] : samples[domain]) {
+            this->emit((netlist.net_delays[output] > 0) ? opcode_t::commit_delayed : opcode_t::commit, output, sample);
+        }
+        this->emit(opcode_t::halt, 0, 0);
+    }
+
+    evaluate_program = code.size();
+    std::vector<uint8_t> fused(netlist.num_gates(), 0);
+    for (std::size_t position = 0; position < combinational.size(); ++position) {
+        const std::size_t gate = combinational[position];
+        if (fused[gate]) {
+            continue;
+        }
+        const uint32_t output = netlist.gate_outputs[gate];
+        if (netlist.net_delays[output] > 0) {
+            // The gate computes the value aside, which is queued only if its inputs changed.
+            const uint32_t value = this->add_value();
+            this->translate(gate, value);
+            this->emit(opcode_t::delayed, output, value, static_cast<uint32_t>(gate));
+            continue;
+        }
+        // The sum and the carry of a full adder, at the same level, read the same inputs.
+        const uint32_t *in      = netlist.inputs.data() + netlist.input_offsets[gate];
+        const std::size_t count = netlist.input_offsets[gate + 1] - netlist.input_offsets[gate];
+        bool is_full_adder      = false;
+        if ((static_cast<gate_op_t>(netlist.gate_ops[gate]) == gate_op_t::xor_) && (count == 3)) {
+            for (std::size_t other = position + 1; !is_full_adder && (other < combinational.size()); ++other) {
+                const std::size_t carry = combinational[other];
+                if (netlist.gate_levels[carry] != netlist.gate_levels[gate]) {
+                    break;
+                }
+                const uint32_t carry_output = netlist.gate_outputs[carry];
+                if ((static_cast<gate_op_t>(netlist.gate_ops[carry]) == gate_op_t::maj) &&
+                    std::equal(in, in + 3, netlist.inputs.data() + netlist.input_offsets[carry]) &&
+                    (netlist.net_delays[carry_output] == 0) &&
+                    (mask_of(netlist, carry_output) == mask_of(netlist, output))) {
+                    this->emit(
+                        opcode_t::full_adder, output, in[0], in[1], in[2], carry_output, mask_of(netlist, output));
+                    fused[carry]  = 1;
+                    is_full_adder = true;
+                }
+            }
+        }
+        if (is_full_adder) {
+            continue;
+        }
+        this->translate(gate, output);
+    }
+    this->emit(opcode_t::halt, 0, 0);
+}
+
+void bytecode_kernel_t::initialize()
+{
+    if (initialized) {
+        return;
+    }
+    for (std::size_t domain = 0; domain < domain_clocks.size(); ++domain) {
+        last_clock[domain] = values[domain_clocks[domain]] & 1U;
+    }
+    this->settle();
+    initialized = true;
+}
+
+void bytecode_kernel_t::run(discrete_time_t simulation_time)
+{
+    this->initialize();
+    const discrete_time_t simulation_end = now + simulation_time;
+    while (true) {
+        // Find the time of the next change, among the delayed nets and the clocks.
+        bool found                   = !updates.empty();
+        discrete_time_t current_time = found ? updates.top().time : 0;
+        for (discrete_time_t edge : next_edge) {
+            if (!found || (edge < current_time)) {
+                current_time = edge;
+                found        = true;
+            }
+        }
+        if (!found || ((simulation_time > 0) && (current_time > simulation_end))) {
+            break;
+        }
+        now = current_time;
+        while (!updates.empty() && (updates.top().time == now)) {
+            values[updates.top().net] = updates.top().value;
+            updates.pop();
+        }
+        for (std::size_t clock = 0; clock < next_edge.size(); ++clock) {
+            if (next_edge[clock] == now) {
+                const std::size_t net = netlist.clock_nets[clock];
+                values[net]           = (values[net] & 1U) ^ 1U;
+                next_edge[clock]      = now + std::max<discrete_time_t>(
+                                                 1, values[net] ? netlist.clock_high[clock] : netlist.clock_low[clock]);
+            }
+        }
+        this->settle();
+    }
+}
+
+void bytecode_kernel_t::set(std::size_t net, uint64_t value)
+{
+    this->initialize();
+    values[net] = value & mask_of(netlist, net);
+    this->settle();
+}
+
+uint32_t bytecode_kernel_t::add_value(uint64_t initial)
+{
+    values.push_back(initial);
+    return static_cast<uint32_t>(values.size() - 1);
+}
+
+void bytecode_kernel_t::emit(
+    opcode_t opcode,
+    uint32_t dst,
+    uint32_t a,
+    uint32_t b,
+    uint32_t c,
+    uint32_t d,
+    uint64_t mask)
+{
+    code.push_back(instruction_t{opcode, dst, a, b, c, d, mask});
+}
+
+void bytecode_kernel_t::translate(std::size_t gate, uint32_t dst)
+{
+    const uint32_t *in      = netlist.inputs.data() + netlist.input_offsets[gate];
+    const std::size_t count = netlist.input_offsets[gate + 1] - netlist.input_offsets[gate];
+    const auto op           = static_cast<gate_op_t>(netlist.gate_ops[gate]);
+    const uint64_t mask     = mask_of(netlist, netlist.gate_outputs[gate]);
+    switch (op) {
+    case gate_op_t::buf:
+        this->emit(opcode_t::copy, dst, in[0], 0, 0, 0, mask);
+        return;
+    case gate_op_t::not_:
+        this->emit(opcode_t::not_, dst, in[0], 0, 0, 0, mask);
+        return;
+    case gate_op_t::maj:
+        this->emit(opcode_t::maj, dst, in[0], in[1], in[2], 0, mask);
+        return;
+    case gate_op_t::mux:
+        this->emit(opcode_t::mux, dst, in[0], in[1], in[2], 0, mask);
+        return;
+    default:
+        break;
+    }
+    // The remaining gates reduce their inputs, and possibly negate the result.
+    opcode_t reduce = opcode_t::and_, reduce3 = opcode_t::and3, negated = opcode_t::nand;
+    if ((op == gate_op_t::or_) || (op == gate_op_t::nor)) {
+        reduce = opcode_t::or_, reduce3 = opcode_t::or3, negated = opcode_t::nor;
+    } else if ((op == gate_op_t::xor_) || (op == gate_op_t::xnor)) {
+        reduce = opcode_t::xor_, reduce3 = opcode_t::xor3, negated = opcode_t::xnor;
+    }
+    const bool negate = (op == gate_op_t::nand) || (op == gate_op_t::nor) || (op == gate_op_t::xnor);
+    if (count == 1) {
+        this->emit(negate ? opcode_t::not_ : opcode_t::copy, dst, in[0], 0, 0, 0, mask);
+    } else if (count == 2) {
+        this->emit(negate ? negated : reduce, dst, in[0], in[1], 0, 0, mask);
+    } else if ((count == 3) && !negate) {
+        this->emit(reduce3, dst, in[0], in[1], in[2], 0, mask);
+    } else {
+        // Each partial result has its own temporary, so that it only changes when the inputs of the gate do.
+        uint32_t partial = this->add_value();
+        this->emit(reduce, partial, in[0], in[1]);
+        for (std::size_t index = 2; index + 1 < count; ++index) {
+            const uint32_t next = this->add_value();
+            this->emit(reduce, next, partial, in[index]);
+            partial = next;
+        }
+        this->emit(negate ? negated : reduce, dst, partial, in[count - 1], 0, 0, mask);
+    }
+}
+
+bool bytecode_kernel_t::execute(std::size_t pc)
+{
+    const instruction_t *ip = code.data() + pc;
+    uint64_t *value         = values.data();
+    bool changed            = false;
+    auto write              = [&changed, value](uint32_t dst, uint64_t result) {
+        changed |= value[dst] != result;
+        value[dst] = result;
+    };
+    auto push = [this](uint32_t net, uint64_t result) {
+        updates.push(update_t{now + netlist.net_delays[net], sequence++, net, result});
+    };
+#ifdef DIGSIM_COMPUTED_GOTO
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+    // In the same order as opcode_t.
+    static const void *const labels[] = {
+        &&op_halt, &&op_copy, &&op_not_, &&op_and_,  &&op_or_,         &&op_xor_,   &&op_nand,
+        &&op_nor,  &&op_xnor, &&op_and3, &&op_or3,   &&op_xor3,        &&op_maj,    &&op_mux,
+        &&op_full_adder, &&op_delayed, &&op_sample, &&op_sample_inverted, &&op_commit, &&op_commit_delayed,
+    };
+#define DIGSIM_CASE(name) op_##name:
+#define DIGSIM_NEXT()                                                                                                  \
+    ++ip;                                                                                                              \
+    goto *labels[static_cast<std::size_t>(ip->opcode)]
+    goto *labels[static_cast<std::size_t>(ip->opcode)];
+#else
+#define DIGSIM_CASE(name) case opcode_t::name:
+#define DIGSIM_NEXT()                                                                                                  \
+    ++ip;                                                                                                              \
+    continue
+    while (true) {
+        switch (ip->opcode) {
+#endif
+    DIGSIM_CASE(halt)
+    {
+        return changed;
+    }
+    DIGSIM_CASE(copy)
+    {
+        write(ip->dst, value[ip->a] & ip->mask);
+        DIGSIM_NEXT();
+    }
+    DIGSIM_CASE(not_)
+    {
+        write(ip->dst, ~value[ip->a] & ip->mask);
+        DIGSIM_NEXT();
+    }
+    DIGSIM_CASE(and_)
+    {
+        write(ip->dst, value[ip->a] & value[ip->b] & ip->mask);
+        DIGSIM_NEXT();
+    }
+    DIGSIM_CASE(or_)
+    {
+        write(ip->dst, (value[ip->a] | value[ip->b]) & ip->mask);
+        DIGSIM_NEXT();
+    }
+    DIGSIM_CASE(xor_)
+    {
+        write(ip->dst, (value[ip->a] ^ value[ip->b]) & ip->mask);
+        DIGSIM_NEXT();
+    }
+    DIGSIM_CASE(nand)
+    {
+        write(ip->dst, ~(value[ip->a] & value[ip->b]) & ip->mask);
+        DIGSIM_NEXT();
+    }
+    DIGSIM_CASE(nor)
+    {
+        write(ip->dst, ~(value[ip->a] | value[ip->b]) & ip->mask);
+        DIGSIM_NEXT();
+    }
+    DIGSIM_CASE(xnor)
+    {
+        write(ip->dst, ~(value[ip->a] ^ value[ip->b]) & ip->mask);
+        DIGSIM_NEXT();
+    }
+    DIGSIM_CASE(and3)
+    {
+        write(ip->dst, value[ip->a] & value[ip->b] & value[ip->c] & ip->mask);
+        DIGSIM_NEXT();
+    }
+    DIGSIM_CASE(or3)
+    {
+        write(ip->dst, (value[ip->a] | value[ip->b] | value[ip->c]) & ip->mask);
+        DIGSIM_NEXT();
+    }
+    DIGSIM_CASE(xor3)
+    {
+        write(ip->dst, (value[ip->a] ^ value[ip->b] ^ value[ip->c]) & ip->mask);
+        DIGSIM_NEXT();
+    }
+    DIGSIM_CASE(maj)
+    {
+        const uint64_t a = value[ip->a], b = value[ip->b], c = value[ip->c];
+        write(ip->dst, ((a & b) | (a & c) | (b & c)) & ip->mask);
+        DIGSIM_NEXT();
+    }
+    DIGSIM_CASE(mux)
+    {
+        write(ip->dst, (value[ip->a] ? value[ip->c] : value[ip->b]) & ip->mask);
+        DIGSIM_NEXT();
+    }
+    DIGSIM_CASE(full_adder)
+    {
+        const uint64_t a = value[ip->a], b = value[ip->b], c = value[ip->c];
+        write(ip->dst, (a ^ b ^ c) & ip->mask);
+        write(ip->d, ((a & b) | (a & c) | (b & c)) & ip->mask);
+        DIGSIM_NEXT();
+    }
+    DIGSIM_CASE(delayed)
+    {
+        // Like the kernel, which queues a change whenever the gate is woken up by its inputs.
+        const uint32_t first = netlist.input_offsets[ip->b], last = netlist.input_offsets[ip->b + 1];
+        bool woken           = !initialized;
+        for (uint32_t index = first; index < last; ++index) {
+            woken |= seen[index] != value[netlist.inputs[index]];
+            seen[index] = value[netlist.inputs[index]];
+        }
+        if (woken) {
+            push(ip->dst, value[ip->a]);
+        }
+        DIGSIM_NEXT();
+    }
+    DIGSIM_CASE(sample)
+    {
+        value[ip->dst] = (value[ip->c] ? 0 : (value[ip->b] ? value[ip->a] : value[ip->d])) & ip->mask;
+        DIGSIM_NEXT();
+    }
+    DIGSIM_CASE(sample_inverted)
+    {
+        value[ip->dst] = ~(value[ip->c] ? 0 : (value[ip->b] ? value[ip->a] : value[ip->d])) & ip->mask;
+        DIGSIM_NEXT();
+    }
+    DIGSIM_CASE(commit)
+    {
+        write(ip->dst, value[ip->a]);
+        DIGSIM_NEXT();
+    }
+    DIGSIM_CASE(commit_delayed)
+    {
+        push(ip->dst, value[ip->a]);
+        DIGSIM_NEXT();
+    }
+#ifdef DIGSIM_COMPUTED_GOTO
+#pragma GCC diagnostic pop
+#else
+        }
+    }
+#endif
+#undef DIGSIM_CASE
+#undef DIGSIM_NEXT
+}
+
+void bytecode_kernel_t::settle()
+{
+    for (std::size_t pass = 0;; ++pass) {
+        if (pass > settle_limit) {
+            throw std::runtime_error("Time step " + std::to_string(now) + " does not settle.");
+        }
+        // Flip-flops sample their inputs together, before any of them drives its output.
+        for (std::size_t domain = 0; domain < domain_clocks.size(); ++domain) {
+            const uint8_t clock = values[domain_clocks[domain]] & 1U;
+            rising[domain]      = clock && !last_clock[domain];
+            last_clock[domain]  = clock;
+            if (rising[domain]) {
+                this->execute(sample_programs[domain]);
+            }
+        }
+        for (std::size_t domain = 0; domain < domain_clocks.size(); ++domain) {
+            if (rising[domain]) {
+                this->execute(commit_programs[domain]);
+            }
+        }
+        for (std::size_t iteration = 0; this->execute(evaluate_program) && has_loops; ++iteration) {
+            if (iteration > settle_limit) {
+                throw std::runtime_error(
+                    "Time step " + std::to_string(now) + " does not settle, the netlist has a combinational loop.");
+            }
+        }
+        // Combinational logic can move the clock of a domain, e.g., gated clocks, which samples it again.
+        bool stable = true;
+        for (std::size_t domain = 0; domain < domain_clocks.size(); ++domain) {
+            stable &= (values[domain_clocks[domain]] & 1U) == last_clock[domain];
+        }
+        if (stable) {
+            break;
+        }
+    }
+}
+
+} // namespace digsim
@@ -19,18 +19,17 @@ clock_t::clock_t(
     , out("out")
     , period(clk_period)
     , duty_cycle(clk_duty_cycle)
+    , first_edge(clk_start_time)
+    , process(digsim::get_or_create_process(this, &clock_t::evaluate, "evaluate"))
 {
     // Get the initial delay for the clock signal.
-    auto delay = clk_start_time;
     if (clk_posedge_first) {
-        delay += static_cast<discrete_time_t>(static_cast<double>(period) * duty_cycle);
+        first_edge += static_cast<discrete_time_t>(static_cast<double>(period) * duty_cycle);
     } else {
-        delay += static_cast<discrete_time_t>(static_cast<double>(period) * (1 - duty_cycle));
+        first_edge += static_cast<discrete_time_t>(static_cast<double>(period) * (1 - duty_cycle));
     }
-    // Create a process info for the clock evaluation method.
-    auto proc_info = digsim::get_or_create_process(this, &clock_t::evaluate, "start");
     // Schedule the first evaluation of the clock signal.
-    scheduler.schedule_after(proc_info, delay);
+    scheduler.schedule_after(process, first_edge);
     // Register the output signal in the dependency graph.
     ADD_PRODUCER(clock_t, evaluate, out);
 }
@@ -48,10 +47,15 @@ void clock_t::evaluate()
     } else {
         delay = static_cast<discrete_time_t>(static_cast<double>(period) * (1 - duty_cycle));
     }
-    // Create the process info for the next evaluation.
-    auto proc_info = digsim::get_or_create_process(this, &clock_t::evaluate, "evaluate");
     // Schedule the next evaluation of the clock signal.
-    scheduler.schedule_after(proc_info, delay);
+    scheduler.schedule_after(process, delay);
+}
+
+void clock_t::describe(netlist_t &netlist) const
+{
+    netlist.add_clock(
+        netlist.get_net(out), first_edge, static_cast<discrete_time_t>(static_cast<double>(period) * duty_cycle),
+        static_cast<discrete_time_t>(static_cast<double>(period) * (1 - duty_cycle)));
 }
 
 } // namespace digsim
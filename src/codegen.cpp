@@ -0,0 +1,453 @@
+/// @file codegen.cpp
+/// @brief Implementation of the generation of straight-line C++ from a frozen netlist.
+/// @copyright
+/// This file is distributed under the terms of the MIT License.
+/// See the full license in the root directory at LICENSE.md.
+
+#include "digsim/codegen.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace digsim
+{
+
+namespace
+{
+
+/// @brief How many times a time step is re-evaluated before giving up, in the generated code.
+constexpr std::size_t settle_limit = 1000;
+
+/// @brief Formats a constant as a 64-bit literal.
+/// @param value the constant.
+/// @return the literal.
+std::string literal(uint64_t value)
+{
+    std::ostringstream ss;
+    ss << "UINT64_C(0x" << std::hex << value << ")";
+    return ss.str();
+}
+
+/// @brief Checks if a string is a valid C++ identifier.
+/// @param name the string.
+/// @return true if it is an identifier, false otherwise.
+bool is_identifier(const std::string &name)
+{
+    if (name.empty() || std::isdigit(static_cast<unsigned char>(name.front()))) {
+        return false;
+    }
+    return std::all_of(name.begin(), name.end(), [](char c) {
+        return std::isalnum(static_cast<unsigned char>(c)) || (c == '_');
+    });
+}
+
+/// @brief Writes the code of a netlist, see generate_cpp().
+class emitter_t
+{
+public:
+    /// @brief Constructor.
+    /// @param _netlist the netlist.
+    emitter_t(const netlist_view_t &_netlist)
+        : netlist(_netlist)
+        , members(_netlist.num_nets())
+        , masks(_netlist.num_nets())
+        , drivers(_netlist.num_nets(), netlist_view_t::npos)
+        , combinational()
+        , clocks()
+        , domains()
+        , has_loops(false)
+    {
+        for (std::size_t net = 0; net < netlist.num_nets(); ++net) {
+            // The index keeps the names unique, the name keeps the generated code readable.
+            std::string name = "n" + std::to_string(net) + "_";
+            for (char c : netlist.get_name(net).substr(0, 32)) {
+                name += std::isalnum(static_cast<unsigned char>(c)) ? c : '_';
+            }
+            members[net] = name;
+            masks[net] = (netlist.net_widths[net] >= 64) ? ~uint64_t{0} : (uint64_t{1} << netlist.net_widths[net]) - 1;
+        }
+        for (std::size_t gate = 0; gate < netlist.num_gates(); ++gate) {
+            drivers[netlist.gate_outputs[gate]] = gate;
+            if (is_sequential(this->op(gate))) {
+                const uint32_t clock = netlist.inputs[netlist.input_offsets[gate]];
+                auto it              = std::find(clocks.begin(), clocks.end(), clock);
+                if (it == clocks.end()) {
+                    clocks.push_back(clock);
+                    domains.emplace_back();
+                    it = clocks.end() - 1;
+                }
+                domains[static_cast<std::size_t>(it - clocks.begin())].push_back(gate);
+            } else {
+                combinational.push_back(gate);
+            }
+        }
+        std::stable_sort(combinational.begin(), combinational.end(), [this](std::size_t lhs, std::size_t rhs) {
+            return netlist.gate_levels[lhs] < netlist.gate_levels[rhs];
+        });
+        // A gate fed by a combinational gate which is not at a lower level closes a loop.
+        for (std::size_t gate : combinational) {
+            for (uint32_t index = netlist.input_offsets[gate]; index < netlist.input_offsets[gate + 1]; ++index) {
+                const std::size_t driver = drivers[netlist.inputs[index]];
+                if ((driver != netlist_view_t::npos) && !is_sequential(this->op(driver)) &&
+                    (netlist.gate_levels[driver] >= netlist.gate_levels[gate])) {
+                    has_loops = true;
+                }
+            }
+        }
+    }
+
+    /// @brief Writes the class.
+    /// @param os the output stream.
+    /// @param class_name the name of the class.
+    void emit(std::ostream &os, const std::string &class_name)
+    {
+        os << "// Generated by digsim from a netlist with " << netlist.num_nets() << " nets, " << netlist.num_gates()
+           << " gates, and " << netlist.num_clocks() << " clocks. Do not edit.\n\n";
+        os << "#pragma once\n\n";
+        os << "#include <cstddef>\n#include <cstdint>\n#include <functional>\n#include <queue>\n";
+        os << "#include <stdexcept>\n#include <string>\n#include <vector>\n\n";
+        os << "class " << class_name << "\n{\npublic:\n";
+        os << "    static constexpr std::size_t num_nets = " << netlist.num_nets() << ";\n\n";
+        this->emit_initialize(os);
+        this->emit_run(os);
+        os << "    std::uint64_t time() const { return now; }\n\n";
+        this->emit_get(os);
+        os << "    void set(std::size_t net, std::uint64_t value)\n    {\n";
+        os << "        initialize();\n        assign(net, value);\n        settle();\n    }\n\n";
+        os << "private:\n";
+        os << "    struct update_t {\n";
+        os << "        std::uint64_t time;\n        std::uint64_t sequence;\n        std::size_t net;\n";
+        os << "        std::uint64_t value;\n\n";
+        os << "        bool operator>(const update_t &other) const\n        {\n";
+        os << "            return (time > other.time) || ((time == other.time) && (sequence > other.sequence));\n";
+        os << "        }\n    };\n\n";
+        this->emit_assign(os);
+        this->emit_domains(os);
+        this->emit_evaluate(os);
+        this->emit_settle(os);
+        this->emit_members(os);
+        os << "};\n";
+    }
+
+private:
+    /// @brief Returns the operation of a gate.
+    gate_op_t op(std::size_t gate) const { return static_cast<gate_op_t>(netlist.gate_ops[gate]); }
+
+    /// @brief Returns the member holding an input of a gate.
+    const std::string &input(std::size_t gate, std::size_t index) const
+    {
+        return members[netlist.inputs[netlist.input_offsets[gate] + index]];
+    }
+
+    /// @brief Returns the number of inputs of a gate.
+    std::size_t count(std::size_t gate) const
+    {
+        return netlist.input_offsets[gate + 1] - netlist.input_offsets[gate];
+    }
+
+    /// @brief Returns the member holding the output of a gate.
+    const std::string &output(std::size_t gate) const { return members[netlist.gate_outputs[gate]]; }
+
+    /// @brief Returns the expression computing a combinational gate.
+    std::string expression(std::size_t gate) const
+    {
+        const gate_op_t gate_op = this->op(gate);
+        if (gate_op == gate_op_t::buf) {
+            return this->input(gate, 0);
+        }
+        if (gate_op == gate_op_t::not_) {
+            return "~" + this->input(gate, 0);
+        }
+        if (gate_op == gate_op_t::maj) {
+            const std::string &a = this->input(gate, 0), &b = this->input(gate, 1), &c = this->input(gate, 2);
+            return "((" + a + " & " + b + ") | (" + a + " & " + c + ") | (" + b + " & " + c + "))";
+        }
+        if (gate_op == gate_op_t::mux) {
+            return "(" + this->input(gate, 0) + " ? " + this->input(gate, 2) + " : " + this->input(gate, 1) + ")";
+        }
+        const char *separator = " & ";
+        if ((gate_op == gate_op_t::or_) || (gate_op == gate_op_t::nor)) {
+            separator = " | ";
+        } else if ((gate_op == gate_op_t::xor_) || (gate_op == gate_op_t::xnor)) {
+            separator = " ^ ";
+        }
+        std::string result = "(" + this->input(gate, 0);
+        for (std::size_t index = 1; index < this->count(gate); ++index) {
+            result += separator + this->input(gate, index);
+        }
+        result += ")";
+        const bool negated =
+            (gate_op == gate_op_t::nand) || (gate_op == gate_op_t::nor) || (gate_op == gate_op_t::xnor);
+        return negated ? "~" + result : result;
+    }
+
+    /// @brief Writes the statement driving the output of a gate.
+    void emit_drive(
+        std::ostream &os,
+        std::size_t gate,
+        const std::string &value,
+        const std::string &indent,
+        bool track_changes) const
+    {
+        const uint32_t net       = netlist.gate_outputs[gate];
+        const std::string &name  = members[net];
+        const std::string masked = "(" + value + ") & " + literal(masks[net]);
+        if ((netlist.net_delays[net] > 0) && is_sequential(this->op(gate))) {
+            // Flip-flops drive on each rising edge of their clock, like in the kernel.
+            os << indent << "updates.push(update_t{now + " << netlist.net_delays[net] << ", sequence++, " << net
+               << ", " << masked << "});\n";
+        } else if (netlist.net_delays[net] > 0) {
+            // Combinational gates drive when their inputs change, i.e., when the kernel wakes them up.
+            os << indent << "if (!initialized";
+            for (std::size_t index = 0; index < this->count(gate); ++index) {
+                os << " || (" << this->input(gate, index) << " != seen_" << gate << "_" << index << ")";
+            }
+            os << ") {\n";
+            for (std::size_t index = 0; index < this->count(gate); ++index) {
+                os << indent << "    seen_" << gate << "_" << index << " = " << this->input(gate, index) << ";\n";
+            }
+            os << indent << "    updates.push(update_t{now + " << netlist.net_delays[net] << ", sequence++, " << net
+               << ", " << masked << "});\n";
+            os << indent << "}\n";
+        } else if (track_changes) {
+            os << indent << "{\n";
+            os << indent << "    const std::uint64_t value = " << masked << ";\n";
+            os << indent << "    changed |= value != " << name << ";\n";
+            os << indent << "    " << name << " = value;\n";
+            os << indent << "}\n";
+        } else {
+            os << indent << name << " = " << masked << ";\n";
+        }
+    }
+
+    void emit_initialize(std::ostream &os) const
+    {
+        os << "    void initialize()\n    {\n";
+        os << "        if (initialized) {\n            return;\n        }\n";
+        for (std::size_t domain = 0; domain < clocks.size(); ++domain) {
+            os << "        last_clock_" << domain << " = (" << members[clocks[domain]] << " & 1U) != 0;\n";
+        }
+        os << "        settle();\n";
+        os << "        initialized = true;\n    }\n\n";
+    }
+
+    void emit_run(std::ostream &os) const
+    {
+        os << "    void run(std::uint64_t simulation_time = 0)\n    {\n";
+        os << "        initialize();\n";
+        os << "        const std::uint64_t simulation_end = now + simulation_time;\n";
+        os << "        while (true) {\n";
+        os << "            bool found                 = !updates.empty();\n";
+        os << "            std::uint64_t current_time = found ? updates.top().time : 0;\n";
+        for (std::size_t clock = 0; clock < netlist.num_clocks(); ++clock) {
+            os << "            if (!found || (next_edge_" << clock << " < current_time)) {\n";
+            os << "                current_time = next_edge_" << clock << ";\n";
+            os << "                found        = true;\n";
+            os << "            }\n";
+        }
+        os << "            if (!found || ((simulation_time > 0) && (current_time > simulation_end))) {\n";
+        os << "                break;\n            }\n";
+        os << "            now = current_time;\n";
+        os << "            while (!updates.empty() && (updates.top().time == now)) {\n";
+        os << "                assign(updates.top().net, updates.top().value);\n";
+        os << "                updates.pop();\n            }\n";
+        for (std::size_t clock = 0; clock < netlist.num_clocks(); ++clock) {
+            const std::string &name = members[netlist.clock_nets[clock]];
+            os << "            if (next_edge_" << clock << " == now) {\n";
+            os << "                " << name << " = (" << name << " & 1U) ^ 1U;\n";
+            os << "                next_edge_" << clock << " = now + (" << name << " ? "
+               << std::max<uint64_t>(1, netlist.clock_high[clock]) << "U : "
+               << std::max<uint64_t>(1, netlist.clock_low[clock]) << "U);\n";
+            os << "            }\n";
+        }
+        os << "            settle();\n        }\n    }\n\n";
+    }
+
+    void emit_get(std::ostream &os) const
+    {
+        os << "    std::uint64_t get(std::size_t net) const\n    {\n        switch (net) {\n";
+        for (std::size_t net = 0; net < netlist.num_nets(); ++net) {
+            os << "        case " << net << ":\n            return " << members[net] << ";\n";
+        }
+        os << "        default:\n";
+        os << "            throw std::out_of_range(\"Net \" + std::to_string(net) + \" does not exist.\");\n";
+        os << "        }\n    }\n\n";
+    }
+
+    void emit_assign(std::ostream &os) const
+    {
+        os << "    void assign(std::size_t net, std::uint64_t value)\n    {\n        switch (net) {\n";
+        for (std::size_t net = 0; net < netlist.num_nets(); ++net) {
+            os << "        case " << net << ":\n";
+            os << "            " << members[net] << " = value & " << literal(masks[net]) << ";\n";
+            os << "            break;\n";
+        }
+        os << "        default:\n";
+        os << "            throw std::out_of_range(\"Net \" + std::to_string(net) + \" does not exist.\");\n";
+        os << "        }\n    }\n\n";
+    }
+
+    void emit_domains(std::ostream &os) const
+    {
+        for (std::size_t domain = 0; domain < clocks.size(); ++domain) {
+            const std::string &clock = members[clocks[domain]];
+            os << "    // Clock domain of `" << netlist.get_name(clocks[domain]) << "`.\n";
+            os << "    bool sample_" << domain << "()\n    {\n";
+            os << "        const bool rising = ((" << clock << " & 1U) != 0) && !last_clock_" << domain << ";\n";
+            os << "        last_clock_" << domain << "  = (" << clock << " & 1U) != 0;\n";
+            os << "        if (rising) {\n";
+            for (std::size_t gate : domains[domain]) {
+                const uint32_t net          = netlist.gate_outputs[gate];
+                const std::size_t inputs    = this->count(gate);
+                const bool inverted         = this->op(gate) == gate_op_t::dffn;
+                const std::string state     = (inputs > 4) ? this->input(gate, 4)
+                                              : inverted   ? "(~" + members[net] + ")"
+                                                           : members[net];
+                std::string next = this->input(gate, 1);
+                if (inputs > 2) {
+                    next = "(" + this->input(gate, 2) + " ? " + next + " : " + state + ")";
+                }
+                if (inputs > 3) {
+                    next = "(" + this->input(gate, 3) + " ? UINT64_C(0) : " + next + ")";
+                }
+                os << "            sample_" << gate << " = " << (inverted ? "~" : "") << next << " & "
+                   << literal(masks[net]) << ";\n";
+            }
+            os << "        }\n        return rising;\n    }\n\n";
+            os << "    void commit_" << domain << "()\n    {\n";
+            for (std::size_t gate : domains[domain]) {
+                this->emit_drive(os, gate, "sample_" + std::to_string(gate), "        ", false);
+            }
+            os << "    }\n\n";
+        }
+    }
+
+    void emit_evaluate(std::ostream &os) const
+    {
+        os << "    void evaluate()\n    {\n";
+        std::string indent = "        ";
+        if (has_loops) {
+            os << "        for (std::size_t pass = 0;; ++pass) {\n";
+            os << "            bool changed = false;\n";
+            indent += "    ";
+        }
+        uint32_t level = 0;
+        for (std::size_t gate : combinational) {
+            if (netlist.gate_levels[gate] != level) {
+                level = netlist.gate_levels[gate];
+                os << indent << "// Level " << level << ".\n";
+            }
+            this->emit_drive(os, gate, this->expression(gate), indent, has_loops);
+        }
+        if (has_loops) {
+            os << "            if (!changed) {\n                break;\n            }\n";
+            os << "            if (pass > " << settle_limit << ") {\n";
+            os << "                throw std::runtime_error(\n";
+            os << "                    \"Time step \" + std::to_string(now) + \" does not settle, the netlist has a "
+                  "combinational loop.\");\n";
+            os << "            }\n        }\n";
+        }
+        os << "    }\n\n";
+    }
+
+    void emit_settle(std::ostream &os) const
+    {
+        os << "    void settle()\n    {\n";
+        if (clocks.empty()) {
+            os << "        evaluate();\n    }\n\n";
+            return;
+        }
+        // Combinational logic can move the clock of a domain, e.g., gated clocks, which samples it again.
+        os << "        for (std::size_t pass = 0;; ++pass) {\n";
+        os << "            if (pass > " << settle_limit << ") {\n";
+        os << "                throw std::runtime_error(\"Time step \" + std::to_string(now) + \" does not "
+              "settle.\");\n";
+        os << "            }\n";
+        for (std::size_t domain = 0; domain < clocks.size(); ++domain) {
+            os << "            const bool rising_" << domain << " = sample_" << domain << "();\n";
+        }
+        for (std::size_t domain = 0; domain < clocks.size(); ++domain) {
+            os << "            if (rising_" << domain << ") {\n                commit_" << domain << "();\n";
+            os << "            }\n";
+        }
+        os << "            evaluate();\n";
+        os << "            if (";
+        for (std::size_t domain = 0; domain < clocks.size(); ++domain) {
+            os << (domain ? " &&\n                " : "") << "(((" << members[clocks[domain]]
+               << " & 1U) != 0) == last_clock_" << domain << ")";
+        }
+        os << ") {\n                break;\n            }\n        }\n    }\n\n";
+    }
+
+    void emit_members(std::ostream &os) const
+    {
+        os << "    // Nets.\n";
+        for (std::size_t net = 0; net < netlist.num_nets(); ++net) {
+            os << "    std::uint64_t " << members[net] << " = " << literal(netlist.net_initial[net]) << ";\n";
+        }
+        os << "    // Inputs seen by the combinational gates driving nets with a delay.\n";
+        for (std::size_t gate : combinational) {
+            if (netlist.net_delays[netlist.gate_outputs[gate]] > 0) {
+                for (std::size_t index = 0; index < this->count(gate); ++index) {
+                    os << "    std::uint64_t seen_" << gate << "_" << index << " = 0;\n";
+                }
+            }
+        }
+        os << "    // Clock domains.\n";
+        for (std::size_t domain = 0; domain < clocks.size(); ++domain) {
+            os << "    bool last_clock_" << domain << " = false;\n";
+            for (std::size_t gate : domains[domain]) {
+                os << "    std::uint64_t sample_" << gate << " = 0;\n";
+            }
+        }
+        os << "    // Clocks.\n";
+        for (std::size_t clock = 0; clock < netlist.num_clocks(); ++clock) {
+            os << "    std::uint64_t next_edge_" << clock << " = " << netlist.clock_first[clock] << "U;\n";
+        }
+        os << "    std::priority_queue<update_t, std::vector<update_t>, std::greater<>> updates;\n";
+        os << "    std::uint64_t sequence = 0;\n";
+        os << "    std::uint64_t now      = 0;\n";
+        os << "    bool initialized       = false;\n";
+    }
+
+    /// @brief The netlist.
+    const netlist_view_t &netlist;
+    /// @brief The name of the member holding each net.
+    std::vector<std::string> members;
+    /// @brief The mask of the bits of each net.
+    std::vector<uint64_t> masks;
+    /// @brief The gate driving each net.
+    std::vector<std::size_t> drivers;
+    /// @brief The combinational gates, in level order.
+    std::vector<std::size_t> combinational;
+    /// @brief The clock net of each domain.
+    std::vector<uint32_t> clocks;
+    /// @brief The flip-flops of each domain.
+    std::vector<std::vector<std::size_t>> domains;
+    /// @brief Whether the combinational gates contain loops.
+    bool has_loops;
+};
+
+} // namespace
+
+void generate_cpp(const netlist_view_t &netlist, std::ostream &os, const std::string &class_name)
+{
+    if (!is_identifier(class_name)) {
+        throw std::runtime_error("`" + class_name + "` is not a valid class name.");
+    }
+    emitter_t(netlist).emit(os, class_name);
+}
+
+void generate_cpp(const netlist_view_t &netlist, const std::string &filename, const std::string &class_name)
+{
+    std::ofstream os(filename);
+    if (!os) {
+        throw std::runtime_error("Cannot open `" + filename + "` for writing.");
+    }
+    generate_cpp(netlist, os, class_name);
+}
+
+} // namespace digsim
@@ -47,6 +47,31 @@ bool process_info_equal::operator()(const process_info_t &lhs, const process_inf
     return lhs.key == rhs.key;
 }
 
+process_table_t &process_table_t::instance()
+{
+    static process_table_t instance;
+    return instance;
+}
+
+void process_table_t::add(process_info_t &info)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    info.id = processes.size();
+    processes.push_back(info);
+    owned[info.owner.ptr].push_back(info.id);
+}
+
+std::size_t process_table_t::size() const { return processes.size(); }
+
+const process_info_t &process_table_t::get(std::size_t id) const { return processes.at(id); }
+
+const std::vector<std::size_t> &process_table_t::get_owned(const named_object_t *owner) const
+{
+    static const std::vector<std::size_t> none;
+    auto it = owned.find(owner);
+    return (it != owned.end()) ? it->second : none;
+}
+
 std::ostream &operator<<(std::ostream &os, const object_ref_t &ref) { return os << ref.name(); }
 
 } // namespace digsim
@@ -0,0 +1,340 @@
+/// @file coverage.cpp
+/// @brief Implementation of the coverage collection.
+/// @copyright
+/// This file is distributed under the terms of the MIT License.
+/// See the full license in the root directory at LICENSE.md.
+
+#include "digsim/coverage.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <stdexcept>
+
+namespace digsim
+{
+
+namespace
+{
+
+/// @brief Identifies the coverage databases.
+constexpr char coverage_magic[8] = {'D', 'S', 'I', 'M', 'C', 'O', 'V', '1'};
+
+/// @brief Returns a mask with the given number of low bits set.
+/// @param width the number of bits.
+/// @return the mask.
+uint64_t width_mask(std::size_t width) { return width >= 64 ? ~uint64_t{0} : (uint64_t{1} << width) - 1; }
+
+/// @brief Returns the number of words needed to store the given number of bits.
+/// @param bits the number of bits.
+/// @return the number of words.
+std::size_t words_for(std::size_t bits) { return (bits + 63) / 64; }
+
+/// @brief Checks if a bit is set in a bit-packed array.
+/// @param words the array.
+/// @param bit the index of the bit.
+/// @return true if the bit is set, false otherwise.
+bool test_bit(const std::vector<uint64_t> &words, std::size_t bit) { return (words[bit / 64] >> (bit % 64)) & 1U; }
+
+void write_u64(std::ostream &os, uint64_t value) { os.write(reinterpret_cast<const char *>(&value), sizeof(value)); }
+
+void write_string(std::ostream &os, const std::string &value)
+{
+    write_u64(os, value.size());
+    os.write(value.data(), static_cast<std::streamsize>(value.size()));
+}
+
+uint64_t read_u64(std::istream &is)
+{
+    uint64_t value = 0;
+    if (!is.read(reinterpret_cast<char *>(&value), sizeof(value))) {
+        throw std::runtime_error("Truncated coverage database.");
+    }
+    return value;
+}
+
+std::string read_string(std::istream &is)
+{
+    std::string value(read_u64(is), '\0');
+    if (!is.read(value.data(), static_cast<std::streamsize>(value.size()))) {
+        throw std::runtime_error("Truncated coverage database.");
+    }
+    return value;
+}
+
+} // namespace
+
+coverage_t &coverage_t::instance()
+{
+    static coverage_t instance;
+    return instance;
+}
+
+coverage_t::coverage_t()
+    : enabled(false)
+    , names()
+    , widths()
+    , rises()
+    , falls()
+    , slots()
+    , registered()
+    , points()
+    , point_indices()
+{
+    // Nothing to do here.
+}
+
+std::size_t coverage_t::add_signal(const std::string &name, std::size_t width)
+{
+    // Skip the keys taken by other signals, but reuse the ones merged from a database before elaboration.
+    std::string key = name;
+    for (std::size_t index = 1; slots.count(key) && registered[slots.at(key)]; ++index) {
+        key = name + "#" + std::to_string(index);
+    }
+    const std::size_t slot = this->find_or_add_slot(key, width);
+    registered[slot]       = 1;
+    return slot;
+}
+
+std::size_t coverage_t::find_or_add_slot(const std::string &key, std::size_t width)
+{
+    if (width > 64) {
+        throw std::runtime_error("Signal `" + key + "` is too wide for the toggle coverage.");
+    }
+    auto it = slots.find(key);
+    if (it != slots.end()) {
+        widths[it->second] = std::max(widths[it->second], width);
+        return it->second;
+    }
+    names.push_back(key);
+    widths.push_back(width);
+    rises.push_back(0);
+    falls.push_back(0);
+    registered.push_back(0);
+    slots.emplace(key, names.size() - 1);
+    return names.size() - 1;
+}
+
+std::size_t coverage_t::add_point(const std::string &name, std::vector<std::string> bins, bool transitions)
+{
+    auto it = point_indices.find(name);
+    if (it != point_indices.end()) {
+        if (points[it->second].bins != bins || points[it->second].transitions != transitions) {
+            throw std::runtime_error("Coverage point `" + name + "` is already registered with different bins.");
+        }
+        return it->second;
+    }
+    const std::size_t size = bins.size();
+    points.push_back(point_t{
+        name,
+        std::move(bins),
+        transitions,
+        std::vector<uint64_t>(words_for(size), 0),
+        std::vector<uint64_t>(transitions ? words_for(size * size) : 0, 0),
+        npos,
+    });
+    point_indices.emplace(name, points.size() - 1);
+    return points.size() - 1;
+}
+
+std::size_t coverage_t::add_fsm(const std::string &name, std::vector<std::string> states)
+{
+    return this->add_point(name, std::move(states), true);
+}
+
+void coverage_t::sample(std::size_t point, std::size_t bin)
+{
+    if (!enabled) {
+        return;
+    }
+    point_t &p = points.at(point);
+    if (bin >= p.bins.size()) {
+        return;
+    }
+    p.hits[bin / 64] |= uint64_t{1} << (bin % 64);
+    if (p.transitions && (p.last != npos)) {
+        std::size_t arc = p.last * p.bins.size() + bin;
+        p.arcs[arc / 64] |= uint64_t{1} << (arc % 64);
+    }
+    p.last = bin;
+}
+
+uint64_t coverage_t::get_rises(const std::string &name) const { return rises[this->get_slot(name)]; }
+
+uint64_t coverage_t::get_falls(const std::string &name) const { return falls[this->get_slot(name)]; }
+
+bool coverage_t::is_hit(const std::string &name, std::size_t bin) const
+{
+    const point_t &p = this->get_point(name);
+    return (bin < p.bins.size()) && test_bit(p.hits, bin);
+}
+
+bool coverage_t::is_hit(const std::string &name, std::size_t from, std::size_t to) const
+{
+    const point_t &p = this->get_point(name);
+    if (!p.transitions) {
+        throw std::runtime_error("Coverage point `" + name + "` does not cover transitions.");
+    }
+    return (from < p.bins.size()) && (to < p.bins.size()) && test_bit(p.arcs, from * p.bins.size() + to);
+}
+
+double coverage_t::get_toggle_coverage() const
+{
+    std::size_t total = 0, covered = 0;
+    for (std::size_t slot = 0; slot < names.size(); ++slot) {
+        total += widths[slot];
+        covered += static_cast<std::size_t>(std::popcount(rises[slot] & falls[slot] & width_mask(widths[slot])));
+    }
+    return total ? static_cast<double>(covered) / static_cast<double>(total) : 1.0;
+}
+
+double coverage_t::get_point_coverage(const std::string &name) const
+{
+    const point_t &p     = this->get_point(name);
+    std::size_t total    = 0;
+    std::size_t hit_bins = 0;
+    for (std::size_t bin = 0; bin < p.bins.size(); ++bin) {
+        if (!p.bins[bin].empty()) {
+            ++total;
+            hit_bins += test_bit(p.hits, bin) ? 1 : 0;
+        }
+    }
+    return total ? static_cast<double>(hit_bins) / static_cast<double>(total) : 1.0;
+}
+
+void coverage_t::clear()
+{
+    std::fill(rises.begin(), rises.end(), 0);
+    std::fill(falls.begin(), falls.end(), 0);
+    for (auto &p : points) {
+        std::fill(p.hits.begin(), p.hits.end(), 0);
+        std::fill(p.arcs.begin(), p.arcs.end(), 0);
+        p.last = npos;
+    }
+}
+
+void coverage_t::save(const std::string &filename) const
+{
+    std::ofstream os(filename, std::ios::binary);
+    if (!os) {
+        throw std::runtime_error("Cannot open `" + filename + "` for writing.");
+    }
+    os.write(coverage_magic, sizeof(coverage_magic));
+    write_u64(os, names.size());
+    for (std::size_t slot = 0; slot < names.size(); ++slot) {
+        write_string(os, names[slot]);
+        write_u64(os, widths[slot]);
+        write_u64(os, rises[slot]);
+        write_u64(os, falls[slot]);
+    }
+    write_u64(os, points.size());
+    for (const auto &p : points) {
+        write_string(os, p.name);
+        write_u64(os, p.transitions ? 1 : 0);
+        write_u64(os, p.bins.size());
+        for (const auto &bin : p.bins) {
+            write_string(os, bin);
+        }
+        for (uint64_t word : p.hits) {
+            write_u64(os, word);
+        }
+        for (uint64_t word : p.arcs) {
+            write_u64(os, word);
+        }
+    }
+}
+
+void coverage_t::merge(const std::string &filename)
+{
+    std::ifstream is(filename, std::ios::binary);
+    if (!is) {
+        throw std::runtime_error("Cannot open `" + filename + "` for reading.");
+    }
+    char magic[sizeof(coverage_magic)];
+    if (!is.read(magic, sizeof(magic)) || std::memcmp(magic, coverage_magic, sizeof(magic)) != 0) {
+        throw std::runtime_error("`" + filename + "` is not a coverage database.");
+    }
+    for (uint64_t count = read_u64(is); count > 0; --count) {
+        std::string name = read_string(is);
+        std::size_t slot = this->find_or_add_slot(name, read_u64(is));
+        rises[slot] |= read_u64(is);
+        falls[slot] |= read_u64(is);
+    }
+    for (uint64_t count = read_u64(is); count > 0; --count) {
+        std::string name = read_string(is);
+        bool transitions = read_u64(is) != 0;
+        std::vector<std::string> bins(read_u64(is));
+        for (auto &bin : bins) {
+            bin = read_string(is);
+        }
+        point_t &p = points[this->add_point(name, std::move(bins), transitions)];
+        for (auto &word : p.hits) {
+            word |= read_u64(is);
+        }
+        for (auto &word : p.arcs) {
+            word |= read_u64(is);
+        }
+    }
+}
+
+void coverage_t::report(std::ostream &os) const
+{
+    os << std::fixed << std::setprecision(1);
+    os << "Toggle coverage: " << (this->get_toggle_coverage() * 100) << "%\n";
+    for (std::size_t slot = 0; slot < names.size(); ++slot) {
+        const uint64_t mask = width_mask(widths[slot]);
+        const uint64_t both = rises[slot] & falls[slot] & mask;
+        os << "    " << std::left << std::setw(32) << names[slot] << std::right << std::setw(3) << std::popcount(both)
+           << "/" << widths[slot];
+        if (both != mask) {
+            os << " missing:";
+            for (std::size_t bit = 0; bit < widths[slot]; ++bit) {
+                const bool rose = (rises[slot] >> bit) & 1U;
+                const bool fell = (falls[slot] >> bit) & 1U;
+                if (!rose || !fell) {
+                    os << " " << bit << (rose ? "" : "r") << (fell ? "" : "f");
+                }
+            }
+        }
+        os << "\n";
+    }
+    for (const auto &p : points) {
+        os << "Point `" << p.name << "`: " << (this->get_point_coverage(p.name) * 100) << "%\n";
+        for (std::size_t bin = 0; bin < p.bins.size(); ++bin) {
+            if (!p.bins[bin].empty() && !test_bit(p.hits, bin)) {
+                os << "    missing " << p.bins[bin] << "\n";
+            }
+        }
+        if (p.transitions) {
+            for (std::size_t from = 0; from < p.bins.size(); ++from) {
+                for (std::size_t to = 0; to < p.bins.size(); ++to) {
+                    if (test_bit(p.arcs, from * p.bins.size() + to)) {
+                        os << "    " << p.bins[from] << " -> " << p.bins[to] << "\n";
+                    }
+                }
+            }
+        }
+    }
+}
+
+std::size_t coverage_t::get_slot(const std::string &name) const
+{
+    auto it = slots.find(name);
+    if (it == slots.end()) {
+        throw std::runtime_error("Signal `" + name + "` is not covered.");
+    }
+    return it->second;
+}
+
+const coverage_t::point_t &coverage_t::get_point(const std::string &name) const
+{
+    auto it = point_indices.find(name);
+    if (it == point_indices.end()) {
+        throw std::runtime_error("Coverage point `" + name + "` does not exist.");
+    }
+    return points[it->second];
+}
+
+} // namespace digsim
@@ -6,10 +6,14 @@
 
 #include "digsim/dependency_graph.hpp"
 
+#include "digsim/clock.hpp"
 #include "digsim/module.hpp"
 
+#include <algorithm>
 #include <fstream>
 #include <iostream>
+#include <limits>
+#include <queue>
 #include <random>
 
 namespace digsim
@@ -220,6 +224,680 @@ bool dependency_graph_t::is_bad_cycle(const path_t &cycle) const
     return true;
 }
 
+std::vector<std::size_t> dependency_graph_t::compute_topological_order() const
+{
+    const std::size_t num_processes = process_table.size();
+    // Resolve the producers and consumers of each signal.
+    std::unordered_map<const isignal_t *, std::vector<std::size_t>> producers_of;
+    std::unordered_map<const isignal_t *, std::vector<std::size_t>> consumers_of;
+    for (const auto &[port, proc_info] : signal_producers) {
+        if (const auto *signal = port->get_bound_signal()) {
+            producers_of[signal].push_back(proc_info.id);
+        }
+    }
+    for (const auto &[port, consumer_list] : signal_consumers) {
+        if (const auto *signal = port->get_bound_signal()) {
+            for (const auto &consumer : consumer_list) {
+                consumers_of[signal].push_back(consumer.id);
+            }
+        }
+    }
+    // Build the edges from each producer to the consumers of its signals.
+    std::vector<std::vector<std::size_t>> successors(num_processes);
+    std::vector<std::size_t> in_degree(num_processes, 0);
+    for (const auto &[signal, producers] : producers_of) {
+        auto it = consumers_of.find(signal);
+        if (it == consumers_of.end()) {
+            continue;
+        }
+        for (std::size_t producer : producers) {
+            for (std::size_t consumer : it->second) {
+                if ((producer != consumer) && (producer < num_processes) && (consumer < num_processes)) {
+                    successors[producer].push_back(consumer);
+                    ++in_degree[consumer];
+                }
+            }
+        }
+    }
+    // Visit the graph in topological order, computing the longest path to each process.
+    std::vector<std::size_t> level(num_processes, 0);
+    std::vector<std::size_t> ready;
+    for (std::size_t id = 0; id < num_processes; ++id) {
+        if (in_degree[id] == 0) {
+            ready.push_back(id);
+        }
+    }
+    std::size_t max_level = 0;
+    while (!ready.empty()) {
+        std::size_t current = ready.back();
+        ready.pop_back();
+        max_level = std::max(max_level, level[current]);
+        for (std::size_t next : successors[current]) {
+            level[next] = std::max(level[next], level[current] + 1);
+            if (--in_degree[next] == 0) {
+                ready.push_back(next);
+            }
+        }
+    }
+    // Whatever was not visited belongs to a cycle.
+    for (std::size_t id = 0; id < num_processes; ++id) {
+        if (in_degree[id] > 0) {
+            level[id] = max_level + 1;
+        }
+    }
+    std::vector<std::size_t> order(num_processes);
+    for (std::size_t id = 0; id < num_processes; ++id) {
+        order[id] = id;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](std::size_t lhs, std::size_t rhs) {
+        return level[lhs] < level[rhs];
+    });
+    return order;
+}
+
+std::vector<process_edge_t> dependency_graph_t::get_process_edges() const
+{
+    std::unordered_map<const isignal_t *, std::vector<std::size_t>> producers_of;
+    for (const auto &[port, proc_info] : signal_producers) {
+        if (const auto *signal = port->get_bound_signal()) {
+            producers_of[signal].push_back(proc_info.id);
+        }
+    }
+    std::vector<process_edge_t> edges;
+    for (const auto &[port, consumer_list] : signal_consumers) {
+        const auto *signal = port->get_bound_signal();
+        auto it            = producers_of.find(signal);
+        if (!signal || (it == producers_of.end())) {
+            continue;
+        }
+        for (std::size_t producer : it->second) {
+            for (const auto &consumer : consumer_list) {
+                if (producer != consumer.id) {
+                    edges.push_back(process_edge_t{producer, consumer.id, signal});
+                }
+            }
+        }
+    }
+    // Processes owned by a signal (e.g., delayed updates) consume what its producer writes.
+    for (std::size_t id = 0; id < process_table.size(); ++id) {
+        const auto *signal = dynamic_cast<const isignal_t *>(process_table.get(id).owner.ptr);
+        auto it            = producers_of.find(signal);
+        if (!signal || (it == producers_of.end())) {
+            continue;
+        }
+        for (std::size_t producer : it->second) {
+            edges.push_back(process_edge_t{producer, id, signal});
+        }
+    }
+    std::sort(edges.begin(), edges.end(), [](const process_edge_t &lhs, const process_edge_t &rhs) {
+        if (lhs.producer != rhs.producer) {
+            return lhs.producer < rhs.producer;
+        }
+        if (lhs.consumer != rhs.consumer) {
+            return lhs.consumer < rhs.consumer;
+        }
+        if (lhs.signal->get_name() != rhs.signal->get_name()) {
+            return lhs.signal->get_name() < rhs.signal->get_name();
+        }
+        return std::less<const isignal_t *>()(lhs.signal, rhs.signal);
+    });
+    // The same signal can reach a consumer through different ports.
+    edges.erase(
+        std::unique(
+            edges.begin(), edges.end(),
+            [](const process_edge_t &lhs, const process_edge_t &rhs) {
+                return (lhs.producer == rhs.producer) && (lhs.consumer == rhs.consumer) && (lhs.signal == rhs.signal);
+            }),
+        edges.end());
+    return edges;
+}
+
+timing_report_t dependency_graph_t::compute_timing(std::size_t top_k, const std::vector<std::size_t> &partitions) const
+{
+    constexpr std::size_t cut = std::numeric_limits<std::size_t>::max();
+
+    timing_report_t report;
+    // Resolve the producers and consumers of each signal, without touching the crossing flags.
+    std::unordered_map<const isignal_t *, std::vector<process_info_t>> producers_of;
+    std::unordered_map<const isignal_t *, std::vector<process_info_t>> consumers_of;
+    for (const auto &[port, proc_info] : signal_producers) {
+        if (const auto *signal = port->get_bound_signal()) {
+            producers_of[signal].push_back(proc_info);
+        }
+    }
+    for (const auto &[port, consumer_list] : signal_consumers) {
+        if (const auto *signal = port->get_bound_signal()) {
+            auto &consumers = consumers_of[signal];
+            consumers.insert(consumers.end(), consumer_list.begin(), consumer_list.end());
+        }
+    }
+    // Number the signals, sorted by their hierarchical name so that the report does not depend on memory layout.
+    std::vector<std::pair<std::string, const isignal_t *>> named;
+    for (const auto &[signal, producers] : producers_of) {
+        named.emplace_back(get_signal_location_string(signal), signal);
+    }
+    for (const auto &[signal, consumers] : consumers_of) {
+        if (producers_of.find(signal) == producers_of.end()) {
+            named.emplace_back(get_signal_location_string(signal), signal);
+        }
+    }
+    std::sort(named.begin(), named.end());
+    const std::size_t num_signals = named.size();
+    std::unordered_map<const isignal_t *, std::size_t> index_of;
+    std::vector<discrete_time_t> delays(num_signals);
+    for (std::size_t index = 0; index < num_signals; ++index) {
+        index_of[named[index].second] = index;
+        delays[index]                 = named[index].second->get_delay();
+    }
+    std::unordered_map<std::size_t, std::vector<std::size_t>> produced_by;
+    for (const auto &[signal, producers] : producers_of) {
+        for (const auto &proc_info : producers) {
+            produced_by[proc_info.id].push_back(index_of[signal]);
+        }
+    }
+    // The clocks, and the sequential processes, i.e., the ones consuming a clock.
+    std::vector<uint8_t> is_clock(num_signals, 0);
+    std::unordered_set<std::size_t> sequential;
+    for (const auto &[signal, producers] : producers_of) {
+        for (const auto &proc_info : producers) {
+            if (dynamic_cast<const clock_t *>(proc_info.owner.ptr)) {
+                is_clock[index_of[signal]] = 1;
+                for (const auto &consumer : consumers_of[signal]) {
+                    sequential.insert(consumer.id);
+                }
+            }
+        }
+    }
+    // Each signal leads to the outputs of the combinational processes consuming it. The data inputs of sequential
+    // processes end the paths, while their clocks lead to their outputs, one delta cycle later.
+    std::vector<std::vector<std::size_t>> successors(num_signals);
+    std::vector<std::vector<std::size_t>> clocked(num_signals);
+    std::vector<uint8_t> is_end(num_signals, 0);
+    for (std::size_t index = 0; index < num_signals; ++index) {
+        auto it = consumers_of.find(named[index].second);
+        if (it == consumers_of.end()) {
+            is_end[index] = 1;
+            continue;
+        }
+        for (const auto &consumer : it->second) {
+            const auto &outputs = produced_by[consumer.id];
+            if (sequential.find(consumer.id) == sequential.end()) {
+                successors[index].insert(successors[index].end(), outputs.begin(), outputs.end());
+            } else if (is_clock[index]) {
+                clocked[index].insert(clocked[index].end(), outputs.begin(), outputs.end());
+            } else {
+                is_end[index] = 1;
+            }
+        }
+        for (auto *targets : {&successors[index], &clocked[index]}) {
+            std::sort(targets->begin(), targets->end());
+            targets->erase(std::unique(targets->begin(), targets->end()), targets->end());
+            targets->erase(std::remove(targets->begin(), targets->end(), index), targets->end());
+        }
+    }
+    // Visit the graph depth-first, cutting the edges which close a loop. The signals are collected in post-order, so
+    // that each one comes after all the signals it leads to.
+    std::vector<uint8_t> state(num_signals, 0);
+    std::vector<std::size_t> post_order;
+    std::vector<std::pair<std::size_t, std::size_t>> stack;
+    for (std::size_t root = 0; root < num_signals; ++root) {
+        if (state[root] != 0) {
+            continue;
+        }
+        state[root] = 1;
+        stack.emplace_back(root, 0);
+        while (!stack.empty()) {
+            const std::size_t node = stack.back().first;
+            const std::size_t next = stack.back().second++;
+            if (next < successors[node].size()) {
+                const std::size_t target = successors[node][next];
+                if (state[target] == 1) {
+                    successors[node][next] = cut;
+                    ++report.loops;
+                } else if (state[target] == 0) {
+                    state[target] = 1;
+                    stack.emplace_back(target, 0);
+                }
+            } else {
+                state[node] = 2;
+                post_order.push_back(node);
+                stack.pop_back();
+            }
+        }
+    }
+    std::vector<uint8_t> has_predecessor(num_signals, 0);
+    for (auto &targets : successors) {
+        targets.erase(std::remove(targets.begin(), targets.end(), cut), targets.end());
+        for (std::size_t target : targets) {
+            has_predecessor[target] = 1;
+        }
+    }
+    // The longest and the shortest delay from each signal to the end of a path, and its delta-cycle depth.
+    std::vector<discrete_time_t> longest(num_signals, 0);
+    std::vector<discrete_time_t> shortest(num_signals, 0);
+    std::vector<std::size_t> depth(num_signals, 0);
+    auto ends_here = [&](std::size_t node) { return is_end[node] || successors[node].empty(); };
+    for (std::size_t node : post_order) {
+        if (!ends_here(node)) {
+            shortest[node] = std::numeric_limits<discrete_time_t>::max();
+        }
+        for (std::size_t target : successors[node]) {
+            longest[node]  = std::max(longest[node], delays[target] + longest[target]);
+            shortest[node] = std::min(shortest[node], delays[target] + shortest[target]);
+            if (delays[target] == 0) {
+                depth[node] = std::max(depth[node], depth[target] + 1);
+            }
+        }
+    }
+    // Paths start from the signals nobody drives, except the clocks, which only wake up the sequential processes.
+    std::vector<std::size_t> starts;
+    for (std::size_t index = 0; index < num_signals; ++index) {
+        if (!has_predecessor[index] && !is_clock[index]) {
+            starts.push_back(index);
+        }
+    }
+    // Turns a chain of signals into a path.
+    auto make_path = [&](const std::vector<std::size_t> &chain) {
+        timing_path_t path;
+        for (std::size_t node : chain) {
+            path.signals.push_back(named[node].second);
+            path.delay += delays[node];
+            path.deltas += (delays[node] == 0) ? 1 : 0;
+        }
+        return path;
+    };
+    // Enumerate the longest paths, best first. The bound of a partial path is exact, thus, complete paths come out
+    // sorted by decreasing delay. Ties are broken in favour of the latest candidate, which goes depth-first.
+    struct candidate_t {
+        discrete_time_t bound; ///< The delay of the longest path completing this one.
+        std::size_t sequence;  ///< The order in which the candidate was found.
+        std::size_t prefix;    ///< The last signal of the path, in the prefix tree.
+        discrete_time_t delay; ///< The delay of the path so far.
+        bool complete;         ///< Whether the path ends here.
+    };
+    auto lower = [](const candidate_t &lhs, const candidate_t &rhs) {
+        return (lhs.bound < rhs.bound) || ((lhs.bound == rhs.bound) && (lhs.sequence < rhs.sequence));
+    };
+    std::priority_queue<candidate_t, std::vector<candidate_t>, decltype(lower)> candidates(lower);
+    // The prefix tree of the candidates, each entry holds its parent entry and its signal.
+    std::vector<std::pair<std::size_t, std::size_t>> prefixes;
+    std::size_t sequence = 0;
+    for (std::size_t start : starts) {
+        prefixes.emplace_back(cut, start);
+        candidates.push({delays[start] + longest[start], sequence++, prefixes.size() - 1, delays[start], false});
+    }
+    while (!candidates.empty() && (report.critical_paths.size() < top_k)) {
+        const candidate_t current = candidates.top();
+        candidates.pop();
+        if (current.complete) {
+            std::vector<std::size_t> chain;
+            for (std::size_t prefix = current.prefix; prefix != cut; prefix = prefixes[prefix].first) {
+                chain.push_back(prefixes[prefix].second);
+            }
+            std::reverse(chain.begin(), chain.end());
+            report.critical_paths.push_back(make_path(chain));
+            continue;
+        }
+        const std::size_t node = prefixes[current.prefix].second;
+        if (ends_here(node)) {
+            candidates.push({current.delay, sequence++, current.prefix, current.delay, true});
+        }
+        for (std::size_t target : successors[node]) {
+            prefixes.emplace_back(current.prefix, target);
+            const discrete_time_t delay = current.delay + delays[target];
+            candidates.push({delay + longest[target], sequence++, prefixes.size() - 1, delay, false});
+        }
+    }
+    // Follow the shortest path from the start closest to an end.
+    auto closest = std::min_element(starts.begin(), starts.end(), [&](std::size_t lhs, std::size_t rhs) {
+        return (delays[lhs] + shortest[lhs]) < (delays[rhs] + shortest[rhs]);
+    });
+    if (closest != starts.end()) {
+        std::vector<std::size_t> chain{*closest};
+        for (std::size_t node = *closest; !ends_here(node);) {
+            node = *std::find_if(successors[node].begin(), successors[node].end(), [&](std::size_t target) {
+                return (delays[target] + shortest[target]) == shortest[node];
+            });
+            chain.push_back(node);
+        }
+        report.shortest_path = make_path(chain);
+    }
+    // The delta-cycle depth of each clock, through the sequential processes it wakes up.
+    for (std::size_t index = 0; index < num_signals; ++index) {
+        if (!is_clock[index]) {
+            continue;
+        }
+        std::size_t clock_depth = 0;
+        for (const auto *targets : {&clocked[index], &successors[index]}) {
+            for (std::size_t target : *targets) {
+                if (delays[target] == 0) {
+                    clock_depth = std::max(clock_depth, depth[target] + 1);
+                }
+            }
+        }
+        report.delta_depth.emplace_back(named[index].second, clock_depth);
+    }
+    // The lookahead of each partition, from the signals it produces for the others.
+    const auto &partition_of = partitions.empty() ? process_domain : partitions;
+    auto get_partition       = [&](std::size_t id) { return (id < partition_of.size()) ? partition_of[id] : 0; };
+    std::size_t num_partitions = 1;
+    for (std::size_t partition : partition_of) {
+        num_partitions = std::max(num_partitions, partition + 1);
+    }
+    report.lookahead.assign(num_partitions, std::numeric_limits<discrete_time_t>::max());
+    for (const auto &[signal, producers] : producers_of) {
+        auto it = consumers_of.find(signal);
+        if (it == consumers_of.end()) {
+            continue;
+        }
+        for (const auto &producer : producers) {
+            const std::size_t source = get_partition(producer.id);
+            for (const auto &consumer : it->second) {
+                if (get_partition(consumer.id) != source) {
+                    report.lookahead[source] = std::min(report.lookahead[source], signal->get_delay());
+                }
+            }
+        }
+    }
+    return report;
+}
+
+void dependency_graph_t::print_timing_report(const timing_report_t &report) const
+{
+    auto print_path = [](const timing_path_t &path) {
+        for (const auto *signal : path.signals) {
+            digsim::info(
+                "dependency_graph_t", "  - {} [delay: {}]", get_signal_location_string(signal), signal->get_delay());
+        }
+    };
+    for (std::size_t index = 0; index < report.critical_paths.size(); ++index) {
+        const auto &path = report.critical_paths[index];
+        digsim::info(
+            "dependency_graph_t", "Critical path {}: delay {}, {} delta cycles", index, path.delay, path.deltas);
+        print_path(path);
+    }
+    digsim::info(
+        "dependency_graph_t", "Shortest path: delay {}, {} delta cycles", report.shortest_path.delay,
+        report.shortest_path.deltas);
+    print_path(report.shortest_path);
+    for (const auto &[clock, depth] : report.delta_depth) {
+        digsim::info("dependency_graph_t", "Delta-cycle depth of {}: {}", get_signal_location_string(clock), depth);
+    }
+    for (std::size_t index = 0; index < report.lookahead.size(); ++index) {
+        if (report.lookahead[index] == std::numeric_limits<discrete_time_t>::max()) {
+            digsim::info("dependency_graph_t", "Partition {}: no signals for the other partitions", index);
+        } else {
+            digsim::info("dependency_graph_t", "Partition {}: lookahead {}", index, report.lookahead[index]);
+        }
+    }
+    if (report.loops > 0) {
+        digsim::info("dependency_graph_t", "{} loops were cut", report.loops);
+    }
+}
+
+void dependency_graph_t::compute_clock_domains()
+{
+    constexpr std::size_t unassigned = std::numeric_limits<std::size_t>::max();
+
+    clock_domains.clear();
+    process_domain.assign(process_table.size(), unassigned);
+
+    // Resolve the producers and consumers of each signal.
+    std::unordered_map<const isignal_t *, std::vector<process_info_t>> producers_of;
+    std::unordered_map<const isignal_t *, std::vector<process_info_t>> consumers_of;
+    std::unordered_map<std::size_t, std::vector<const isignal_t *>> produced_by;
+    this->resolve_signals(producers_of, consumers_of);
+    for (const auto &[signal, producers] : producers_of) {
+        for (const auto &proc_info : producers) {
+            produced_by[proc_info.id].push_back(signal);
+        }
+    }
+
+    // Assigns a process to a domain, if it is not already assigned.
+    auto assign = [&](const process_info_t &proc_info, std::size_t domain) {
+        if ((proc_info.id >= process_domain.size()) || (process_domain[proc_info.id] != unassigned)) {
+            return false;
+        }
+        process_domain[proc_info.id] = domain;
+        clock_domains[domain].processes.push_back(proc_info);
+        return true;
+    };
+
+    // The first domain contains everything which is not driven by a clock.
+    clock_domains.emplace_back();
+
+    // Find the clocks, sorted by name so that the domain indices are stable.
+    std::vector<std::pair<const module_t *, const isignal_t *>> clocks;
+    for (const auto &[port, proc_info] : signal_producers) {
+        const auto *clock  = dynamic_cast<const clock_t *>(proc_info.owner.ptr);
+        const auto *signal = port->get_bound_signal();
+        if (clock && signal) {
+            clocks.emplace_back(clock, signal);
+        }
+    }
+    std::sort(clocks.begin(), clocks.end(), [](const auto &lhs, const auto &rhs) {
+        return lhs.first->get_name() < rhs.first->get_name();
+    });
+
+    // Each clock defines a domain, which contains the clock itself and the processes sensitive to it.
+    std::queue<process_info_t> frontier;
+    for (const auto &[clock, signal] : clocks) {
+        std::size_t domain = clock_domains.size();
+        clock_domains.emplace_back();
+        clock_domains[domain].clock  = signal;
+        clock_domains[domain].source = clock;
+        for (const auto &proc_info : producers_of[signal]) {
+            if (assign(proc_info, domain)) {
+                frontier.push(proc_info);
+            }
+        }
+        for (const auto &proc_info : consumers_of[signal]) {
+            if (assign(proc_info, domain)) {
+                frontier.push(proc_info);
+            }
+        }
+    }
+    // Combinational processes inherit the domain of the processes feeding them.
+    while (!frontier.empty()) {
+        process_info_t current = frontier.front();
+        frontier.pop();
+        for (const auto *signal : produced_by[current.id]) {
+            for (const auto &consumer : consumers_of[signal]) {
+                if (assign(consumer, process_domain[current.id])) {
+                    frontier.push(consumer);
+                }
+            }
+        }
+    }
+    // Processes owned by signals (e.g., delayed updates) run in the domain of the signal producer.
+    for (std::size_t id = 0; id < process_domain.size(); ++id) {
+        const auto &proc_info = process_table.get(id);
+        if (process_domain[id] != unassigned) {
+            continue;
+        }
+        std::size_t domain = 0;
+        if (const auto *signal = dynamic_cast<const isignal_t *>(proc_info.owner.ptr)) {
+            auto it = producers_of.find(signal);
+            if ((it != producers_of.end()) && (process_domain[it->second.front().id] != unassigned)) {
+                domain = process_domain[it->second.front().id];
+            }
+        }
+        assign(proc_info, domain);
+    }
+
+    this->mark_crossings(producers_of, consumers_of);
+}
+
+void dependency_graph_t::restore_clock_domains(const std::vector<std::size_t> &domains)
+{
+    std::unordered_map<const isignal_t *, std::vector<process_info_t>> producers_of;
+    std::unordered_map<const isignal_t *, std::vector<process_info_t>> consumers_of;
+    this->resolve_signals(producers_of, consumers_of);
+
+    process_domain = domains;
+    process_domain.resize(process_table.size(), 0);
+    std::size_t count = 1;
+    for (std::size_t domain : process_domain) {
+        count = std::max(count, domain + 1);
+    }
+    clock_domains.assign(count, clock_domain_t{});
+    for (std::size_t id = 0; id < process_domain.size(); ++id) {
+        clock_domains[process_domain[id]].processes.push_back(process_table.get(id));
+    }
+    // Each clock is in the domain it defines.
+    for (const auto &[port, proc_info] : signal_producers) {
+        const auto *clock  = dynamic_cast<const clock_t *>(proc_info.owner.ptr);
+        const auto *signal = port->get_bound_signal();
+        if (clock && signal) {
+            clock_domains[this->get_clock_domain(proc_info)].clock  = signal;
+            clock_domains[this->get_clock_domain(proc_info)].source = clock;
+        }
+    }
+    this->mark_crossings(producers_of, consumers_of);
+}
+
+std::uint64_t dependency_graph_t::compute_fingerprint() const
+{
+    // Describe the design with strings that do not depend on memory layout, then sort them.
+    std::vector<std::string> entries;
+    for (std::size_t id = 0; id < process_table.size(); ++id) {
+        const auto &proc_info = process_table.get(id);
+        std::string owner     = proc_info.owner.name();
+        if (const auto *module = dynamic_cast<const module_t *>(proc_info.owner.ptr)) {
+            for (module = module->get_parent(); module; module = module->get_parent()) {
+                owner = module->get_name() + "::" + owner;
+            }
+        }
+        entries.push_back("process " + std::to_string(id) + " " + owner + "." + proc_info.name);
+    }
+    // Describe each port without its signal first, sorted, so that the signals can be numbered by first appearance.
+    // Two ports bound to the same signal thus differ from two ports bound to distinct signals with the same name.
+    std::vector<std::pair<std::string, const isignal_t *>> ports;
+    for (const auto &[port, proc_info] : signal_producers) {
+        ports.emplace_back(
+            "producer " + get_signal_location_string(port) + " " + std::to_string(proc_info.id),
+            port->get_bound_signal());
+    }
+    for (const auto &[port, consumer_list] : signal_consumers) {
+        for (const auto &proc_info : consumer_list) {
+            ports.emplace_back(
+                "consumer " + get_signal_location_string(port) + " " + std::to_string(proc_info.id),
+                port->get_bound_signal());
+        }
+    }
+    std::sort(ports.begin(), ports.end(), [](const auto &lhs, const auto &rhs) { return lhs.first < rhs.first; });
+    std::unordered_map<const isignal_t *, std::size_t> signal_index;
+    for (const auto &[entry, signal] : ports) {
+        if (!signal) {
+            entries.push_back(entry + " ");
+            continue;
+        }
+        auto it = signal_index.emplace(signal, signal_index.size()).first;
+        entries.push_back(
+            entry + " " + signal->get_name() + "#" + std::to_string(it->second) + " " + signal->get_type_name() + " " +
+            std::to_string(signal->get_delay()));
+    }
+    std::sort(entries.begin(), entries.end());
+    // FNV-1a, which is fully specified, thus, stable across runs and platforms.
+    std::uint64_t hash = 14695981039346656037ULL;
+    for (const auto &entry : entries) {
+        for (char c : entry) {
+            hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ULL;
+        }
+        hash = (hash ^ static_cast<unsigned char>('\n')) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+void dependency_graph_t::resolve_signals(
+    std::unordered_map<const isignal_t *, std::vector<process_info_t>> &producers_of,
+    std::unordered_map<const isignal_t *, std::vector<process_info_t>> &consumers_of) const
+{
+    for (const auto &[port, proc_info] : signal_producers) {
+        if (const auto *signal = port->get_bound_signal()) {
+            producers_of[signal].push_back(proc_info);
+            const_cast<isignal_t *>(signal)->set_crossing(false);
+        }
+    }
+    for (const auto &[port, consumer_list] : signal_consumers) {
+        if (const auto *signal = port->get_bound_signal()) {
+            auto &consumers = consumers_of[signal];
+            consumers.insert(consumers.end(), consumer_list.begin(), consumer_list.end());
+        }
+    }
+    // Sort by id, so that the assignment does not depend on memory layout.
+    for (auto &[signal, producers] : producers_of) {
+        std::sort(producers.begin(), producers.end(), [](const process_info_t &lhs, const process_info_t &rhs) {
+            return lhs.id < rhs.id;
+        });
+    }
+    for (auto &[signal, consumers] : consumers_of) {
+        std::sort(consumers.begin(), consumers.end(), [](const process_info_t &lhs, const process_info_t &rhs) {
+            return lhs.id < rhs.id;
+        });
+    }
+}
+
+void dependency_graph_t::mark_crossings(
+    const std::unordered_map<const isignal_t *, std::vector<process_info_t>> &producers_of,
+    const std::unordered_map<const isignal_t *, std::vector<process_info_t>> &consumers_of)
+{
+    for (const auto &[signal, producers] : producers_of) {
+        // The signal crosses into the domain of each of its producers and consumers that is not the domain of all
+        // its producers, since a write from another domain may then run concurrently with the access.
+        std::vector<std::size_t> sources;
+        for (const auto &producer : producers) {
+            std::size_t source = this->get_clock_domain(producer);
+            if (std::find(sources.begin(), sources.end(), source) == sources.end()) {
+                sources.push_back(source);
+            }
+        }
+        std::vector<process_info_t> accessors = producers;
+        if (auto it = consumers_of.find(signal); it != consumers_of.end()) {
+            accessors.insert(accessors.end(), it->second.begin(), it->second.end());
+        }
+        for (const auto &accessor : accessors) {
+            std::size_t target = this->get_clock_domain(accessor);
+            if ((sources.size() == 1) && (sources.front() == target)) {
+                continue;
+            }
+            auto &domain = clock_domains[target];
+            if (std::find(domain.crossings.begin(), domain.crossings.end(), signal) == domain.crossings.end()) {
+                domain.lookahead = domain.crossings.empty() ? signal->get_delay()
+                                                            : std::min(domain.lookahead, signal->get_delay());
+                domain.crossings.push_back(signal);
+            }
+            const_cast<isignal_t *>(signal)->set_crossing(true);
+        }
+    }
+}
+
+const std::vector<clock_domain_t> &dependency_graph_t::get_clock_domains() const { return clock_domains; }
+
+std::size_t dependency_graph_t::get_clock_domain(const process_info_t &proc_info) const
+{
+    return (proc_info.id < process_domain.size()) ? process_domain[proc_info.id] : 0;
+}
+
+void dependency_graph_t::print_clock_domain_report() const
+{
+    for (std::size_t index = 0; index < clock_domains.size(); ++index) {
+        const auto &domain = clock_domains[index];
+        if (domain.source) {
+            digsim::debug(
+                "dependency_graph_t", "Clock domain {} [{}]: {} processes, {} crossings, lookahead {}", index,
+                domain.source->get_name(), domain.processes.size(), domain.crossings.size(), domain.lookahead);
+        } else {
+            digsim::debug(
+                "dependency_graph_t", "Clock domain {} [default]: {} processes, {} crossings, lookahead {}", index,
+                domain.processes.size(), domain.crossings.size(), domain.lookahead);
+        }
+        for (const auto *signal : domain.crossings) {
+            digsim::debug("dependency_graph_t", "  - {} [delay: {}]", signal->get_name(), signal->get_delay());
+        }
+    }
+}
+
 inline std::string dependency_graph_t::random_id(size_t length) const
 {
     static const char charset[] = "0123456789abcdef";
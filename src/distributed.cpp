@@ -0,0 +1,875 @@
+/// @file distributed.cpp
+/// @brief Implementation of the distributed simulation.
+/// @copyright
+/// This file is distributed under the terms of the MIT License.
+/// See the full license in the root directory at LICENSE.md.
+
+#include "digsim/distributed.hpp"
+
+#include "digsim/logger.hpp"
+#include "digsim/scheduler.hpp"
+#include "digsim/state_log.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <limits>
+#include <set>
+#include <stdexcept>
+#include <thread>
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace digsim
+{
+
+namespace
+{
+
+/// @brief The kinds of messages exchanged by the peers, the first byte of each frame.
+enum : char {
+    hello_message   = 'H', ///< The lookahead of the sender, and the names of the signals it sends.
+    update_message  = 'U', ///< A value of a signal, with the time it is applied.
+    promise_message = 'P', ///< The time before which the sender sends no more values.
+    anti_message    = 'A', ///< Cancels a value sent before, by an optimistic sender.
+    report_message  = 'R', ///< How far an optimistic sender got, and how many messages it received.
+};
+
+/// @brief The number of time steps executed ahead between two reports, so that the peers can drop what is committed.
+constexpr std::size_t report_interval = 16;
+
+/// @brief The state of the simulation before a time step executed optimistically.
+struct checkpoint_t {
+    discrete_time_t step;        ///< The time of the step.
+    scheduler_state_t scheduler; ///< The time and the pending events before the step.
+    std::size_t log_position;    ///< The position of the state log before the step.
+};
+
+/// @brief Records the changes in the state log while the optimistic simulation runs, and disables it however the
+/// simulation returns, i.e., at the end, on a stop request, or with an exception.
+struct state_log_guard_t {
+    /// @brief Constructor, enables the state log.
+    state_log_guard_t() { digsim::state_log.enable(); }
+    /// @brief Destructor, disables and clears the state log.
+    ~state_log_guard_t() { digsim::state_log.enable(false); }
+};
+
+/// @brief Throws an exception describing the last error of a system call.
+/// @param what what was being done.
+[[noreturn]] void throw_system_error(const std::string &what)
+{
+    throw std::runtime_error(what + ": " + std::strerror(errno));
+}
+
+/// @brief Appends an integer to a frame, least significant byte first, so that the hosts can differ.
+/// @param frame the frame.
+/// @param value the value.
+/// @param bytes the number of bytes.
+void put(std::string &frame, std::uint64_t value, std::size_t bytes = 8)
+{
+    for (std::size_t index = 0; index < bytes; ++index) {
+        frame.push_back(static_cast<char>((value >> (8 * index)) & 0xffU));
+    }
+}
+
+/// @brief Reads an integer from a frame, see put().
+/// @param frame the frame.
+/// @param offset the position of the integer, moved past it.
+/// @param bytes the number of bytes.
+/// @return the value.
+std::uint64_t get(const std::string &frame, std::size_t &offset, std::size_t bytes = 8)
+{
+    if (offset + bytes > frame.size()) {
+        throw std::runtime_error("Truncated message from a peer.");
+    }
+    std::uint64_t value = 0;
+    for (std::size_t index = 0; index < bytes; ++index) {
+        value |= static_cast<std::uint64_t>(static_cast<unsigned char>(frame[offset++])) << (8 * index);
+    }
+    return value;
+}
+
+/// @brief Adds two times, without overflowing.
+/// @param time the time.
+/// @param delay the delay.
+/// @return the sum, or the largest time.
+discrete_time_t saturating_add(discrete_time_t time, discrete_time_t delay)
+{
+    return (time > std::numeric_limits<discrete_time_t>::max() - delay) ? std::numeric_limits<discrete_time_t>::max()
+                                                                         : time + delay;
+}
+
+/// @brief Tries to connect a socket until the other side listens, or the timeout expires.
+/// @param connect_once creates a socket and connects it, returns -1 on failure.
+/// @param timeout_ms the timeout, in milliseconds.
+/// @param what what is being connected, for the error message.
+/// @return the connected socket.
+template <typename Connect> int connect_with_retry(Connect &&connect_once, unsigned timeout_ms, const std::string &what)
+{
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (true) {
+        const int fd = connect_once();
+        if (fd >= 0) {
+            return fd;
+        }
+        if (std::chrono::steady_clock::now() >= deadline) {
+            throw_system_error("Cannot connect to " + what);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+}
+
+/// @brief Fills the address of a Unix-domain socket.
+/// @param path the path of the socket.
+/// @return the address.
+sockaddr_un unix_address(const std::string &path)
+{
+    sockaddr_un address{};
+    if (path.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error("The path of the socket is too long: " + path);
+    }
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    return address;
+}
+
+/// @brief Disables the coalescing of small packets, the peers exchange many short messages.
+/// @param fd the socket.
+void set_no_delay(int fd)
+{
+    int enable = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+}
+
+} // namespace
+
+channel_t::channel_t()
+    : fd(-1)
+    , input()
+    , input_offset(0)
+{
+    // Nothing to do here.
+}
+
+channel_t::channel_t(int _fd)
+    : fd(_fd)
+    , input()
+    , input_offset(0)
+{
+    // Nothing to do here.
+}
+
+channel_t::~channel_t()
+{
+    if (fd >= 0) {
+        close(fd);
+    }
+}
+
+channel_t::channel_t(channel_t &&other) noexcept
+    : fd(std::exchange(other.fd, -1))
+    , input(std::move(other.input))
+    , input_offset(std::exchange(other.input_offset, 0))
+{
+    // Nothing to do here.
+}
+
+channel_t &channel_t::operator=(channel_t &&other) noexcept
+{
+    if (this != &other) {
+        if (fd >= 0) {
+            close(fd);
+        }
+        fd           = std::exchange(other.fd, -1);
+        input        = std::move(other.input);
+        input_offset = std::exchange(other.input_offset, 0);
+    }
+    return *this;
+}
+
+std::pair<channel_t, channel_t> channel_t::make_pair()
+{
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+        throw_system_error("Cannot create a pair of sockets");
+    }
+    return {channel_t(fds[0]), channel_t(fds[1])};
+}
+
+channel_t channel_t::listen_unix(const std::string &path)
+{
+    const sockaddr_un address = unix_address(path);
+    const int listener        = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0) {
+        throw_system_error("Cannot create a socket");
+    }
+    unlink(path.c_str());
+    if ((bind(listener, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0) ||
+        (listen(listener, 1) != 0)) {
+        close(listener);
+        throw_system_error("Cannot listen on " + path);
+    }
+    const int connected = accept(listener, nullptr, nullptr);
+    close(listener);
+    unlink(path.c_str());
+    if (connected < 0) {
+        throw_system_error("Cannot accept a connection on " + path);
+    }
+    return channel_t(connected);
+}
+
+channel_t channel_t::connect_unix(const std::string &path, unsigned timeout_ms)
+{
+    const sockaddr_un address = unix_address(path);
+    return channel_t(connect_with_retry(
+        [&address]() {
+            const int candidate = socket(AF_UNIX, SOCK_STREAM, 0);
+            if ((candidate >= 0) &&
+                (connect(candidate, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0)) {
+                close(candidate);
+                return -1;
+            }
+            return candidate;
+        },
+        timeout_ms, path));
+}
+
+channel_t channel_t::listen_tcp(std::uint16_t port)
+{
+    const int listener = socket(AF_INET, SOCK_STREAM, 0);
+    if (listener < 0) {
+        throw_system_error("Cannot create a socket");
+    }
+    int reuse = 1;
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    sockaddr_in address{};
+    address.sin_family      = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port        = htons(port);
+    if ((bind(listener, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0) ||
+        (listen(listener, 1) != 0)) {
+        close(listener);
+        throw_system_error("Cannot listen on port " + std::to_string(port));
+    }
+    const int connected = accept(listener, nullptr, nullptr);
+    close(listener);
+    if (connected < 0) {
+        throw_system_error("Cannot accept a connection on port " + std::to_string(port));
+    }
+    set_no_delay(connected);
+    return channel_t(connected);
+}
+
+channel_t channel_t::connect_tcp(const std::string &host, std::uint16_t port, unsigned timeout_ms)
+{
+    addrinfo hints{};
+    hints.ai_family   = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo *addresses = nullptr;
+    if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &addresses) != 0) {
+        throw std::runtime_error("Cannot resolve " + host);
+    }
+    const int connected = connect_with_retry(
+        [addresses]() {
+            for (const addrinfo *address = addresses; address; address = address->ai_next) {
+                const int candidate = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+                if (candidate < 0) {
+                    continue;
+                }
+                if (connect(candidate, address->ai_addr, address->ai_addrlen) == 0) {
+                    return candidate;
+                }
+                close(candidate);
+            }
+            return -1;
+        },
+        timeout_ms, host + ":" + std::to_string(port));
+    freeaddrinfo(addresses);
+    set_no_delay(connected);
+    return channel_t(connected);
+}
+
+void channel_t::send(const std::string &frame) { this->send(std::vector<std::string>{frame}); }
+
+void channel_t::send(const std::vector<std::string> &frames)
+{
+    // The frames go out together, with as few system calls as possible.
+    std::string data;
+    for (const auto &frame : frames) {
+        put(data, frame.size(), 4);
+        data += frame;
+    }
+    for (std::size_t sent = 0; sent < data.size();) {
+        const auto count = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (count >= 0) {
+            sent += static_cast<std::size_t>(count);
+            continue;
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        // The other side is gone, e.g., it reached the end of the simulation first: nobody needs the frames.
+        if ((errno == EPIPE) || (errno == ECONNRESET)) {
+            return;
+        }
+        if ((errno != EAGAIN) && (errno != EWOULDBLOCK)) {
+            throw_system_error("Cannot send to a peer");
+        }
+        // The socket is full. The other side might be sending as well, and waiting for this one to make room in turn:
+        // keep receiving while waiting, so that neither side blocks the other.
+        pollfd event{fd, POLLIN | POLLOUT, 0};
+        if (::poll(&event, 1, -1) < 0) {
+            if (errno != EINTR) {
+                throw_system_error("Cannot wait for a peer");
+            }
+            continue;
+        }
+        if (((event.revents & POLLIN) != 0) && !this->buffer_input()) {
+            return;
+        }
+    }
+}
+
+bool channel_t::buffer_input()
+{
+    char buffer[65536];
+    while (true) {
+        const auto count = ::recv(fd, buffer, sizeof(buffer), MSG_DONTWAIT);
+        if (count > 0) {
+            input.append(buffer, static_cast<std::size_t>(count));
+            return true;
+        }
+        if (count == 0) {
+            return false;
+        }
+        if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
+            return true;
+        }
+        if (errno != EINTR) {
+            throw_system_error("Cannot receive from a peer");
+        }
+    }
+}
+
+bool channel_t::receive(std::string &frame)
+{
+    // Reads exactly the given number of bytes, the ones received while sending first, returns false at the end of
+    // the stream.
+    auto read_exactly = [this](char *buffer, std::size_t size) {
+        const std::size_t buffered = std::min(size, input.size() - input_offset);
+        std::memcpy(buffer, input.data() + input_offset, buffered);
+        input_offset += buffered;
+        if (input_offset == input.size()) {
+            input.clear();
+            input_offset = 0;
+        }
+        for (std::size_t done = buffered; done < size;) {
+            const auto count = ::recv(fd, buffer + done, size - done, 0);
+            if (count == 0) {
+                return false;
+            }
+            if (count < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw_system_error("Cannot receive from a peer");
+            }
+            done += static_cast<std::size_t>(count);
+        }
+        return true;
+    };
+    std::string header(4, '\0');
+    if (!read_exactly(header.data(), header.size())) {
+        return false;
+    }
+    std::size_t offset = 0;
+    frame.resize(static_cast<std::size_t>(get(header, offset, 4)));
+    return read_exactly(frame.data(), frame.size());
+}
+
+std::size_t channel_t::wait_any(const std::vector<const channel_t *> &channels, int timeout_ms)
+{
+    // The bytes received while sending are ready right away.
+    for (std::size_t index = 0; index < channels.size(); ++index) {
+        if (channels[index]->input_offset < channels[index]->input.size()) {
+            return index;
+        }
+    }
+    std::vector<pollfd> fds;
+    fds.reserve(channels.size());
+    for (const auto *channel : channels) {
+        fds.push_back(pollfd{channel->fd, POLLIN, 0});
+    }
+    while (::poll(fds.data(), static_cast<nfds_t>(fds.size()), timeout_ms) < 0) {
+        if (errno != EINTR) {
+            throw_system_error("Cannot wait for the peers");
+        }
+    }
+    for (std::size_t index = 0; index < fds.size(); ++index) {
+        if (fds[index].revents != 0) {
+            return index;
+        }
+    }
+    return channels.size();
+}
+
+peer_t::peer_t(const std::string &_name, channel_t _channel, discrete_time_t _lookahead)
+    : named_object_t(_name)
+    , channel(std::move(_channel))
+    , lookahead(_lookahead)
+    , sent_names()
+    , unwatchers()
+    , received()
+    , remote_to_local()
+    , outgoing()
+    , outgoing_mutex()
+    , incoming()
+    , promised(0)
+    , safe_time(0)
+    , connected(false)
+    , messages_sent(0)
+    , optimistic(false)
+    , sent()
+    , sent_count(0)
+    , received_count(0)
+    , in_flight()
+    , remote_floor(0)
+    , last_report(0, 0)
+    , closed(false)
+    , rollbacks(0)
+    , anti_messages(0)
+    , apply_process(digsim::get_or_create_process(this, &peer_t::apply, "apply"))
+{
+    if (lookahead == 0) {
+        throw std::runtime_error("The lookahead of peer `" + _name + "` must be at least 1.");
+    }
+}
+
+peer_t::~peer_t()
+{
+    // The signals might be written after the peer is gone.
+    for (const auto &unwatch : unwatchers) {
+        unwatch();
+    }
+}
+
+void peer_t::handshake()
+{
+    std::string frame(1, hello_message);
+    put(frame, lookahead);
+    put(frame, sent_names.size(), 4);
+    for (const auto &signal_name : sent_names) {
+        put(frame, signal_name.size(), 4);
+        frame += signal_name;
+    }
+    channel.send(frame);
+    if (!channel.receive(frame) || frame.empty() || (frame[0] != hello_message)) {
+        throw std::runtime_error("Peer `" + get_name() + "` did not introduce itself.");
+    }
+    std::size_t offset = 1;
+    // Nothing can arrive before the lookahead of the other process.
+    safe_time                = get(frame, offset);
+    const std::size_t count  = static_cast<std::size_t>(get(frame, offset, 4));
+    std::vector<bool> routed = std::vector<bool>(received.size(), false);
+    for (std::size_t index = 0; index < count; ++index) {
+        const std::size_t length = static_cast<std::size_t>(get(frame, offset, 4));
+        if (offset + length > frame.size()) {
+            throw std::runtime_error("Truncated message from peer `" + get_name() + "`.");
+        }
+        const std::string signal_name = frame.substr(offset, length);
+        offset += length;
+        auto it = std::find_if(received.begin(), received.end(), [&signal_name](const auto &entry) {
+            return entry.first == signal_name;
+        });
+        if (it == received.end()) {
+            throw std::runtime_error(
+                "Peer `" + get_name() + "` sends signal `" + signal_name + "`, which is not received.");
+        }
+        remote_to_local.push_back(static_cast<std::size_t>(it - received.begin()));
+        routed[remote_to_local.back()] = true;
+    }
+    for (std::size_t index = 0; index < received.size(); ++index) {
+        if (!routed[index]) {
+            throw std::runtime_error("Peer `" + get_name() + "` does not send signal `" + received[index].first + "`.");
+        }
+    }
+    connected = true;
+    digsim::debug(
+        "peer_t", "Connected to `{}`: {} signal(s) sent, {} received, lookahead {}", get_name(), sent_names.size(),
+        received.size(), lookahead);
+}
+
+void peer_t::flush()
+{
+    std::vector<update_t> updates;
+    {
+        std::lock_guard<std::mutex> lock(outgoing_mutex);
+        updates.swap(outgoing);
+    }
+    if (updates.empty()) {
+        return;
+    }
+    std::vector<std::string> frames;
+    frames.reserve(updates.size());
+    for (const auto &update : updates) {
+        std::string frame(1, update_message);
+        put(frame, update.time);
+        put(frame, update.index, 4);
+        put(frame, update.bits);
+        frames.push_back(std::move(frame));
+        // Keep the value, until it can no longer be cancelled.
+        if (optimistic) {
+            sent.push_back(update);
+            in_flight.emplace_back(++sent_count, update.time);
+        }
+    }
+    channel.send(frames);
+    messages_sent += updates.size();
+}
+
+void peer_t::cancel(discrete_time_t step)
+{
+    // The values of the undone steps are the last ones sent.
+    std::vector<std::string> frames;
+    while (!sent.empty() && (sent.back().time >= saturating_add(step, lookahead))) {
+        const auto &update = sent.back();
+        std::string frame(1, anti_message);
+        put(frame, update.time);
+        put(frame, update.index, 4);
+        put(frame, update.bits);
+        frames.push_back(std::move(frame));
+        in_flight.emplace_back(++sent_count, update.time);
+        sent.pop_back();
+    }
+    if (frames.empty()) {
+        return;
+    }
+    channel.send(frames);
+    messages_sent += frames.size();
+    anti_messages += frames.size();
+}
+
+void peer_t::report(discrete_time_t floor)
+{
+    if (last_report == std::make_pair(floor, received_count)) {
+        return;
+    }
+    last_report = std::make_pair(floor, received_count);
+    std::string frame(1, report_message);
+    put(frame, floor);
+    put(frame, received_count);
+    channel.send(frame);
+    ++messages_sent;
+}
+
+discrete_time_t peer_t::unacknowledged() const
+{
+    discrete_time_t time = std::numeric_limits<discrete_time_t>::max();
+    for (const auto &entry : in_flight) {
+        time = std::min(time, entry.second);
+    }
+    return time;
+}
+
+void peer_t::commit(discrete_time_t time)
+{
+    while (!sent.empty() && (sent.front().time < saturating_add(time, lookahead))) {
+        sent.pop_front();
+    }
+    incoming.erase(incoming.begin(), incoming.lower_bound(time));
+}
+
+char peer_t::read(update_t &update)
+{
+    std::string frame;
+    if (!channel.receive(frame)) {
+        return 0;
+    }
+    if (frame.empty()) {
+        throw std::runtime_error("Peer `" + get_name() + "` sent an empty message.");
+    }
+    std::size_t offset = 1;
+    if (frame[0] == report_message) {
+        remote_floor                  = get(frame, offset);
+        const std::uint64_t delivered = get(frame, offset);
+        while (!in_flight.empty() && (in_flight.front().first <= delivered)) {
+            in_flight.pop_front();
+        }
+    } else if ((frame[0] == update_message) || (frame[0] == anti_message)) {
+        update.time = get(frame, offset);
+        update.index = static_cast<std::size_t>(get(frame, offset, 4));
+        update.bits  = get(frame, offset);
+        if (update.index >= remote_to_local.size()) {
+            throw std::runtime_error("Peer `" + get_name() + "` sent an invalid value.");
+        }
+        update.index = remote_to_local[update.index];
+        ++received_count;
+    } else {
+        throw std::runtime_error("Peer `" + get_name() + "` sent an unknown message.");
+    }
+    return frame[0];
+}
+
+void peer_t::promise(discrete_time_t time)
+{
+    if (time <= promised) {
+        return;
+    }
+    promised = time;
+    std::string frame(1, promise_message);
+    put(frame, time);
+    channel.send(frame);
+    ++messages_sent;
+}
+
+void peer_t::receive()
+{
+    std::string frame;
+    if (!channel.receive(frame) || frame.empty()) {
+        throw std::runtime_error("Peer `" + get_name() + "` disconnected.");
+    }
+    std::size_t offset = 1;
+    if (frame[0] == promise_message) {
+        safe_time = std::max(safe_time, get(frame, offset));
+    } else if (frame[0] == update_message) {
+        const discrete_time_t time = get(frame, offset);
+        const auto index           = static_cast<std::size_t>(get(frame, offset, 4));
+        const std::uint64_t bits   = get(frame, offset);
+        if ((index >= remote_to_local.size()) || (time < safe_time)) {
+            throw std::runtime_error("Peer `" + get_name() + "` sent an invalid value.");
+        }
+        incoming.emplace(time, std::make_pair(remote_to_local[index], bits));
+        digsim::scheduler.schedule_after(apply_process, time - digsim::scheduler.time());
+    } else {
+        throw std::runtime_error("Peer `" + get_name() + "` sent an unknown message.");
+    }
+}
+
+void peer_t::apply()
+{
+    // Values received for the same time are applied in the order they were sent.
+    const auto [first, last] = incoming.equal_range(digsim::scheduler.time());
+    for (auto it = first; it != last; ++it) {
+        received[it->second.first].second(it->second.second);
+    }
+    // An optimistic simulation keeps them, the time step might be executed again.
+    if (!optimistic) {
+        incoming.erase(first, last);
+    }
+}
+
+void peer_t::schedule_incoming(discrete_time_t time, const scheduler_state_t &restored)
+{
+    // The values which arrived before the copy was taken are already applied by the events it holds.
+    std::set<discrete_time_t> scheduled;
+    for (const auto &event : restored.events) {
+        if (event.process_info == apply_process) {
+            scheduled.insert(event.time);
+        }
+    }
+    for (auto it = incoming.lower_bound(time); it != incoming.end(); it = incoming.upper_bound(it->first)) {
+        if (scheduled.count(it->first) == 0) {
+            digsim::scheduler.schedule_after(apply_process, it->first - digsim::scheduler.time());
+        }
+    }
+}
+
+void run_distributed(const std::vector<peer_t *> &peers, discrete_time_t end_time)
+{
+    if (!digsim::scheduler.is_initialized()) {
+        digsim::scheduler.initialize();
+    }
+    for (auto *peer : peers) {
+        if (!peer->connected) {
+            peer->handshake();
+        }
+    }
+    while (true) {
+        // Nothing can be received before the safe time.
+        discrete_time_t safe_time = std::numeric_limits<discrete_time_t>::max();
+        for (const auto *peer : peers) {
+            safe_time = std::min(safe_time, peer->safe_time);
+        }
+        const discrete_time_t next_time = digsim::scheduler.next_event_time();
+        if ((next_time < safe_time) && (next_time <= end_time)) {
+            digsim::scheduler.run_until(std::min(safe_time - 1, end_time));
+            if (digsim::scheduler.stopped()) {
+                break;
+            }
+            continue;
+        }
+        // The next values sent by this process, if any, change at the next local event or at the next value received.
+        for (auto *peer : peers) {
+            peer->flush();
+            peer->promise(saturating_add(std::min(next_time, safe_time), peer->lookahead));
+        }
+        if ((next_time > end_time) && (safe_time > end_time)) {
+            break;
+        }
+        // Wait for the peer holding back the simulation.
+        auto *slowest = *std::min_element(peers.begin(), peers.end(), [](const peer_t *lhs, const peer_t *rhs) {
+            return lhs->safe_time < rhs->safe_time;
+        });
+        slowest->receive();
+    }
+    // Tell the peers how far this process got also when the scheduler was stopped, they might be waiting for it.
+    discrete_time_t safe_time = std::numeric_limits<discrete_time_t>::max();
+    for (const auto *peer : peers) {
+        safe_time = std::min(safe_time, peer->safe_time);
+    }
+    const discrete_time_t next_time = digsim::scheduler.next_event_time();
+    for (auto *peer : peers) {
+        peer->flush();
+        peer->promise(saturating_add(std::min(next_time, safe_time), peer->lookahead));
+    }
+}
+
+void run_optimistic(const std::vector<peer_t *> &peers, discrete_time_t end_time, discrete_time_t window)
+{
+    // The GVT combines reports taken at different moments, which is only safe when there is a single other process.
+    if (peers.size() > 1) {
+        throw std::runtime_error("The optimistic simulation supports two processes only, i.e., a single peer.");
+    }
+    if (!digsim::scheduler.is_initialized()) {
+        digsim::scheduler.initialize();
+    }
+    for (auto *peer : peers) {
+        if (!peer->connected) {
+            peer->handshake();
+        }
+        peer->optimistic = true;
+        // Send the values set by the initialization, there might be no time step to execute.
+        peer->flush();
+    }
+    const state_log_guard_t guard;
+    std::deque<checkpoint_t> checkpoints;
+    // The earliest time this process might still execute, or send a value for.
+    auto local_floor = [&peers]() {
+        discrete_time_t floor = digsim::scheduler.next_event_time();
+        for (const auto *peer : peers) {
+            floor = std::min(floor, peer->unacknowledged());
+        }
+        return floor;
+    };
+    // Undoes the time steps from the given time on, returns false if the copy taken before them was already dropped.
+    auto roll_back = [&peers, &checkpoints](discrete_time_t time) {
+        auto it = std::find_if(checkpoints.begin(), checkpoints.end(), [time](const checkpoint_t &checkpoint) {
+            return checkpoint.step >= time;
+        });
+        // The copy must be taken before the time, otherwise the steps from the time on are committed.
+        if ((it == checkpoints.end()) || (it->scheduler.time >= time)) {
+            return false;
+        }
+        const discrete_time_t step = it->step;
+        digsim::debug("peer_t", "Rolling back from time {} to time {}", digsim::scheduler.time(), it->scheduler.time);
+        digsim::state_log.rollback(it->log_position);
+        digsim::scheduler.restore_state(it->scheduler);
+        for (auto *peer : peers) {
+            peer->cancel(step);
+            // The values received after the copy was taken must be applied again.
+            peer->schedule_incoming(step, it->scheduler);
+        }
+        checkpoints.erase(it, checkpoints.end());
+        return true;
+    };
+    // Handles a message, going back in time if it concerns a time step already executed.
+    auto handle = [&roll_back](peer_t *peer) {
+        peer_t::update_t update{};
+        const char kind = peer->read(update);
+        if (kind == 0) {
+            peer->closed = true;
+            return;
+        }
+        if ((kind != update_message) && (kind != anti_message)) {
+            return;
+        }
+        if (update.time <= digsim::scheduler.time()) {
+            if (!roll_back(update.time)) {
+                throw std::runtime_error("Peer `" + peer->get_name() + "` sent a value for a committed time.");
+            }
+            ++peer->rollbacks;
+        }
+        if (kind == update_message) {
+            peer->incoming.emplace(update.time, std::make_pair(update.index, update.bits));
+            digsim::scheduler.schedule_after(peer->apply_process, update.time - digsim::scheduler.time());
+            return;
+        }
+        const auto [first, last] = peer->incoming.equal_range(update.time);
+        auto it                  = std::find_if(first, last, [&update](const auto &entry) {
+            return entry.second == std::make_pair(update.index, update.bits);
+        });
+        if (it == last) {
+            throw std::runtime_error("Peer `" + peer->get_name() + "` cancelled a value it never sent.");
+        }
+        peer->incoming.erase(it);
+    };
+    std::size_t steps = 0;
+    while (true) {
+        // Handle what arrived so far, without waiting.
+        for (auto *peer : peers) {
+            while (!peer->closed && (channel_t::wait_any({&peer->channel}, 0) == 0)) {
+                handle(peer);
+            }
+        }
+        // Drop what can no longer be undone.
+        const discrete_time_t floor = local_floor();
+        discrete_time_t gvt         = floor;
+        for (const auto *peer : peers) {
+            gvt = std::min(gvt, peer->remote_floor);
+        }
+        while (!checkpoints.empty() && (checkpoints.front().step < gvt)) {
+            checkpoints.pop_front();
+        }
+        digsim::state_log.forget(
+            checkpoints.empty() ? std::numeric_limits<std::size_t>::max() : checkpoints.front().log_position);
+        for (auto *peer : peers) {
+            peer->commit(gvt);
+        }
+        if (gvt > end_time) {
+            break;
+        }
+        // Execute the next time step, unless it is too far ahead.
+        const discrete_time_t next_time = digsim::scheduler.next_event_time();
+        if ((next_time <= end_time) && ((window == 0) || (next_time < saturating_add(gvt, window)))) {
+            checkpoints.push_back(checkpoint_t{next_time, digsim::scheduler.save_state(), digsim::state_log.mark()});
+            digsim::scheduler.run_until(next_time);
+            for (auto *peer : peers) {
+                peer->flush();
+            }
+            // A stop request still goes through the final report, the peers might be waiting for it.
+            if (digsim::scheduler.stopped()) {
+                break;
+            }
+            if ((++steps % report_interval) == 0) {
+                for (auto *peer : peers) {
+                    peer->report(local_floor());
+                }
+            }
+            continue;
+        }
+        // Nothing to execute: tell the peers how far this process got, and wait for them.
+        std::vector<const channel_t *> channels;
+        for (auto *peer : peers) {
+            peer->report(floor);
+            if (!peer->closed) {
+                channels.push_back(&peer->channel);
+            } else if (peer->remote_floor <= end_time) {
+                throw std::runtime_error("Peer `" + peer->get_name() + "` disconnected.");
+            }
+        }
+        channel_t::wait_any(channels);
+    }
+    // The peers might still be waiting for this process to get beyond the end time, or to report where it stopped.
+    for (auto *peer : peers) {
+        peer->report(local_floor());
+    }
+}
+
+} // namespace digsim
@@ -0,0 +1,90 @@
+/// @file elaboration_cache.cpp
+/// @brief Implementation of the elaboration cache.
+/// @copyright
+/// This file is distributed under the terms of the MIT License.
+/// See the full license in the root directory at LICENSE.md.
+
+#include "digsim/elaboration_cache.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace digsim
+{
+
+namespace
+{
+
+/// @brief Identifies the elaboration caches.
+constexpr char elaboration_magic[8] = {'D', 'S', 'I', 'M', 'E', 'L', 'B', '2'};
+
+void write_u64(std::ostream &os, uint64_t value) { os.write(reinterpret_cast<const char *>(&value), sizeof(value)); }
+
+void write_vector(std::ostream &os, const std::vector<std::size_t> &values)
+{
+    write_u64(os, values.size());
+    for (std::size_t value : values) {
+        write_u64(os, value);
+    }
+}
+
+bool read_u64(std::istream &is, uint64_t &value)
+{
+    return static_cast<bool>(is.read(reinterpret_cast<char *>(&value), sizeof(value)));
+}
+
+bool read_vector(std::istream &is, std::vector<std::size_t> &values)
+{
+    uint64_t size = 0;
+    if (!read_u64(is, size)) {
+        return false;
+    }
+    values.clear();
+    for (uint64_t value = 0; size > 0; --size) {
+        if (!read_u64(is, value)) {
+            return false;
+        }
+        values.push_back(static_cast<std::size_t>(value));
+    }
+    return true;
+}
+
+} // namespace
+
+bool elaboration_cache_t::load(const std::string &filename, std::uint64_t expected)
+{
+    std::ifstream is(filename, std::ios::binary);
+    if (!is) {
+        return false;
+    }
+    // A stale or damaged cache is not an error, the analyses are simply run again.
+    char magic[sizeof(elaboration_magic)];
+    if (!is.read(magic, sizeof(magic)) || std::memcmp(magic, elaboration_magic, sizeof(magic)) != 0) {
+        return false;
+    }
+    if (!read_u64(is, fingerprint) || (fingerprint != expected)) {
+        return false;
+    }
+    uint64_t checked = 0;
+    if (!read_u64(is, checked) || (checked == 0)) {
+        return false;
+    }
+    cycles_checked = true;
+    return read_vector(is, topological_order) && read_vector(is, process_domain);
+}
+
+void elaboration_cache_t::save(const std::string &filename) const
+{
+    std::ofstream os(filename, std::ios::binary);
+    if (!os) {
+        throw std::runtime_error("Cannot open `" + filename + "` for writing.");
+    }
+    os.write(elaboration_magic, sizeof(elaboration_magic));
+    write_u64(os, fingerprint);
+    write_u64(os, cycles_checked ? 1 : 0);
+    write_vector(os, topological_order);
+    write_vector(os, process_domain);
+}
+
+} // namespace digsim
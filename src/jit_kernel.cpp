@@ -0,0 +1,297 @@
+/// @file jit_kernel.cpp
+/// @brief Implementation of the simulation of frozen netlists by code compiled at run time.
+/// @copyright
+/// This file is distributed under the terms of the MIT License.
+/// See the full license in the root directory at LICENSE.md.
+
+#include "digsim/jit_kernel.hpp"
+
+#include "digsim/codegen.hpp"
+#include "digsim/logger.hpp"
+
+#include <cstdlib>
+#include <dlfcn.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <unistd.h>
+
+namespace digsim
+{
+
+namespace
+{
+
+/// @brief The C interface of the library, around the generated class.
+constexpr const char *interface_code = R"(
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <new>
+#include <string>
+
+namespace
+{
+thread_local std::string last_error;
+
+const char *fail(const std::exception &e)
+{
+    last_error = e.what();
+    return last_error.c_str();
+}
+} // namespace
+
+extern "C" {
+void *digsim_jit_create() { return new (std::nothrow) digsim_jit_model_t(); }
+void digsim_jit_destroy(void *model) { delete static_cast<digsim_jit_model_t *>(model); }
+const char *digsim_jit_initialize(void *model)
+{
+    try {
+        static_cast<digsim_jit_model_t *>(model)->initialize();
+    } catch (const std::exception &e) {
+        return fail(e);
+    }
+    return nullptr;
+}
+const char *digsim_jit_run(void *model, std::uint64_t simulation_time)
+{
+    try {
+        static_cast<digsim_jit_model_t *>(model)->run(simulation_time);
+    } catch (const std::exception &e) {
+        return fail(e);
+    }
+    return nullptr;
+}
+const char *digsim_jit_set(void *model, std::size_t net, std::uint64_t value)
+{
+    try {
+        static_cast<digsim_jit_model_t *>(model)->set(net, value);
+    } catch (const std::exception &e) {
+        return fail(e);
+    }
+    return nullptr;
+}
+std::uint64_t digsim_jit_time(const void *model) { return static_cast<const digsim_jit_model_t *>(model)->time(); }
+std::uint64_t digsim_jit_get(const void *model, std::size_t net)
+{
+    return static_cast<const digsim_jit_model_t *>(model)->get(net);
+}
+}
+)";
+
+/// @brief Looks up a function of the library.
+/// @param library the handle of the library.
+/// @param name the name of the function.
+/// @param function where the function is stored.
+/// @return true if the function was found, false otherwise.
+template <typename F> bool resolve(void *library, const char *name, F &function)
+{
+    function = reinterpret_cast<F>(dlsym(library, name));
+    return function != nullptr;
+}
+
+/// @brief Quotes a path for the shell, so that no character in it is interpreted.
+/// @param path the path.
+/// @return the path within single quotes, those inside it being escaped.
+std::string shell_quote(const std::filesystem::path &path)
+{
+    std::string quoted = "'";
+    for (char c : path.string()) {
+        quoted += (c == '\'') ? std::string("'\\''") : std::string(1, c);
+    }
+    return quoted + "'";
+}
+
+} // namespace
+
+jit_kernel_t::jit_kernel_t(const netlist_view_t &_netlist, const std::string &_cache_directory)
+    : netlist(_netlist)
+    , cache_directory(_cache_directory)
+    , compiler(std::getenv("CXX") ? std::getenv("CXX") : "c++")
+    , library_path()
+    , library(nullptr)
+    , model(nullptr)
+    , functions()
+    , fallback()
+    , cached(false)
+    , initialized(false)
+{
+    // Nothing to do here.
+}
+
+jit_kernel_t::~jit_kernel_t()
+{
+    if (model) {
+        functions.destroy(model);
+    }
+    if (library) {
+        dlclose(library);
+    }
+}
+
+void jit_kernel_t::initialize()
+{
+    if (initialized) {
+        return;
+    }
+    initialized = true;
+    if (this->load()) {
+        check(functions.initialize(model));
+    } else {
+        fallback = std::make_unique<netlist_kernel_t>(netlist);
+        fallback->initialize();
+    }
+}
+
+void jit_kernel_t::run(discrete_time_t simulation_time)
+{
+    this->initialize();
+    if (model) {
+        check(functions.run(model, simulation_time));
+    } else {
+        fallback->run(simulation_time);
+    }
+}
+
+discrete_time_t jit_kernel_t::time() const
+{
+    if (model) {
+        return functions.time(model);
+    }
+    return fallback ? fallback->time() : 0;
+}
+
+uint64_t jit_kernel_t::get(std::size_t net) const
+{
+    if (net >= netlist.num_nets()) {
+        throw std::out_of_range("Net " + std::to_string(net) + " does not exist.");
+    }
+    if (model) {
+        return functions.get(model, net);
+    }
+    return fallback ? fallback->get(net) : netlist.net_initial[net];
+}
+
+void jit_kernel_t::set(std::size_t net, uint64_t value)
+{
+    if (net >= netlist.num_nets()) {
+        throw std::out_of_range("Net " + std::to_string(net) + " does not exist.");
+    }
+    this->initialize();
+    if (model) {
+        check(functions.set(model, net, value));
+    } else {
+        fallback->set(net, value);
+    }
+}
+
+bool jit_kernel_t::load()
+{
+    std::ostringstream code;
+    generate_cpp(netlist, code, "digsim_jit_model_t");
+    const std::string header = code.str();
+    // The library depends on the code and on how it is compiled. FNV-1a is stable across runs and platforms.
+    uint64_t hash = 14695981039346656037ULL;
+    for (const std::string &text : {header, compiler}) {
+        for (char c : text) {
+            hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ULL;
+        }
+    }
+    std::ostringstream name;
+    name << "netlist_" << std::hex << hash;
+    library_path = (std::filesystem::path(cache_directory) / (name.str() + ".so")).string();
+
+    std::error_code ec;
+    cached = std::filesystem::exists(library_path, ec);
+    if (!cached && !this->compile(header, name.str())) {
+        return false;
+    }
+    if (!this->open()) {
+        if (!cached) {
+            return false;
+        }
+        // A cached library may be damaged, e.g., truncated by a crash or built against another runtime: replace it,
+        // once.
+        digsim::error("JIT", "The cached `{}` cannot be used, compiling it again.", library_path);
+        std::filesystem::remove(library_path, ec);
+        cached = false;
+        if (!this->compile(header, name.str()) || !this->open()) {
+            return false;
+        }
+    }
+    model = functions.create();
+    if (!model) {
+        throw std::bad_alloc();
+    }
+    digsim::debug("JIT", "Loaded `{}`{}", library_path, cached ? " from the cache" : "");
+    return true;
+}
+
+bool jit_kernel_t::compile(const std::string &header, const std::string &name)
+{
+    const std::filesystem::path directory(cache_directory);
+    std::error_code ec;
+    std::filesystem::create_directories(directory, ec);
+    if (ec) {
+        digsim::error("JIT", "Cannot create `{}`: {}", cache_directory, ec.message());
+        return false;
+    }
+    // Other processes may compile the same design at the same time: each one writes and compiles its own files, and
+    // only the final rename into the cache is shared, which is atomic.
+    const std::string stem                     = name + "." + std::to_string(getpid());
+    const std::filesystem::path header_file    = directory / (stem + ".hpp");
+    const std::filesystem::path source_file    = directory / (stem + ".cpp");
+    const std::filesystem::path log_file       = directory / (stem + ".log");
+    const std::filesystem::path temporary_file = directory / (stem + ".so.tmp");
+    std::ofstream(header_file) << header;
+    std::ofstream(source_file) << "#include \"" << header_file.filename().string() << "\"\n" << interface_code;
+    const std::string command = compiler + " -std=c++17 -O2 -shared -fPIC -o " + shell_quote(temporary_file) + " " +
+                                shell_quote(source_file) + " > " + shell_quote(log_file) + " 2>&1";
+    digsim::debug("JIT", "Compiling: {}", command);
+    const bool compiled = std::system(command.c_str()) == 0;
+    if (!compiled) {
+        std::ifstream log(log_file);
+        std::string first_line;
+        std::getline(log, first_line);
+        digsim::error("JIT", "Cannot compile `{}` ({}), using the compact kernel instead.", library_path, first_line);
+    } else {
+        std::filesystem::rename(temporary_file, library_path, ec);
+        if (ec) {
+            digsim::error("JIT", "Cannot store `{}`: {}", library_path, ec.message());
+        }
+    }
+    for (const auto &file : {header_file, source_file, log_file, temporary_file}) {
+        std::filesystem::remove(file, ec);
+    }
+    return compiled && std::filesystem::exists(library_path, ec);
+}
+
+bool jit_kernel_t::open()
+{
+    library = dlopen(library_path.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (!library) {
+        digsim::error("JIT", "Cannot load `{}` ({}).", library_path, dlerror());
+        return false;
+    }
+    if (!resolve(library, "digsim_jit_create", functions.create) ||
+        !resolve(library, "digsim_jit_destroy", functions.destroy) ||
+        !resolve(library, "digsim_jit_initialize", functions.initialize) ||
+        !resolve(library, "digsim_jit_run", functions.run) || !resolve(library, "digsim_jit_set", functions.set) ||
+        !resolve(library, "digsim_jit_time", functions.time) || !resolve(library, "digsim_jit_get", functions.get)) {
+        digsim::error("JIT", "`{}` is not a compiled netlist.", library_path);
+        dlclose(library);
+        library = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void jit_kernel_t::check(const char *message)
+{
+    if (message) {
+        throw std::runtime_error(message);
+    }
+}
+
+} // namespace digsim
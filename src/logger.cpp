@@ -30,6 +30,7 @@ log_level_t logger_t::get_level() const noexcept { return global_level; }
 void logger_t::log(log_level_t level, const std::string &source, const std::string &msg) noexcept
 {
     if (level <= global_level) {
+        std::lock_guard<std::mutex> lock(mutex);
         std::cout << "[" << level_to_str(level) << "]";
         std::cout << " [" << std::right << std::setw(4) << scheduler.time() << "]";
         std::cout << " [" << std::left << std::setw(12) << source << "]";
@@ -10,19 +10,105 @@
 #include "digsim/scheduler.hpp"
 #include "digsim/signal.hpp"
 
+#include <algorithm>
+#include <limits>
+
 namespace digsim
 {
 
 module_t::module_t(const std::string &_name, module_t *_parent_module)
     : named_object_t(_name)
-    , parent_module(_parent_module)
+    , parent_module(nullptr)
+    , children()
+    , enabled(true)
+    , sensitivity_ports()
+{
+    this->set_parent(_parent_module);
+}
+
+module_t::~module_t()
+{
+    this->set_parent(nullptr);
+    for (auto *child : children) {
+        child->parent_module = nullptr;
+    }
+}
+
+void module_t::set_parent(module_t *_parent_module)
+{
+    if (parent_module) {
+        auto &siblings = parent_module->children;
+        siblings.erase(std::remove(siblings.begin(), siblings.end(), this), siblings.end());
+    }
+    parent_module = _parent_module;
+    if (parent_module) {
+        parent_module->children.push_back(this);
+    }
+}
+
+void module_t::set_enabled(bool _enabled)
+{
+    // The processes are restored by the scheduler, the flag of the module by the state log.
+    if (digsim::state_log.is_enabled()) {
+        digsim::state_log.record([this, previous = enabled]() { enabled = previous; });
+    }
+    enabled = _enabled;
+    // Update the processes of the subtree. Submodules which were explicitly disabled stay disabled.
+    std::vector<const module_t *> stack{this};
+    while (!stack.empty()) {
+        const module_t *module = stack.back();
+        stack.pop_back();
+        const bool module_enabled = module->is_enabled();
+        for (std::size_t id : process_table.get_owned(module)) {
+            scheduler.set_process_enabled(process_table.get(id), module_enabled);
+        }
+        stack.insert(stack.end(), module->children.begin(), module->children.end());
+    }
+    digsim::debug(get_name(), "Module {}", enabled ? "enabled" : "disabled");
+}
+
+bool module_t::is_enabled() const
+{
+    for (const module_t *module = this; module; module = module->parent_module) {
+        if (!module->enabled) {
+            return false;
+        }
+    }
+    return true;
+}
+
+sensitivity_mask_t module_t::changed_mask() const { return scheduler.get_changed_mask(); }
+
+bool module_t::triggered_by(const isignal_t &port) const
+{
+    auto it = std::find(sensitivity_ports.begin(), sensitivity_ports.end(), &port);
+    if (it == sensitivity_ports.end()) {
+        throw std::runtime_error("Module `" + get_name() + "` is not sensitive to `" + port.get_name() + "`.");
+    }
+    auto index = static_cast<std::size_t>(it - sensitivity_ports.begin());
+    if (index >= std::numeric_limits<sensitivity_mask_t>::digits) {
+        // Inputs beyond the size of the mask are reported as changed whenever the process is woken up.
+        return this->changed_mask() != 0;
+    }
+    return (this->changed_mask() >> index) & 1U;
+}
+
+sensitivity_mask_t module_t::get_sensitivity_mask(const isignal_t &port)
 {
-    // Nothing to do here.
+    auto it = std::find(sensitivity_ports.begin(), sensitivity_ports.end(), &port);
+    if (it == sensitivity_ports.end()) {
+        it = sensitivity_ports.insert(sensitivity_ports.end(), &port);
+    }
+    auto index = static_cast<std::size_t>(it - sensitivity_ports.begin());
+    if (index >= std::numeric_limits<sensitivity_mask_t>::digits) {
+        return std::numeric_limits<sensitivity_mask_t>::max();
+    }
+    return sensitivity_mask_t{1} << index;
 }
 
 void module_t::add_sensitivity(const process_info_t &proc_info, isignal_t &signal)
 {
-    signal.subscribe(proc_info);
+    signal.subscribe(proc_info, this->get_sensitivity_mask(signal));
     scheduler.register_initializer(proc_info);
 }
 
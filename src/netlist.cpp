@@ -0,0 +1,489 @@
+/// @file netlist.cpp
+/// @brief Implementation of the netlists and of their binary images.
+/// @copyright
+/// This file is distributed under the terms of the MIT License.
+/// See the full license in the root directory at LICENSE.md.
+
+#include "digsim/netlist.hpp"
+
+#include "digsim/isignal.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <queue>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <type_traits>
+#include <unistd.h>
+#include <unordered_set>
+
+namespace digsim
+{
+
+namespace
+{
+
+/// @brief Identifies the netlist images.
+constexpr char netlist_magic[8] = {'D', 'S', 'I', 'M', 'N', 'E', 'T', '1'};
+
+/// @brief The number of arrays stored in an image.
+constexpr std::size_t num_sections = 16;
+
+/// @brief The position of an array inside an image.
+struct section_t {
+    uint64_t offset; ///< The offset from the start of the image, in bytes.
+    uint64_t count;  ///< The number of elements.
+};
+
+/// @brief The header of an image, followed by the arrays, each aligned to 8 bytes.
+struct image_header_t {
+    char magic[8];                       ///< Identifies the image.
+    section_t sections[num_sections];    ///< The arrays, in the order of for_each_section().
+};
+
+/// @brief Calls a function on each array of a view, in the order they are stored in an image.
+/// @param view the view.
+/// @param function the function, called with a reference to each span.
+template <typename View, typename Function> void for_each_section(View &view, Function &&function)
+{
+    function(view.net_widths);
+    function(view.net_delays);
+    function(view.net_initial);
+    function(view.name_offsets);
+    function(view.name_chars);
+    function(view.gate_ops);
+    function(view.gate_outputs);
+    function(view.gate_levels);
+    function(view.input_offsets);
+    function(view.inputs);
+    function(view.fanout_offsets);
+    function(view.fanout);
+    function(view.clock_nets);
+    function(view.clock_first);
+    function(view.clock_high);
+    function(view.clock_low);
+}
+
+/// @brief Rounds a size up to a multiple of 8 bytes.
+/// @param bytes the size.
+/// @return the rounded size.
+uint64_t align_to_word(uint64_t bytes) { return (bytes + 7) & ~uint64_t{7}; }
+
+/// @brief Checks if a gate can have the given number of inputs.
+/// @param op the operation of the gate.
+/// @param count the number of inputs.
+/// @return true if the number of inputs is valid, false otherwise.
+bool has_valid_inputs(gate_op_t op, std::size_t count)
+{
+    if ((op == gate_op_t::buf) || (op == gate_op_t::not_)) {
+        return count == 1;
+    }
+    if ((op == gate_op_t::maj) || (op == gate_op_t::mux)) {
+        return count == 3;
+    }
+    if (is_sequential(op)) {
+        return (count >= 2) && (count <= 5);
+    }
+    return count >= 1;
+}
+
+/// @brief Checks that all the values of an array are below a limit, e.g., that they are valid indices.
+/// @param values the values.
+/// @param limit the limit.
+/// @return true if all the values are below the limit, false otherwise.
+template <typename T> bool all_below(std::span<const T> values, std::size_t limit)
+{
+    return std::all_of(values.begin(), values.end(), [limit](T value) { return value < limit; });
+}
+
+/// @brief Checks that an array of offsets starts from zero, never decreases, and ends within the indexed array.
+/// @param offsets the offsets.
+/// @param size the size of the indexed array.
+/// @return true if the offsets are valid, false otherwise.
+template <typename T> bool are_offsets(std::span<const T> offsets, std::size_t size)
+{
+    return !offsets.empty() && (offsets.front() == 0) && std::is_sorted(offsets.begin(), offsets.end()) &&
+           (offsets.back() <= size);
+}
+
+/// @brief Checks that the arrays of a view are consistent with each other, and that all indices are valid.
+/// @param view the view.
+/// @return true if the view is consistent, false otherwise.
+bool is_consistent(const netlist_view_t &view)
+{
+    const std::size_t nets  = view.num_nets();
+    const std::size_t gates = view.num_gates();
+    const bool sizes =
+        (view.net_delays.size() == nets) && (view.net_initial.size() == nets) &&
+        (view.name_offsets.size() == nets + 1) && (view.gate_outputs.size() == gates) &&
+        (view.gate_levels.size() == gates) && (view.input_offsets.size() == gates + 1) &&
+        (view.fanout_offsets.size() == nets + 1) && (view.clock_first.size() == view.num_clocks()) &&
+        (view.clock_high.size() == view.num_clocks()) && (view.clock_low.size() == view.num_clocks());
+    if (!sizes || !are_offsets(view.name_offsets, view.name_chars.size()) ||
+        !are_offsets(view.input_offsets, view.inputs.size()) || !are_offsets(view.fanout_offsets, view.fanout.size())) {
+        return false;
+    }
+    // The simulation indexes the arrays with the stored values without checking them.
+    if (!all_below(view.gate_outputs, nets) || !all_below(view.inputs, nets) || !all_below(view.clock_nets, nets) ||
+        !all_below(view.fanout, gates)) {
+        return false;
+    }
+    for (uint32_t width : view.net_widths) {
+        if ((width == 0) || (width > 64)) {
+            return false;
+        }
+    }
+    for (std::size_t gate = 0; gate < gates; ++gate) {
+        if (view.gate_ops[gate] > static_cast<uint8_t>(gate_op_t::dffn)) {
+            return false;
+        }
+        const std::size_t count = view.input_offsets[gate + 1] - view.input_offsets[gate];
+        if (!has_valid_inputs(static_cast<gate_op_t>(view.gate_ops[gate]), count)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+const char *to_string(gate_op_t op)
+{
+    switch (op) {
+    case gate_op_t::buf:
+        return "buf";
+    case gate_op_t::not_:
+        return "not";
+    case gate_op_t::and_:
+        return "and";
+    case gate_op_t::or_:
+        return "or";
+    case gate_op_t::xor_:
+        return "xor";
+    case gate_op_t::nand:
+        return "nand";
+    case gate_op_t::nor:
+        return "nor";
+    case gate_op_t::xnor:
+        return "xnor";
+    case gate_op_t::maj:
+        return "maj";
+    case gate_op_t::mux:
+        return "mux";
+    case gate_op_t::dff:
+        return "dff";
+    case gate_op_t::dffn:
+        return "dffn";
+    }
+    return "unknown";
+}
+
+std::string_view netlist_view_t::get_name(std::size_t net) const
+{
+    return std::string_view(name_chars.data() + name_offsets[net], name_offsets[net + 1] - name_offsets[net]);
+}
+
+std::size_t netlist_view_t::find(std::string_view name) const
+{
+    for (std::size_t net = 0; net < this->num_nets(); ++net) {
+        if (this->get_name(net) == name) {
+            return net;
+        }
+    }
+    return npos;
+}
+
+void netlist_view_t::save(const std::string &filename) const
+{
+    std::ofstream os(filename, std::ios::binary);
+    if (!os) {
+        throw std::runtime_error("Cannot open `" + filename + "` for writing.");
+    }
+    image_header_t header{};
+    std::memcpy(header.magic, netlist_magic, sizeof(netlist_magic));
+    uint64_t offset   = align_to_word(sizeof(header));
+    std::size_t index = 0;
+    for_each_section(*this, [&](const auto &section) {
+        header.sections[index++] = section_t{offset, section.size()};
+        offset += align_to_word(section.size_bytes());
+    });
+    const char padding[8] = {};
+    os.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    os.write(padding, static_cast<std::streamsize>(align_to_word(sizeof(header)) - sizeof(header)));
+    for_each_section(*this, [&](const auto &section) {
+        os.write(reinterpret_cast<const char *>(section.data()), static_cast<std::streamsize>(section.size_bytes()));
+        os.write(padding, static_cast<std::streamsize>(align_to_word(section.size_bytes()) - section.size_bytes()));
+    });
+    if (!os) {
+        throw std::runtime_error("Cannot write `" + filename + "`.");
+    }
+}
+
+netlist_t::netlist_t()
+    : frozen(false)
+    , net_widths()
+    , net_delays()
+    , net_initial()
+    , name_offsets{0}
+    , name_chars()
+    , gate_ops()
+    , gate_outputs()
+    , gate_levels()
+    , input_offsets{0}
+    , inputs()
+    , fanout_offsets()
+    , fanout()
+    , clock_nets()
+    , clock_first()
+    , clock_high()
+    , clock_low()
+    , drivers()
+    , nets()
+{
+    // Nothing to do here.
+}
+
+netlist_t netlist_t::extract()
+{
+    netlist_t netlist;
+    // Visit the owners of the processes once, in the order of their first process.
+    std::unordered_set<const named_object_t *> visited;
+    for (std::size_t id = 0; id < process_table.size(); ++id) {
+        const named_object_t *owner = process_table.get(id).owner.ptr;
+        if (!owner || !visited.insert(owner).second) {
+            continue;
+        }
+        // The delayed updates of the signals become the delays of the nets.
+        if (dynamic_cast<const isignal_t *>(owner)) {
+            continue;
+        }
+        const auto *structural = dynamic_cast<const structural_t *>(owner);
+        if (!structural) {
+            throw std::runtime_error("Module `" + owner->get_name() + "` has no structural description.");
+        }
+        structural->describe(netlist);
+    }
+    netlist.freeze();
+    return netlist;
+}
+
+std::size_t netlist_t::add_net(const std::string &name, std::size_t width, uint64_t initial, discrete_time_t delay)
+{
+    this->check_not_frozen();
+    if ((width == 0) || (width > 64)) {
+        throw std::runtime_error("Net `" + name + "` must have between 1 and 64 bits.");
+    }
+    const uint64_t mask = (width == 64) ? ~uint64_t{0} : (uint64_t{1} << width) - 1;
+    net_widths.push_back(static_cast<uint32_t>(width));
+    net_delays.push_back(delay);
+    net_initial.push_back(initial & mask);
+    name_chars.insert(name_chars.end(), name.begin(), name.end());
+    name_offsets.push_back(name_chars.size());
+    drivers.push_back(netlist_view_t::npos);
+    return net_widths.size() - 1;
+}
+
+std::size_t netlist_t::get_net(const isignal_t &port)
+{
+    const isignal_t *signal = port.get_bound_signal() ? port.get_bound_signal() : &port;
+    auto it                 = nets.find(signal);
+    if (it != nets.end()) {
+        return it->second;
+    }
+    if (signal->get_width() == 0) {
+        throw std::runtime_error(
+            "Signal `" + get_signal_location_string(&port) +
+            "` is not bound, or its type cannot be part of a netlist.");
+    }
+    std::size_t net =
+        this->add_net(signal->get_name(), signal->get_width(), signal->get_bits(), signal->get_delay());
+    nets.emplace(signal, net);
+    return net;
+}
+
+std::size_t netlist_t::add_gate(gate_op_t op, const std::vector<std::size_t> &gate_inputs, std::size_t output)
+{
+    this->check_not_frozen();
+    const std::size_t count = gate_inputs.size();
+    if (!has_valid_inputs(op, count)) {
+        throw std::runtime_error(
+            "A `" + std::string(to_string(op)) + "` gate cannot have " + std::to_string(count) + " inputs.");
+    }
+    for (std::size_t net : gate_inputs) {
+        if (net >= net_widths.size()) {
+            throw std::runtime_error("Net " + std::to_string(net) + " does not exist.");
+        }
+        inputs.push_back(static_cast<uint32_t>(net));
+    }
+    if (output >= net_widths.size()) {
+        throw std::runtime_error("Net " + std::to_string(output) + " does not exist.");
+    }
+    if (drivers[output] != netlist_view_t::npos) {
+        const std::string name(
+            name_chars.data() + name_offsets[output], name_offsets[output + 1] - name_offsets[output]);
+        throw std::runtime_error("Net `" + name + "` has more than one driver.");
+    }
+    drivers[output] = gate_ops.size();
+    gate_ops.push_back(static_cast<uint8_t>(op));
+    gate_outputs.push_back(static_cast<uint32_t>(output));
+    input_offsets.push_back(static_cast<uint32_t>(inputs.size()));
+    return gate_ops.size() - 1;
+}
+
+std::size_t
+netlist_t::add_gate(gate_op_t op, std::initializer_list<const isignal_t *> gate_inputs, const isignal_t &output)
+{
+    std::vector<std::size_t> input_nets;
+    for (const auto *port : gate_inputs) {
+        input_nets.push_back(this->get_net(*port));
+    }
+    return this->add_gate(op, input_nets, this->get_net(output));
+}
+
+void netlist_t::add_clock(std::size_t net, discrete_time_t first, discrete_time_t high, discrete_time_t low)
+{
+    this->check_not_frozen();
+    if (net >= net_widths.size()) {
+        throw std::runtime_error("Net " + std::to_string(net) + " does not exist.");
+    }
+    if (drivers[net] != netlist_view_t::npos) {
+        throw std::runtime_error("The net of a clock cannot be driven by a gate.");
+    }
+    clock_nets.push_back(static_cast<uint32_t>(net));
+    clock_first.push_back(first);
+    clock_high.push_back(high);
+    clock_low.push_back(low);
+}
+
+void netlist_t::freeze()
+{
+    this->check_not_frozen();
+    const std::size_t num_nets  = net_widths.size();
+    const std::size_t num_gates = gate_ops.size();
+
+    // The gates woken up by each net, flip-flops are only woken up by their clock.
+    std::vector<std::vector<uint32_t>> woken(num_nets);
+    for (std::size_t gate = 0; gate < num_gates; ++gate) {
+        const std::size_t begin = input_offsets[gate];
+        const std::size_t end   = is_sequential(static_cast<gate_op_t>(gate_ops[gate])) ? begin + 1
+                                                                                        : input_offsets[gate + 1];
+        for (std::size_t index = begin; index < end; ++index) {
+            auto &gates = woken[inputs[index]];
+            if (gates.empty() || (gates.back() != gate)) {
+                gates.push_back(static_cast<uint32_t>(gate));
+            }
+        }
+    }
+    fanout_offsets.assign(1, 0);
+    for (const auto &gates : woken) {
+        fanout.insert(fanout.end(), gates.begin(), gates.end());
+        fanout_offsets.push_back(static_cast<uint32_t>(fanout.size()));
+    }
+
+    // Level the combinational gates, flip-flops break the paths and stay at level 0.
+    auto combinational = [this](std::size_t gate) { return !is_sequential(static_cast<gate_op_t>(gate_ops[gate])); };
+    gate_levels.assign(num_gates, 0);
+    std::vector<std::size_t> pending(num_gates, 0);
+    for (std::size_t gate = 0; gate < num_gates; ++gate) {
+        if (combinational(gate)) {
+            for (uint32_t successor : woken[gate_outputs[gate]]) {
+                pending[successor] += combinational(successor) ? 1 : 0;
+            }
+        }
+    }
+    std::queue<std::size_t> ready;
+    for (std::size_t gate = 0; gate < num_gates; ++gate) {
+        if (combinational(gate) && (pending[gate] == 0)) {
+            gate_levels[gate] = 1;
+            ready.push(gate);
+        }
+    }
+    uint32_t max_level = 0;
+    std::size_t leveled = 0;
+    while (!ready.empty()) {
+        std::size_t gate = ready.front();
+        ready.pop();
+        ++leveled;
+        max_level = std::max(max_level, gate_levels[gate]);
+        for (uint32_t successor : woken[gate_outputs[gate]]) {
+            if (combinational(successor)) {
+                gate_levels[successor] = std::max(gate_levels[successor], gate_levels[gate] + 1);
+                if (--pending[successor] == 0) {
+                    ready.push(successor);
+                }
+            }
+        }
+    }
+    // The gates of combinational loops come after all the others, and are evaluated until they settle.
+    for (std::size_t gate = 0; gate < num_gates; ++gate) {
+        if (combinational(gate) && (pending[gate] != 0)) {
+            gate_levels[gate] = max_level + 1;
+        }
+    }
+    frozen = true;
+}
+
+netlist_view_t netlist_t::view() const
+{
+    if (!frozen) {
+        throw std::runtime_error("The netlist must be frozen before being used.");
+    }
+    return netlist_view_t{
+        net_widths,   net_delays, net_initial,    name_offsets, name_chars, gate_ops,  gate_outputs, gate_levels,
+        input_offsets, inputs,    fanout_offsets, fanout,       clock_nets, clock_first, clock_high,  clock_low,
+    };
+}
+
+void netlist_t::check_not_frozen() const
+{
+    if (frozen) {
+        throw std::runtime_error("The netlist is frozen, it cannot be modified.");
+    }
+}
+
+netlist_image_t::netlist_image_t(const std::string &filename)
+    : data(nullptr)
+    , size(0)
+    , netlist()
+{
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open `" + filename + "` for reading.");
+    }
+    struct stat info {};
+    if ((::fstat(fd, &info) != 0) || (static_cast<std::size_t>(info.st_size) < sizeof(image_header_t))) {
+        ::close(fd);
+        throw std::runtime_error("`" + filename + "` is not a netlist image.");
+    }
+    size = static_cast<std::size_t>(info.st_size);
+    data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        throw std::runtime_error("Cannot map `" + filename + "`.");
+    }
+    // Point the arrays into the mapping, checking that they fit.
+    const auto *base   = static_cast<const char *>(data);
+    const auto *header = reinterpret_cast<const image_header_t *>(base);
+    bool valid         = std::memcmp(header->magic, netlist_magic, sizeof(netlist_magic)) == 0;
+    std::size_t index  = 0;
+    for_each_section(netlist, [&](auto &section) {
+        using element_t         = typename std::remove_reference_t<decltype(section)>::element_type;
+        const section_t &stored = header->sections[index++];
+        valid = valid && (stored.offset % alignof(element_t) == 0) && (stored.offset <= size) &&
+                (stored.count <= (size - stored.offset) / sizeof(element_t));
+        if (valid) {
+            section = std::span<element_t>(reinterpret_cast<element_t *>(base + stored.offset), stored.count);
+        }
+    });
+    if (!valid || !is_consistent(netlist)) {
+        ::munmap(data, size);
+        throw std::runtime_error("`" + filename + "` is not a netlist image.");
+    }
+}
+
+netlist_image_t::~netlist_image_t() { ::munmap(data, size); }
+
+} // namespace digsim
@@ -0,0 +1,241 @@
+/// @file netlist_kernel.cpp
+/// @brief Implementation of the compact simulation kernel for frozen netlists.
+/// @copyright
+/// This file is distributed under the terms of the MIT License.
+/// See the full license in the root directory at LICENSE.md.
+
+#include "digsim/netlist_kernel.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace digsim
+{
+
+netlist_kernel_t::netlist_kernel_t(const netlist_view_t &_netlist)
+    : netlist(_netlist)
+    , values(_netlist.net_initial.begin(), _netlist.net_initial.end())
+    , masks(_netlist.num_nets())
+    , last_clock(_netlist.num_gates(), 0)
+    , woken(_netlist.num_gates(), 0)
+    , levels()
+    , first_level(0)
+    , batch()
+    , sampled()
+    , next_edge(_netlist.clock_first.begin(), _netlist.clock_first.end())
+    , updates()
+    , sequence(0)
+    , now(0)
+    , initialized(false)
+{
+    for (std::size_t net = 0; net < netlist.num_nets(); ++net) {
+        masks[net] = (netlist.net_widths[net] >= 64) ? ~uint64_t{0} : (uint64_t{1} << netlist.net_widths[net]) - 1;
+    }
+    uint32_t max_level = 0;
+    for (uint32_t level : netlist.gate_levels) {
+        max_level = std::max(max_level, level);
+    }
+    levels.resize(max_level + 1);
+    first_level = levels.size();
+}
+
+void netlist_kernel_t::initialize()
+{
+    if (initialized) {
+        return;
+    }
+    for (std::size_t gate = 0; gate < netlist.num_gates(); ++gate) {
+        last_clock[gate] = values[netlist.inputs[netlist.input_offsets[gate]]] & 1U;
+        this->wake(gate);
+    }
+    this->settle();
+    initialized = true;
+}
+
+void netlist_kernel_t::run(discrete_time_t simulation_time)
+{
+    this->initialize();
+    const discrete_time_t simulation_end = now + simulation_time;
+    while (true) {
+        // Find the time of the next change, among the delayed nets and the clocks.
+        bool found                   = !updates.empty();
+        discrete_time_t current_time = found ? updates.top().time : 0;
+        for (discrete_time_t edge : next_edge) {
+            if (!found || (edge < current_time)) {
+                current_time = edge;
+                found        = true;
+            }
+        }
+        if (!found || ((simulation_time > 0) && (current_time > simulation_end))) {
+            break;
+        }
+        now = current_time;
+        while (!updates.empty() && (updates.top().time == now)) {
+            this->assign(updates.top().net, updates.top().value);
+            updates.pop();
+        }
+        for (std::size_t clock = 0; clock < next_edge.size(); ++clock) {
+            if (next_edge[clock] == now) {
+                const std::size_t net = netlist.clock_nets[clock];
+                const bool high       = !(values[net] & 1U);
+                this->assign(net, high ? 1 : 0);
+                // A clock never stops, however, it cannot toggle twice in the same time step.
+                next_edge[clock] = now + std::max<discrete_time_t>(
+                                             1, high ? netlist.clock_high[clock] : netlist.clock_low[clock]);
+            }
+        }
+        this->settle();
+    }
+}
+
+void netlist_kernel_t::set(std::size_t net, uint64_t value)
+{
+    this->initialize();
+    this->assign(net, value);
+    this->settle();
+}
+
+bool netlist_kernel_t::evaluate(std::size_t gate, uint64_t &value)
+{
+    const uint32_t *in      = netlist.inputs.data() + netlist.input_offsets[gate];
+    const std::size_t count = netlist.input_offsets[gate + 1] - netlist.input_offsets[gate];
+    const auto op           = static_cast<gate_op_t>(netlist.gate_ops[gate]);
+    switch (op) {
+    case gate_op_t::buf:
+        value = values[in[0]];
+        break;
+    case gate_op_t::not_:
+        value = ~values[in[0]];
+        break;
+    case gate_op_t::and_:
+    case gate_op_t::nand:
+        value = values[in[0]];
+        for (std::size_t index = 1; index < count; ++index) {
+            value &= values[in[index]];
+        }
+        value = (op == gate_op_t::nand) ? ~value : value;
+        break;
+    case gate_op_t::or_:
+    case gate_op_t::nor:
+        value = values[in[0]];
+        for (std::size_t index = 1; index < count; ++index) {
+            value |= values[in[index]];
+        }
+        value = (op == gate_op_t::nor) ? ~value : value;
+        break;
+    case gate_op_t::xor_:
+    case gate_op_t::xnor:
+        value = values[in[0]];
+        for (std::size_t index = 1; index < count; ++index) {
+            value ^= values[in[index]];
+        }
+        value = (op == gate_op_t::xnor) ? ~value : value;
+        break;
+    case gate_op_t::maj:
+        value = (values[in[0]] & values[in[1]]) | (values[in[0]] & values[in[2]]) | (values[in[1]] & values[in[2]]);
+        break;
+    case gate_op_t::mux:
+        value = values[in[0]] ? values[in[2]] : values[in[1]];
+        break;
+    case gate_op_t::dff:
+    case gate_op_t::dffn: {
+        const uint8_t clock = values[in[0]] & 1U;
+        const bool rising   = clock && !last_clock[gate];
+        last_clock[gate]    = clock;
+        if (!rising) {
+            return false;
+        }
+        // The held state is the non-inverted output, either given or the one driven by the gate.
+        const std::size_t output = netlist.gate_outputs[gate];
+        uint64_t state           = (count > 4)              ? values[in[4]]
+                                   : (op == gate_op_t::dff) ? values[output]
+                                                            : ~values[output];
+        if ((count > 3) && values[in[3]]) {
+            state = 0;
+        } else if ((count < 3) || values[in[2]]) {
+            state = values[in[1]];
+        }
+        value = (op == gate_op_t::dff) ? state : ~state;
+        break;
+    }
+    }
+    value &= masks[netlist.gate_outputs[gate]];
+    return true;
+}
+
+void netlist_kernel_t::drive(std::size_t gate, uint64_t value)
+{
+    const uint32_t net = netlist.gate_outputs[gate];
+    if (netlist.net_delays[net] == 0) {
+        this->assign(net, value);
+    } else {
+        updates.push(update_t{now + netlist.net_delays[net], sequence++, net, value});
+    }
+}
+
+void netlist_kernel_t::assign(std::size_t net, uint64_t value)
+{
+    value &= masks[net];
+    if (values[net] == value) {
+        return;
+    }
+    values[net] = value;
+    for (uint32_t index = netlist.fanout_offsets[net]; index < netlist.fanout_offsets[net + 1]; ++index) {
+        this->wake(netlist.fanout[index]);
+    }
+}
+
+void netlist_kernel_t::wake(std::size_t gate)
+{
+    if (!woken[gate]) {
+        woken[gate]              = 1;
+        const std::size_t level = netlist.gate_levels[gate];
+        levels[level].push_back(static_cast<uint32_t>(gate));
+        first_level = std::min(first_level, level);
+    }
+}
+
+void netlist_kernel_t::settle()
+{
+    // Acyclic logic evaluates each gate at most once per level visit, loops are given a generous budget.
+    const std::size_t budget = 1000 * (netlist.num_gates() + 1);
+    std::size_t evaluations  = 0;
+    uint64_t value           = 0;
+    while (first_level < levels.size()) {
+        if (levels[first_level].empty()) {
+            ++first_level;
+            continue;
+        }
+        const std::size_t level = first_level;
+        batch.swap(levels[level]);
+        evaluations += batch.size();
+        if (evaluations > budget) {
+            throw std::runtime_error(
+                "Time step " + std::to_string(now) + " does not settle, the netlist has a combinational loop.");
+        }
+        if (level == 0) {
+            // Flip-flops sample their inputs together, before any of them drives its output.
+            sampled.clear();
+            for (uint32_t gate : batch) {
+                woken[gate] = 0;
+                if (this->evaluate(gate, value)) {
+                    sampled.emplace_back(gate, value);
+                }
+            }
+            for (const auto &[gate, sample] : sampled) {
+                this->drive(gate, sample);
+            }
+        } else {
+            for (uint32_t gate : batch) {
+                woken[gate] = 0;
+                if (this->evaluate(gate, value)) {
+                    this->drive(gate, value);
+                }
+            }
+        }
+        batch.clear();
+    }
+}
+
+} // namespace digsim
@@ -0,0 +1,472 @@
+/// @file partitioner.cpp
+/// @brief Implementation of the multilevel partitioner.
+/// @copyright
+/// This file is distributed under the terms of the MIT License.
+/// See the full license in the root directory at LICENSE.md.
+
+#include "digsim/partitioner.hpp"
+
+#include "digsim/dependency_graph.hpp"
+#include "digsim/isignal.hpp"
+#include "digsim/logger.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <numeric>
+#include <queue>
+#include <random>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+
+namespace digsim
+{
+
+namespace
+{
+
+/// @brief Identifies the partition maps.
+constexpr const char *partition_map_magic = "digsim-partition-map 1";
+
+/// @brief The weight of a signal without delay, relative to one with a long delay.
+constexpr discrete_time_t delay_bonus = 8;
+
+/// @brief How many times the coarsest graph is partitioned, from different seeds.
+constexpr std::size_t initial_trials = 8;
+
+/// @brief Marks the vertices which are not matched, or not assigned.
+constexpr std::size_t none = std::numeric_limits<std::size_t>::max();
+
+/// @brief A weighted, undirected graph.
+struct graph_t {
+    /// @brief The weight of each vertex.
+    std::vector<std::uint64_t> weights;
+    /// @brief The neighbours of each vertex, with the weight of the edge.
+    std::vector<std::vector<std::pair<std::size_t, std::uint64_t>>> adjacency;
+};
+
+/// @brief Sorts the neighbours, merges the edges going to the same one, and drops the ones going to the vertex itself.
+/// @param graph the graph.
+void normalize(graph_t &graph)
+{
+    for (std::size_t vertex = 0; vertex < graph.adjacency.size(); ++vertex) {
+        auto &edges = graph.adjacency[vertex];
+        std::sort(edges.begin(), edges.end());
+        std::vector<std::pair<std::size_t, std::uint64_t>> merged;
+        for (const auto &[neighbour, weight] : edges) {
+            if (neighbour == vertex) {
+                continue;
+            }
+            if (!merged.empty() && (merged.back().first == neighbour)) {
+                merged.back().second += weight;
+            } else {
+                merged.emplace_back(neighbour, weight);
+            }
+        }
+        edges = std::move(merged);
+    }
+}
+
+/// @brief Merges each vertex with the unmatched neighbour it shares the heaviest edge with.
+/// @param graph the graph.
+/// @param max_weight the maximum weight of a merged vertex.
+/// @param rng the generator used to shuffle the vertices.
+/// @param map filled with the coarse vertex of each vertex.
+/// @return the coarse graph.
+graph_t coarsen(const graph_t &graph, std::uint64_t max_weight, std::mt19937_64 &rng, std::vector<std::size_t> &map)
+{
+    const std::size_t num_vertices = graph.weights.size();
+    std::vector<std::size_t> order(num_vertices);
+    std::iota(order.begin(), order.end(), 0);
+    // A Fisher-Yates shuffle, since std::shuffle is implementation-defined, and the partitions must not depend on the
+    // standard library.
+    for (std::size_t i = num_vertices; i > 1; --i) {
+        std::swap(order[i - 1], order[static_cast<std::size_t>(rng() % i)]);
+    }
+    std::vector<std::size_t> match(num_vertices, none);
+    for (std::size_t vertex : order) {
+        if (match[vertex] != none) {
+            continue;
+        }
+        std::size_t best         = vertex;
+        std::uint64_t best_weight = 0;
+        for (const auto &[neighbour, weight] : graph.adjacency[vertex]) {
+            if ((match[neighbour] == none) && (weight > best_weight) &&
+                (graph.weights[vertex] + graph.weights[neighbour] <= max_weight)) {
+                best        = neighbour;
+                best_weight = weight;
+            }
+        }
+        match[vertex] = best;
+        match[best]   = vertex;
+    }
+    graph_t coarse;
+    map.assign(num_vertices, none);
+    for (std::size_t vertex = 0; vertex < num_vertices; ++vertex) {
+        if (map[vertex] == none) {
+            map[vertex] = map[match[vertex]] = coarse.weights.size();
+            coarse.weights.push_back(
+                graph.weights[vertex] + ((match[vertex] != vertex) ? graph.weights[match[vertex]] : 0));
+        }
+    }
+    coarse.adjacency.resize(coarse.weights.size());
+    for (std::size_t vertex = 0; vertex < num_vertices; ++vertex) {
+        for (const auto &[neighbour, weight] : graph.adjacency[vertex]) {
+            coarse.adjacency[map[vertex]].emplace_back(map[neighbour], weight);
+        }
+    }
+    normalize(coarse);
+    return coarse;
+}
+
+/// @brief Computes the weight of the edges between different partitions.
+/// @param graph the graph.
+/// @param part the partition of each vertex.
+/// @return the weight of the cut.
+std::uint64_t compute_cut(const graph_t &graph, const std::vector<std::size_t> &part)
+{
+    std::uint64_t cut = 0;
+    for (std::size_t vertex = 0; vertex < graph.weights.size(); ++vertex) {
+        for (const auto &[neighbour, weight] : graph.adjacency[vertex]) {
+            cut += (part[vertex] != part[neighbour]) ? weight : 0;
+        }
+    }
+    // Each edge is stored on both its ends.
+    return cut / 2;
+}
+
+/// @brief Partitions a graph by growing one partition at a time from a seed, always adding the vertex most connected to
+/// it, until it reaches the average weight. The last partition takes what is left.
+/// @param graph the graph.
+/// @param num_partitions the number of partitions.
+/// @param max_load the maximum weight of a partition.
+/// @param first the seed of the first partition, the next ones start from the heaviest vertex left.
+/// @param loads filled with the weight of each partition.
+/// @return the partition of each vertex.
+std::vector<std::size_t> grow_partition(
+    const graph_t &graph,
+    std::size_t num_partitions,
+    std::uint64_t max_load,
+    std::size_t first,
+    std::vector<std::uint64_t> &loads)
+{
+    const std::size_t num_vertices = graph.weights.size();
+    const std::uint64_t total      = std::accumulate(graph.weights.begin(), graph.weights.end(), std::uint64_t{0});
+    const std::uint64_t target     = (total + num_partitions - 1) / num_partitions;
+    const std::uint64_t heaviest =
+        graph.weights.empty() ? 0 : *std::max_element(graph.weights.begin(), graph.weights.end());
+    // Seeds are taken from the heaviest vertex.
+    std::vector<std::size_t> seeds(num_vertices);
+    std::iota(seeds.begin(), seeds.end(), 0);
+    std::stable_sort(seeds.begin(), seeds.end(), [&graph, first](std::size_t lhs, std::size_t rhs) {
+        return (lhs == first) || ((rhs != first) && (graph.weights[lhs] > graph.weights[rhs]));
+    });
+    std::vector<std::size_t> part(num_vertices, none);
+    std::vector<std::uint64_t> connection(num_vertices, 0);
+    std::vector<std::size_t> touched;
+    loads.assign(num_partitions, 0);
+    for (std::size_t partition = 0; partition + 1 < num_partitions; ++partition) {
+        // The candidates, by connection to the partition, then by index.
+        std::priority_queue<std::pair<std::uint64_t, std::size_t>> frontier;
+        auto next_seed = seeds.begin();
+        while (loads[partition] < target) {
+            std::size_t vertex = none;
+            while (!frontier.empty() && (vertex == none)) {
+                const auto [weight, index] = frontier.top();
+                frontier.pop();
+                const std::size_t candidate = num_vertices - 1 - index;
+                if ((part[candidate] == none) && (connection[candidate] == weight)) {
+                    vertex = candidate;
+                }
+            }
+            for (; (vertex == none) && (next_seed != seeds.end()); ++next_seed) {
+                if (part[*next_seed] == none) {
+                    vertex = *next_seed;
+                }
+            }
+            if (vertex == none) {
+                break;
+            }
+            // A vertex without room ends the partition if it is close enough to the average, otherwise, it is left to
+            // the next partitions.
+            if ((loads[partition] > 0) && (loads[partition] + graph.weights[vertex] > max_load)) {
+                if (loads[partition] + heaviest >= target) {
+                    break;
+                }
+                continue;
+            }
+            part[vertex] = partition;
+            loads[partition] += graph.weights[vertex];
+            for (const auto &[neighbour, weight] : graph.adjacency[vertex]) {
+                if (part[neighbour] == none) {
+                    connection[neighbour] += weight;
+                    touched.push_back(neighbour);
+                    frontier.emplace(connection[neighbour], num_vertices - 1 - neighbour);
+                }
+            }
+        }
+        for (std::size_t vertex : touched) {
+            connection[vertex] = 0;
+        }
+        touched.clear();
+    }
+    for (std::size_t vertex = 0; vertex < num_vertices; ++vertex) {
+        if (part[vertex] == none) {
+            part[vertex] = num_partitions - 1;
+            loads[num_partitions - 1] += graph.weights[vertex];
+        }
+    }
+    return part;
+}
+
+/// @brief Moves the vertices to the partition they are most connected to, as long as it reduces the cut, or it keeps
+/// the cut and improves the balance. Vertices of overloaded partitions move whenever there is room elsewhere.
+/// @param graph the graph.
+/// @param max_load the maximum weight of a partition.
+/// @param part the partition of each vertex.
+/// @param loads the weight of each partition.
+void refine(
+    const graph_t &graph,
+    std::uint64_t max_load,
+    std::vector<std::size_t> &part,
+    std::vector<std::uint64_t> &loads)
+{
+    constexpr std::size_t max_passes = 16;
+
+    const std::size_t num_partitions = loads.size();
+    std::vector<std::uint64_t> connection(num_partitions);
+    for (std::size_t pass = 0; pass < max_passes; ++pass) {
+        bool moved = false;
+        for (std::size_t vertex = 0; vertex < graph.weights.size(); ++vertex) {
+            const std::size_t own      = part[vertex];
+            const std::uint64_t weight = graph.weights[vertex];
+            std::fill(connection.begin(), connection.end(), 0);
+            for (const auto &[neighbour, edge_weight] : graph.adjacency[vertex]) {
+                connection[part[neighbour]] += edge_weight;
+            }
+            // The best destination, by gain, then by load.
+            std::size_t best        = none;
+            std::int64_t best_gain = 0;
+            for (std::size_t partition = 0; partition < num_partitions; ++partition) {
+                if ((partition == own) || (loads[partition] + weight > max_load)) {
+                    continue;
+                }
+                const auto gain =
+                    static_cast<std::int64_t>(connection[partition]) - static_cast<std::int64_t>(connection[own]);
+                if ((best == none) || (gain > best_gain) || ((gain == best_gain) && (loads[partition] < loads[best]))) {
+                    best      = partition;
+                    best_gain = gain;
+                }
+            }
+            if ((best == none) ||
+                ((best_gain < 0) && (loads[own] <= max_load)) ||
+                ((best_gain == 0) && (loads[best] + weight >= loads[own]))) {
+                continue;
+            }
+            part[vertex] = best;
+            loads[own] -= weight;
+            loads[best] += weight;
+            moved = true;
+        }
+        if (!moved) {
+            break;
+        }
+    }
+}
+
+} // namespace
+
+bool partition_map_t::load(const std::string &filename, std::uint64_t expected)
+{
+    std::ifstream is(filename);
+    if (!is) {
+        return false;
+    }
+    // A stale or damaged map is not an error, the processes are simply partitioned again.
+    std::string magic, key;
+    std::size_t num_processes = 0;
+    if (!std::getline(is, magic) || (magic != partition_map_magic)) {
+        return false;
+    }
+    if (!(is >> key >> fingerprint) || (key != "fingerprint") || (fingerprint != expected)) {
+        return false;
+    }
+    if (!(is >> key >> num_partitions) || (key != "partitions") || (num_partitions == 0)) {
+        return false;
+    }
+    if (!(is >> key >> num_processes) || (key != "processes")) {
+        return false;
+    }
+    process_partition.assign(num_processes, 0);
+    for (auto &partition : process_partition) {
+        if (!(is >> partition) || (partition >= num_partitions)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void partition_map_t::save(const std::string &filename) const
+{
+    std::ofstream os(filename);
+    if (!os) {
+        throw std::runtime_error("Cannot open `" + filename + "` for writing.");
+    }
+    os << partition_map_magic << "\n";
+    os << "fingerprint " << fingerprint << "\n";
+    os << "partitions " << num_partitions << "\n";
+    os << "processes " << process_partition.size() << "\n";
+    for (std::size_t partition : process_partition) {
+        os << partition << "\n";
+    }
+}
+
+partitioner_t::partitioner_t()
+    : activations()
+    , costs()
+    , imbalance(0.05)
+    , seed(0)
+    , cut(0)
+    , loads()
+{
+    // Nothing to do here.
+}
+
+void partitioner_t::set_activations(const std::vector<std::uint64_t> &_activations) { activations = _activations; }
+
+void partitioner_t::set_cost(const process_info_t &proc_info, std::uint64_t cost)
+{
+    if (proc_info.id >= costs.size()) {
+        costs.resize(proc_info.id + 1, 1);
+    }
+    costs[proc_info.id] = cost;
+}
+
+void partitioner_t::set_imbalance(double _imbalance) { imbalance = std::max(0.0, _imbalance); }
+
+void partitioner_t::set_seed(std::uint64_t _seed) { seed = _seed; }
+
+partition_map_t partitioner_t::partition(std::size_t num_partitions)
+{
+    if (num_partitions == 0) {
+        throw std::runtime_error("The number of partitions must be at least 1.");
+    }
+    const std::size_t num_processes = process_table.size();
+    const auto edges                = digsim::dependency_graph.get_process_edges();
+    auto get_activations = [this](std::size_t id) { return (id < activations.size()) ? activations[id] : 0; };
+    auto get_cost        = [this](std::size_t id) { return (id < costs.size()) ? costs[id] : 1; };
+
+    // Processes owned by a signal go with its producer, the others are the vertices of the graph.
+    std::vector<std::size_t> representative(num_processes);
+    std::iota(representative.begin(), representative.end(), 0);
+    for (const auto &edge : edges) {
+        if ((edge.consumer < num_processes) && (edge.producer < num_processes) &&
+            (dynamic_cast<const isignal_t *>(process_table.get(edge.consumer).owner.ptr) == edge.signal)) {
+            representative[edge.consumer] = edge.producer;
+        }
+    }
+    std::vector<std::size_t> vertex_of(num_processes, none);
+    graph_t graph;
+    for (std::size_t id = 0; id < num_processes; ++id) {
+        if (representative[id] == id) {
+            vertex_of[id] = graph.weights.size();
+            graph.weights.push_back(0);
+        }
+    }
+    for (std::size_t id = 0; id < num_processes; ++id) {
+        vertex_of[id] = vertex_of[representative[id]];
+        graph.weights[vertex_of[id]] += 1 + get_activations(id) * get_cost(id);
+    }
+    graph.adjacency.resize(graph.weights.size());
+    for (const auto &edge : edges) {
+        if ((edge.producer >= num_processes) || (edge.consumer >= num_processes)) {
+            continue;
+        }
+        const discrete_time_t delay = edge.signal->get_delay();
+        const std::uint64_t bonus   = (delay >= delay_bonus) ? 1 : 1 + delay_bonus / (1 + delay);
+        const std::uint64_t weight  = (1 + get_activations(edge.producer)) * bonus;
+        graph.adjacency[vertex_of[edge.producer]].emplace_back(vertex_of[edge.consumer], weight);
+        graph.adjacency[vertex_of[edge.consumer]].emplace_back(vertex_of[edge.producer], weight);
+    }
+    normalize(graph);
+
+    // Partitions can be heavier than the average by the imbalance, or by the heaviest vertex, whichever is larger.
+    const std::uint64_t total = std::accumulate(graph.weights.begin(), graph.weights.end(), std::uint64_t{0});
+    const std::uint64_t heaviest =
+        graph.weights.empty() ? 0 : *std::max_element(graph.weights.begin(), graph.weights.end());
+    const double average = static_cast<double>(total) / static_cast<double>(num_partitions);
+    const std::uint64_t max_load =
+        std::max(static_cast<std::uint64_t>(std::ceil(average * (1.0 + imbalance))), heaviest);
+
+    // Coarsen the graph until it is small, or it stops shrinking.
+    const std::size_t coarsest = std::max<std::size_t>(16, 8 * num_partitions);
+    std::mt19937_64 rng(seed);
+    std::vector<graph_t> levels;
+    std::vector<std::vector<std::size_t>> maps;
+    levels.push_back(std::move(graph));
+    while (levels.back().weights.size() > coarsest) {
+        std::vector<std::size_t> map;
+        graph_t coarse = coarsen(levels.back(), std::max(max_load / 4, heaviest), rng, map);
+        if (coarse.weights.size() * 10 > levels.back().weights.size() * 9) {
+            break;
+        }
+        maps.push_back(std::move(map));
+        levels.push_back(std::move(coarse));
+    }
+    // Partition the coarsest graph a few times, from different seeds, and keep the smallest cut within the balance.
+    const graph_t &coarsest_graph = levels.back();
+    std::vector<std::size_t> part;
+    std::uint64_t best_cut = 0, best_load = 0;
+    const std::size_t num_coarsest = coarsest_graph.weights.size();
+    for (std::size_t trial = 0; trial < std::min(initial_trials, num_coarsest); ++trial) {
+        // The first trial starts from the heaviest vertex, the others from random ones.
+        std::size_t first = static_cast<std::size_t>(
+            std::max_element(coarsest_graph.weights.begin(), coarsest_graph.weights.end()) -
+            coarsest_graph.weights.begin());
+        if (trial > 0) {
+            first = static_cast<std::size_t>(rng() % num_coarsest);
+        }
+        std::vector<std::uint64_t> trial_loads;
+        auto trial_part = grow_partition(coarsest_graph, num_partitions, max_load, first, trial_loads);
+        refine(coarsest_graph, max_load, trial_part, trial_loads);
+        const std::uint64_t trial_cut  = compute_cut(coarsest_graph, trial_part);
+        const std::uint64_t trial_load = *std::max_element(trial_loads.begin(), trial_loads.end());
+        const bool balanced            = trial_load <= max_load;
+        if (part.empty() || (balanced && ((best_load > max_load) || (trial_cut < best_cut))) ||
+            (!balanced && (trial_load < best_load))) {
+            part      = std::move(trial_part);
+            loads     = std::move(trial_loads);
+            best_cut  = trial_cut;
+            best_load = trial_load;
+        }
+    }
+    if (part.empty()) {
+        loads.assign(num_partitions, 0);
+    }
+    // Project the partition back, refining it at each level.
+    for (std::size_t level = maps.size(); level-- > 0;) {
+        std::vector<std::size_t> finer(maps[level].size());
+        for (std::size_t vertex = 0; vertex < finer.size(); ++vertex) {
+            finer[vertex] = part[maps[level][vertex]];
+        }
+        part = std::move(finer);
+        refine(levels[level], max_load, part, loads);
+    }
+    cut = compute_cut(levels.front(), part);
+
+    partition_map_t map;
+    map.fingerprint    = digsim::dependency_graph.compute_fingerprint();
+    map.num_partitions = num_partitions;
+    map.process_partition.resize(num_processes);
+    for (std::size_t id = 0; id < num_processes; ++id) {
+        map.process_partition[id] = part[vertex_of[id]];
+    }
+    digsim::debug(
+        "partitioner_t", "{} processes in {} partitions, {} levels, cut {}", num_processes, num_partitions,
+        levels.size(), cut);
+    return map;
+}
+
+} // namespace digsim
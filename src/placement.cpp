@@ -0,0 +1,188 @@
+/// @file placement.cpp
+/// @brief Implementation of the placement of the worker threads.
+/// @copyright
+/// This file is distributed under the terms of the MIT License.
+/// See the full license in the root directory at LICENSE.md.
+
+#include "digsim/placement.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+namespace digsim
+{
+
+bool parse_placement(const std::string &text, placement_t &placement)
+{
+    for (auto candidate : {placement_t::none, placement_t::compact, placement_t::scatter}) {
+        if (text == to_string(candidate)) {
+            placement = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+const char *to_string(placement_t placement)
+{
+    switch (placement) {
+    case placement_t::compact:
+        return "compact";
+    case placement_t::scatter:
+        return "scatter";
+    default:
+        return "none";
+    }
+}
+
+std::vector<int> parse_cpu_list(const std::string &list)
+{
+    std::vector<int> cpus;
+    std::stringstream ss(list);
+    std::string range;
+    while (std::getline(ss, range, ',')) {
+        int first = 0, last = 0;
+        char dash = 0;
+        std::stringstream rs(range);
+        if (!(rs >> first)) {
+            continue;
+        }
+        last = (rs >> dash >> last) && (dash == '-') ? last : first;
+        for (int cpu = first; cpu <= last; ++cpu) {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+cpu_topology_t cpu_topology_t::detect()
+{
+    cpu_topology_t topology;
+    const auto allowed = get_thread_cpus();
+    auto is_allowed    = [&allowed](int cpu) {
+        return std::find(allowed.begin(), allowed.end(), cpu) != allowed.end();
+    };
+    // Visit the nodes by number, the directory does not list them in order.
+    std::vector<std::pair<int, std::vector<int>>> nodes;
+    std::error_code ec;
+    for (const auto &entry : std::filesystem::directory_iterator("/sys/devices/system/node", ec)) {
+        const std::string name = entry.path().filename().string();
+        if ((name.rfind("node", 0) != 0) || (name.size() == 4) ||
+            !std::all_of(name.begin() + 4, name.end(), [](char c) { return (c >= '0') && (c <= '9'); })) {
+            continue;
+        }
+        std::ifstream file(entry.path() / "cpulist");
+        std::string list;
+        std::getline(file, list);
+        std::vector<int> cpus;
+        for (int cpu : parse_cpu_list(list)) {
+            if (is_allowed(cpu)) {
+                cpus.push_back(cpu);
+            }
+        }
+        if (!cpus.empty()) {
+            nodes.emplace_back(std::stoi(name.substr(4)), std::move(cpus));
+        }
+    }
+    std::sort(nodes.begin(), nodes.end());
+    for (auto &node : nodes) {
+        topology.nodes.push_back(std::move(node.second));
+    }
+    if (topology.nodes.empty() && !allowed.empty()) {
+        topology.nodes.push_back(allowed);
+    }
+    return topology;
+}
+
+std::size_t cpu_topology_t::num_cpus() const
+{
+    std::size_t count = 0;
+    for (const auto &node : nodes) {
+        count += node.size();
+    }
+    return count;
+}
+
+int cpu_topology_t::cpu_of(placement_t placement, std::size_t slot) const
+{
+    const int node = this->node_of(placement, slot);
+    if (node < 0) {
+        return -1;
+    }
+    const auto &cpus = nodes[static_cast<std::size_t>(node)];
+    if (placement == placement_t::scatter) {
+        return cpus[(slot / nodes.size()) % cpus.size()];
+    }
+    // Skip the CPUs of the nodes before the one of the thread.
+    std::size_t index = slot % this->num_cpus();
+    for (std::size_t previous = 0; previous < static_cast<std::size_t>(node); ++previous) {
+        index -= nodes[previous].size();
+    }
+    return cpus[index];
+}
+
+int cpu_topology_t::node_of(placement_t placement, std::size_t slot) const
+{
+    if ((placement == placement_t::none) || nodes.empty()) {
+        return -1;
+    }
+    if (placement == placement_t::scatter) {
+        return static_cast<int>(slot % nodes.size());
+    }
+    std::size_t index = slot % this->num_cpus();
+    std::size_t node  = 0;
+    while (index >= nodes[node].size()) {
+        index -= nodes[node].size();
+        ++node;
+    }
+    return static_cast<int>(node);
+}
+
+#if defined(__linux__)
+
+bool pin_thread(int cpu) { return set_thread_cpus({cpu}); }
+
+std::vector<int> get_thread_cpus()
+{
+    std::vector<int> cpus;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &set)) {
+                cpus.push_back(cpu);
+            }
+        }
+    }
+    return cpus;
+}
+
+bool set_thread_cpus(const std::vector<int> &cpus)
+{
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus) {
+        if ((cpu >= 0) && (cpu < CPU_SETSIZE)) {
+            CPU_SET(cpu, &set);
+        }
+    }
+    return (CPU_COUNT(&set) > 0) && (sched_setaffinity(0, sizeof(set), &set) == 0);
+}
+
+#else
+
+bool pin_thread(int) { return false; }
+
+std::vector<int> get_thread_cpus() { return {}; }
+
+bool set_thread_cpus(const std::vector<int> &) { return false; }
+
+#endif
+
+} // namespace digsim
@@ -0,0 +1,66 @@
+/// @file quantum_keeper.cpp
+/// @brief Implementation of the quantum keeper.
+/// @copyright
+/// This file is distributed under the terms of the MIT License.
+/// See the full license in the root directory at LICENSE.md.
+
+#include "digsim/quantum_keeper.hpp"
+
+#include "digsim/logger.hpp"
+#include "digsim/scheduler.hpp"
+
+namespace digsim
+{
+
+quantum_keeper_t::quantum_keeper_t()
+    : local_time(0)
+    , next_sync_point(compute_next_sync_point(scheduler.time()))
+{
+    // Nothing to do here.
+}
+
+void quantum_keeper_t::inc(discrete_time_t t) { local_time += t; }
+
+void quantum_keeper_t::set(discrete_time_t t) { local_time = t; }
+
+discrete_time_t quantum_keeper_t::get_local_time() const { return local_time; }
+
+discrete_time_t quantum_keeper_t::get_current_time() const { return scheduler.time() + local_time; }
+
+bool quantum_keeper_t::need_sync() const { return this->get_current_time() >= next_sync_point; }
+
+bool quantum_keeper_t::sync(const process_info_t &resume)
+{
+    // The process did not run ahead, there is nothing to wait for.
+    if (local_time == 0) {
+        next_sync_point = compute_next_sync_point(scheduler.time());
+        return false;
+    }
+    // The process will resume at the time it has reached locally.
+    discrete_time_t resume_time = this->get_current_time();
+    digsim::trace("quantum_keeper_t", "Sync {} at {} (+{}t)", resume.to_string(), resume_time, local_time);
+    scheduler.schedule_after(resume, local_time);
+    // Restart the quantum from the resume time.
+    local_time      = 0;
+    next_sync_point = compute_next_sync_point(resume_time);
+    return true;
+}
+
+void quantum_keeper_t::reset()
+{
+    local_time      = 0;
+    next_sync_point = compute_next_sync_point(scheduler.time());
+}
+
+discrete_time_t quantum_keeper_t::compute_next_sync_point(discrete_time_t time)
+{
+    discrete_time_t quantum = scheduler.get_global_quantum();
+    // Without a quantum, the process must synchronize as soon as it runs ahead.
+    if (quantum == 0) {
+        return time + 1;
+    }
+    // Align the synchronization point to the next quantum boundary.
+    return ((time / quantum) + 1) * quantum;
+}
+
+} // namespace digsim
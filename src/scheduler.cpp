@@ -7,34 +7,314 @@
 #include "digsim/scheduler.hpp"
 
 #include "digsim/dependency_graph.hpp"
+#include "digsim/isignal.hpp"
 #include "digsim/logger.hpp"
+#include "digsim/module.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <set>
 
 namespace digsim
 {
+
+/// @brief The partition executed by the calling thread, valid only during a parallel phase.
+static thread_local std::size_t current_partition = 0;
+/// @brief Whether the calling thread is executing a partition concurrently with others.
+static thread_local bool parallel_phase = false;
+/// @brief The changed mask of the process being executed by the calling thread.
+static thread_local sensitivity_mask_t changed_mask = 0;
+/// @brief The id of the process being executed by the calling thread.
+static thread_local std::size_t current_process = std::numeric_limits<std::size_t>::max();
+
+/// @brief Reads the placement policy from the DIGSIM_PLACEMENT environment variable.
+/// @return the policy, placement_t::none if the variable is not set or not valid.
+static placement_t placement_from_environment()
+{
+    placement_t placement = placement_t::none;
+    const char *value     = std::getenv("DIGSIM_PLACEMENT");
+    if (value && !parse_placement(value, placement)) {
+        digsim::error("scheduler_t", "Unknown placement `{}` in DIGSIM_PLACEMENT, threads are not placed", value);
+    }
+    return placement;
+}
+
 scheduler_t::scheduler_t()
     : initialized(false)
     , now(0)
-    , event_queue()
+    , global_quantum(0)
+    , partitions(1)
+    , process_partition()
+    , process_changed()
+    , process_disabled()
+    , process_pending()
+    , partitioning(partitioning_t::none)
+    , partition_map()
+    , profiling(false)
+    , activations()
+    , rebalance_interval(0)
+    , rebalance_tolerance(0.25)
+    , rebalance_steps(0)
+    , rebalance_base()
+    , migration_unit()
+    , unit_processes()
+    , unit_neighbours()
+    , migrations(0)
+    , num_threads(1)
+    , placement(placement_from_environment())
+    , topology()
+    , caller_cpus()
+    , stop_requested(false)
+    , stop_honoured(false)
+    , ordering(ordering_t::registration)
+    , ordering_seed(0)
+    , process_rank()
+    , elaboration_cache_file()
+    , elaboration_cache()
+    , elaboration_cached(false)
+    , race_detection(false)
+    , accesses()
+    , accesses_mutex()
+    , races()
+    , delta_limit(100000)
+    , delta_policy(delta_policy_t::abort)
+    , delta_time(0)
+    , delta_count(0)
+    , storm_tracing(false)
+    , storm_processes()
+    , storm_signals()
+    , delta_storm()
     , initializer_queue()
+    , workers()
+    , workers_mutex()
+    , workers_start()
+    , workers_done()
+    , generation(0)
+    , busy_workers(0)
+    , stopping(false)
+    , tasks()
+    , next_task(0)
 {
     // Nothing to do here.
 }
 
+scheduler_t::~scheduler_t() { this->stop_workers(); }
+
 discrete_time_t scheduler_t::time() const { return now; }
 
-void scheduler_t::schedule(const event_t &event) { event_queue.push(event); }
+void scheduler_t::schedule(const event_t &event)
+{
+    std::size_t target = this->get_partition(event.process_info);
+    // While running in parallel, each worker can only touch the queue of its own partition.
+    if (parallel_phase && (target != current_partition)) {
+        partitions[current_partition].outbox.push_back(event);
+        return;
+    }
+    if (this->suppress(event.process_info, event.time)) {
+        return;
+    }
+    partitions[target].event_queue.push(event);
+}
 
 void scheduler_t::schedule_now(const process_info_t &proc_info)
 {
     schedule(event_t{now, proc_info});
-    digsim::trace("scheduler_t", "[#queue = {:-2}] Now: {} (now)", event_queue.size(), proc_info.to_string());
+    digsim::trace("scheduler_t", "[#queue = {:-2}] Now: {} (now)", pending_events(), proc_info.to_string());
+}
+
+void scheduler_t::schedule_now(const process_info_t &proc_info, sensitivity_mask_t mask)
+{
+    // The table is sized during initialization, processes created afterwards just do not get a mask.
+    if (proc_info.id < process_changed.size()) {
+        process_changed[proc_info.id] |= mask;
+    }
+    this->schedule_now(proc_info);
 }
 
+sensitivity_mask_t scheduler_t::get_changed_mask() const { return changed_mask; }
+
 void scheduler_t::schedule_after(const process_info_t &proc_info, discrete_time_t delay)
 {
     schedule(event_t{now + delay, proc_info});
     digsim::trace(
-        "scheduler_t", "[#queue = {:-2}] Schedule: {} (+{}t)", event_queue.size(), proc_info.to_string(), delay);
+        "scheduler_t", "[#queue = {:-2}] Schedule: {} (+{}t)", pending_events(), proc_info.to_string(), delay);
+}
+
+void scheduler_t::set_global_quantum(discrete_time_t quantum)
+{
+    digsim::trace("scheduler_t", "[#queue = {:-2}] Global quantum set to {}", pending_events(), quantum);
+    global_quantum = quantum;
+}
+
+discrete_time_t scheduler_t::get_global_quantum() const { return global_quantum; }
+
+void scheduler_t::set_partitioning(partitioning_t mode)
+{
+    if (initialized) {
+        throw std::runtime_error("The partitioning must be set before initializing the scheduler.");
+    }
+    partitioning = mode;
+}
+
+void scheduler_t::set_partition_map(const partition_map_t &map)
+{
+    if (initialized) {
+        throw std::runtime_error("The partition map must be set before initializing the scheduler.");
+    }
+    if ((map.process_partition.size() != process_table.size()) ||
+        (map.fingerprint != digsim::dependency_graph.compute_fingerprint())) {
+        throw std::runtime_error("The partition map does not match the processes of the design.");
+    }
+    partition_map = map;
+    partitioning  = partitioning_t::custom;
+}
+
+void scheduler_t::set_profiling(bool enabled)
+{
+    profiling = enabled;
+    if (profiling) {
+        activations.assign(process_table.size(), 0);
+    }
+}
+
+void scheduler_t::set_rebalancing(std::size_t interval, double tolerance)
+{
+    rebalance_interval  = interval;
+    rebalance_tolerance = std::max(tolerance, 0.0);
+    rebalance_steps     = 0;
+    rebalance_base      = activations;
+}
+
+void scheduler_t::set_num_threads(std::size_t threads)
+{
+    this->stop_workers();
+    num_threads = std::max<std::size_t>(threads, 1);
+}
+
+void scheduler_t::set_placement(placement_t _placement)
+{
+    this->stop_workers();
+    placement = _placement;
+}
+
+std::size_t scheduler_t::get_num_partitions() const { return partitions.size(); }
+
+std::size_t scheduler_t::get_partition(const process_info_t &proc_info) const
+{
+    return (proc_info.id < process_partition.size()) ? process_partition[proc_info.id] : 0;
+}
+
+bool scheduler_t::in_parallel_phase() const { return parallel_phase; }
+
+void scheduler_t::defer_update(std::function<void()> update)
+{
+    partitions[current_partition].updates.push_back(std::move(update));
+}
+
+std::size_t scheduler_t::pending_events() const
+{
+    // While running in parallel, the queues of the other partitions cannot be accessed.
+    if (parallel_phase) {
+        return partitions[current_partition].event_queue.size();
+    }
+    std::size_t count = 0;
+    for (const auto &partition : partitions) {
+        count += partition.event_queue.size();
+    }
+    return count;
+}
+
+discrete_time_t scheduler_t::next_event_time() const
+{
+    discrete_time_t time = std::numeric_limits<discrete_time_t>::max();
+    for (const auto &partition : partitions) {
+        if (!partition.event_queue.empty()) {
+            time = std::min(time, partition.event_queue.top().time);
+        }
+    }
+    return time;
+}
+
+scheduler_state_t scheduler_t::save_state() const
+{
+    scheduler_state_t state;
+    state.time             = now;
+    state.process_disabled = process_disabled;
+    state.process_pending  = process_pending;
+    for (const auto &partition : partitions) {
+        auto copy = partition.event_queue;
+        while (!copy.empty()) {
+            state.events.push_back(copy.top());
+            copy.pop();
+        }
+    }
+    return state;
+}
+
+void scheduler_t::restore_state(const scheduler_state_t &state)
+{
+    for (auto &partition : partitions) {
+        partition.event_queue = {};
+    }
+    now              = state.time;
+    process_disabled = state.process_disabled;
+    process_pending  = state.process_pending;
+    // The time steps are executed again, with a fresh delta cycle budget.
+    delta_count = 0;
+    for (const auto &event : state.events) {
+        partitions[this->get_partition(event.process_info)].event_queue.push(event);
+    }
+}
+
+void scheduler_t::set_process_enabled(const process_info_t &proc_info, bool enabled)
+{
+    // Other partitions might be reading the state of the process, wait for the end of the delta cycle.
+    if (parallel_phase) {
+        this->defer_update([this, proc_info, enabled] { this->set_process_enabled(proc_info, enabled); });
+        return;
+    }
+    if (proc_info.id >= process_disabled.size()) {
+        if (enabled) {
+            return;
+        }
+        process_disabled.resize(process_table.size(), 0);
+        process_pending.resize(process_table.size());
+    }
+    process_disabled[proc_info.id] = enabled ? 0 : 1;
+    if (!enabled) {
+        return;
+    }
+    // Re-evaluate the process only if it missed an activation, the past ones are replayed now.
+    auto pending = std::move(process_pending[proc_info.id]);
+    process_pending[proc_info.id].clear();
+    for (discrete_time_t time : pending) {
+        this->schedule(event_t{std::max(time, now), proc_info});
+        digsim::trace(
+            "scheduler_t", "[#queue = {:-2}] Replay: {} ({}t)", pending_events(), proc_info.to_string(), time);
+    }
+}
+
+bool scheduler_t::is_process_enabled(const process_info_t &proc_info) const
+{
+    return (proc_info.id >= process_disabled.size()) || !process_disabled[proc_info.id];
+}
+
+bool scheduler_t::suppress(const process_info_t &proc_info, discrete_time_t time)
+{
+    if ((proc_info.id < process_disabled.size()) && process_disabled[proc_info.id]) {
+        // The activations in the past are all replayed at the same time, only keep the earliest one.
+        auto &pending = process_pending[proc_info.id];
+        if (!pending.empty() && (*pending.begin() < now)) {
+            pending.erase(std::next(pending.begin()), pending.lower_bound(now));
+        }
+        pending.insert(time);
+        digsim::trace("scheduler_t", "[#queue = {:-2}] Suppress: {}", pending_events(), proc_info.to_string());
+        return true;
+    }
+    return false;
 }
 
 void scheduler_t::register_initializer(const process_info_t &proc_info) { initializer_queue.insert(proc_info); }
@@ -44,29 +324,75 @@ void scheduler_t::initialize()
     if (initialized) {
         digsim::trace(
             "scheduler_t", "[#queue = {:-2}] Scheduler already initialized. Skipping initialization",
-            event_queue.size());
+            pending_events());
         return;
     }
-    digsim::trace("scheduler_t", "[#queue = {:-2}] -- Check for bad cycles", event_queue.size());
-    // First, compute the cycles in the dependency graph.
-    digsim::dependency_graph.compute_cycles();
-    // Check the cycles.
-    for (const auto &cycle : digsim::dependency_graph.get_cycles()) {
-        if (digsim::dependency_graph.is_bad_cycle(cycle)) {
-            digsim::error("scheduler_t", "Bad cycle detected:");
-            digsim::dependency_graph.print_cycle_report(cycle);
-            digsim::error("scheduler_t", "Exporting DOT graph as `bad_cycle_graph.dot`.");
-            digsim::dependency_graph.export_dot("bad_cycle_graph.dot");
-            digsim::error("scheduler_t", "Exiting.");
-            std::exit(EXIT_FAILURE);
+    // Reuse the results of a previous elaboration of the same design, if any.
+    elaboration_cached = false;
+    if (!elaboration_cache_file.empty()) {
+        const std::uint64_t fingerprint = digsim::dependency_graph.compute_fingerprint();
+        elaboration_cached =
+            elaboration_cache.load(elaboration_cache_file, fingerprint) &&
+            (elaboration_cache.topological_order.size() == process_table.size()) &&
+            ((partitioning != partitioning_t::clock_domains) ||
+             (elaboration_cache.process_domain.size() == process_table.size()));
+        elaboration_cache.fingerprint = fingerprint;
+        digsim::debug(
+            "scheduler_t", "[#queue = {:-2}] Elaboration cache `{}` {}", pending_events(), elaboration_cache_file,
+            elaboration_cached ? "matches the design" : "is missing or stale");
+    }
+    if (!elaboration_cached) {
+        digsim::trace("scheduler_t", "[#queue = {:-2}] -- Check for bad cycles", pending_events());
+        // First, compute the cycles in the dependency graph.
+        digsim::dependency_graph.compute_cycles();
+        // Check the cycles.
+        for (const auto &cycle : digsim::dependency_graph.get_cycles()) {
+            if (digsim::dependency_graph.is_bad_cycle(cycle)) {
+                digsim::error("scheduler_t", "Bad cycle detected:");
+                digsim::dependency_graph.print_cycle_report(cycle);
+                digsim::error("scheduler_t", "Exporting DOT graph as `bad_cycle_graph.dot`.");
+                digsim::dependency_graph.export_dot("bad_cycle_graph.dot");
+                digsim::error("scheduler_t", "Exiting.");
+                std::exit(EXIT_FAILURE);
+            }
+        }
+        elaboration_cache.cycles_checked = true;
+    }
+    // Split the processes among the partitions.
+    this->assign_partitions();
+    // Store the results for the next elaboration.
+    if (!elaboration_cache_file.empty() && !elaboration_cached) {
+        // The topological ordering already computed the order.
+        if (ordering != ordering_t::topological) {
+            elaboration_cache.topological_order = digsim::dependency_graph.compute_topological_order();
+        }
+        elaboration_cache.process_domain.clear();
+        if (partitioning == partitioning_t::clock_domains) {
+            for (std::size_t id = 0; id < process_table.size(); ++id) {
+                elaboration_cache.process_domain.push_back(
+                    digsim::dependency_graph.get_clock_domain(process_table.get(id)));
+            }
+        }
+        // The cache only saves time, failing to write it must not stop the simulation.
+        try {
+            elaboration_cache.save(elaboration_cache_file);
+        } catch (const std::runtime_error &e) {
+            digsim::error("scheduler_t", "Elaboration cache not saved: {}", e.what());
         }
     }
     // Run all initialization callbacks.
     if (!initializer_queue.empty()) {
-        digsim::trace("scheduler_t", "[#queue = {:-2}] -- Begin initialization cylce", event_queue.size());
-        // Run all initializers.
-        for (const auto &initializer : initializer_queue) {
-            (*initializer.process)();
+        digsim::trace("scheduler_t", "[#queue = {:-2}] -- Begin initialization cylce", pending_events());
+        // Run all initializers, in the same order used for the delta cycles.
+        std::vector<process_info_t> initializers(initializer_queue.begin(), initializer_queue.end());
+        std::sort(
+            initializers.begin(), initializers.end(), [this](const process_info_t &lhs, const process_info_t &rhs) {
+                return this->get_rank(lhs.id) < this->get_rank(rhs.id);
+            });
+        for (const auto &initializer : initializers) {
+            if (!this->suppress(initializer, now)) {
+                (*initializer.process)();
+            }
         }
         // Clear the initializer queue.
         initializer_queue.clear();
@@ -76,56 +402,362 @@ void scheduler_t::initialize()
 
 void scheduler_t::run(discrete_time_t simulation_time)
 {
+    this->run_until((simulation_time > 0) ? now + simulation_time : std::numeric_limits<discrete_time_t>::max());
+}
+
+void scheduler_t::run_until(discrete_time_t end_time)
+{
+    // A stop requested while not running, e.g., by a signal set from the testbench, must not pause this run.
+    stop_requested.store(false);
     if (!initialized) {
         digsim::trace(
-            "scheduler_t", "[#queue = {:-2}] Scheduler not initialized. Calling initialize()", event_queue.size());
+            "scheduler_t", "[#queue = {:-2}] Scheduler not initialized. Calling initialize()", pending_events());
         initialize();
     }
-    // This will hold the batched processes to be executed.
-    std::set<std::shared_ptr<process_t>> batch;
-    discrete_time_t simulation_end = now + simulation_time;
-    while (!event_queue.empty()) {
-        discrete_time_t current_time = event_queue.top().time;
+    // This will hold the partitions that have something to execute.
+    std::vector<std::size_t> active;
+    stop_honoured = false;
+    while (true) {
+        // Find the time of the next event, among all partitions.
+        bool found                   = false;
+        discrete_time_t current_time = 0;
+        for (const auto &partition : partitions) {
+            if (!partition.event_queue.empty() && (!found || (partition.event_queue.top().time < current_time))) {
+                current_time = partition.event_queue.top().time;
+                found        = true;
+            }
+        }
+        // No more events.
+        if (!found) {
+            break;
+        }
         // Next event is beyond the allowed time.
-        if ((simulation_time > 0) && (current_time > simulation_end)) {
+        if (current_time > end_time) {
             break;
         }
-        digsim::trace("scheduler_t", "[#queue = {:-2}] -- Begin cylce", event_queue.size());
+        // Stop a time step that keeps spinning.
+        if (this->count_delta(current_time)) {
+            this->report_delta_storm();
+            if (delta_policy == delta_policy_t::abort) {
+                throw std::runtime_error(
+                    "Time step " + std::to_string(current_time) + " exceeded the limit of " +
+                    std::to_string(delta_limit) + " delta cycles.");
+            }
+            // Give the time step a fresh budget, in case the simulation is resumed.
+            delta_count   = 0;
+            stop_honoured = true;
+            break;
+        }
+        digsim::trace("scheduler_t", "[#queue = {:-2}] -- Begin cylce", pending_events());
+        // Between two time steps nothing is in flight, processes can move to another partition.
+        if ((rebalance_interval > 0) && (partitions.size() > 1) && (current_time != now) &&
+            (++rebalance_steps >= rebalance_interval)) {
+            rebalance_steps = 0;
+            this->rebalance();
+        }
         // Update the current time.
         now = current_time;
-        // Clear the batch for this time.
-        batch.clear();
-        // Extract all callbacks scheduled for this time
-        while (!event_queue.empty() && event_queue.top().time == current_time) {
-            if (batch.insert(event_queue.top().process_info.process).second) {
-                digsim::trace(
-                    "scheduler_t", "[#queue = {:-2}]     Pop: {}", event_queue.size(),
-                    event_queue.top().process_info.to_string());
+        // Extract all callbacks scheduled for this time, partition by partition.
+        active.clear();
+        for (std::size_t index = 0; index < partitions.size(); ++index) {
+            auto &partition = partitions[index];
+            // Clear the batch for this time.
+            partition.batch.clear();
+            while (!partition.event_queue.empty() && partition.event_queue.top().time == current_time) {
+                const auto &proc_info = partition.event_queue.top().process_info;
+                // The process might have been disabled after the event was scheduled.
+                if (this->suppress(proc_info, current_time)) {
+                    partition.event_queue.pop();
+                    continue;
+                }
+                auto entry = std::make_pair(proc_info.id, proc_info.process);
+                if (partition.batch.emplace(this->get_rank(proc_info.id), std::move(entry)).second) {
+                    digsim::trace(
+                        "scheduler_t", "[#queue = {:-2}]     Pop: {}", pending_events(), proc_info.to_string());
+                }
+                partition.event_queue.pop();
             }
-            event_queue.pop();
+            if (!partition.batch.empty()) {
+                active.push_back(index);
+            }
+        }
+        if (storm_tracing) {
+            this->trace_batches();
         }
-        // Now run the batch.
-        if (!batch.empty()) {
-            digsim::trace("scheduler_t", "[#queue = {:-2}] -- Run batch", event_queue.size());
-            for (auto &callback : batch) {
-                (*callback)();
+        // Now run the batches.
+        digsim::trace("scheduler_t", "[#queue = {:-2}] -- Run batch", pending_events());
+        if (partitions.size() == 1) {
+            for (auto index : active) {
+                this->run_partition(index);
             }
+        } else if ((num_threads > 1) && (active.size() > 1)) {
+            this->run_parallel(active);
+        } else {
+            this->run_serial(active);
+        }
+        if (race_detection) {
+            this->check_races();
+        }
+        if (logger.get_level() >= log_level_t::trace) {
+            print_event_queue();
         }
-        print_event_queue();
+        // Return control to the caller if a process asked to pause the simulation.
+        if (stop_requested.exchange(false)) {
+            digsim::debug("scheduler_t", "Simulation paused at time {}", now);
+            stop_honoured = true;
+            break;
+        }
+    }
+}
+
+void scheduler_t::request_stop() { stop_requested.store(true); }
+
+void scheduler_t::set_ordering(ordering_t mode, std::uint64_t seed)
+{
+    if (initialized) {
+        throw std::runtime_error("The ordering must be set before initializing the scheduler.");
+    }
+    ordering      = mode;
+    ordering_seed = seed;
+}
+
+ordering_t scheduler_t::get_ordering() const { return ordering; }
+
+void scheduler_t::set_elaboration_cache(const std::string &filename)
+{
+    if (initialized) {
+        throw std::runtime_error("The elaboration cache must be set before initializing the scheduler.");
+    }
+    elaboration_cache_file = filename;
+}
+
+bool scheduler_t::is_elaboration_cached() const { return elaboration_cached; }
+
+void scheduler_t::set_race_detection(bool enabled)
+{
+    race_detection = enabled;
+    accesses.clear();
+}
+
+void scheduler_t::record_read(const isignal_t *signal, bool woken)
+{
+    // Reads outside of a delta cycle, from the process itself, or waking up the reader are not order-dependent.
+    if ((current_process == std::numeric_limits<std::size_t>::max()) || woken) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(accesses_mutex);
+    accesses[signal].readers.push_back(current_process);
+}
+
+void scheduler_t::record_read(const isignal_t *signal, std::function<bool()> woken)
+{
+    if (current_process == std::numeric_limits<std::size_t>::max()) {
+        return;
     }
+    std::lock_guard<std::mutex> lock(accesses_mutex);
+    accesses[signal].guarded_readers.emplace_back(current_process, std::move(woken));
 }
 
+void scheduler_t::record_write(const isignal_t *signal)
+{
+    std::lock_guard<std::mutex> lock(accesses_mutex);
+    if (storm_tracing && !storm_signals.empty()) {
+        storm_signals.back().push_back(signal);
+    }
+    if (race_detection && (current_process != std::numeric_limits<std::size_t>::max())) {
+        accesses[signal].writers.push_back(current_process);
+    }
+}
+
+void scheduler_t::set_delta_limit(std::size_t limit, delta_policy_t policy)
+{
+    delta_limit  = limit;
+    delta_policy = policy;
+}
+
+std::size_t scheduler_t::get_delta_limit() const { return delta_limit; }
+
+const delta_storm_t &scheduler_t::get_delta_storm() const { return delta_storm; }
+
+bool scheduler_t::count_delta(discrete_time_t time)
+{
+    /// The number of delta cycles before the limit whose processes and signals are reported.
+    constexpr std::size_t storm_depth = 4;
+    if ((time != delta_time) || (delta_count == 0)) {
+        delta_time    = time;
+        delta_count   = 0;
+        storm_tracing = false;
+        storm_processes.clear();
+        storm_signals.clear();
+    }
+    ++delta_count;
+    if (delta_limit == 0) {
+        return false;
+    }
+    if (delta_count > delta_limit) {
+        return true;
+    }
+    // Start recording the last delta cycles before the limit.
+    if (delta_count + storm_depth > delta_limit) {
+        storm_tracing = true;
+        storm_processes.emplace_back();
+        storm_signals.emplace_back();
+    }
+    return false;
+}
+
+void scheduler_t::trace_batches()
+{
+    for (const auto &partition : partitions) {
+        for (const auto &[rank, entry] : partition.batch) {
+            storm_processes.back().push_back(entry.first);
+        }
+    }
+}
+
+void scheduler_t::report_delta_storm()
+{
+    delta_storm        = delta_storm_t{};
+    delta_storm.time   = delta_time;
+    delta_storm.deltas = delta_count - 1;
+    // Collect the hierarchical names of the processes, without duplicates.
+    for (const auto &batch : storm_processes) {
+        for (std::size_t id : batch) {
+            // Use the same notation of get_signal_location_string(), e.g., `top::cpu::alu.evaluate`.
+            const auto &proc_info = process_table.get(id);
+            std::string path      = proc_info.owner.name() + "." + proc_info.name;
+            const auto *module    = dynamic_cast<const module_t *>(proc_info.owner.ptr);
+            for (module = module ? module->get_parent() : nullptr; module; module = module->get_parent()) {
+                path = module->get_name() + "::" + path;
+            }
+            if (std::find(delta_storm.processes.begin(), delta_storm.processes.end(), path) ==
+                delta_storm.processes.end()) {
+                delta_storm.processes.push_back(path);
+            }
+        }
+    }
+    for (const auto &writes : storm_signals) {
+        for (const auto *signal : writes) {
+            std::string path = get_signal_location_string(signal);
+            if (std::find(delta_storm.signals.begin(), delta_storm.signals.end(), path) == delta_storm.signals.end()) {
+                delta_storm.signals.push_back(path);
+            }
+        }
+    }
+    storm_tracing = false;
+    storm_processes.clear();
+    storm_signals.clear();
+    digsim::error(
+        "scheduler_t", "[#queue = {:-2}] Time step {} exceeded the limit of {} delta cycles", pending_events(),
+        delta_storm.time, delta_limit);
+    for (const auto &process : delta_storm.processes) {
+        digsim::error("scheduler_t", "[#queue = {:-2}]     Process: {}", pending_events(), process);
+    }
+    for (const auto &signal : delta_storm.signals) {
+        digsim::error("scheduler_t", "[#queue = {:-2}]     Signal : {}", pending_events(), signal);
+    }
+}
+
+const std::vector<race_t> &scheduler_t::get_races() const { return races; }
+
+std::size_t scheduler_t::get_current_process() const { return current_process; }
+
+void scheduler_t::compute_ranks()
+{
+    const std::size_t num_processes = process_table.size();
+    std::vector<std::size_t> order(num_processes);
+    if (ordering == ordering_t::topological) {
+        // Keep the order computed on a miss, it is also the one stored in the elaboration cache.
+        if (!elaboration_cached) {
+            elaboration_cache.topological_order = digsim::dependency_graph.compute_topological_order();
+        }
+        order = elaboration_cache.topological_order;
+    } else {
+        for (std::size_t id = 0; id < num_processes; ++id) {
+            order[id] = id;
+        }
+        if (ordering == ordering_t::shuffled) {
+            // The generator is fully specified by the standard, thus, the order only depends on the seed.
+            std::mt19937_64 generator(ordering_seed);
+            for (std::size_t i = num_processes; i > 1; --i) {
+                std::swap(order[i - 1], order[generator() % i]);
+            }
+        }
+    }
+    process_rank.assign(num_processes, 0);
+    for (std::size_t rank = 0; rank < order.size(); ++rank) {
+        process_rank[order[rank]] = rank;
+    }
+}
+
+std::size_t scheduler_t::get_rank(std::size_t id) const
+{
+    return (id < process_rank.size()) ? process_rank[id] : id;
+}
+
+void scheduler_t::check_races()
+{
+    // Visit the signals in a stable order, so that the report does not depend on memory layout.
+    std::vector<std::pair<const isignal_t *, access_t *>> signals;
+    for (auto &[signal, access] : accesses) {
+        if (!access.writers.empty()) {
+            signals.emplace_back(signal, &access);
+        }
+    }
+    std::sort(signals.begin(), signals.end(), [](const auto &lhs, const auto &rhs) {
+        return lhs.first->get_name() < rhs.first->get_name();
+    });
+    auto describe = [](std::size_t id) {
+        const auto &proc_info = process_table.get(id);
+        return proc_info.owner.name() + "." + proc_info.name;
+    };
+    auto report = [&](race_kind_t kind, const isignal_t *signal, std::size_t first, std::size_t second) {
+        race_t race{now, kind, signal->get_name(), describe(first), describe(second)};
+        digsim::error(
+            "scheduler_t", "[#queue = {:-2}] Race on `{}` at time {}: `{}` {} `{}`", pending_events(), race.signal,
+            race.time, race.first, kind == race_kind_t::write_write ? "and" : "writes while", race.second);
+        races.push_back(std::move(race));
+    };
+    for (auto &[signal, access] : signals) {
+        auto &writers = access->writers;
+        auto &readers = access->readers;
+        // The signal holds the last value written, the readers it does not wake up might have missed it.
+        for (const auto &[reader, woken] : access->guarded_readers) {
+            if (!woken()) {
+                readers.push_back(reader);
+            }
+        }
+        std::sort(writers.begin(), writers.end());
+        writers.erase(std::unique(writers.begin(), writers.end()), writers.end());
+        std::sort(readers.begin(), readers.end());
+        readers.erase(std::unique(readers.begin(), readers.end()), readers.end());
+        for (std::size_t i = 1; i < writers.size(); ++i) {
+            report(race_kind_t::write_write, signal, writers[0], writers[i]);
+        }
+        for (std::size_t reader : readers) {
+            if (!std::binary_search(writers.begin(), writers.end(), reader)) {
+                report(race_kind_t::read_write, signal, writers[0], reader);
+            }
+        }
+    }
+    accesses.clear();
+}
+
+bool scheduler_t::stopped() const { return stop_honoured; }
+
 void scheduler_t::print_event_queue() const
 {
-    std::priority_queue<event_t, std::vector<event_t>, std::greater<>> copy = event_queue;
     std::unordered_map<discrete_time_t, std::vector<std::string>> time_buckets;
-    while (!copy.empty()) {
-        const auto &ev = copy.top();
-        time_buckets[ev.time].push_back(ev.process_info.to_string());
-        copy.pop();
+    for (const auto &partition : partitions) {
+        std::priority_queue<event_t, std::vector<event_t>, std::greater<>> copy = partition.event_queue;
+        while (!copy.empty()) {
+            const auto &ev = copy.top();
+            time_buckets[ev.time].push_back(ev.process_info.to_string());
+            copy.pop();
+        }
     }
     if (!time_buckets.empty()) {
-        digsim::trace("scheduler_t", "[#queue = {:-2}] -- Event queue", event_queue.size());
+        digsim::trace("scheduler_t", "[#queue = {:-2}] -- Event queue", pending_events());
         for (const auto &[t, names] : time_buckets) {
             std::stringstream ss;
             ss << "    Queue [" << std::right << std::setw(3) << t << "] : [ ";
@@ -133,10 +765,380 @@ void scheduler_t::print_event_queue() const
                 ss << n << " ";
             }
             ss << "]";
-            digsim::trace("scheduler_t", "[#queue = {:-2}] {}", event_queue.size(), ss.str());
+            digsim::trace("scheduler_t", "[#queue = {:-2}] {}", pending_events(), ss.str());
+        }
+    } else {
+        digsim::trace("scheduler_t", "[#queue = {:-2}] -- Event queue is empty", pending_events());
+    }
+}
+
+void scheduler_t::assign_partitions()
+{
+    std::size_t num_partitions = 1;
+    process_partition.assign(process_table.size(), 0);
+    process_changed.resize(process_table.size(), 0);
+    activations.resize(process_table.size(), 0);
+    this->compute_ranks();
+    if (partitioning == partitioning_t::clock_domains) {
+        if (elaboration_cached) {
+            digsim::dependency_graph.restore_clock_domains(elaboration_cache.process_domain);
+        } else {
+            digsim::dependency_graph.compute_clock_domains();
+        }
+        num_partitions = digsim::dependency_graph.get_clock_domains().size();
+        for (std::size_t id = 0; id < process_partition.size(); ++id) {
+            process_partition[id] = digsim::dependency_graph.get_clock_domain(process_table.get(id));
+        }
+        digsim::dependency_graph.print_clock_domain_report();
+    } else if (partitioning == partitioning_t::custom) {
+        if (partition_map.process_partition.size() != process_table.size()) {
+            throw std::runtime_error("The partition map does not match the processes of the design.");
+        }
+        digsim::dependency_graph.restore_clock_domains(partition_map.process_partition);
+        num_partitions = std::max(partition_map.num_partitions, digsim::dependency_graph.get_clock_domains().size());
+        process_partition = partition_map.process_partition;
+        digsim::dependency_graph.print_clock_domain_report();
+    }
+    // Collect the events scheduled during elaboration...
+    std::vector<event_t> pending;
+    for (auto &partition : partitions) {
+        while (!partition.event_queue.empty()) {
+            pending.push_back(partition.event_queue.top());
+            partition.event_queue.pop();
+        }
+    }
+    // ...and move them to the partition of their process.
+    partitions = std::vector<partition_t>(num_partitions);
+    for (const auto &event : pending) {
+        this->schedule(event);
+    }
+    digsim::debug("scheduler_t", "Using {} partition(s) on {} thread(s)", partitions.size(), num_threads);
+}
+
+void scheduler_t::run_partition(std::size_t index)
+{
+    for (const auto &[rank, entry] : partitions[index].batch) {
+        const auto &[id, callback] = entry;
+        if (id < process_changed.size()) {
+            changed_mask        = process_changed[id];
+            process_changed[id] = 0;
+        }
+        if ((profiling || (rebalance_interval > 0)) && (id < activations.size())) {
+            ++activations[id];
+        }
+        current_process = id;
+        (*callback)();
+        current_process = std::numeric_limits<std::size_t>::max();
+        changed_mask    = 0;
+    }
+}
+
+void scheduler_t::build_migration_units()
+{
+    const auto edges = digsim::dependency_graph.get_process_edges();
+    // A process owned by a signal wakes up the consumers of the signal, it must stay with the producer.
+    std::vector<std::size_t> leader(process_table.size());
+    std::iota(leader.begin(), leader.end(), std::size_t{0});
+    for (const auto &edge : edges) {
+        if ((edge.producer < leader.size()) && (edge.consumer < leader.size()) &&
+            (dynamic_cast<const isignal_t *>(process_table.get(edge.consumer).owner.ptr) == edge.signal)) {
+            leader[edge.consumer] = edge.producer;
+        }
+    }
+    migration_unit.assign(process_table.size(), 0);
+    unit_processes.clear();
+    std::vector<std::size_t> unit_of(process_table.size(), std::numeric_limits<std::size_t>::max());
+    for (std::size_t id = 0; id < leader.size(); ++id) {
+        auto &unit = unit_of[leader[id]];
+        if (unit == std::numeric_limits<std::size_t>::max()) {
+            unit = unit_processes.size();
+            unit_processes.emplace_back();
+        }
+        migration_unit[id] = unit;
+        unit_processes[unit].push_back(id);
+    }
+    unit_neighbours.assign(unit_processes.size(), {});
+    for (const auto &edge : edges) {
+        if ((edge.producer >= leader.size()) || (edge.consumer >= leader.size())) {
+            continue;
+        }
+        const std::size_t producer = migration_unit[edge.producer], consumer = migration_unit[edge.consumer];
+        if (producer != consumer) {
+            unit_neighbours[producer].push_back(consumer);
+            unit_neighbours[consumer].push_back(producer);
+        }
+    }
+}
+
+void scheduler_t::rebalance()
+{
+    if (migration_unit.size() != process_table.size()) {
+        this->build_migration_units();
+    }
+    // The activations of each unit, and of each partition, since the last check.
+    const std::size_t num_processes = std::min({activations.size(), process_partition.size(), migration_unit.size()});
+    rebalance_base.resize(activations.size(), 0);
+    std::vector<std::uint64_t> unit_load(unit_processes.size(), 0);
+    std::vector<std::uint64_t> loads(partitions.size(), 0);
+    std::vector<std::size_t> unit_partition(unit_processes.size(), 0);
+    for (std::size_t id = 0; id < num_processes; ++id) {
+        // The counters are cleared when the profiling is enabled again.
+        const std::uint64_t count = (activations[id] >= rebalance_base[id]) ? activations[id] - rebalance_base[id]
+                                                                             : activations[id];
+        unit_load[migration_unit[id]] += count;
+        loads[process_partition[id]] += count;
+        unit_partition[migration_unit[id]] = process_partition[id];
+    }
+    rebalance_base = activations;
+    const std::uint64_t total = std::accumulate(loads.begin(), loads.end(), std::uint64_t{0});
+    const double limit =
+        static_cast<double>(total) / static_cast<double>(partitions.size()) * (1.0 + rebalance_tolerance);
+    std::size_t moved = 0;
+    // Each round relieves the busiest partition, by moving processes to the idlest one.
+    for (std::size_t round = 0; round < partitions.size(); ++round) {
+        const auto busiest = static_cast<std::size_t>(std::max_element(loads.begin(), loads.end()) - loads.begin());
+        const auto idlest  = static_cast<std::size_t>(std::min_element(loads.begin(), loads.end()) - loads.begin());
+        if (static_cast<double>(loads[busiest]) <= limit) {
+            break;
+        }
+        // The gain of a unit is the number of its signals going to the idlest partition, minus the ones it would cut
+        // from the busiest. Units with the highest gain move first, idle units stay where they are.
+        const std::uint64_t target = (loads[busiest] - loads[idlest]) / 2;
+        std::vector<std::int64_t> gain(unit_processes.size(), 0);
+        std::set<std::pair<std::int64_t, std::size_t>> candidates;
+        for (std::size_t unit = 0; unit < unit_processes.size(); ++unit) {
+            if ((unit_partition[unit] != busiest) || (unit_load[unit] == 0) || (unit_load[unit] > target)) {
+                continue;
+            }
+            for (std::size_t neighbour : unit_neighbours[unit]) {
+                if (unit_partition[neighbour] == idlest) {
+                    ++gain[unit];
+                } else if (unit_partition[neighbour] == busiest) {
+                    --gain[unit];
+                }
+            }
+            candidates.emplace(-gain[unit], unit);
+        }
+        std::uint64_t shifted = 0;
+        std::size_t count     = 0;
+        while (!candidates.empty()) {
+            const std::size_t unit = candidates.begin()->second;
+            candidates.erase(candidates.begin());
+            if (shifted + unit_load[unit] > target) {
+                continue;
+            }
+            unit_partition[unit] = idlest;
+            shifted += unit_load[unit];
+            count += unit_processes[unit].size();
+            // The signals shared with the unit now go to the idlest partition.
+            for (std::size_t neighbour : unit_neighbours[unit]) {
+                if (candidates.erase({-gain[neighbour], neighbour}) > 0) {
+                    gain[neighbour] += 2;
+                    candidates.emplace(-gain[neighbour], neighbour);
+                }
+            }
+        }
+        if (count == 0) {
+            break;
+        }
+        digsim::debug(
+            "scheduler_t", "Moved {} process(es) from partition {} to {} at time {}, {} of {} activations", count,
+            busiest, idlest, now, shifted, loads[busiest]);
+        loads[busiest] -= shifted;
+        loads[idlest] += shifted;
+        moved += count;
+    }
+    if (moved == 0) {
+        return;
+    }
+    migrations += moved;
+    for (std::size_t id = 0; id < num_processes; ++id) {
+        process_partition[id] = unit_partition[migration_unit[id]];
+    }
+    // Mark the signals which now go from a partition to another...
+    digsim::dependency_graph.restore_clock_domains(process_partition);
+    // ...and move the pending events to the partition of their process.
+    std::vector<event_t> pending;
+    for (auto &partition : partitions) {
+        while (!partition.event_queue.empty()) {
+            pending.push_back(partition.event_queue.top());
+            partition.event_queue.pop();
+        }
+    }
+    for (const auto &event : pending) {
+        this->schedule(event);
+    }
+}
+
+void scheduler_t::run_serial(const std::vector<std::size_t> &active)
+{
+    // Behave as if the partitions were running concurrently, so that the results match the parallel execution.
+    parallel_phase = true;
+    for (auto index : active) {
+        current_partition = index;
+        this->run_partition(index);
+    }
+    parallel_phase = false;
+    this->commit(active);
+}
+
+void scheduler_t::commit(const std::vector<std::size_t> &active)
+{
+    // Partitions are visited in order, so that the outcome does not depend on which thread executed what.
+    for (auto index : active) {
+        auto &partition = partitions[index];
+        for (const auto &event : partition.outbox) {
+            this->schedule(event);
+        }
+        partition.outbox.clear();
+        for (const auto &update : partition.updates) {
+            update();
+        }
+        partition.updates.clear();
+    }
+}
+
+void scheduler_t::run_parallel(const std::vector<std::size_t> &active)
+{
+    if (workers.empty()) {
+        this->start_workers();
+    }
+    // Publish the tasks and wake up the workers.
+    {
+        std::lock_guard<std::mutex> lock(workers_mutex);
+        tasks = active;
+        next_task.store(0);
+        busy_workers = workers.size();
+        ++generation;
+    }
+    workers_start.notify_all();
+    // The calling thread takes part in the execution as well.
+    this->drain_tasks(0);
+    // Wait for the workers to complete.
+    {
+        std::unique_lock<std::mutex> lock(workers_mutex);
+        workers_done.wait(lock, [this] { return busy_workers == 0; });
+    }
+    // Forward the events targeting other partitions, and commit the updates of crossing signals.
+    this->commit(active);
+}
+
+void scheduler_t::start_workers()
+{
+    stopping = false;
+    if (placement != placement_t::none) {
+        if (topology.nodes.empty()) {
+            topology = cpu_topology_t::detect();
+        }
+        caller_cpus = get_thread_cpus();
+        this->place_thread(0);
+    }
+    // Wait for the workers to be placed, they touch the storage of their partitions.
+    {
+        std::lock_guard<std::mutex> lock(workers_mutex);
+        busy_workers = num_threads - 1;
+    }
+    for (std::size_t slot = 1; slot < num_threads; ++slot) {
+        workers.emplace_back(&scheduler_t::worker_loop, this, slot, generation);
+    }
+    std::unique_lock<std::mutex> lock(workers_mutex);
+    workers_done.wait(lock, [this] { return busy_workers == 0; });
+}
+
+void scheduler_t::stop_workers()
+{
+    {
+        std::lock_guard<std::mutex> lock(workers_mutex);
+        stopping = true;
+    }
+    workers_start.notify_all();
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+    // Give the calling thread its CPUs back.
+    if (!caller_cpus.empty()) {
+        set_thread_cpus(caller_cpus);
+        caller_cpus.clear();
+    }
+}
+
+void scheduler_t::worker_loop(std::size_t slot, std::size_t last_generation)
+{
+    this->place_thread(slot);
+    {
+        std::lock_guard<std::mutex> lock(workers_mutex);
+        --busy_workers;
+    }
+    workers_done.notify_one();
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(workers_mutex);
+            workers_start.wait(lock, [&] { return stopping || (generation != last_generation); });
+            if (stopping) {
+                return;
+            }
+            last_generation = generation;
+        }
+        this->drain_tasks(slot);
+        {
+            std::lock_guard<std::mutex> lock(workers_mutex);
+            --busy_workers;
+        }
+        workers_done.notify_one();
+    }
+}
+
+void scheduler_t::drain_tasks(std::size_t slot)
+{
+    parallel_phase = true;
+    if (placement == placement_t::none) {
+        for (std::size_t task = next_task.fetch_add(1); task < tasks.size(); task = next_task.fetch_add(1)) {
+            current_partition = tasks[task];
+            this->run_partition(current_partition);
         }
     } else {
-        digsim::trace("scheduler_t", "[#queue = {:-2}] -- Event queue is empty", event_queue.size());
+        // Each partition stays on the thread, and thus on the node, which holds its memory.
+        for (auto index : tasks) {
+            if (index % num_threads == slot) {
+                current_partition = index;
+                this->run_partition(current_partition);
+            }
+        }
+    }
+    parallel_phase = false;
+}
+
+void scheduler_t::place_thread(std::size_t slot)
+{
+    if (placement == placement_t::none) {
+        return;
+    }
+    const int cpu = topology.cpu_of(placement, slot);
+    if ((cpu < 0) || !pin_thread(cpu)) {
+        digsim::error("scheduler_t", "Cannot pin thread {} to a CPU, it is left to the operating system", slot);
+        return;
+    }
+    digsim::debug("scheduler_t", "Thread {} pinned to CPU {} of node {}", slot, cpu, topology.node_of(placement, slot));
+    for (std::size_t index = slot; index < partitions.size(); index += num_threads) {
+        auto &partition = partitions[index];
+        // Move the storage to memory allocated, and touched first, by this thread. The signals and the processes
+        // belong to the design, and cannot be moved.
+        std::vector<event_t> events;
+        events.reserve(std::max<std::size_t>(partition.event_queue.size(), 64));
+        while (!partition.event_queue.empty()) {
+            events.push_back(partition.event_queue.top());
+            partition.event_queue.pop();
+        }
+        partition.event_queue = decltype(partition.event_queue)(std::greater<>(), std::move(events));
+        std::vector<event_t> outbox;
+        outbox.reserve(std::max<std::size_t>(partition.outbox.capacity(), 64));
+        outbox.insert(outbox.end(), partition.outbox.begin(), partition.outbox.end());
+        partition.outbox.swap(outbox);
+        std::vector<std::function<void()>> updates;
+        updates.reserve(std::max<std::size_t>(partition.updates.capacity(), 64));
+        std::move(partition.updates.begin(), partition.updates.end(), std::back_inserter(updates));
+        partition.updates.swap(updates);
     }
 }
 
@@ -0,0 +1,74 @@
+/// @file state_log.cpp
+/// @brief Implementation of the incremental saving of the simulation state.
+/// @copyright
+/// This file is distributed under the terms of the MIT License.
+/// See the full license in the root directory at LICENSE.md.
+
+#include "digsim/state_log.hpp"
+
+#include <stdexcept>
+#include <string>
+
+namespace digsim
+{
+
+state_log_t::state_log_t()
+    : enabled(false)
+    , base(0)
+    , entries()
+    , saved()
+    , mutex()
+{
+    // Nothing to do here.
+}
+
+state_log_t &state_log_t::instance()
+{
+    static state_log_t instance;
+    return instance;
+}
+
+void state_log_t::enable(bool _enabled)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    enabled = _enabled;
+    base += entries.size();
+    entries.clear();
+    saved.clear();
+}
+
+void state_log_t::record(std::function<void()> undo)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.push_back(std::move(undo));
+}
+
+std::size_t state_log_t::mark()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    saved.clear();
+    return base + entries.size();
+}
+
+void state_log_t::rollback(std::size_t position)
+{
+    if (position < base) {
+        throw std::runtime_error("Cannot undo the changes before position " + std::to_string(base) + ".");
+    }
+    // The undo functions write the state directly, they never record anything.
+    while (base + entries.size() > position) {
+        entries.back()();
+        entries.pop_back();
+    }
+    saved.clear();
+}
+
+void state_log_t::forget(std::size_t position)
+{
+    while ((base < position) && !entries.empty()) {
+        entries.pop_front();
+        ++base;
+    }
+}
+
+} // namespace digsim
@@ -0,0 +1,68 @@
+/// @file netlist_counter.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief A counter made of flip-flops and full adders, shared by the tests of the netlists and of their kernels.
+
+#pragma once
+
+#include <digsim/digsim.hpp>
+
+#include <d_flip_flop.hpp>
+#include <full_adder.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+/// @brief A counter: flip-flops holding the value, and full adders adding one at each rising edge of the clock.
+struct netlist_counter_t {
+    /// @brief The clock, the constant inputs of the adders, and the controls of the flip-flops.
+    digsim::signal_t<bool> clk_out;
+    digsim::signal_t<bool> one;
+    digsim::signal_t<bool> zero;
+    digsim::signal_t<bool> enable;
+    digsim::signal_t<bool> reset;
+    /// @brief The value, its negation, the sum, and the carry of each bit.
+    std::vector<std::unique_ptr<digsim::signal_t<bool>>> q, q_not, sum, carry;
+    /// @brief The clock, created after the signals of the bits.
+    std::unique_ptr<digsim::clock_t> clk;
+    /// @brief The full adder and the flip-flop of each bit.
+    std::vector<std::unique_ptr<FullAdder>> adders;
+    std::vector<std::unique_ptr<DFlipFlop>> flip_flops;
+
+    /// @brief Constructor.
+    /// @param bits the number of bits of the counter.
+    explicit netlist_counter_t(std::size_t bits)
+        : clk_out("clk_out")
+        , one("one", true)
+        , zero("zero", false)
+        , enable("enable", true)
+        , reset("reset", false)
+    {
+        for (std::size_t bit = 0; bit < bits; ++bit) {
+            const std::string suffix = std::to_string(bit);
+            // The clock-to-output delay keeps the loop through the adders from being a combinational cycle.
+            q.push_back(std::make_unique<digsim::signal_t<bool>>("q" + suffix, false, 1));
+            q_not.push_back(std::make_unique<digsim::signal_t<bool>>("q_not" + suffix));
+            sum.push_back(std::make_unique<digsim::signal_t<bool>>("sum" + suffix));
+            carry.push_back(std::make_unique<digsim::signal_t<bool>>("carry" + suffix));
+        }
+        clk = std::make_unique<digsim::clock_t>("clk", 10);
+        clk->out(clk_out);
+        for (std::size_t bit = 0; bit < bits; ++bit) {
+            const std::string suffix = std::to_string(bit);
+            adders.push_back(std::make_unique<FullAdder>("adder" + suffix));
+            adders[bit]->a(*q[bit]);
+            adders[bit]->b(bit == 0 ? one : zero);
+            adders[bit]->cin(bit == 0 ? zero : *carry[bit - 1]);
+            adders[bit]->sum(*sum[bit]);
+            adders[bit]->cout(*carry[bit]);
+            flip_flops.push_back(std::make_unique<DFlipFlop>("ff" + suffix));
+            flip_flops[bit]->clk(clk_out);
+            flip_flops[bit]->d(*sum[bit]);
+            flip_flops[bit]->enable(enable);
+            flip_flops[bit]->reset(reset);
+            flip_flops[bit]->q(*q[bit]);
+            flip_flops[bit]->q_not(*q_not[bit]);
+        }
+    }
+};
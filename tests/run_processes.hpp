@@ -0,0 +1,56 @@
+/// @file run_processes.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Runs the two halves of a design split across two processes, for the tests of the distributed simulation.
+
+#pragma once
+
+#include <digsim/logger.hpp>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <exception>
+#include <functional>
+#include <string>
+#include <vector>
+
+/// @brief Runs the two halves in two child processes, and waits for them.
+/// @param name the name of the scenario.
+/// @param first runs the first half.
+/// @param second runs the second half.
+/// @return true if both halves succeeded.
+inline bool
+run_processes(const std::string &name, const std::function<int()> &first, const std::function<int()> &second)
+{
+    std::vector<pid_t> children;
+    for (const auto *half : {&first, &second}) {
+        const pid_t pid = fork();
+        if (pid < 0) {
+            digsim::error("Test", "[{}] Cannot fork", name);
+            return false;
+        }
+        if (pid == 0) {
+            int result = 1;
+            try {
+                result = (*half)();
+            } catch (const std::exception &e) {
+                digsim::error("Test", "[{}] {}", name, e.what());
+            }
+            // Leave without running the destructors of the parent, but keep the logs.
+            std::fflush(nullptr);
+            _exit(result);
+        }
+        children.push_back(pid);
+    }
+    bool success = true;
+    for (pid_t pid : children) {
+        int status = 0;
+        waitpid(pid, &status, 0);
+        success = success && WIFEXITED(status) && (WEXITSTATUS(status) == 0);
+    }
+    if (!success) {
+        digsim::error("Test", "[{}] A half of the design failed", name);
+    }
+    return success;
+}
@@ -0,0 +1,133 @@
+/// @file test_activity.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Tests the switching activity and its SAIF export.
+
+#include <digsim/digsim.hpp>
+
+#include <sstream>
+
+/// @brief Counts the rising edges of the clock.
+class counter_t : public digsim::module_t
+{
+public:
+    digsim::input_t<bool> clk;
+    digsim::output_t<uint8_t> count;
+
+    counter_t(const std::string &_name)
+        : digsim::module_t(_name)
+        , clk("clk", this)
+        , count("count", this)
+    {
+        ADD_SENSITIVITY_WHEN(counter_t, evaluate, clk, digsim::when_equals(true));
+        ADD_PRODUCER(counter_t, evaluate, count);
+    }
+
+private:
+    void evaluate()
+    {
+        if (clk.posedge()) {
+            count.set(static_cast<uint8_t>(count.get() + 1));
+        }
+    }
+};
+
+int main()
+{
+    digsim::logger.set_level(digsim::log_level_t::info);
+
+    digsim::signal_t<bool> clk_out("clk_out");
+    digsim::signal_t<uint8_t> count("count");
+
+    digsim::clock_t clk("clk", 10);
+    clk.out(clk_out);
+
+    counter_t counter("counter");
+    counter.clk(clk_out);
+    counter.count(count);
+
+    digsim::activity.enable();
+    digsim::scheduler.initialize();
+    digsim::scheduler.run(100);
+
+    // The clock rises at 5, 15, ..., 95, and falls at 10, 20, ..., 100.
+    if (digsim::activity.get_toggles("clk_out") != 20 || digsim::activity.get_time_high("clk_out") != 50 ||
+        digsim::activity.get_time_low("clk_out") != 50) {
+        digsim::error(
+            "Test", "clk_out: TC {}, T1 {}, T0 {}", digsim::activity.get_toggles("clk_out"),
+            digsim::activity.get_time_high("clk_out"), digsim::activity.get_time_low("clk_out"));
+        return 1;
+    }
+    // The counter goes from 1 to 10, one step at each rising edge.
+    if (digsim::activity.get_toggles("count", 0) != 10 || digsim::activity.get_time_high("count", 0) != 50) {
+        digsim::error("Test", "Wrong activity of count[0]");
+        return 1;
+    }
+    if (digsim::activity.get_toggles("count", 1) != 5 || digsim::activity.get_time_high("count", 1) != 45) {
+        digsim::error(
+            "Test", "count[1]: TC {}, T1 {}", digsim::activity.get_toggles("count", 1),
+            digsim::activity.get_time_high("count", 1));
+        return 1;
+    }
+    if (digsim::activity.get_toggles("count", 7) != 0 || digsim::activity.get_time_low("count", 7) != 100) {
+        digsim::error("Test", "count[7] never toggles");
+        return 1;
+    }
+
+    std::stringstream saif;
+    digsim::activity.export_saif(saif, "cpu");
+    const std::string text = saif.str();
+    if (text.find("(DURATION 100)") == std::string::npos || text.find("(INSTANCE cpu") == std::string::npos ||
+        text.find("(clk_out\n        (T0 50) (T1 50) (TX 0)\n        (TC 20) (IG 0)") == std::string::npos ||
+        text.find("(count\\[1\\]\n        (T0 55) (T1 45) (TX 0)\n        (TC 5) (IG 0)") == std::string::npos) {
+        digsim::error("Test", "Wrong SAIF:\n{}", text);
+        return 1;
+    }
+
+    // A new observation window starts from the current values.
+    digsim::activity.clear();
+    digsim::scheduler.run(10);
+    if (digsim::activity.get_toggles("clk_out") != 2 || digsim::activity.get_time_high("clk_out") != 5 ||
+        digsim::activity.get_time_high("count", 1) != 10) {
+        digsim::error("Test", "Wrong activity after clearing");
+        return 1;
+    }
+
+    // Signals sharing a name have their own counters, also in the SAIF.
+    digsim::signal_t<bool> twin("twin");
+    digsim::signal_t<bool> other_twin("twin");
+    twin.set(true);
+    digsim::scheduler.run(10);
+    other_twin.set(true);
+    digsim::scheduler.run(10);
+    if (digsim::activity.get_toggles("twin") != 1 || digsim::activity.get_time_high("twin") != 20 ||
+        digsim::activity.get_toggles("twin#1") != 1 || digsim::activity.get_time_high("twin#1") != 10) {
+        digsim::error(
+            "Test", "twin: T1 {} and {}", digsim::activity.get_time_high("twin"),
+            digsim::activity.get_time_high("twin#1"));
+        return 1;
+    }
+    saif.str("");
+    digsim::activity.export_saif(saif, "cpu");
+    if (saif.str().find("(twin\\#1\n        (T0 20) (T1 10)") == std::string::npos) {
+        digsim::error("Test", "Wrong SAIF:\n{}", saif.str());
+        return 1;
+    }
+
+    // Changes made while the activity is disabled are not counted, but a window opened later starts from them.
+    digsim::activity.enable(false);
+    digsim::signal_t<bool> preset("preset");
+    preset.set(true);
+    digsim::scheduler.run(10);
+    digsim::activity.enable();
+    digsim::scheduler.run(50);
+    if (digsim::activity.get_toggles("preset") != 0 || digsim::activity.get_time_high("preset") != 50 ||
+        digsim::activity.get_time_low("preset") != 0) {
+        digsim::error(
+            "Test", "preset: TC {}, T1 {}, T0 {}", digsim::activity.get_toggles("preset"),
+            digsim::activity.get_time_high("preset"), digsim::activity.get_time_low("preset"));
+        return 1;
+    }
+
+    digsim::info("Test", "✅ All tests passed.");
+    return 0;
+}
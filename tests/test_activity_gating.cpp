@@ -0,0 +1,146 @@
+/// @file test_activity_gating.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Tests the activity gating of module subtrees.
+
+#include <digsim/digsim.hpp>
+
+/// @brief Counts the rising edges of its clock, and how many times it is activated.
+class counter_t : public digsim::module_t
+{
+public:
+    digsim::input_t<bool> clk;
+    std::size_t edges       = 0;
+    std::size_t activations = 0;
+
+    counter_t(const std::string &_name, digsim::module_t *_parent_module)
+        : digsim::module_t(_name, _parent_module)
+        , clk("clk", this)
+    {
+        ADD_SENSITIVITY(counter_t, evaluate, clk);
+    }
+
+private:
+    void evaluate()
+    {
+        ++activations;
+        if (clk.posedge()) {
+            ++edges;
+        }
+    }
+};
+
+/// @brief Fires once, after a delay, and records when it fired.
+class alarm_t : public digsim::module_t
+{
+public:
+    digsim::discrete_time_t fired_at = 0;
+
+    alarm_t(const std::string &_name)
+        : digsim::module_t(_name)
+    {
+        // Nothing to do here.
+    }
+
+    /// @brief Schedules the alarm.
+    /// @param delay the delay after which the alarm fires.
+    void arm(digsim::discrete_time_t delay)
+    {
+        digsim::scheduler.schedule_after(digsim::get_or_create_process(this, &alarm_t::fire, "fire"), delay);
+    }
+
+private:
+    void fire() { fired_at = digsim::scheduler.time(); }
+};
+
+/// @brief A core with two units, both clocked.
+class core_t : public digsim::module_t
+{
+public:
+    digsim::input_t<bool> clk;
+    counter_t fetch;
+    counter_t execute;
+
+    core_t(const std::string &_name)
+        : digsim::module_t(_name)
+        , clk("clk", this)
+        , fetch("fetch", this)
+        , execute("execute", this)
+    {
+        fetch.clk(clk);
+        execute.clk(clk);
+    }
+};
+
+int main()
+{
+    digsim::logger.set_level(digsim::log_level_t::info);
+
+    digsim::signal_t<bool> clk_out("clk_out");
+    digsim::clock_t clk("clk", 10);
+    clk.out(clk_out);
+
+    core_t core("core");
+    core.clk(clk_out);
+
+    alarm_t alarm("alarm");
+
+    if (core.get_children().size() != 2 || core.fetch.get_parent() != &core) {
+        digsim::error("Test", "Wrong module hierarchy");
+        return 1;
+    }
+
+    digsim::scheduler.initialize();
+    digsim::scheduler.run(95);
+
+    const std::size_t edges       = core.fetch.edges;
+    const std::size_t activations = core.fetch.activations;
+    digsim::info("Test", "Running: {} edges, {} activations", edges, activations);
+
+    // While the core is disabled, its units must never be activated.
+    core.set_enabled(false);
+    if (core.fetch.is_enabled() || core.execute.is_enabled()) {
+        digsim::error("Test", "Disabling a module must disable its submodules");
+        return 1;
+    }
+    // Stop on a falling edge, so that the re-evaluation does not see a rising one.
+    digsim::scheduler.run(105);
+    if (core.fetch.activations != activations || core.execute.activations != activations) {
+        digsim::error("Test", "Disabled units were activated {} times", core.fetch.activations - activations);
+        return 1;
+    }
+
+    // An explicitly disabled unit stays disabled when its parent is enabled again.
+    core.execute.set_enabled(false);
+    core.set_enabled(true);
+    if (!core.fetch.is_enabled() || core.execute.is_enabled()) {
+        digsim::error("Test", "Wrong enable state after enabling the core");
+        return 1;
+    }
+    // The unit missed some clock edges, thus, it is re-evaluated once.
+    digsim::scheduler.run(1);
+    if (core.fetch.activations != activations + 1) {
+        digsim::error("Test", "Expected a single re-evaluation, got {}", core.fetch.activations - activations);
+        return 1;
+    }
+    digsim::scheduler.run(100);
+    if (core.fetch.edges != edges + 10 || core.execute.edges != edges) {
+        digsim::error(
+            "Test", "Expected {} and {} edges, got {} and {}", edges + 10, edges, core.fetch.edges, core.execute.edges);
+        return 1;
+    }
+
+    // An activation which was dropped while disabled, but is still in the future, keeps its time.
+    const digsim::discrete_time_t expected = digsim::scheduler.time() + 50;
+    alarm.set_enabled(false);
+    alarm.arm(50);
+    digsim::scheduler.run(10);
+    alarm.set_enabled(true);
+    digsim::scheduler.run(100);
+    if (alarm.fired_at != expected) {
+        digsim::error("Test", "The alarm fired at {}, instead of {}", alarm.fired_at, expected);
+        return 1;
+    }
+
+    digsim::info("Test", "✅ All tests passed.");
+    return 0;
+}
@@ -0,0 +1,138 @@
+/// @file test_assertion.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Tests the clocked temporal assertions.
+
+#include <digsim/digsim.hpp>
+
+#include <set>
+
+/// @brief Drives a few control signals, following a script indexed by the clock cycle.
+class script_t : public digsim::module_t
+{
+public:
+    digsim::input_t<bool> clk;
+    digsim::output_t<bool> reset;
+    digsim::output_t<bool> halt;
+    digsim::output_t<bool> reg_write;
+    digsim::output_t<unsigned> pc;
+
+    script_t(const std::string &_name)
+        : digsim::module_t(_name)
+        , clk("clk", this)
+        , reset("reset", this)
+        , halt("halt", this)
+        , reg_write("reg_write", this)
+        , pc("pc", this)
+    {
+        ADD_SENSITIVITY_WHEN(script_t, evaluate, clk, digsim::when_equals(true));
+        ADD_PRODUCER(script_t, evaluate, reset, halt, reg_write, pc);
+    }
+
+private:
+    unsigned cycle = 0;
+
+    void evaluate()
+    {
+        const std::set<unsigned> halts{3, 10};
+        const std::set<unsigned> idle{5, 16, 17, 18, 19};
+        reset.set(cycle < 2);
+        halt.set(halts.count(cycle) > 0);
+        reg_write.set(idle.count(cycle) == 0);
+        pc.set(cycle < 2 ? 0 : cycle - 2);
+        ++cycle;
+    }
+};
+
+int main()
+{
+    digsim::logger.set_level(digsim::log_level_t::info);
+
+    digsim::signal_t<bool> clk_out("clk_out");
+    digsim::signal_t<bool> reset("reset");
+    digsim::signal_t<bool> halt("halt");
+    digsim::signal_t<bool> reg_write("reg_write");
+    digsim::signal_t<unsigned> pc("pc");
+
+    digsim::clock_t clk("clk", 10);
+    clk.out(clk_out);
+
+    script_t script("script");
+    script.clk(clk_out);
+    script.reset(reset);
+    script.halt(halt);
+    script.reg_write(reg_write);
+    script.pc(pc);
+
+    digsim::assertion_t checker("checker");
+    checker.clk(clk_out);
+
+    // halt |-> ##[1:4] !reg_write
+    auto halt_stops_writes = checker.add(
+        "halt_stops_writes", digsim::property_t::implies(
+                                 digsim::sequence_t([&] { return halt.get(); }),
+                                 digsim::sequence_t::after(1, 4, [&] { return !reg_write.get(); })));
+    // reset ##1 !reset |-> pc == 0
+    auto reset_clears_pc = checker.add(
+        "reset_clears_pc", digsim::property_t::implies(
+                               digsim::sequence_t([&] { return reset.get(); }).then([&] { return !reset.get(); }),
+                               digsim::sequence_t([&] { return pc.get() == 0; })));
+    // reset ##1 !reset |=> pc == 1
+    auto reset_then_pc = checker.add(
+        "reset_then_pc", digsim::property_t::implies_next(
+                             digsim::sequence_t([&] { return reset.get(); }).then([&] { return !reset.get(); }),
+                             digsim::sequence_t([&] { return pc.get() == 2; })));
+    // pc == 0 |-> ##[1:2] pc == 1 ##[2:3] halt
+    auto pc_then_halt = checker.add(
+        "pc_then_halt", digsim::property_t::implies(
+                            digsim::sequence_t([&] { return pc.get() == 0; }),
+                            digsim::sequence_t::after(1, 2, [&] { return pc.get() == 1; }).then(2, 3, [&] {
+                                return halt.get();
+                            })));
+    // always pc < 100
+    auto pc_bounded = checker.add("pc_bounded", digsim::property_t::always([&] { return pc.get() < 100; }));
+
+    std::vector<std::string> failed;
+    checker.on_failure([&](const std::string &name, digsim::discrete_time_t) { failed.push_back(name); });
+
+    digsim::scheduler.initialize();
+    digsim::scheduler.run(200);
+
+    // The first halt is followed by an idle cycle in time, the second one is not.
+    if (checker.get_successes(halt_stops_writes) != 1 || checker.get_failures(halt_stops_writes) != 1) {
+        digsim::error(
+            "Test", "halt_stops_writes: {} successes, {} failures", checker.get_successes(halt_stops_writes),
+            checker.get_failures(halt_stops_writes));
+        return 1;
+    }
+    if (checker.get_successes(reset_clears_pc) != 1 || checker.get_failures(reset_clears_pc) != 0) {
+        digsim::error("Test", "reset_clears_pc must hold once");
+        return 1;
+    }
+    // The pc is 1 on the cycle after the reset is released, not 2.
+    if (checker.get_successes(reset_then_pc) != 0 || checker.get_failures(reset_then_pc) != 1) {
+        digsim::error("Test", "reset_then_pc must fail once");
+        return 1;
+    }
+    if (checker.get_successes(pc_bounded) != 20 || checker.get_failures(pc_bounded) != 0) {
+        digsim::error("Test", "pc_bounded: {} successes", checker.get_successes(pc_bounded));
+        return 1;
+    }
+    // The pc is 0 on the first two cycles, both checks wait for the same pc and then merge, thus, they fail
+    // together: both are counted, but only reported once.
+    if (checker.get_successes(pc_then_halt) != 0 || checker.get_failures(pc_then_halt) != 2) {
+        digsim::error("Test", "pc_then_halt: {} failures", checker.get_failures(pc_then_halt));
+        return 1;
+    }
+    if (failed.size() != 3 || failed[0] != "reset_then_pc" || failed[1] != "pc_then_halt" ||
+        failed[2] != "halt_stops_writes") {
+        digsim::error("Test", "Wrong failure reports");
+        return 1;
+    }
+    if (checker.get_pending() != 0) {
+        digsim::error("Test", "Expected no pending checks, got {}", checker.get_pending());
+        return 1;
+    }
+
+    digsim::info("Test", "✅ All tests passed.");
+    return 0;
+}
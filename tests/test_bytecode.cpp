@@ -0,0 +1,128 @@
+/// @file test_bytecode.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Tests that the bytecode interpreter matches the compact kernel, on a netlist using all the operations.
+
+#include <digsim/digsim.hpp>
+
+#include <algorithm>
+#include <chrono>
+
+int main()
+{
+    digsim::logger.set_level(digsim::log_level_t::info);
+
+    using op_t = digsim::gate_op_t;
+    digsim::netlist_t netlist;
+    const std::size_t clk = netlist.add_net("clk", 1);
+    netlist.add_clock(clk, 5, 5, 5);
+    const std::size_t one  = netlist.add_net("one", 1, 1);
+    const std::size_t zero = netlist.add_net("zero", 1, 0);
+    // A 4-bit counter, with full adders made of a three-input XOR and a majority gate.
+    std::vector<std::size_t> q, carry;
+    for (std::size_t bit = 0; bit < 4; ++bit) {
+        q.push_back(netlist.add_net("q" + std::to_string(bit), 1, 0, 1));
+    }
+    for (std::size_t bit = 0; bit < 4; ++bit) {
+        const std::size_t sum = netlist.add_net("sum" + std::to_string(bit), 1);
+        carry.push_back(netlist.add_net("carry" + std::to_string(bit), 1));
+        const std::vector<std::size_t> inputs{q[bit], bit == 0 ? one : zero, bit == 0 ? zero : carry[bit - 1]};
+        netlist.add_gate(op_t::xor_, inputs, sum);
+        netlist.add_gate(op_t::maj, inputs, carry[bit]);
+        netlist.add_gate(op_t::dff, {clk, sum}, q[bit]);
+    }
+    // Wide gates, negated ones, and a delay.
+    const std::size_t all   = netlist.add_net("all", 1);
+    const std::size_t none  = netlist.add_net("none", 1, 0, 2);
+    const std::size_t odd   = netlist.add_net("odd", 1);
+    const std::size_t even  = netlist.add_net("even", 1, 0, 3);
+    const std::size_t low   = netlist.add_net("low", 1);
+    const std::size_t alias = netlist.add_net("alias", 1);
+    netlist.add_gate(op_t::nand, q, all);
+    netlist.add_gate(op_t::nor, {q[0], q[1], q[2]}, none);
+    netlist.add_gate(op_t::xor_, {q[0], q[1], q[2], q[3]}, odd);
+    netlist.add_gate(op_t::xnor, {q[0], q[1]}, even);
+    netlist.add_gate(op_t::or_, {q[0], q[1], q[2]}, low);
+    netlist.add_gate(op_t::buf, {low}, alias);
+    // Words, selected by the counter, and registered by flip-flops with enable, reset, and an inverted output.
+    const std::size_t word_a   = netlist.add_net("word_a", 16, 0x1234);
+    const std::size_t word_b   = netlist.add_net("word_b", 16, 0xabcd);
+    const std::size_t word     = netlist.add_net("word", 16);
+    const std::size_t word_and = netlist.add_net("word_and", 16);
+    const std::size_t held     = netlist.add_net("held", 16);
+    const std::size_t held_not = netlist.add_net("held_not", 16, 0xffff);
+    const std::size_t toggled  = netlist.add_net("toggled", 16, 0, 1);
+    netlist.add_gate(op_t::mux, {q[1], word_a, word_b}, word);
+    netlist.add_gate(op_t::and_, {word, word_b, word_a}, word_and);
+    netlist.add_gate(op_t::dff, {clk, word, q[0], q[3]}, held);
+    netlist.add_gate(op_t::dffn, {clk, word, q[0], q[3], held}, held_not);
+    netlist.add_gate(op_t::dffn, {clk, word_and, low}, toggled);
+    // A latch, set when the counter reaches 3, and reset when it reaches 4.
+    const std::size_t set_n   = netlist.add_net("set_n", 1, 1);
+    const std::size_t reset_n = netlist.add_net("reset_n", 1, 1);
+    const std::size_t latch   = netlist.add_net("latch", 1, 1);
+    const std::size_t latch_n = netlist.add_net("latch_n", 1, 0);
+    const std::size_t q1_not  = netlist.add_net("q1_not", 1, 1);
+    netlist.add_gate(op_t::not_, {q[1]}, q1_not);
+    netlist.add_gate(op_t::nand, {q[0], q[1]}, set_n);
+    netlist.add_gate(op_t::nand, {q[2], q1_not}, reset_n);
+    netlist.add_gate(op_t::nand, {set_n, latch_n}, latch);
+    netlist.add_gate(op_t::nand, {reset_n, latch}, latch_n);
+    netlist.freeze();
+    const auto view = netlist.view();
+
+    digsim::netlist_kernel_t reference(view);
+    digsim::bytecode_kernel_t kernel(view);
+    const auto &code = kernel.get_code();
+    if (std::none_of(code.begin(), code.end(), [](const auto &instruction) {
+            return instruction.opcode == digsim::bytecode_kernel_t::opcode_t::full_adder;
+        })) {
+        digsim::error("Test", "The full adders were not fused");
+        return 1;
+    }
+    auto compare = [&]() {
+        if (kernel.time() != reference.time()) {
+            digsim::error("Test", "The interpreter is at time {}, instead of {}", kernel.time(), reference.time());
+            return false;
+        }
+        for (std::size_t net = 0; net < view.num_nets(); ++net) {
+            if (kernel.get(net) != reference.get(net)) {
+                digsim::error(
+                    "Test", "At time {}, `{}` is {} instead of {}", kernel.time(), view.get_name(net), kernel.get(net),
+                    reference.get(net));
+                return false;
+            }
+        }
+        return true;
+    };
+    reference.initialize();
+    kernel.initialize();
+    for (std::size_t step = 0; step < 60; ++step) {
+        if (step == 40) {
+            reference.set(word_b, 0x5555);
+            kernel.set(word_b, 0x5555);
+        } else if (step > 0) {
+            reference.run(7);
+            kernel.run(7);
+        }
+        if (!compare()) {
+            return 1;
+        }
+    }
+
+    // Compare the throughput, only informative.
+    const auto start = std::chrono::steady_clock::now();
+    reference.run(100000);
+    const auto middle = std::chrono::steady_clock::now();
+    kernel.run(100000);
+    const auto end = std::chrono::steady_clock::now();
+    if (!compare()) {
+        return 1;
+    }
+    digsim::info(
+        "Test", "Kernel: {} us, bytecode: {} us ({} instructions)",
+        std::chrono::duration_cast<std::chrono::microseconds>(middle - start).count(),
+        std::chrono::duration_cast<std::chrono::microseconds>(end - middle).count(), code.size());
+
+    digsim::info("Test", "✅ All tests passed.");
+    return 0;
+}
@@ -0,0 +1,211 @@
+/// @file test_clock_domains.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Tests the clock domain inference and the partitioned, multi-threaded scheduling.
+
+#include <digsim/digsim.hpp>
+
+#include <algorithm>
+
+/// @brief Counts the rising edges of its clock.
+class counter_t : public digsim::module_t
+{
+public:
+    digsim::input_t<bool> clk;
+    digsim::output_t<unsigned> count;
+
+    counter_t(const std::string &_name)
+        : digsim::module_t(_name)
+        , clk("clk", this)
+        , count("count", this)
+    {
+        ADD_SENSITIVITY(counter_t, evaluate, clk);
+        ADD_PRODUCER(counter_t, evaluate, count);
+    }
+
+private:
+    void evaluate()
+    {
+        if (clk.posedge()) {
+            count.set(count.get() + 1);
+        }
+    }
+};
+
+/// @brief Combinational logic doubling its input.
+class doubler_t : public digsim::module_t
+{
+public:
+    digsim::input_t<unsigned> in;
+    digsim::output_t<unsigned> out;
+
+    doubler_t(const std::string &_name)
+        : digsim::module_t(_name)
+        , in("in", this)
+        , out("out", this)
+    {
+        ADD_SENSITIVITY(doubler_t, evaluate, in);
+        ADD_PRODUCER(doubler_t, evaluate, out);
+    }
+
+private:
+    void evaluate() { out.set(in.get() * 2); }
+};
+
+/// @brief Samples its input on the rising edges of its clock.
+class sampler_t : public digsim::module_t
+{
+public:
+    digsim::input_t<bool> clk;
+    digsim::input_t<unsigned> in;
+    digsim::output_t<unsigned> sample;
+    bool consistent = true;
+
+    sampler_t(const std::string &_name)
+        : digsim::module_t(_name)
+        , clk("clk", this)
+        , in("in", this)
+        , sample("sample", this)
+    {
+        ADD_SENSITIVITY(sampler_t, evaluate, clk);
+        ADD_CONSUMER(sampler_t, evaluate, in);
+        ADD_PRODUCER(sampler_t, evaluate, sample);
+    }
+
+private:
+    void evaluate()
+    {
+        if (clk.posedge()) {
+            // The doubled value must never be observed half-updated.
+            consistent &= (in.get() % 2) == 0;
+            sample.set(in.get());
+        }
+    }
+};
+
+/// @brief Writes its identifier on the rising edges of its clock, onto a signal shared with other writers.
+class stamper_t : public digsim::module_t
+{
+public:
+    digsim::input_t<bool> clk;
+    digsim::output_t<unsigned> stamp;
+
+    stamper_t(const std::string &_name, unsigned _id)
+        : digsim::module_t(_name)
+        , clk("clk", this)
+        , stamp("stamp", this)
+        , id(_id)
+    {
+        ADD_SENSITIVITY(stamper_t, evaluate, clk);
+        ADD_PRODUCER(stamper_t, evaluate, stamp);
+    }
+
+private:
+    unsigned id;
+
+    void evaluate()
+    {
+        if (clk.posedge()) {
+            stamp.set(id);
+        }
+    }
+};
+
+int main()
+{
+    digsim::logger.set_level(digsim::log_level_t::info);
+
+    // Domain A.
+    digsim::signal_t<bool> clk_a_out("clk_a_out");
+    digsim::signal_t<unsigned> count_a("count_a");
+    digsim::signal_t<unsigned> double_a("double_a");
+    digsim::clock_t clk_a("clk_a", 4);
+    counter_t counter_a("counter_a");
+    doubler_t doubler_a("doubler_a");
+    clk_a.out(clk_a_out);
+    counter_a.clk(clk_a_out);
+    counter_a.count(count_a);
+    doubler_a.in(count_a);
+    doubler_a.out(double_a);
+
+    // Domain B.
+    digsim::signal_t<bool> clk_b_out("clk_b_out");
+    digsim::signal_t<unsigned> count_b("count_b");
+    digsim::signal_t<unsigned> sample_b("sample_b");
+    digsim::clock_t clk_b("clk_b", 6);
+    counter_t counter_b("counter_b");
+    sampler_t sampler_b("sampler_b");
+    clk_b.out(clk_b_out);
+    counter_b.clk(clk_b_out);
+    counter_b.count(count_b);
+    sampler_b.clk(clk_b_out);
+    sampler_b.in(double_a);
+    sampler_b.sample(sample_b);
+
+    // A signal driven from both domains, and read by none.
+    digsim::signal_t<unsigned> stamp("stamp");
+    stamper_t stamper_a("stamper_a", 1);
+    stamper_t stamper_b("stamper_b", 2);
+    stamper_a.clk(clk_a_out);
+    stamper_a.stamp(stamp);
+    stamper_b.clk(clk_b_out);
+    stamper_b.stamp(stamp);
+
+    digsim::scheduler.set_partitioning(digsim::partitioning_t::clock_domains);
+    digsim::scheduler.set_num_threads(2);
+    digsim::scheduler.initialize();
+
+    // Check the inferred domains.
+    const auto &domains = digsim::dependency_graph.get_clock_domains();
+    if (domains.size() != 3 || digsim::scheduler.get_num_partitions() != 3) {
+        digsim::error("Test", "Expected 3 clock domains, got {}", domains.size());
+        return 1;
+    }
+    if (domains[1].source != &clk_a || domains[2].source != &clk_b) {
+        digsim::error("Test", "Clock domains are not sorted by clock name");
+        return 1;
+    }
+    // Clock, counter, doubler, stamper, plus the delayed update processes of the signals they drive. The update of
+    // `stamp` runs in the domain of its first producer.
+    for (std::size_t index = 1; index < 3; ++index) {
+        const auto &domain   = domains[index];
+        std::size_t expected = (index == 1) ? 8 : 7;
+        if (domain.processes.size() != expected) {
+            digsim::error(
+                "Test", "Expected {} processes in domain {}, got {}", expected, index, domain.processes.size());
+            return 1;
+        }
+    }
+    if (!double_a.is_crossing() || !stamp.is_crossing() || count_a.is_crossing() || count_b.is_crossing()) {
+        digsim::error("Test", "Wrong crossing signals");
+        return 1;
+    }
+    // Both domains write `stamp`, so it crosses into each of them, even though nobody reads it.
+    if (domains[1].crossings.size() != 1 || domains[1].crossings.front() != &stamp) {
+        digsim::error("Test", "Domain A must only be reached by `stamp`");
+        return 1;
+    }
+    if (domains[2].crossings.size() != 2 ||
+        std::find(domains[2].crossings.begin(), domains[2].crossings.end(), &double_a) == domains[2].crossings.end() ||
+        std::find(domains[2].crossings.begin(), domains[2].crossings.end(), &stamp) == domains[2].crossings.end()) {
+        digsim::error("Test", "Domain B must only be reached by `double_a` and `stamp`");
+        return 1;
+    }
+
+    digsim::scheduler.run(120);
+
+    if (count_a.get() != 30) {
+        digsim::error("Test", "Expected 30 edges on clock A, got {}", count_a.get());
+        return 1;
+    }
+    if (count_b.get() != 20) {
+        digsim::error("Test", "Expected 20 edges on clock B, got {}", count_b.get());
+        return 1;
+    }
+    if (!sampler_b.consistent || sample_b.get() != 58) {
+        digsim::error("Test", "Expected to sample 58 across domains, got {}", sample_b.get());
+        return 1;
+    }
+
+    digsim::info("Test", "✅ All tests passed.");
+    return 0;
+}
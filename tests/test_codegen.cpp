@@ -0,0 +1,100 @@
+/// @file test_codegen.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Tests that the code generated by test_codegen_emit matches the compact kernel running the same netlist.
+
+#include <digsim/digsim.hpp>
+
+#include <counter_model.hpp>
+
+#include <chrono>
+
+int main(int argc, char *argv[])
+{
+    digsim::logger.set_level(digsim::log_level_t::info);
+
+    if (argc < 2) {
+        digsim::error("Test", "Usage: {} <netlist image>", argv[0]);
+        return 1;
+    }
+    digsim::netlist_image_t image(argv[1]);
+    const auto view = image.view();
+    if (counter_model_t::num_nets != view.num_nets()) {
+        digsim::error(
+            "Test", "The generated code has {} nets instead of {}", counter_model_t::num_nets, view.num_nets());
+        return 1;
+    }
+
+    // Run the kernel and the generated code side by side.
+    digsim::netlist_kernel_t kernel(view);
+    counter_model_t model;
+    kernel.initialize();
+    model.initialize();
+    auto compare = [&]() {
+        if (kernel.time() != model.time()) {
+            digsim::error("Test", "The generated code is at time {}, instead of {}", model.time(), kernel.time());
+            return false;
+        }
+        for (std::size_t net = 0; net < view.num_nets(); ++net) {
+            if (kernel.get(net) != model.get(net)) {
+                digsim::error(
+                    "Test", "At time {}, `{}` is {} instead of {}", model.time(), view.get_name(net), model.get(net),
+                    kernel.get(net));
+                return false;
+            }
+        }
+        return true;
+    };
+    for (std::size_t step = 0; step < 40; ++step) {
+        if (step > 0) {
+            kernel.run(7);
+            model.run(7);
+        }
+        if (!compare()) {
+            return 1;
+        }
+    }
+    // The latch is set at 3 and 7, and reset at 4, it holds in between.
+    const uint64_t count = model.get(view.find("q0")) | (model.get(view.find("q1")) << 1) |
+                           (model.get(view.find("q2")) << 2);
+    if (model.get(view.find("latch_q")) != (((count < 4) || (count == 7)) ? 1U : 0U)) {
+        digsim::error("Test", "The latch is {} with the counter at {}", model.get(view.find("latch_q")), count);
+        return 1;
+    }
+
+    // Forcing nets from outside.
+    kernel.set(view.find("word_b"), 42);
+    model.set(view.find("word_b"), 42);
+    kernel.set(view.find("enable"), 0);
+    model.set(view.find("enable"), 0);
+    for (std::size_t step = 0; step < 10; ++step) {
+        kernel.run(7);
+        model.run(7);
+        if (!compare()) {
+            return 1;
+        }
+    }
+    try {
+        model.set(view.num_nets(), 0);
+        digsim::error("Test", "A net that does not exist was set");
+        return 1;
+    } catch (const std::out_of_range &) {
+        // Expected.
+    }
+
+    // Compare the throughput, only informative.
+    const auto start = std::chrono::steady_clock::now();
+    kernel.run(100000);
+    const auto middle = std::chrono::steady_clock::now();
+    model.run(100000);
+    const auto end = std::chrono::steady_clock::now();
+    if (!compare()) {
+        return 1;
+    }
+    digsim::info(
+        "Test", "Kernel: {} us, generated code: {} us",
+        std::chrono::duration_cast<std::chrono::microseconds>(middle - start).count(),
+        std::chrono::duration_cast<std::chrono::microseconds>(end - middle).count());
+
+    digsim::info("Test", "✅ All tests passed.");
+    return 0;
+}
@@ -0,0 +1,87 @@
+/// @file test_codegen_emit.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Generates the C++ code and the netlist image of a design, which test_codegen compiles and compares.
+
+#include <digsim/digsim.hpp>
+
+#include <gates/and_gate.hpp>
+#include <gates/nand_gate.hpp>
+#include <gates/not_gate.hpp>
+#include <mux2to1.hpp>
+
+#include "netlist_counter.hpp"
+
+#include <filesystem>
+
+int main(int argc, char *argv[])
+{
+    digsim::logger.set_level(digsim::log_level_t::info);
+
+    if (argc < 2) {
+        digsim::error("Test", "Usage: {} <output directory>", argv[0]);
+        return 1;
+    }
+    const std::filesystem::path directory(argv[1]);
+    std::filesystem::create_directories(directory);
+
+    // A 3-bit counter: flip-flops holding the value, and full adders adding one.
+    netlist_counter_t counter(3);
+    // Some logic with a delay, and a word-wide multiplexer.
+    digsim::signal_t<bool> low_ones("low_ones", false, 3);
+    digsim::signal_t<bool> not_low_ones("not_low_ones");
+    digsim::signal_t<unsigned> word_a("word_a", 5);
+    digsim::signal_t<unsigned> word_b("word_b", 9);
+    digsim::signal_t<unsigned> word_out("word_out");
+    AndGate both("both");
+    both.a(*counter.q[0]);
+    both.b(*counter.q[1]);
+    both.out(low_ones);
+    NotGate neither("neither");
+    neither.in(low_ones);
+    neither.out(not_low_ones);
+    Mux2to1<unsigned> mux("mux");
+    mux.a(word_a);
+    mux.b(word_b);
+    mux.sel(*counter.q[2]);
+    mux.out(word_out);
+    // A latch, i.e., a combinational loop, set when the counter reaches 3, and reset when it reaches 4.
+    digsim::signal_t<bool> set_n("set_n", true);
+    digsim::signal_t<bool> reset_n("reset_n", true);
+    digsim::signal_t<bool> latch_q("latch_q", true);
+    digsim::signal_t<bool> latch_q_not("latch_q_not", false);
+    NandGate set_gate("set_gate");
+    set_gate.a(*counter.q[0]);
+    set_gate.b(*counter.q[1]);
+    set_gate.out(set_n);
+    NandGate reset_gate("reset_gate");
+    reset_gate.a(*counter.q[2]);
+    reset_gate.b(*counter.q_not[1]);
+    reset_gate.out(reset_n);
+    NandGate latch_set("latch_set");
+    latch_set.a(set_n);
+    latch_set.b(latch_q_not);
+    latch_set.out(latch_q);
+    NandGate latch_reset("latch_reset");
+    latch_reset.a(reset_n);
+    latch_reset.b(latch_q);
+    latch_reset.out(latch_q_not);
+
+    // Freeze the design, and write both the image and the code.
+    digsim::netlist_t netlist = digsim::netlist_t::extract();
+    const auto view           = netlist.view();
+    view.save((directory / "counter.img").string());
+    digsim::generate_cpp(view, (directory / "counter_model.hpp").string(), "counter_model_t");
+
+    // Class names must be identifiers.
+    try {
+        digsim::generate_cpp(view, (directory / "invalid.hpp").string(), "2 bad");
+        digsim::error("Test", "An invalid class name was accepted");
+        return 1;
+    } catch (const std::runtime_error &) {
+        // Expected.
+    }
+    std::filesystem::remove(directory / "invalid.hpp");
+
+    digsim::info("Test", "✅ All tests passed.");
+    return 0;
+}
@@ -0,0 +1,160 @@
+/// @file test_coverage.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Tests the toggle, FSM, and opcode coverage.
+
+#include <digsim/digsim.hpp>
+
+#include "cpu/decoder.hpp"
+#include "cpu/phase_fsm.hpp"
+
+#include <cstdio>
+#include <sstream>
+
+int main()
+{
+    digsim::logger.set_level(digsim::log_level_t::info);
+
+    digsim::signal_t<bool> a("a");
+    digsim::signal_t<uint8_t> b("b");
+    digsim::signal_t<std::bitset<4>> c("c");
+    digsim::signal_t<std::string> text("text");
+
+    // Nothing is recorded while the coverage is disabled.
+    a.set(true);
+    a.set(false);
+    if (digsim::coverage.get_rises("a") != 0 || digsim::coverage.get_falls("a") != 0) {
+        digsim::error("Test", "Toggles recorded while the coverage is disabled");
+        return 1;
+    }
+
+    digsim::coverage.enable();
+
+    a.set(true);
+    a.set(false);
+    b.set(0x05);
+    b.set(0x04);
+    c.set(std::bitset<4>(0xF));
+    text.set("ignored");
+
+    if (digsim::coverage.get_rises("a") != 1 || digsim::coverage.get_falls("a") != 1) {
+        digsim::error("Test", "Signal `a` must toggle in both directions");
+        return 1;
+    }
+    if (digsim::coverage.get_rises("b") != 0x05 || digsim::coverage.get_falls("b") != 0x01) {
+        digsim::error(
+            "Test", "Wrong toggles of `b`: rises 0x{:02X}, falls 0x{:02X}", digsim::coverage.get_rises("b"),
+            digsim::coverage.get_falls("b"));
+        return 1;
+    }
+    if (digsim::coverage.get_rises("c") != 0xF || digsim::coverage.get_falls("c") != 0) {
+        digsim::error("Test", "Wrong toggles of `c`");
+        return 1;
+    }
+    try {
+        digsim::coverage.get_rises("text");
+        digsim::error("Test", "Signals of types without bits must not be covered");
+        return 1;
+    } catch (const std::runtime_error &) {
+        // Expected.
+    }
+    // Signals sharing a name have their own counters, a rise of one and a fall of the other is not a full toggle.
+    digsim::signal_t<bool> twin("twin");
+    digsim::signal_t<bool> other_twin("twin", true);
+    twin.set(true);
+    other_twin.set(false);
+    if (digsim::coverage.get_rises("twin") != 1 || digsim::coverage.get_falls("twin") != 0 ||
+        digsim::coverage.get_rises("twin#1") != 0 || digsim::coverage.get_falls("twin#1") != 1) {
+        digsim::error("Test", "Signals with the same name must not share their toggles");
+        return 1;
+    }
+
+    // The phase FSM drives the decoder, which always decodes the same instruction.
+    digsim::signal_t<bool> clk_out("clk_out");
+    digsim::signal_t<bool> reset("reset");
+    digsim::signal_t<bs_phase_t> phase("phase");
+    digsim::signal_t<bs_instruction_t> instruction("instruction", bs_instruction_t(opcode_t::MEM_LOAD << 9));
+    digsim::signal_t<bs_opcode_t> opcode("opcode");
+    digsim::signal_t<bs_register_t> rs("rs");
+    digsim::signal_t<bs_register_t> rt("rt");
+    digsim::signal_t<bool> flag("flag");
+
+    digsim::clock_t clk("clk", 10);
+    clk.out(clk_out);
+
+    phase_fsm_t fsm("fsm");
+    fsm.clk(clk_out);
+    fsm.reset(reset);
+    fsm.phase(phase);
+
+    decoder_t decoder("decoder");
+    decoder.instruction(instruction);
+    decoder.phase(phase);
+    decoder.opcode(opcode);
+    decoder.rs(rs);
+    decoder.rt(rt);
+    decoder.flag(flag);
+
+    digsim::scheduler.initialize();
+    digsim::scheduler.run(100);
+
+    for (std::size_t state = 0; state < NUM_PHASES; ++state) {
+        if (!digsim::coverage.is_hit("fsm.state", state)) {
+            digsim::error("Test", "State {} not covered", phase_to_string(static_cast<phase_t>(state)));
+            return 1;
+        }
+        std::size_t next = (state + 1) % NUM_PHASES;
+        if (!digsim::coverage.is_hit("fsm.state", state, next)) {
+            digsim::error("Test", "Transition from {} not covered", phase_to_string(static_cast<phase_t>(state)));
+            return 1;
+        }
+    }
+    if (digsim::coverage.is_hit("fsm.state", phase_t::FETCH, phase_t::EXECUTE)) {
+        digsim::error("Test", "Transition FETCH -> EXECUTE never happens");
+        return 1;
+    }
+    if (!digsim::coverage.is_hit("decoder.opcode", opcode_t::MEM_LOAD) ||
+        digsim::coverage.is_hit("decoder.opcode", opcode_t::ALU_ADD)) {
+        digsim::error("Test", "Wrong opcode coverage");
+        return 1;
+    }
+    // 26 opcodes are defined, besides the reserved ones.
+    double expected = 1.0 / 26.0;
+    if (std::abs(digsim::coverage.get_point_coverage("decoder.opcode") - expected) > 1e-9) {
+        digsim::error("Test", "Wrong opcode coverage ratio {}", digsim::coverage.get_point_coverage("decoder.opcode"));
+        return 1;
+    }
+    if (digsim::coverage.get_rises("clk_out") != 1 || digsim::coverage.get_falls("clk_out") != 1) {
+        digsim::error("Test", "The clock must toggle in both directions");
+        return 1;
+    }
+
+    // Save, clear, and merge the database twice, which must give back the same counters.
+    const std::string filename = "test_coverage.dscov";
+    double toggle_coverage     = digsim::coverage.get_toggle_coverage();
+    digsim::coverage.save(filename);
+    digsim::coverage.clear();
+    if (digsim::coverage.get_rises("b") != 0 || digsim::coverage.is_hit("fsm.state", phase_t::FETCH)) {
+        digsim::error("Test", "The counters must be cleared");
+        return 1;
+    }
+    digsim::coverage.merge(filename);
+    digsim::coverage.merge(filename);
+    std::remove(filename.c_str());
+    if (std::abs(digsim::coverage.get_toggle_coverage() - toggle_coverage) > 1e-9 ||
+        digsim::coverage.get_rises("b") != 0x05 ||
+        !digsim::coverage.is_hit("fsm.state", phase_t::WRITEBACK, phase_t::FETCH)) {
+        digsim::error("Test", "The merged counters differ from the saved ones");
+        return 1;
+    }
+
+    std::stringstream report;
+    digsim::coverage.report(report);
+    if (report.str().find("FETCH -> DECODE") == std::string::npos ||
+        report.str().find("missing ALU_ADD") == std::string::npos) {
+        digsim::error("Test", "Incomplete report:\n{}", report.str());
+        return 1;
+    }
+
+    digsim::info("Test", "✅ All tests passed.");
+    return 0;
+}
@@ -0,0 +1,83 @@
+/// @file test_delta_storm.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Tests the detection of time steps that never settle.
+
+#include <digsim/digsim.hpp>
+
+#include <algorithm>
+
+/// @brief Inverts its input onto a signal it did not declare as an output, thus, the loop is not in the dependency
+/// graph and it is not detected during the initialization.
+class oscillator_t : public digsim::module_t
+{
+public:
+    digsim::input_t<bool> in;
+
+    oscillator_t(const std::string &_name, digsim::signal_t<bool> &_target, digsim::module_t *_parent)
+        : digsim::module_t(_name, _parent)
+        , in("in", this)
+        , target(_target)
+    {
+        ADD_SENSITIVITY(oscillator_t, evaluate, in);
+    }
+
+private:
+    digsim::signal_t<bool> &target;
+
+    void evaluate() { target.set(!in.get()); }
+};
+
+/// @brief A container, to check the hierarchical names in the report.
+class top_t : public digsim::module_t
+{
+public:
+    oscillator_t osc;
+
+    top_t(const std::string &_name, digsim::signal_t<bool> &loop)
+        : digsim::module_t(_name)
+        , osc("osc", loop, this)
+    {
+        osc.in(loop);
+    }
+};
+
+int main()
+{
+    digsim::logger.set_level(digsim::log_level_t::info);
+
+    digsim::signal_t<bool> loop("loop");
+    top_t top("top", loop);
+
+    digsim::scheduler.set_delta_limit(50, digsim::delta_policy_t::pause);
+    digsim::scheduler.initialize();
+    digsim::scheduler.run(10);
+
+    // The simulation pauses at the time step that does not settle.
+    const auto &storm = digsim::scheduler.get_delta_storm();
+    if (!digsim::scheduler.stopped() || digsim::scheduler.time() != 0 || storm.deltas != 50 || storm.time != 0) {
+        digsim::error("Test", "Expected a pause at time 0 after 50 deltas, got {} deltas", storm.deltas);
+        return 1;
+    }
+    if (storm.processes != std::vector<std::string>{"top::osc.evaluate"} ||
+        storm.signals != std::vector<std::string>{"loop"}) {
+        digsim::error("Test", "The report must name the oscillating process and signal");
+        return 1;
+    }
+
+    // Resuming gives the time step a new budget, then the simulation is aborted.
+    digsim::scheduler.set_delta_limit(20, digsim::delta_policy_t::abort);
+    try {
+        digsim::scheduler.run(10);
+        digsim::error("Test", "The simulation must be aborted");
+        return 1;
+    } catch (const std::runtime_error &) {
+        // Expected.
+    }
+    if (digsim::scheduler.get_delta_storm().deltas != 20) {
+        digsim::error("Test", "Expected a report after 20 deltas");
+        return 1;
+    }
+
+    digsim::info("Test", "✅ All tests passed.");
+    return 0;
+}
@@ -0,0 +1,184 @@
+/// @file test_distributed.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Tests a design split across two processes, exchanging the boundary signals over sockets.
+
+#include <digsim/digsim.hpp>
+
+#include <d_flip_flop.hpp>
+#include <gates/not_gate.hpp>
+
+#include "run_processes.hpp"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+/// @brief The delay of the signals going from a process to the other.
+constexpr digsim::discrete_time_t lookahead = 2;
+/// @brief How long the design runs.
+constexpr digsim::discrete_time_t duration = 200;
+
+/// @brief The first half: a flip-flop toggling at each rising edge, which receives back its inverted output.
+/// @param channel the connection with the other half.
+/// @return 0 on success.
+int run_toggler(digsim::channel_t channel)
+{
+    digsim::signal_t<bool> clk_out("clk_out");
+    digsim::signal_t<bool> enable("enable", true);
+    digsim::signal_t<bool> reset("reset", false);
+    digsim::signal_t<bool> q("q", false, 1);
+    digsim::signal_t<bool> q_not("q_not", true, 1);
+    digsim::signal_t<bool> back("back", false);
+    digsim::clock_t clock("clock", 4);
+    clock.out(clk_out);
+    DFlipFlop ff("ff");
+    ff.clk(clk_out);
+    ff.d(q_not);
+    ff.enable(enable);
+    ff.reset(reset);
+    ff.q(q);
+    ff.q_not(q_not);
+
+    digsim::peer_t peer("inverter", std::move(channel), lookahead);
+    peer.send_signal("q", q);
+    peer.receive_signal("inverted", back);
+
+    // Record the changes, with their time.
+    std::vector<std::pair<digsim::discrete_time_t, bool>> q_changes, back_changes;
+    q.watch(nullptr, [&] { q_changes.emplace_back(digsim::scheduler.time(), q.get()); });
+    back.watch(nullptr, [&] { back_changes.emplace_back(digsim::scheduler.time(), back.get()); });
+    // Run in two steps, the second one resumes the synchronization.
+    digsim::run_distributed({&peer}, duration / 2);
+    digsim::run_distributed({&peer}, duration);
+    if (digsim::scheduler.time() > duration) {
+        digsim::error("Test", "The simulation went past its end, at {}", digsim::scheduler.time());
+        return 1;
+    }
+    if (q_changes.size() < 20) {
+        digsim::error("Test", "The flip-flop toggled {} times only", q_changes.size());
+        return 1;
+    }
+    // Each change comes back inverted, after crossing the connection twice.
+    for (const auto &[time, value] : q_changes) {
+        if (time + 2 * lookahead > duration) {
+            continue;
+        }
+        const std::pair<digsim::discrete_time_t, bool> expected{time + 2 * lookahead, !value};
+        if (std::find(back_changes.begin(), back_changes.end(), expected) == back_changes.end()) {
+            digsim::error("Test", "The change of `q` at {} did not come back at {}", time, expected.first);
+            return 1;
+        }
+    }
+    digsim::info("Test", "{} messages sent by the toggler", peer.get_messages_sent());
+    return 0;
+}
+
+/// @brief The second half: inverts the signal it receives, and sends it back.
+/// @param channel the connection with the other half.
+/// @return 0 on success.
+int run_inverter(digsim::channel_t channel)
+{
+    digsim::signal_t<bool> remote_q("remote_q", false);
+    digsim::signal_t<bool> inverted("inverted", false);
+    NotGate gate("gate");
+    gate.in(remote_q);
+    gate.out(inverted);
+
+    digsim::peer_t peer("toggler", std::move(channel), lookahead);
+    peer.receive_signal("q", remote_q);
+    peer.send_signal("inverted", inverted);
+
+    std::size_t changes = 0;
+    remote_q.watch(nullptr, [&changes] { ++changes; });
+    digsim::run_distributed({&peer}, duration / 2);
+    digsim::run_distributed({&peer}, duration);
+    if (changes < 20) {
+        digsim::error("Test", "The inverter received {} changes only", changes);
+        return 1;
+    }
+    return 0;
+}
+
+/// @brief Both halves send many frames at once, more than the sockets hold, before receiving the ones of the other.
+/// @param channel the connection with the other half.
+/// @return 0 on success.
+int run_flood(digsim::channel_t channel)
+{
+    constexpr std::size_t count = 100000;
+    const std::vector<std::string> frames(count, std::string(64, 'x'));
+    channel.send(frames);
+    std::string frame;
+    for (std::size_t index = 0; index < count; ++index) {
+        if (!channel.receive(frame) || (frame != frames[index])) {
+            digsim::error("Test", "Frame {} of {} was not received", index, count);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int main()
+{
+    digsim::logger.set_level(digsim::log_level_t::info);
+
+    // A pair of connected sockets, inherited by the two processes.
+    {
+        auto [first, second] = digsim::channel_t::make_pair();
+        const bool success   = run_processes(
+            "socketpair", [&first]() { return run_toggler(std::move(first)); },
+            [&second]() { return run_inverter(std::move(second)); });
+        if (!success) {
+            return 1;
+        }
+    }
+
+    // A Unix-domain socket, which the processes connect to by its path.
+    const std::string path = "/tmp/digsim_test_distributed_" + std::to_string(getpid()) + ".sock";
+    if (!run_processes(
+            "unix", [&path]() { return run_toggler(digsim::channel_t::listen_unix(path)); },
+            [&path]() { return run_inverter(digsim::channel_t::connect_unix(path)); })) {
+        return 1;
+    }
+
+    // A TCP connection over the loopback interface, on a port depending on the process, so that runs can overlap.
+    const auto port = static_cast<std::uint16_t>(20000 + getpid() % 20000);
+    if (!run_processes(
+            "tcp", [port]() { return run_toggler(digsim::channel_t::listen_tcp(port)); },
+            [port]() { return run_inverter(digsim::channel_t::connect_tcp("127.0.0.1", port)); })) {
+        return 1;
+    }
+
+    // The two sides sending to each other more than the sockets hold must not block each other.
+    {
+        auto [first, second] = digsim::channel_t::make_pair();
+        const bool success   = run_processes(
+            "flood", [&first]() { return run_flood(std::move(first)); },
+            [&second]() { return run_flood(std::move(second)); });
+        if (!success) {
+            return 1;
+        }
+    }
+
+    // A signal written after the peer sending it is gone must not reach the peer.
+    {
+        auto [first, second] = digsim::channel_t::make_pair();
+        digsim::signal_t<bool> orphan("orphan", false);
+        {
+            digsim::peer_t peer("orphan", std::move(first), 1);
+            peer.send_signal("orphan", orphan);
+        }
+        orphan.set(true);
+        digsim::scheduler.run(1);
+        if (!orphan.get()) {
+            digsim::error("Test", "The orphan signal was not written");
+            return 1;
+        }
+    }
+
+    digsim::info("Test", "✅ All tests passed.");
+    return 0;
+}
@@ -0,0 +1,189 @@
+/// @file test_elaboration_cache.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Tests that the results of the elaboration analyses are reused when the design does not change.
+
+#include <digsim/digsim.hpp>
+
+#include "gates/not_gate.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+
+/// @brief Counts the rising edges of its clock.
+class counter_t : public digsim::module_t
+{
+public:
+    digsim::input_t<bool> clk;
+    digsim::output_t<unsigned> count;
+
+    counter_t(const std::string &_name)
+        : digsim::module_t(_name)
+        , clk("clk", this)
+        , count("count", this)
+    {
+        ADD_SENSITIVITY(counter_t, evaluate, clk);
+        ADD_PRODUCER(counter_t, evaluate, count);
+    }
+
+private:
+    void evaluate()
+    {
+        if (clk.posedge()) {
+            count.set(count.get() + 1);
+        }
+    }
+};
+
+/// @brief Samples its input on the rising edges of its clock.
+class sampler_t : public digsim::module_t
+{
+public:
+    digsim::input_t<bool> clk;
+    digsim::input_t<unsigned> in;
+    digsim::output_t<unsigned> sample;
+
+    sampler_t(const std::string &_name)
+        : digsim::module_t(_name)
+        , clk("clk", this)
+        , in("in", this)
+        , sample("sample", this)
+    {
+        ADD_SENSITIVITY(sampler_t, evaluate, clk);
+        ADD_CONSUMER(sampler_t, evaluate, in);
+        ADD_PRODUCER(sampler_t, evaluate, sample);
+    }
+
+private:
+    void evaluate()
+    {
+        if (clk.posedge()) {
+            sample.set(in.get());
+        }
+    }
+};
+
+/// @brief The name of the cache file shared by the runs.
+const char *cache_file = "test_elaboration_cache.bin";
+
+/// @brief Elaborates and runs the design, each run is a separate process since elaboration cannot be undone.
+/// @param mode "miss" and "hit" build the same design, "changed" adds a sampler, "unwritable" cannot save the cache.
+/// @return 0 on success, 1 on failure.
+int run_design(const std::string &mode)
+{
+    digsim::signal_t<bool> clk_a_out("clk_a_out");
+    digsim::signal_t<unsigned> count_a("count_a");
+    digsim::clock_t clk_a("clk_a", 4);
+    counter_t counter_a("counter_a");
+    clk_a.out(clk_a_out);
+    counter_a.clk(clk_a_out);
+    counter_a.count(count_a);
+
+    digsim::signal_t<bool> clk_b_out("clk_b_out");
+    digsim::signal_t<unsigned> sample_b("sample_b");
+    digsim::clock_t clk_b("clk_b", 6);
+    sampler_t sampler_b("sampler_b");
+    clk_b.out(clk_b_out);
+    sampler_b.clk(clk_b_out);
+    sampler_b.in(count_a);
+    sampler_b.sample(sample_b);
+
+    digsim::signal_t<unsigned> extra_out("extra_out");
+    std::unique_ptr<sampler_t> extra;
+    if (mode == "changed") {
+        extra = std::make_unique<sampler_t>("extra");
+        extra->clk(clk_a_out);
+        extra->in(sample_b);
+        extra->sample(extra_out);
+    }
+
+    digsim::scheduler.set_partitioning(digsim::partitioning_t::clock_domains);
+    digsim::scheduler.set_ordering(digsim::ordering_t::topological);
+    digsim::scheduler.set_elaboration_cache((mode == "unwritable") ? "missing_directory/cache.bin" : cache_file);
+    digsim::scheduler.initialize();
+
+    if (digsim::scheduler.is_elaboration_cached() != (mode == "hit")) {
+        digsim::error(
+            "Test", "[{}] The cache was {}used", mode, digsim::scheduler.is_elaboration_cached() ? "" : "not ");
+        return 1;
+    }
+    // The restored domains must be the same as the inferred ones.
+    const auto &domains = digsim::dependency_graph.get_clock_domains();
+    if (domains.size() != 3 || digsim::scheduler.get_num_partitions() != 3) {
+        digsim::error("Test", "[{}] Expected 3 clock domains, got {}", mode, domains.size());
+        return 1;
+    }
+    if (domains[1].source != &clk_a || domains[2].source != &clk_b || domains[2].clock != &clk_b_out) {
+        digsim::error("Test", "[{}] Wrong clocks", mode);
+        return 1;
+    }
+    if (!count_a.is_crossing() || sample_b.is_crossing() != (mode == "changed")) {
+        digsim::error("Test", "[{}] Wrong crossing signals", mode);
+        return 1;
+    }
+    if (domains[2].crossings.size() != 1 || domains[2].crossings.front() != &count_a) {
+        digsim::error("Test", "[{}] Domain B must only be reached by `count_a`", mode);
+        return 1;
+    }
+
+    digsim::scheduler.run(120);
+
+    if (count_a.get() != 30 || sample_b.get() == 0) {
+        digsim::error("Test", "[{}] Wrong results: count {}, sample {}", mode, count_a.get(), sample_b.get());
+        return 1;
+    }
+    return 0;
+}
+
+/// @brief Elaborates two inverters reading signals named `x`, either the same one or two distinct ones.
+/// @param mode "shared" binds both inverters to one signal, "split" gives each its own.
+/// @return 0 on success, 1 on failure.
+int run_duplicates(const std::string &mode)
+{
+    digsim::signal_t<bool> x0("x");
+    digsim::signal_t<bool> x1("x");
+    digsim::signal_t<bool> y0("y0");
+    digsim::signal_t<bool> y1("y1");
+    NotGate not0("not0");
+    NotGate not1("not1");
+    not0.in(x0);
+    not0.out(y0);
+    not1.in((mode == "shared") ? x0 : x1);
+    not1.out(y1);
+
+    digsim::scheduler.set_elaboration_cache(cache_file);
+    digsim::scheduler.initialize();
+
+    // The "split" run follows the "shared" one, and must not mistake it for the same design.
+    if (digsim::scheduler.is_elaboration_cached()) {
+        digsim::error("Test", "[{}] The cache of a different design was used", mode);
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    digsim::logger.set_level(digsim::log_level_t::info);
+
+    if (argc > 1) {
+        const std::string mode = argv[1];
+        return ((mode == "shared") || (mode == "split")) ? run_duplicates(mode) : run_design(mode);
+    }
+
+    // The first run fills the cache, the second reuses it, the third elaborates a different design, and the last one
+    // goes on without saving it. Then, two designs differing only in which signals named alike are shared.
+    std::remove(cache_file);
+    for (const char *mode : {"miss", "hit", "changed", "unwritable", "shared", "split"}) {
+        const std::string command = std::string("\"") + argv[0] + "\" " + mode;
+        if (std::system(command.c_str()) != 0) {
+            digsim::error("Test", "The `{}` run failed", mode);
+            return 1;
+        }
+    }
+    std::remove(cache_file);
+
+    digsim::info("Test", "✅ All tests passed.");
+    return 0;
+}
@@ -0,0 +1,155 @@
+/// @file test_jit.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Tests the compilation of netlists at run time, the cache of the compiled libraries, and the fallback.
+
+#include <digsim/digsim.hpp>
+
+#include <gates/and_gate.hpp>
+
+#include "netlist_counter.hpp"
+
+#include <filesystem>
+#include <fstream>
+
+/// @brief Runs a kernel and the compact kernel side by side.
+/// @param kernel the kernel.
+/// @param view the netlist.
+/// @return true if they match, false otherwise.
+static bool matches(digsim::jit_kernel_t &kernel, const digsim::netlist_view_t &view)
+{
+    digsim::netlist_kernel_t reference(view);
+    reference.initialize();
+    kernel.initialize();
+    for (std::size_t step = 0; step < 30; ++step) {
+        if (step == 20) {
+            reference.set(view.find("enable"), 0);
+            kernel.set(view.find("enable"), 0);
+        } else if (step > 0) {
+            reference.run(7);
+            kernel.run(7);
+        }
+        if (kernel.time() != reference.time()) {
+            digsim::error("Test", "The kernel is at time {}, instead of {}", kernel.time(), reference.time());
+            return false;
+        }
+        for (std::size_t net = 0; net < view.num_nets(); ++net) {
+            if (kernel.get(net) != reference.get(net)) {
+                digsim::error(
+                    "Test", "At time {}, `{}` is {} instead of {}", kernel.time(), view.get_name(net), kernel.get(net),
+                    reference.get(net));
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+int main()
+{
+    digsim::logger.set_level(digsim::log_level_t::info);
+
+    // A 4-bit counter, and some logic with a delay.
+    netlist_counter_t counter(4);
+    digsim::signal_t<bool> high_ones("high_ones", false, 2);
+    AndGate both("both");
+    both.a(*counter.q[2]);
+    both.b(*counter.q[3]);
+    both.out(high_ones);
+
+    digsim::netlist_t netlist = digsim::netlist_t::extract();
+    const auto view           = netlist.view();
+    const std::string cache   = "test_jit_cache";
+    std::filesystem::remove_all(cache);
+
+    // The first run compiles the design.
+    std::string library;
+    {
+        digsim::jit_kernel_t kernel(view, cache);
+        if (!matches(kernel, view)) {
+            return 1;
+        }
+        if (!kernel.is_compiled()) {
+            digsim::info("Test", "The compiler is not available, only the fallback was tested.");
+        } else if (kernel.is_cached() || !std::filesystem::exists(kernel.get_library())) {
+            digsim::error("Test", "The library was not compiled");
+            return 1;
+        }
+        library = kernel.get_library();
+    }
+    // The second run reuses the library.
+    {
+        digsim::jit_kernel_t kernel(view, cache);
+        if (!matches(kernel, view)) {
+            return 1;
+        }
+        if (kernel.is_compiled() && (!kernel.is_cached() || (kernel.get_library() != library))) {
+            digsim::error("Test", "The library was not reused");
+            return 1;
+        }
+        try {
+            kernel.get(view.num_nets());
+            digsim::error("Test", "A net that does not exist was read");
+            return 1;
+        } catch (const std::out_of_range &) {
+            // Expected.
+        }
+    }
+    // A damaged library in the cache is compiled again, and the temporary files of each compilation are removed. It
+    // goes in another cache, since the library loaded above stays loaded under its own path.
+    if (std::filesystem::exists(library)) {
+        const std::string damaged_cache = cache + "_damaged";
+        std::filesystem::remove_all(damaged_cache);
+        std::filesystem::create_directories(damaged_cache);
+        const auto damaged_library = std::filesystem::path(damaged_cache) / std::filesystem::path(library).filename();
+        std::ofstream(damaged_library) << "damaged";
+        {
+            digsim::jit_kernel_t kernel(view, damaged_cache);
+            if (!matches(kernel, view)) {
+                return 1;
+            }
+            if (!kernel.is_compiled() || kernel.is_cached()) {
+                digsim::error("Test", "The damaged library was not compiled again");
+                return 1;
+            }
+        }
+        for (const auto &entry : std::filesystem::directory_iterator(damaged_cache)) {
+            if (entry.path() != damaged_library) {
+                digsim::error("Test", "The temporary file `{}` was left in the cache", entry.path().string());
+                return 1;
+            }
+        }
+        std::filesystem::remove_all(damaged_cache);
+    }
+    // A cache directory with a quote in its name is passed to the compiler as it is.
+    if (std::filesystem::exists(library)) {
+        const std::string quoted_cache = cache + "_it's";
+        std::filesystem::remove_all(quoted_cache);
+        {
+            digsim::jit_kernel_t kernel(view, quoted_cache);
+            if (!matches(kernel, view)) {
+                return 1;
+            }
+            if (!kernel.is_compiled()) {
+                digsim::error("Test", "The library was not compiled in `{}`", quoted_cache);
+                return 1;
+            }
+        }
+        std::filesystem::remove_all(quoted_cache);
+    }
+    // When the code cannot be compiled, the compact kernel takes over.
+    {
+        digsim::jit_kernel_t kernel(view, cache);
+        kernel.set_compiler("false");
+        if (!matches(kernel, view)) {
+            return 1;
+        }
+        if (kernel.is_compiled()) {
+            digsim::error("Test", "A failed compilation was loaded");
+            return 1;
+        }
+    }
+    std::filesystem::remove_all(cache);
+
+    digsim::info("Test", "✅ All tests passed.");
+    return 0;
+}
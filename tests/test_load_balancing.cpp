@@ -0,0 +1,160 @@
+/// @file test_load_balancing.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Tests the migration of processes between partitions, as the activity moves from a part of the design to
+/// another.
+
+#include <digsim/digsim.hpp>
+
+#include <d_flip_flop.hpp>
+#include <gates/not_gate.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <numeric>
+
+/// @brief A flip-flop toggling at each rising edge of its clock while enabled, followed by a chain of inverters.
+class toggler_t : public digsim::module_t
+{
+public:
+    digsim::input_t<bool> clk;
+    digsim::input_t<bool> enable;
+    digsim::input_t<bool> reset;
+    digsim::output_t<bool> out;
+
+    toggler_t(const std::string &_name, std::size_t length)
+        : digsim::module_t(_name)
+        , clk("clk", this)
+        , enable("enable", this)
+        , reset("reset", this)
+        , out("out", this)
+        , ff("ff", this)
+        , q(_name + "_q", false, 1)
+        , q_not(_name + "_q_not", true, 1)
+    {
+        ff.clk(clk);
+        ff.d(q_not);
+        ff.enable(enable);
+        ff.reset(reset);
+        ff.q(q);
+        ff.q_not(q_not);
+        for (std::size_t index = 0; index < length; ++index) {
+            gates.emplace_back(std::make_unique<NotGate>("not" + std::to_string(index), this));
+            gates.back()->in((index == 0) ? q : *wires.back());
+            if (index + 1 == length) {
+                gates.back()->out(out);
+            } else {
+                wires.emplace_back(std::make_unique<digsim::signal_t<bool>>(_name + "_w" + std::to_string(index)));
+                gates.back()->out(*wires.back());
+            }
+        }
+    }
+
+    /// @brief Checks if one of the wires of the chain goes from a partition to another.
+    /// @return true if the chain is split.
+    bool split() const
+    {
+        return std::any_of(wires.begin(), wires.end(), [](const auto &wire) { return wire->is_crossing(); });
+    }
+
+    DFlipFlop ff;
+    digsim::signal_t<bool> q;
+    digsim::signal_t<bool> q_not;
+
+private:
+    std::vector<std::unique_ptr<NotGate>> gates;
+    std::vector<std::unique_ptr<digsim::signal_t<bool>>> wires;
+};
+
+int main()
+{
+    digsim::logger.set_level(digsim::log_level_t::info);
+
+    digsim::signal_t<bool> clk_a_out("clk_a_out");
+    digsim::signal_t<bool> clk_b_out("clk_b_out");
+    digsim::signal_t<bool> enable_a("enable_a", true);
+    digsim::signal_t<bool> enable_b("enable_b", false);
+    digsim::signal_t<bool> reset("reset", false);
+    digsim::signal_t<bool> a_out("a_out", false);
+    digsim::signal_t<bool> b_out("b_out", false);
+
+    digsim::clock_t clk_a("clk_a", 4);
+    digsim::clock_t clk_b("clk_b", 6);
+    clk_a.out(clk_a_out);
+    clk_b.out(clk_b_out);
+    toggler_t toggler_a("toggler_a", 16);
+    toggler_a.clk(clk_a_out);
+    toggler_a.enable(enable_a);
+    toggler_a.reset(reset);
+    toggler_a.out(a_out);
+    toggler_t toggler_b("toggler_b", 16);
+    toggler_b.clk(clk_b_out);
+    toggler_b.enable(enable_b);
+    toggler_b.reset(reset);
+    toggler_b.out(b_out);
+
+    // Each toggler starts in the partition of its clock, only the first one is busy.
+    digsim::scheduler.set_partitioning(digsim::partitioning_t::clock_domains);
+    digsim::scheduler.set_num_threads(2);
+    digsim::scheduler.set_rebalancing(10, 0.25);
+    digsim::scheduler.initialize();
+    if (digsim::scheduler.get_num_partitions() < 2) {
+        digsim::error("Test", "Expected a partition per clock, got {}", digsim::scheduler.get_num_partitions());
+        return 1;
+    }
+
+    // Returns the activations of each partition, since the given ones.
+    auto loads_since = [](const std::vector<std::uint64_t> &base) {
+        const auto &activations = digsim::scheduler.get_activations();
+        std::vector<std::uint64_t> loads(digsim::scheduler.get_num_partitions(), 0);
+        for (std::size_t id = 0; id < activations.size(); ++id) {
+            const auto &proc_info = digsim::process_table.get(id);
+            loads[digsim::scheduler.get_partition(proc_info)] += activations[id] - ((id < base.size()) ? base[id] : 0);
+        }
+        return loads;
+    };
+    // Runs a phase: the migrations must happen early, then the partitions must stay balanced.
+    auto run_phase = [&](const char *name, digsim::discrete_time_t duration) {
+        const std::size_t migrations = digsim::scheduler.get_migrations();
+        digsim::scheduler.run(duration);
+        if (digsim::scheduler.get_migrations() == migrations) {
+            digsim::error("Test", "[{}] No process was moved", name);
+            return false;
+        }
+        const auto base = digsim::scheduler.get_activations();
+        digsim::scheduler.run(duration);
+        const auto loads = loads_since(base);
+        const std::uint64_t total   = std::accumulate(loads.begin(), loads.end(), std::uint64_t{0});
+        const std::uint64_t busiest = *std::max_element(loads.begin(), loads.end());
+        digsim::info("Test", "[{}] The busiest partition has {} of {} activations", name, busiest, total);
+        // Allow for the tolerance, and for the processes which cannot be split.
+        if (busiest * loads.size() * 100 > total * 140) {
+            digsim::error("Test", "[{}] The partitions are not balanced", name);
+            return false;
+        }
+        // The chains of inverters are even, they must have settled.
+        if ((a_out.get() != toggler_a.q.get()) || (b_out.get() != toggler_b.q.get())) {
+            digsim::error("Test", "[{}] The outputs of the togglers are out of date", name);
+            return false;
+        }
+        return true;
+    };
+
+    if (!run_phase("first", 200) || !toggler_a.split()) {
+        return 1;
+    }
+    // The activity moves to the second toggler.
+    enable_a.set(false);
+    enable_b.set(true);
+    const bool a_before = toggler_a.q.get();
+    if (!run_phase("second", 300) || !toggler_b.split()) {
+        return 1;
+    }
+    if (toggler_a.q.get() != a_before) {
+        digsim::error("Test", "The first toggler must be idle");
+        return 1;
+    }
+    digsim::info("Test", "Moved {} process(es) in total", digsim::scheduler.get_migrations());
+
+    digsim::info("Test", "✅ All tests passed.");
+    return 0;
+}
@@ -0,0 +1,168 @@
+/// @file test_netlist.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Tests the extraction of a netlist, its binary image, and the compact kernel running it.
+
+#include <digsim/digsim.hpp>
+
+#include <gates/and_gate.hpp>
+#include <gates/not_gate.hpp>
+#include <mux2to1.hpp>
+
+#include "netlist_counter.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+int main()
+{
+    digsim::logger.set_level(digsim::log_level_t::info);
+
+    // A 3-bit counter: flip-flops holding the value, and full adders adding one.
+    netlist_counter_t counter(3);
+    // Some logic with a delay, and a word-wide multiplexer.
+    digsim::signal_t<bool> low_ones("low_ones", false, 3);
+    digsim::signal_t<bool> not_low_ones("not_low_ones");
+    digsim::signal_t<unsigned> word_a("word_a", 5);
+    digsim::signal_t<unsigned> word_b("word_b", 9);
+    digsim::signal_t<unsigned> word_out("word_out");
+    AndGate both("both");
+    both.a(*counter.q[0]);
+    both.b(*counter.q[1]);
+    both.out(low_ones);
+    NotGate neither("neither");
+    neither.in(low_ones);
+    neither.out(not_low_ones);
+    Mux2to1<unsigned> mux("mux");
+    mux.a(word_a);
+    mux.b(word_b);
+    mux.sel(*counter.q[2]);
+    mux.out(word_out);
+
+    // Freeze the design, and save it.
+    digsim::netlist_t netlist = digsim::netlist_t::extract();
+    const auto view           = netlist.view();
+    if (view.num_nets() != 22 || view.num_gates() != 15 || view.num_clocks() != 1) {
+        digsim::error(
+            "Test", "Wrong netlist: {} nets, {} gates, {} clocks", view.num_nets(), view.num_gates(),
+            view.num_clocks());
+        return 1;
+    }
+    const std::size_t low_ones_net = view.find("low_ones");
+    if (low_ones_net == digsim::netlist_view_t::npos || view.net_delays[low_ones_net] != 3 ||
+        view.net_widths[view.find("word_out")] != 32 || view.net_initial[view.find("word_b")] != 9) {
+        digsim::error("Test", "Wrong nets");
+        return 1;
+    }
+    // The flip-flops come first, then the adders, along the ripple of the carries.
+    auto driver = [&view](const char *name) {
+        auto it = std::find(view.gate_outputs.begin(), view.gate_outputs.end(), view.find(name));
+        return static_cast<std::size_t>(std::distance(view.gate_outputs.begin(), it));
+    };
+    for (std::size_t gate = 0; gate < view.num_gates(); ++gate) {
+        const auto op = static_cast<digsim::gate_op_t>(view.gate_ops[gate]);
+        if (digsim::is_sequential(op) != (view.gate_levels[gate] == 0)) {
+            digsim::error("Test", "Gate {} is at level {}", gate, view.gate_levels[gate]);
+            return 1;
+        }
+    }
+    if (view.gate_levels[driver("carry2")] != view.gate_levels[driver("carry0")] + 2) {
+        digsim::error("Test", "The carries do not ripple");
+        return 1;
+    }
+    view.save("test_netlist.img");
+
+    // Run the event-driven simulation and the kernel on the mapped image side by side.
+    digsim::netlist_image_t image("test_netlist.img");
+    digsim::netlist_kernel_t kernel(image.view());
+    std::vector<const digsim::isignal_t *> signals{
+        &counter.clk_out, &counter.one, &low_ones, &not_low_ones, &word_a, &word_b, &word_out};
+    for (std::size_t bit = 0; bit < 3; ++bit) {
+        signals.insert(
+            signals.end(),
+            {counter.q[bit].get(), counter.q_not[bit].get(), counter.sum[bit].get(), counter.carry[bit].get()});
+    }
+    digsim::scheduler.initialize();
+    kernel.initialize();
+    for (std::size_t step = 0; step < 30; ++step) {
+        if (step > 0) {
+            digsim::scheduler.run(7);
+            kernel.run(7);
+        }
+        if (kernel.time() != digsim::scheduler.time()) {
+            digsim::error("Test", "The kernel is at time {}, instead of {}", kernel.time(), digsim::scheduler.time());
+            return 1;
+        }
+        for (const auto *signal : signals) {
+            const uint64_t value = kernel.get(image.view().find(signal->get_name()));
+            if (value != signal->get_bits()) {
+                digsim::error(
+                    "Test", "At time {}, `{}` is {} instead of {}", kernel.time(), signal->get_name(), value,
+                    signal->get_bits());
+                return 1;
+            }
+        }
+    }
+    // The counter counted the rising edges.
+    const uint64_t count = kernel.get(image.view().find("q0")) | (kernel.get(image.view().find("q1")) << 1) |
+                           (kernel.get(image.view().find("q2")) << 2);
+    if (count != ((digsim::scheduler.time() + 5) / 10) % 8) {
+        digsim::error("Test", "The counter is {} at time {}", count, kernel.time());
+        return 1;
+    }
+
+    // Damaged images are rejected.
+    {
+        std::ofstream os("test_netlist.img", std::ios::binary | std::ios::trunc);
+        os << "DSIMNET1 this is not a netlist";
+    }
+    try {
+        digsim::netlist_image_t damaged("test_netlist.img");
+        digsim::error("Test", "A damaged image was accepted");
+        return 1;
+    } catch (const std::runtime_error &) {
+        // Expected.
+    }
+    // So are images whose arrays have the right sizes, but hold invalid indices, opcodes, or offsets.
+    auto rejected = [](const digsim::netlist_view_t &damaged) {
+        damaged.save("test_netlist.img");
+        try {
+            digsim::netlist_image_t image_damaged("test_netlist.img");
+            return false;
+        } catch (const std::runtime_error &) {
+            return true;
+        }
+    };
+    std::vector<uint32_t> bad_inputs(view.inputs.begin(), view.inputs.end());
+    bad_inputs.back() = static_cast<uint32_t>(view.num_nets());
+    std::vector<uint8_t> bad_ops(view.gate_ops.begin(), view.gate_ops.end());
+    bad_ops.front() = 0xFF;
+    std::vector<uint32_t> bad_offsets(view.input_offsets.begin(), view.input_offsets.end());
+    std::swap(bad_offsets[1], bad_offsets[2]);
+    std::vector<uint32_t> bad_fanout(view.fanout.begin(), view.fanout.end());
+    bad_fanout.front() = static_cast<uint32_t>(view.num_gates());
+    auto with_inputs = view, with_ops = view, with_offsets = view, with_fanout = view;
+    with_inputs.inputs         = bad_inputs;
+    with_ops.gate_ops          = bad_ops;
+    with_offsets.input_offsets = bad_offsets;
+    with_fanout.fanout         = bad_fanout;
+    if (!rejected(with_inputs) || !rejected(with_ops) || !rejected(with_offsets) || !rejected(with_fanout)) {
+        digsim::error("Test", "An image with invalid contents was accepted");
+        return 1;
+    }
+    std::remove("test_netlist.img");
+
+    // Clocks cannot be added to nets which do not exist.
+    try {
+        digsim::netlist_t empty;
+        empty.add_clock(0, 5, 5, 5);
+        digsim::error("Test", "A clock was added to a missing net");
+        return 1;
+    } catch (const std::runtime_error &) {
+        // Expected.
+    }
+
+    digsim::info("Test", "✅ All tests passed.");
+    return 0;
+}
@@ -0,0 +1,189 @@
+/// @file test_ordering.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Tests the ordering of the processes within a delta cycle, and the race detection.
+
+#include <digsim/digsim.hpp>
+
+#include <algorithm>
+
+/// @brief The order in which the processes were executed.
+std::vector<std::string> execution_log;
+
+/// @brief Samples its input on the rising edges of the clock, without being sensitive to it.
+class sampler_t : public digsim::module_t
+{
+public:
+    digsim::input_t<bool> clk;
+    digsim::input_t<unsigned> data;
+    unsigned sampled = 0;
+
+    sampler_t(const std::string &_name)
+        : digsim::module_t(_name)
+        , clk("clk", this)
+        , data("data", this)
+    {
+        ADD_SENSITIVITY_WHEN(sampler_t, evaluate, clk, digsim::when_equals(true));
+        ADD_CONSUMER(sampler_t, evaluate, data);
+    }
+
+private:
+    void evaluate()
+    {
+        if (clk.posedge()) {
+            execution_log.push_back(get_name());
+            sampled = data.get();
+        }
+    }
+};
+
+/// @brief Samples its input on the rising edges of the clock, and is only woken up by one value of it.
+class watcher_t : public digsim::module_t
+{
+public:
+    digsim::input_t<bool> clk;
+    digsim::input_t<unsigned> data;
+    unsigned sampled = 0;
+
+    watcher_t(const std::string &_name, unsigned _wake_value)
+        : digsim::module_t(_name)
+        , clk("clk", this)
+        , data("data", this)
+    {
+        ADD_SENSITIVITY_WHEN(watcher_t, evaluate, clk, digsim::when_equals(true));
+        ADD_SENSITIVITY_WHEN(watcher_t, evaluate, data, digsim::when_equals(_wake_value));
+    }
+
+private:
+    void evaluate()
+    {
+        if (clk.posedge()) {
+            sampled = data.get();
+        }
+    }
+};
+
+/// @brief Writes a value on the rising edges of the clock.
+class writer_t : public digsim::module_t
+{
+public:
+    digsim::input_t<bool> clk;
+    digsim::output_t<unsigned> out;
+
+    writer_t(const std::string &_name, unsigned _step)
+        : digsim::module_t(_name)
+        , clk("clk", this)
+        , out("out", this)
+        , step(_step)
+    {
+        ADD_SENSITIVITY_WHEN(writer_t, evaluate, clk, digsim::when_equals(true));
+        ADD_PRODUCER(writer_t, evaluate, out);
+    }
+
+private:
+    unsigned step;
+    unsigned value = 0;
+
+    void evaluate()
+    {
+        if (clk.posedge()) {
+            execution_log.push_back(get_name());
+            value += step;
+            out.set(value);
+        }
+    }
+};
+
+int main()
+{
+    digsim::logger.set_level(digsim::log_level_t::info);
+
+    digsim::signal_t<bool> clk_out("clk_out");
+    digsim::signal_t<unsigned> data("data");
+    digsim::signal_t<unsigned> shared("shared");
+
+    digsim::clock_t clk("clk", 10);
+    clk.out(clk_out);
+
+    // The sampler is registered before the producer of its data.
+    sampler_t sampler("sampler");
+    sampler.clk(clk_out);
+    sampler.data(data);
+
+    writer_t producer("producer", 1);
+    producer.clk(clk_out);
+    producer.out(data);
+
+    // Two readers sensitive to the data, only one of them woken up by the value written.
+    watcher_t missed("missed", 100);
+    missed.clk(clk_out);
+    missed.data(data);
+    watcher_t woken("woken", 1);
+    woken.clk(clk_out);
+    woken.data(data);
+
+    // Two processes driving the same signal.
+    writer_t first("first", 1);
+    first.clk(clk_out);
+    first.out(shared);
+    writer_t second("second", 2);
+    second.clk(clk_out);
+    second.out(shared);
+
+    // The producer of the data must come before its consumer.
+    auto order = digsim::dependency_graph.compute_topological_order();
+    auto position = [&](const digsim::module_t &module) {
+        for (std::size_t rank = 0; rank < order.size(); ++rank) {
+            if (digsim::process_table.get(order[rank]).owner.ptr == &module) {
+                return rank;
+            }
+        }
+        return order.size();
+    };
+    if (order.size() != digsim::process_table.size() || position(producer) > position(sampler)) {
+        digsim::error("Test", "The producer must precede the sampler in topological order");
+        return 1;
+    }
+
+    digsim::scheduler.set_ordering(digsim::ordering_t::topological);
+    digsim::scheduler.set_race_detection(true);
+    digsim::scheduler.initialize();
+    digsim::scheduler.run(5);
+
+    // With the topological ordering, the sampler comes after the producer, and sees the value written in the same
+    // delta cycle. The writers have the same level as the producer, and come after it by registration order.
+    if (execution_log != std::vector<std::string>{"producer", "first", "second", "sampler"} || sampler.sampled != 1) {
+        digsim::error("Test", "Wrong execution order");
+        return 1;
+    }
+    if (shared.get() != 2) {
+        digsim::error("Test", "The last writer of a signal must win");
+        return 1;
+    }
+
+    const auto &races = digsim::scheduler.get_races();
+    auto found        = [&](digsim::race_kind_t kind, const std::string &signal, const std::string &other) {
+        return std::any_of(races.begin(), races.end(), [&](const digsim::race_t &race) {
+            return (race.kind == kind) && (race.signal == signal) && (race.second.find(other) != std::string::npos) &&
+                   (race.time == 5);
+        });
+    };
+    // The watcher waiting for another value is not woken up by the write, and might miss it.
+    if (races.size() != 3 || !found(digsim::race_kind_t::read_write, "data", "sampler") ||
+        !found(digsim::race_kind_t::read_write, "data", "missed") ||
+        !found(digsim::race_kind_t::write_write, "shared", "second")) {
+        digsim::error("Test", "Expected three races, found {}", races.size());
+        return 1;
+    }
+
+    // The ordering cannot change once the simulation started.
+    try {
+        digsim::scheduler.set_ordering(digsim::ordering_t::shuffled, 42);
+        digsim::error("Test", "Changing the ordering after the initialization must fail");
+        return 1;
+    } catch (const std::runtime_error &) {
+        // Expected.
+    }
+
+    digsim::info("Test", "✅ All tests passed.");
+    return 0;
+}
@@ -0,0 +1,231 @@
+/// @file test_partitioner.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Tests the multilevel partitioner, the partition maps, and the profiling of the activations.
+
+#include <digsim/digsim.hpp>
+
+#include <d_flip_flop.hpp>
+#include <gates/and_gate.hpp>
+#include <gates/not_gate.hpp>
+
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+
+/// @brief A flip-flop toggling at each rising edge of its clock, followed by a chain of inverters.
+class toggler_t : public digsim::module_t
+{
+public:
+    digsim::input_t<bool> clk;
+    digsim::input_t<bool> enable;
+    digsim::input_t<bool> reset;
+    digsim::output_t<bool> out;
+
+    toggler_t(const std::string &_name, std::size_t length)
+        : digsim::module_t(_name)
+        , clk("clk", this)
+        , enable("enable", this)
+        , reset("reset", this)
+        , out("out", this)
+        , ff("ff", this)
+        , q(_name + "_q", false, 1)
+        , q_not(_name + "_q_not", true, 1)
+    {
+        ff.clk(clk);
+        ff.d(q_not);
+        ff.enable(enable);
+        ff.reset(reset);
+        ff.q(q);
+        ff.q_not(q_not);
+        for (std::size_t index = 0; index < length; ++index) {
+            gates.emplace_back(std::make_unique<NotGate>("not" + std::to_string(index), this));
+            gates.back()->in((index == 0) ? q : *wires.back());
+            if (index + 1 == length) {
+                gates.back()->out(out);
+            } else {
+                wires.emplace_back(std::make_unique<digsim::signal_t<bool>>(_name + "_w" + std::to_string(index)));
+                gates.back()->out(*wires.back());
+            }
+        }
+    }
+
+    /// @brief Checks if a process belongs to the toggler, or to one of its submodules.
+    /// @param proc_info the process.
+    /// @return true if the process belongs to the toggler.
+    bool owns(const digsim::process_info_t &proc_info) const
+    {
+        for (const auto *module = dynamic_cast<const digsim::module_t *>(proc_info.owner.ptr); module;
+             module             = module->get_parent()) {
+            if (module == this) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    DFlipFlop ff;
+    digsim::signal_t<bool> q;
+    digsim::signal_t<bool> q_not;
+    std::vector<std::unique_ptr<NotGate>> gates;
+    std::vector<std::unique_ptr<digsim::signal_t<bool>>> wires;
+};
+
+int main()
+{
+    digsim::logger.set_level(digsim::log_level_t::info);
+
+    digsim::signal_t<bool> clk_a_out("clk_a_out");
+    digsim::signal_t<bool> clk_b_out("clk_b_out");
+    digsim::signal_t<bool> enable("enable", true);
+    digsim::signal_t<bool> reset("reset", false);
+    // The output of the first toggler reaches the second one late, this is where the cut should go.
+    digsim::signal_t<bool> a_out("a_out", false, 5);
+    digsim::signal_t<bool> b_out("b_out", false);
+    digsim::signal_t<bool> joined("joined", false);
+
+    digsim::clock_t clk_a("clk_a", 4);
+    digsim::clock_t clk_b("clk_b", 6);
+    clk_a.out(clk_a_out);
+    clk_b.out(clk_b_out);
+    toggler_t toggler_a("toggler_a", 12);
+    toggler_a.clk(clk_a_out);
+    toggler_a.enable(enable);
+    toggler_a.reset(reset);
+    toggler_a.out(a_out);
+    toggler_t toggler_b("toggler_b", 12);
+    toggler_b.clk(clk_b_out);
+    toggler_b.enable(enable);
+    toggler_b.reset(reset);
+    toggler_b.out(b_out);
+    AndGate join("join");
+    join.a(a_out);
+    join.b(b_out);
+    join.out(joined);
+
+    // Returns the partition of the processes of a module, or the number of partitions if they are split.
+    auto partition_of = [](const digsim::partition_map_t &map, auto &&owns) {
+        std::size_t result = map.num_partitions;
+        for (std::size_t id = 0; id < digsim::process_table.size(); ++id) {
+            if (owns(digsim::process_table.get(id))) {
+                if ((result != map.num_partitions) && (result != map.process_partition[id])) {
+                    return map.num_partitions;
+                }
+                result = map.process_partition[id];
+            }
+        }
+        return result;
+    };
+    auto owns_join = [&join](const digsim::process_info_t &proc_info) { return proc_info.owner.ptr == &join; };
+    auto owns_a    = [&toggler_a](const digsim::process_info_t &proc_info) { return toggler_a.owns(proc_info); };
+    auto owns_b    = [&toggler_b](const digsim::process_info_t &proc_info) { return toggler_b.owns(proc_info); };
+    // Checks that each toggler gets its own partition, and that the AND gate stays with the second one.
+    auto check_map = [&](const digsim::partition_map_t &map) {
+        const std::size_t a = partition_of(map, owns_a), b = partition_of(map, owns_b);
+        if ((a == map.num_partitions) || (b == map.num_partitions) || (a == b)) {
+            digsim::error("Test", "The togglers must get a partition each, got {} and {}", a, b);
+            return false;
+        }
+        if (partition_of(map, owns_join) != b) {
+            digsim::error("Test", "The AND gate must be cut away from the first toggler only");
+            return false;
+        }
+        return true;
+    };
+
+    // Partition without a profile, the result must be reproducible.
+    digsim::partitioner_t partitioner;
+    const auto map = partitioner.partition(2);
+    if (!check_map(map) || (partitioner.partition(2).process_partition != map.process_partition)) {
+        return 1;
+    }
+    const auto &loads = partitioner.get_loads();
+    if ((loads.size() != 2) || (std::accumulate(loads.begin(), loads.end(), std::uint64_t{0}) !=
+                                digsim::process_table.size())) {
+        digsim::error("Test", "Each process weighs 1 without a profile");
+        return 1;
+    }
+
+    // Store the map, and load it back.
+    map.save("test_partitioner.map");
+    digsim::partition_map_t loaded;
+    if (!loaded.load("test_partitioner.map", digsim::dependency_graph.compute_fingerprint()) ||
+        (loaded.process_partition != map.process_partition) || (loaded.num_partitions != 2)) {
+        digsim::error("Test", "The partition map was not restored");
+        return 1;
+    }
+    if (digsim::partition_map_t{}.load("test_partitioner.map", map.fingerprint + 1)) {
+        digsim::error("Test", "A partition map of another design was accepted");
+        return 1;
+    }
+
+    // The scheduler refuses a map of another design.
+    try {
+        digsim::partition_map_t stale = loaded;
+        ++stale.fingerprint;
+        digsim::scheduler.set_partition_map(stale);
+        digsim::error("Test", "The scheduler accepted a partition map of another design");
+        return 1;
+    } catch (const std::runtime_error &) {
+        // Expected.
+    }
+
+    // Run on the partitions, while profiling.
+    digsim::scheduler.set_partition_map(loaded);
+    digsim::scheduler.set_num_threads(2);
+    digsim::scheduler.set_profiling(true);
+    digsim::scheduler.initialize();
+    digsim::scheduler.run(100);
+    if (digsim::scheduler.get_num_partitions() != 2) {
+        digsim::error("Test", "Expected 2 partitions, got {}", digsim::scheduler.get_num_partitions());
+        return 1;
+    }
+    if (!a_out.is_crossing() || b_out.is_crossing()) {
+        digsim::error("Test", "Only `a_out` goes from a partition to the other");
+        return 1;
+    }
+    if (joined.get() != (a_out.get() && b_out.get())) {
+        digsim::error("Test", "The AND gate is out of date");
+        return 1;
+    }
+    const auto &activations = digsim::scheduler.get_activations();
+    for (std::size_t id = 0; id < digsim::process_table.size(); ++id) {
+        if (owns_join(digsim::process_table.get(id)) && (activations[id] == 0)) {
+            digsim::error("Test", "The AND gate was never activated");
+            return 1;
+        }
+    }
+
+    // Partition again from the profile: the first toggler is busier and more expensive, so that it has to be split
+    // to balance the load, while the second one stays whole.
+    digsim::partitioner_t profiled;
+    profiled.set_activations(activations);
+    std::uint64_t total = 0, heaviest = 0;
+    for (std::size_t id = 0; id < digsim::process_table.size(); ++id) {
+        const auto &proc_info    = digsim::process_table.get(id);
+        const std::uint64_t cost = owns_a(proc_info) ? 3 : 1;
+        profiled.set_cost(proc_info, cost);
+        total += 1 + activations[id] * cost;
+        heaviest = std::max(heaviest, 1 + activations[id] * cost);
+    }
+    const auto profiled_map = profiled.partition(2);
+    if ((partition_of(profiled_map, owns_a) != 2) || (partition_of(profiled_map, owns_b) == 2)) {
+        digsim::error("Test", "Only the first toggler must be split");
+        return 1;
+    }
+    const auto &profiled_loads = profiled.get_loads();
+    if (std::accumulate(profiled_loads.begin(), profiled_loads.end(), std::uint64_t{0}) != total) {
+        digsim::error("Test", "The loads do not add up to the weight of the processes");
+        return 1;
+    }
+    // A flip-flop goes with the delayed updates of its two outputs.
+    const std::uint64_t bound = total * 105 / 200 + 3 * heaviest;
+    if (std::max(profiled_loads[0], profiled_loads[1]) > bound) {
+        digsim::error("Test", "Unbalanced loads {} and {}, beyond {}", profiled_loads[0], profiled_loads[1], bound);
+        return 1;
+    }
+    digsim::info("Test", "Loads {} and {}, cut {}", profiled_loads[0], profiled_loads[1], profiled.get_cut());
+
+    digsim::info("Test", "✅ All tests passed.");
+    return 0;
+}
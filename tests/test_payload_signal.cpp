@@ -0,0 +1,145 @@
+/// @file test_payload_signal.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Tests that large payloads travel through signals without being copied.
+
+#include <digsim/digsim.hpp>
+
+#include <cstdint>
+#include <vector>
+
+/// @brief A network packet, which counts how many times it is copied.
+struct packet_t {
+    std::vector<uint8_t> bytes;
+
+    static inline std::size_t copies = 0;
+
+    packet_t() = default;
+
+    packet_t(std::size_t size, uint8_t fill)
+        : bytes(size, fill)
+    {
+        // Nothing to do here.
+    }
+
+    packet_t(const packet_t &other)
+        : bytes(other.bytes)
+    {
+        ++copies;
+    }
+
+    packet_t(packet_t &&other) noexcept = default;
+
+    packet_t &operator=(const packet_t &other)
+    {
+        bytes = other.bytes;
+        ++copies;
+        return *this;
+    }
+
+    packet_t &operator=(packet_t &&other) noexcept = default;
+};
+
+/// @brief Packets are never compared, every write is a new transaction.
+template <> struct digsim::change_policy_t<packet_t> {
+    static bool changed(const packet_t &, const packet_t &) { return true; }
+};
+
+/// @brief Custom formatter for packet_t, used when tracing the signals.
+template <> struct std::formatter<packet_t, char> {
+    constexpr auto parse(std::format_parse_context &ctx) { return ctx.begin(); }
+
+    template <typename FormatContext> auto format(const packet_t &packet, FormatContext &ctx) const
+    {
+        return std::format_to(ctx.out(), "packet[{}]", packet.bytes.size());
+    }
+};
+
+/// @brief Sums the bytes of the packets it receives.
+class sink_t : public digsim::module_t
+{
+public:
+    digsim::input_t<packet_t> in;
+    std::size_t received = 0;
+    std::size_t checksum = 0;
+
+    sink_t(const std::string &_name)
+        : digsim::module_t(_name)
+        , in("in", this)
+    {
+        ADD_SENSITIVITY(sink_t, evaluate, in);
+    }
+
+private:
+    void evaluate()
+    {
+        const packet_t &packet = in.get();
+        if (packet.bytes.empty()) {
+            return;
+        }
+        ++received;
+        for (auto byte : packet.bytes) {
+            checksum += byte;
+        }
+    }
+};
+
+int main()
+{
+    digsim::logger.set_level(digsim::log_level_t::info);
+
+    digsim::signal_t<packet_t> link("link");
+    sink_t sink("sink");
+    sink.in(link);
+    // The same, through a delayed signal.
+    digsim::signal_t<packet_t> delayed_link("delayed_link", packet_t(), 2);
+    sink_t delayed_sink("delayed_sink");
+    delayed_sink.in(delayed_link);
+
+    digsim::scheduler.initialize();
+
+    // Only count the copies made while the simulation is running.
+    packet_t::copies = 0;
+    for (uint8_t index = 1; index <= 10; ++index) {
+        link.set(packet_t(1500, index));
+        delayed_link.set(packet_t(1500, index));
+        digsim::scheduler.run();
+    }
+    // Sending the same content again is still a new transaction.
+    link.set(packet_t(1500, 10));
+    digsim::scheduler.run();
+
+    if (sink.received != 11 || sink.checksum != 1500 * (55 + 10)) {
+        digsim::error("Test", "Expected 11 packets, got {} (checksum {})", sink.received, sink.checksum);
+        return 1;
+    }
+    if (link.get_version() != 11) {
+        digsim::error("Test", "Expected version 11, got {}", link.get_version());
+        return 1;
+    }
+    if (delayed_sink.received != 10 || delayed_sink.checksum != 1500 * 55) {
+        digsim::error(
+            "Test", "Expected 10 delayed packets, got {} (checksum {})", delayed_sink.received, delayed_sink.checksum);
+        return 1;
+    }
+    if (packet_t::copies != 0) {
+        digsim::error("Test", "Packets were copied {} times", packet_t::copies);
+        return 1;
+    }
+    // A delayed write overwritten before it is applied: both pending applications apply the last value.
+    delayed_link.set(packet_t(1500, 20));
+    digsim::scheduler.run(1);
+    delayed_link.set(packet_t(1500, 30));
+    digsim::scheduler.run();
+    if (delayed_link.get().bytes.size() != 1500 || delayed_link.get().bytes.front() != 30) {
+        digsim::error("Test", "The delayed packet was lost");
+        return 1;
+    }
+    // The previous packet is still available, without having been copied.
+    if (link.get_last().bytes.size() != 1500 || link.get_last().bytes.front() != 10) {
+        digsim::error("Test", "Wrong last value");
+        return 1;
+    }
+
+    digsim::info("Test", "✅ All tests passed.");
+    return 0;
+}
@@ -0,0 +1,140 @@
+/// @file test_placement.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Tests the placement of the threads on the CPUs and NUMA nodes.
+
+#include <digsim/digsim.hpp>
+
+#include <d_flip_flop.hpp>
+#include <gates/not_gate.hpp>
+
+#include <memory>
+
+int main()
+{
+    digsim::logger.set_level(digsim::log_level_t::info);
+
+    // The lists of CPUs, as found in sysfs.
+    if ((digsim::parse_cpu_list("0-3,8,10-11") != std::vector<int>{0, 1, 2, 3, 8, 10, 11}) ||
+        !digsim::parse_cpu_list("").empty()) {
+        digsim::error("Test", "The list of CPUs was not parsed");
+        return 1;
+    }
+    digsim::placement_t placement = digsim::placement_t::none;
+    if (!digsim::parse_placement("scatter", placement) || (placement != digsim::placement_t::scatter) ||
+        digsim::parse_placement("spread", placement) || (placement != digsim::placement_t::scatter)) {
+        digsim::error("Test", "The placement policy was not parsed");
+        return 1;
+    }
+
+    // Two nodes with two CPUs each.
+    digsim::cpu_topology_t topology;
+    topology.nodes = {{0, 1}, {4, 5}};
+    const std::vector<int> compact{0, 1, 4, 5, 0}, scatter{0, 4, 1, 5, 0};
+    for (std::size_t slot = 0; slot < compact.size(); ++slot) {
+        if ((topology.cpu_of(digsim::placement_t::compact, slot) != compact[slot]) ||
+            (topology.node_of(digsim::placement_t::compact, slot) != ((slot % 4) / 2 == 0 ? 0 : 1))) {
+            digsim::error("Test", "Compact placement of thread {} is wrong", slot);
+            return 1;
+        }
+        if ((topology.cpu_of(digsim::placement_t::scatter, slot) != scatter[slot]) ||
+            (topology.node_of(digsim::placement_t::scatter, slot) != static_cast<int>(slot % 2))) {
+            digsim::error("Test", "Scatter placement of thread {} is wrong", slot);
+            return 1;
+        }
+    }
+    if (topology.cpu_of(digsim::placement_t::none, 0) != -1) {
+        digsim::error("Test", "Threads are not pinned without a placement policy");
+        return 1;
+    }
+    const auto detected = digsim::cpu_topology_t::detect();
+    if (detected.nodes.empty() || (detected.num_cpus() == 0)) {
+        digsim::error("Test", "No CPU found");
+        return 1;
+    }
+    digsim::info("Test", "{} CPUs on {} node(s)", detected.num_cpus(), detected.nodes.size());
+
+    // A flip-flop per clock, each toggling a chain of inverters, and running on its own pinned thread.
+    digsim::signal_t<bool> enable("enable", true);
+    digsim::signal_t<bool> reset("reset", false);
+    std::vector<std::unique_ptr<digsim::clock_t>> clocks;
+    std::vector<std::unique_ptr<DFlipFlop>> flip_flops;
+    std::vector<std::unique_ptr<NotGate>> gates;
+    std::vector<std::unique_ptr<digsim::signal_t<bool>>> signals;
+    std::vector<digsim::signal_t<bool> *> qs, outs;
+    auto make_signal = [&signals](const std::string &name, bool value, digsim::discrete_time_t delay) {
+        signals.emplace_back(std::make_unique<digsim::signal_t<bool>>(name, value, delay));
+        return signals.back().get();
+    };
+    for (std::size_t index = 0; index < 2; ++index) {
+        const std::string name = "d" + std::to_string(index);
+        auto *clk              = make_signal(name + "_clk", false, 0);
+        auto *q                = make_signal(name + "_q", false, 1);
+        auto *q_not            = make_signal(name + "_q_not", true, 1);
+        clocks.emplace_back(std::make_unique<digsim::clock_t>(name + "_clock", 4 + 2 * index));
+        clocks.back()->out(*clk);
+        flip_flops.emplace_back(std::make_unique<DFlipFlop>(name + "_ff"));
+        flip_flops.back()->clk(*clk);
+        flip_flops.back()->d(*q_not);
+        flip_flops.back()->enable(enable);
+        flip_flops.back()->reset(reset);
+        flip_flops.back()->q(*q);
+        flip_flops.back()->q_not(*q_not);
+        auto *wire = q;
+        for (std::size_t gate = 0; gate < 4; ++gate) {
+            auto *next = make_signal(name + "_w" + std::to_string(gate), false, 0);
+            gates.emplace_back(std::make_unique<NotGate>(name + "_not" + std::to_string(gate)));
+            gates.back()->in(*wire);
+            gates.back()->out(*next);
+            wire = next;
+        }
+        qs.push_back(q);
+        outs.push_back(wire);
+    }
+
+    const auto cpus = digsim::get_thread_cpus();
+    digsim::scheduler.set_partitioning(digsim::partitioning_t::clock_domains);
+    digsim::scheduler.set_num_threads(2);
+    digsim::scheduler.set_placement(digsim::placement_t::scatter);
+    digsim::scheduler.initialize();
+    if (digsim::scheduler.get_num_partitions() < 2) {
+        digsim::error("Test", "Expected a partition per clock, got {}", digsim::scheduler.get_num_partitions());
+        return 1;
+    }
+    // Runs for a while, checking the chains, and returns whether the first flip-flop toggled.
+    auto run_and_check = [&qs, &outs]() {
+        bool toggled     = false;
+        const bool first = qs[0]->get();
+        for (digsim::discrete_time_t step = 0; step < 10; ++step) {
+            digsim::scheduler.run(7);
+            // The chains of inverters are even, they must have settled.
+            for (std::size_t index = 0; index < qs.size(); ++index) {
+                if (outs[index]->get() != qs[index]->get()) {
+                    digsim::error("Test", "The chain {} is out of date at time {}", index, digsim::scheduler.time());
+                    return false;
+                }
+            }
+            toggled = toggled || (qs[0]->get() != first);
+        }
+        if (!toggled) {
+            digsim::error("Test", "The first flip-flop is not toggling");
+        }
+        return toggled;
+    };
+    if (!run_and_check()) {
+        return 1;
+    }
+    // Placing the threads again moves the storage of the partitions, the events must survive.
+    digsim::scheduler.set_placement(digsim::placement_t::compact);
+    if (!run_and_check()) {
+        return 1;
+    }
+    // The calling thread gets its CPUs back when the threads are stopped.
+    digsim::scheduler.set_num_threads(1);
+    if (digsim::get_thread_cpus() != cpus) {
+        digsim::error("Test", "The calling thread is still pinned");
+        return 1;
+    }
+
+    digsim::info("Test", "✅ All tests passed.");
+    return 0;
+}
@@ -0,0 +1,133 @@
+/// @file test_quantum_keeper.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Tests temporal decoupling of a loosely-timed process through the quantum keeper.
+
+#include <digsim/digsim.hpp>
+
+/// @brief A loosely-timed core executing one instruction per time unit.
+class fast_core_t : public digsim::module_t
+{
+public:
+    std::size_t instructions = 0; ///< Number of executed instructions.
+    std::size_t activations  = 0; ///< Number of times the scheduler activated the core.
+    bool in_sync             = true; ///< Whether the scheduler time always matched the core time.
+
+    fast_core_t(const std::string &_name)
+        : digsim::module_t(_name)
+        , keeper()
+    {
+        digsim::scheduler.schedule_now(step_process());
+    }
+
+    /// @brief Returns the process executing the instructions.
+    /// @return the process information.
+    digsim::process_info_t step_process() { return digsim::get_or_create_process(this, &fast_core_t::step, "step"); }
+
+private:
+    digsim::quantum_keeper_t keeper;
+
+    void step()
+    {
+        ++activations;
+        // The scheduler time must never be ahead of the time reached by the core.
+        if (digsim::scheduler.time() != instructions) {
+            digsim::error(
+                get_name(), "Core out of sync: time {}, instructions {}", digsim::scheduler.time(), instructions);
+            in_sync = false;
+        }
+        while (true) {
+            // Execute one instruction.
+            ++instructions;
+            keeper.inc(1);
+            if (keeper.need_sync()) {
+                keeper.sync(step_process());
+                return;
+            }
+        }
+    }
+};
+
+/// @brief A peripheral counting the rising edges of a clock.
+class edge_counter_t : public digsim::module_t
+{
+public:
+    digsim::input_t<bool> clk;
+    std::size_t edges = 0;
+
+    edge_counter_t(const std::string &_name)
+        : digsim::module_t(_name)
+        , clk("clk", this)
+    {
+        ADD_SENSITIVITY(edge_counter_t, evaluate, clk);
+    }
+
+private:
+    void evaluate()
+    {
+        if (clk.posedge()) {
+            ++edges;
+        }
+    }
+};
+
+int main()
+{
+    digsim::logger.set_level(digsim::log_level_t::info);
+
+    constexpr digsim::discrete_time_t quantum  = 100;
+    constexpr digsim::discrete_time_t duration = 1000;
+
+    digsim::scheduler.set_global_quantum(quantum);
+
+    digsim::signal_t<bool> clk_out("clk_out");
+    digsim::clock_t clk("clk", 10);
+    clk.out(clk_out);
+
+    edge_counter_t counter("counter");
+    counter.clk(clk_out);
+
+    fast_core_t core("core");
+
+    digsim::scheduler.initialize();
+    digsim::scheduler.run(duration);
+
+    if (!core.in_sync) {
+        digsim::error("Test", "The core resumed at the wrong time");
+        return 1;
+    }
+    // The core must have kept up with the simulated time...
+    if (core.instructions != duration + quantum) {
+        digsim::error("Test", "Expected {} instructions, got {}", duration + quantum, core.instructions);
+        return 1;
+    }
+    // ...while only being activated once per quantum.
+    if (core.activations != (duration / quantum) + 1) {
+        digsim::error("Test", "Expected {} activations, got {}", (duration / quantum) + 1, core.activations);
+        return 1;
+    }
+    // The peripheral still sees every clock edge.
+    if (counter.edges != duration / 10) {
+        digsim::error("Test", "Expected {} clock edges, got {}", duration / 10, counter.edges);
+        return 1;
+    }
+
+    // Without a quantum, the core synchronizes after every instruction.
+    digsim::scheduler.set_global_quantum(0);
+    digsim::quantum_keeper_t keeper;
+    keeper.inc(1);
+    if (!keeper.need_sync()) {
+        digsim::error("Test", "A zero quantum must always require synchronization");
+        return 1;
+    }
+    // A process which did not run ahead is not scheduled again in the same time step.
+    keeper.reset();
+    const std::size_t pending = digsim::scheduler.pending_events();
+    if (keeper.sync(core.step_process()) ||
+        (digsim::scheduler.pending_events() != pending)) {
+        digsim::error("Test", "A process in sync must not be scheduled again");
+        return 1;
+    }
+
+    digsim::info("Test", "✅ All tests passed.");
+    return 0;
+}
@@ -0,0 +1,116 @@
+/// @file test_signal_history.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Tests the history of past values of a signal.
+
+#include <digsim/digsim.hpp>
+
+/// @brief Counts the rising edges of its clock.
+class counter_t : public digsim::module_t
+{
+public:
+    digsim::input_t<bool> clk;
+    digsim::output_t<unsigned> count;
+
+    counter_t(const std::string &_name)
+        : digsim::module_t(_name)
+        , clk("clk", this)
+        , count("count", this)
+    {
+        ADD_SENSITIVITY_WHEN(counter_t, evaluate, clk, digsim::when_equals(true));
+        ADD_PRODUCER(counter_t, evaluate, count);
+    }
+
+private:
+    void evaluate()
+    {
+        if (clk.posedge()) {
+            count.set(count.get() + 1);
+        }
+    }
+};
+
+/// @brief A delay line, which reads the value its input had a few cycles ago, without any shadow register.
+class delay_line_t : public digsim::module_t
+{
+public:
+    digsim::input_t<bool> clk;
+    digsim::input_t<unsigned> in;
+    digsim::output_t<unsigned> out;
+    std::size_t delay;
+
+    delay_line_t(const std::string &_name, std::size_t _delay)
+        : digsim::module_t(_name)
+        , clk("clk", this)
+        , in("in", this)
+        , out("out", this)
+        , delay(_delay)
+    {
+        // Sample on the falling edges, when the counter is stable.
+        ADD_SENSITIVITY_WHEN(delay_line_t, evaluate, clk, digsim::when_equals(false));
+        ADD_CONSUMER(delay_line_t, evaluate, in);
+        ADD_PRODUCER(delay_line_t, evaluate, out);
+    }
+
+private:
+    void evaluate()
+    {
+        // The history is shorter than the delay at the beginning of the simulation.
+        if (in.get() >= delay) {
+            out.set(in.history(delay));
+        }
+    }
+};
+
+int main()
+{
+    digsim::logger.set_level(digsim::log_level_t::info);
+
+    digsim::signal_t<bool> clk_out("clk_out");
+    digsim::signal_t<unsigned> count("count");
+    digsim::signal_t<unsigned> delayed("delayed");
+
+    digsim::clock_t clk("clk", 10);
+    clk.out(clk_out);
+
+    counter_t counter("counter");
+    counter.clk(clk_out);
+    counter.count(count);
+
+    delay_line_t delay_line("delay_line", 3);
+    delay_line.clk(clk_out);
+    delay_line.in(count);
+    delay_line.out(delayed);
+
+    // Keep the current value, plus the three previous ones.
+    count.enable_history(4);
+
+    digsim::scheduler.initialize();
+    digsim::scheduler.run(100);
+
+    if (count.get() != 10 || delayed.get() != 7) {
+        digsim::error("Test", "Expected count 10 and delayed 7, got {} and {}", count.get(), delayed.get());
+        return 1;
+    }
+    for (std::size_t k = 0; k < 4; ++k) {
+        if (count.history(k) != 10 - k) {
+            digsim::error("Test", "Expected history({}) to be {}, got {}", k, 10 - k, count.history(k));
+            return 1;
+        }
+    }
+    // The counter changes on the rising edges, at 5, 15, 25, ...
+    if (count.value_at(94) != 9 || count.value_at(95) != 10 || count.value_at(70) != 7) {
+        digsim::error("Test", "Wrong values in the past");
+        return 1;
+    }
+    // Anything older than the history is an error.
+    try {
+        (void)count.value_at(60);
+        digsim::error("Test", "Expected an error when going beyond the history");
+        return 1;
+    } catch (const std::runtime_error &) {
+        // Nothing to do here.
+    }
+
+    digsim::info("Test", "✅ All tests passed.");
+    return 0;
+}
@@ -0,0 +1,90 @@
+/// @file test_static_netlist.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Tests the netlists described as types, both at compile time and inside an event-driven design.
+
+#include <digsim/digsim.hpp>
+
+#include <static_adder.hpp>
+#include <static_mux2to1.hpp>
+
+// The netlists are evaluated at compile time as well.
+using adder8_t = ripple_adder_netlist_t<8>::type;
+static_assert(adder8_t::evaluate({200, 100, 0})[8] == 44);
+static_assert(adder8_t::evaluate({200, 100, 0})[9] == 1);
+static_assert(adder8_t::evaluate({255, 0, 1})[8] == 0);
+static_assert(mux2to1_netlist_t::evaluate({7, 9, 1})[0] == 9);
+// A wire reading another one, and a constant.
+using masked_nand_t = digsim::static_netlist_t<
+    2,
+    2,
+    digsim::assign_t<0, digsim::nand_t<digsim::input_ref_t<0>, digsim::input_ref_t<1>>>,
+    digsim::assign_t<1, digsim::and_t<digsim::wire_ref_t<0>, digsim::constant_t<0xf>>>>;
+static_assert(masked_nand_t::evaluate({0xc, 0xa})[1] == 0x7);
+
+#ifdef DIGSIM_TEST_OUT_OF_ORDER
+// Must not compile: the first assignment reads a wire which is only assigned after it.
+using out_of_order_t = digsim::static_netlist_t<
+    1,
+    2,
+    digsim::assign_t<1, digsim::wire_ref_t<0>>,
+    digsim::assign_t<0, digsim::input_ref_t<0>>>;
+static_assert(out_of_order_t::num_wires == 2);
+#endif
+
+int main()
+{
+    digsim::logger.set_level(digsim::log_level_t::info);
+
+    // An adder, whose sum is selected against a constant.
+    digsim::signal_t<uint64_t> a("a", 0);
+    digsim::signal_t<uint64_t> b("b", 0);
+    digsim::signal_t<bool> cin("cin", false);
+    digsim::signal_t<uint64_t> sum("sum", 0);
+    digsim::signal_t<bool> cout("cout", false);
+    digsim::signal_t<uint64_t> other("other", 0xdead);
+    digsim::signal_t<uint64_t> out("out", 0);
+    StaticAdder<4> adder("adder");
+    adder.a(a);
+    adder.b(b);
+    adder.cin(cin);
+    adder.sum(sum);
+    adder.cout(cout);
+    StaticMux2to1<uint64_t> mux("mux");
+    mux.a(sum);
+    mux.b(other);
+    mux.sel(cout);
+    mux.out(out);
+
+    digsim::scheduler.initialize();
+    for (uint64_t x = 0; x < 16; ++x) {
+        for (uint64_t y = 0; y < 16; ++y) {
+            for (uint64_t carry = 0; carry < 2; ++carry) {
+                a.set(x);
+                b.set(y);
+                cin.set(carry != 0);
+                digsim::scheduler.run();
+                const uint64_t expected = x + y + carry;
+                if ((sum.get() != (expected & 0xf)) || (cout.get() != (expected > 0xf))) {
+                    digsim::error("Test", "{} + {} + {} is {} with carry {}", x, y, carry, sum.get(), cout.get());
+                    return 1;
+                }
+                if (out.get() != ((expected > 0xf) ? 0xdead : (expected & 0xf))) {
+                    digsim::error("Test", "The multiplexer selected {}", out.get());
+                    return 1;
+                }
+            }
+        }
+    }
+    // Bits above the width of the adder are ignored.
+    a.set(0x1f);
+    b.set(0x11);
+    cin.set(false);
+    digsim::scheduler.run();
+    if ((sum.get() != 0) || !cout.get()) {
+        digsim::error("Test", "0xf + 0x1 is {} with carry {}", sum.get(), cout.get());
+        return 1;
+    }
+
+    digsim::info("Test", "✅ All tests passed.");
+    return 0;
+}
@@ -0,0 +1,267 @@
+/// @file test_time_warp.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Tests the state log, and the optimistic simulation of a design split across two processes.
+
+#include <digsim/digsim.hpp>
+
+#include <d_flip_flop.hpp>
+#include <gates/not_gate.hpp>
+
+#include "run_processes.hpp"
+
+#include <array>
+#include <chrono>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/// @brief The delay of the signals going from a process to the other, the smallest one.
+constexpr digsim::discrete_time_t lookahead = 1;
+/// @brief How long the design runs.
+constexpr digsim::discrete_time_t duration = 200;
+
+/// @brief Records the changes of a signal, the record is part of the state undone by a rollback.
+class recorder_t
+{
+public:
+    /// @brief The changes, with their time.
+    std::vector<std::pair<digsim::discrete_time_t, bool>> changes;
+
+    /// @brief Constructor.
+    /// @param signal the signal to record.
+    explicit recorder_t(digsim::signal_t<bool> &signal)
+        : changes()
+    {
+        signal.watch(nullptr, [this, &signal] {
+            digsim::state_log.save(changes);
+            changes.emplace_back(digsim::scheduler.time(), signal.get());
+        });
+    }
+};
+
+/// @brief Runs the local half of the design, optimistically or not.
+/// @param peer the connection with the other half.
+/// @param optimistic true to use the optimistic synchronization.
+void run_half(digsim::peer_t &peer, bool optimistic)
+{
+    // Run in two steps, the second one resumes the synchronization.
+    for (const auto end_time : {duration / 2, duration}) {
+        if (optimistic) {
+            digsim::run_optimistic({&peer}, end_time);
+        } else {
+            digsim::run_distributed({&peer}, end_time);
+        }
+    }
+}
+
+/// @brief The first half: a flip-flop sampling, at each rising edge, its output inverted by the other half.
+/// @param channel the connection with the other half.
+/// @param optimistic true to use the optimistic synchronization.
+/// @return 0 on success.
+int run_toggler(digsim::channel_t channel, bool optimistic)
+{
+    digsim::signal_t<bool> clk_out("clk_out");
+    digsim::signal_t<bool> enable("enable", true);
+    digsim::signal_t<bool> reset("reset", false);
+    digsim::signal_t<bool> q("q", false, 1);
+    digsim::signal_t<bool> q_not("q_not", true, 1);
+    digsim::signal_t<bool> back("back", false);
+    digsim::clock_t clock("clock", 4);
+    clock.out(clk_out);
+    DFlipFlop ff("ff");
+    ff.clk(clk_out);
+    ff.d(back);
+    ff.enable(enable);
+    ff.reset(reset);
+    ff.q(q);
+    ff.q_not(q_not);
+
+    digsim::peer_t peer("inverter", std::move(channel), lookahead);
+    peer.send_signal("q", q);
+    peer.send_signal("clk", clk_out);
+    peer.receive_signal("inverted", back);
+
+    recorder_t q_record(q), back_record(back);
+    run_half(peer, optimistic);
+    // The flip-flop toggles one time unit after each rising edge, since the inverted value comes back before the next
+    // one, and the inverted value comes back after crossing the connection twice.
+    std::vector<std::pair<digsim::discrete_time_t, bool>> q_expected, back_expected{{lookahead, true}};
+    for (digsim::discrete_time_t time = 3; time <= duration; time += 4) {
+        q_expected.emplace_back(time, q_expected.empty() || !q_expected.back().second);
+        if (time + 2 * lookahead <= duration) {
+            back_expected.emplace_back(time + 2 * lookahead, !q_expected.back().second);
+        }
+    }
+    if (q_record.changes != q_expected) {
+        digsim::error(
+            "Test", "The flip-flop toggled {} times, instead of {}", q_record.changes.size(), q_expected.size());
+        return 1;
+    }
+    if (back_record.changes != back_expected) {
+        digsim::error(
+            "Test", "Got {} inverted values, instead of {}", back_record.changes.size(), back_expected.size());
+        return 1;
+    }
+    // The other half is slower, this one must have run ahead of it, and sent clock edges it had to cancel.
+    if (optimistic && ((peer.get_rollbacks() == 0) || (peer.get_anti_messages() == 0))) {
+        digsim::error("Test", "The toggler never went back in time");
+        return 1;
+    }
+    if (digsim::state_log.is_enabled() || (digsim::state_log.size() != 0)) {
+        digsim::error("Test", "The state log must be cleared at the end of the run");
+        return 1;
+    }
+    digsim::info(
+        "Test", "{} messages sent by the toggler, {} rollbacks, {} anti-messages", peer.get_messages_sent(),
+        peer.get_rollbacks(), peer.get_anti_messages());
+    return 0;
+}
+
+/// @brief The second half: inverts the signal it receives, slowly, and sends it back.
+/// @param channel the connection with the other half.
+/// @param optimistic true to use the optimistic synchronization.
+/// @return 0 on success.
+int run_inverter(digsim::channel_t channel, bool optimistic)
+{
+    digsim::signal_t<bool> remote_q("remote_q", false);
+    digsim::signal_t<bool> remote_clk("remote_clk", false);
+    digsim::signal_t<bool> inverted("inverted", false);
+    NotGate gate("gate");
+    gate.in(remote_q);
+    gate.out(inverted);
+
+    digsim::peer_t peer("toggler", std::move(channel), lookahead);
+    peer.receive_signal("q", remote_q);
+    peer.receive_signal("clk", remote_clk);
+    peer.send_signal("inverted", inverted);
+
+    remote_q.watch(nullptr, [] { std::this_thread::sleep_for(std::chrono::milliseconds(1)); });
+    run_half(peer, optimistic);
+    // The last change of the flip-flop which arrived before the end.
+    const std::size_t toggles = (duration - lookahead - 3) / 4 + 1;
+    // The clock is high for the second half of each period.
+    const bool clk_high = ((duration - lookahead) % 4) >= 2;
+    if ((remote_q.get() != (toggles % 2 == 1)) || (inverted.get() == remote_q.get()) ||
+        (remote_clk.get() != clk_high)) {
+        digsim::error("Test", "The inverter ended with the wrong values");
+        return 1;
+    }
+    return 0;
+}
+
+/// @brief Runs the two halves in two child processes, connected by a pair of sockets, and waits for them.
+/// @param optimistic true to use the optimistic synchronization.
+/// @return true if both halves succeeded.
+bool run_halves(bool optimistic)
+{
+    auto [first, second] = digsim::channel_t::make_pair();
+    return run_processes(
+        optimistic ? "optimistic" : "conservative", [&]() { return run_toggler(std::move(first), optimistic); },
+        [&]() { return run_inverter(std::move(second), optimistic); });
+}
+
+int main()
+{
+    digsim::logger.set_level(digsim::log_level_t::info);
+
+    // The state log undoes the changes of the signals and of the models, newest first.
+    {
+        digsim::signal_t<int> value("value", 1);
+        std::array<int, 4> memory{1, 2, 3, 4};
+        digsim::state_log.enable();
+        const std::size_t start = digsim::state_log.mark();
+        value.set(2);
+        digsim::state_log.save(memory[1]);
+        memory[1] = 20;
+        digsim::state_log.save(memory);
+        memory.fill(0);
+        // Only the first write after a mark copies the object.
+        digsim::state_log.save(memory);
+        memory.fill(5);
+        digsim::state_log.mark();
+        value.set(3);
+        if (digsim::state_log.size() != 4) {
+            digsim::error("Test", "Expected 4 changes in the log, got {}", digsim::state_log.size());
+            return 1;
+        }
+        digsim::state_log.rollback(start);
+        if ((value.get() != 1) || (value.get_version() != 0) || (memory != std::array<int, 4>{1, 2, 3, 4})) {
+            digsim::error("Test", "The changes were not undone");
+            return 1;
+        }
+        digsim::state_log.enable(false);
+        value.set(4);
+        if (digsim::state_log.size() != 0) {
+            digsim::error("Test", "A disabled log must not record anything");
+            return 1;
+        }
+    }
+
+    // Both synchronizations must give the same results.
+    if (!run_halves(false) || !run_halves(true)) {
+        return 1;
+    }
+
+    // The optimistic synchronization is limited to two processes.
+    {
+        auto [first, second] = digsim::channel_t::make_pair();
+        auto [third, fourth] = digsim::channel_t::make_pair();
+        digsim::peer_t one("one", std::move(first), 1);
+        digsim::peer_t other("other", std::move(third), 1);
+        bool rejected = false;
+        try {
+            digsim::run_optimistic({&one, &other}, duration);
+        } catch (const std::runtime_error &) {
+            rejected = true;
+        }
+        if (!rejected) {
+            digsim::error("Test", "More than one peer must be rejected");
+            return 1;
+        }
+    }
+
+    // A stop request ends the optimistic run early, and leaves the state log disabled.
+    {
+        digsim::signal_t<bool> clk_out("clk_out");
+        digsim::clock_t clock("clock", 4);
+        clock.out(clk_out);
+        clk_out.watch(nullptr, [] {
+            if (digsim::scheduler.time() >= 10) {
+                digsim::scheduler.request_stop();
+            }
+        });
+        digsim::run_optimistic({}, duration);
+        if (!digsim::scheduler.stopped() || (digsim::scheduler.time() >= duration)) {
+            digsim::error("Test", "The stop request was not honoured, at {}", digsim::scheduler.time());
+            return 1;
+        }
+        if (digsim::state_log.is_enabled() || (digsim::state_log.size() != 0)) {
+            digsim::error("Test", "The state log must be cleared when the run is stopped");
+            return 1;
+        }
+    }
+
+    // A module disabled by an undone step is enabled again, with the same activations pending.
+    {
+        digsim::signal_t<bool> in("gated_in", false);
+        digsim::signal_t<bool> out("gated_out", true);
+        NotGate gate("gate");
+        gate.in(in);
+        gate.out(out);
+        const auto &process = digsim::process_table.get(digsim::process_table.get_owned(&gate).front());
+        digsim::state_log.enable();
+        const digsim::scheduler_state_t state = digsim::scheduler.save_state();
+        const std::size_t start               = digsim::state_log.mark();
+        gate.set_enabled(false);
+        digsim::state_log.rollback(start);
+        digsim::scheduler.restore_state(state);
+        digsim::state_log.enable(false);
+        if (!gate.is_enabled() || !digsim::scheduler.is_process_enabled(process)) {
+            digsim::error("Test", "The module disabled by an undone step is still disabled");
+            return 1;
+        }
+    }
+
+    digsim::info("Test", "✅ All tests passed.");
+    return 0;
+}
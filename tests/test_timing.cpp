@@ -0,0 +1,145 @@
+/// @file test_timing.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Tests the static timing analysis: critical paths, delta-cycle depth, and lookahead.
+
+#include <digsim/digsim.hpp>
+
+#include <d_flip_flop.hpp>
+#include <gates/and_gate.hpp>
+#include <gates/nand_gate.hpp>
+#include <gates/not_gate.hpp>
+
+#include <limits>
+
+/// @brief Checks that a path goes through the given signals.
+/// @param path the path.
+/// @param signals the expected signals.
+/// @param delay the expected delay.
+/// @return true if the path matches.
+static bool check_path(
+    const digsim::timing_path_t &path,
+    const std::vector<const digsim::isignal_t *> &signals,
+    digsim::discrete_time_t delay)
+{
+    if ((path.signals != signals) || (path.delay != delay)) {
+        digsim::error("Test", "Expected a path of {} signals with delay {}", signals.size(), delay);
+        digsim::dependency_graph.print_timing_report(digsim::timing_report_t{{path}, {}, {}, {}, 0});
+        return false;
+    }
+    return true;
+}
+
+int main()
+{
+    digsim::logger.set_level(digsim::log_level_t::info);
+
+    digsim::signal_t<bool> clk_out("clk_out");
+    digsim::signal_t<bool> en("en", true);
+    digsim::signal_t<bool> rst("rst", false);
+    digsim::signal_t<bool> d("d", false);
+    digsim::signal_t<bool> q1("q1", false, 2);
+    digsim::signal_t<bool> q1n("q1n", true);
+    digsim::signal_t<bool> a1("a1", false, 3);
+    digsim::signal_t<bool> n1("n1", true);
+    digsim::signal_t<bool> a2("a2", false, 1);
+    digsim::signal_t<bool> q2("q2", false);
+    digsim::signal_t<bool> q2n("q2n", true);
+    digsim::signal_t<bool> la("la", true);
+    digsim::signal_t<bool> lb("lb", false);
+
+    digsim::clock_t clk("clk", 10);
+    clk.out(clk_out);
+    // A first flip-flop, whose outputs go through some gates to the second one.
+    DFlipFlop ff1("ff1");
+    ff1.clk(clk_out);
+    ff1.d(d);
+    ff1.enable(en);
+    ff1.reset(rst);
+    ff1.q(q1);
+    ff1.q_not(q1n);
+    AndGate g1("g1");
+    g1.a(q1);
+    g1.b(en);
+    g1.out(a1);
+    NotGate g2("g2");
+    g2.in(a1);
+    g2.out(n1);
+    AndGate g3("g3");
+    g3.a(n1);
+    g3.b(q1n);
+    g3.out(a2);
+    DFlipFlop ff2("ff2");
+    ff2.clk(clk_out);
+    ff2.d(a2);
+    ff2.enable(en);
+    ff2.reset(rst);
+    ff2.q(q2);
+    ff2.q_not(q2n);
+    // A latch, i.e., a loop.
+    NandGate l1("l1");
+    l1.a(q2);
+    l1.b(lb);
+    l1.out(la);
+    NandGate l2("l2");
+    l2.a(n1);
+    l2.b(la);
+    l2.out(lb);
+
+    // The AND gate before the second flip-flop gets a partition of its own.
+    std::vector<std::size_t> partitions(digsim::process_table.size(), 0);
+    for (std::size_t id = 0; id < digsim::process_table.size(); ++id) {
+        if (digsim::process_table.get(id).owner.ptr == &g3) {
+            partitions[id] = 1;
+        }
+    }
+
+    const auto report = digsim::dependency_graph.compute_timing(3, partitions);
+    digsim::dependency_graph.print_timing_report(report);
+
+    if (report.critical_paths.size() != 3) {
+        digsim::error("Test", "Expected 3 critical paths, got {}", report.critical_paths.size());
+        return 1;
+    }
+    if (!check_path(report.critical_paths[0], {&q1, &a1, &n1, &a2}, 6) ||
+        !check_path(report.critical_paths[1], {&q1, &a1, &n1, &lb, &la}, 5) ||
+        !check_path(report.critical_paths[2], {&en, &a1, &n1, &a2}, 4)) {
+        return 1;
+    }
+    if (report.critical_paths[0].deltas != 1) {
+        digsim::error("Test", "Expected 1 delta cycle on the critical path, got {}", report.critical_paths[0].deltas);
+        return 1;
+    }
+    if (report.shortest_path.delay != 0) {
+        digsim::error("Test", "Expected a shortest path without delay, got {}", report.shortest_path.delay);
+        return 1;
+    }
+    if (report.loops != 1) {
+        digsim::error("Test", "Expected 1 loop, got {}", report.loops);
+        return 1;
+    }
+    // The clock wakes up the second flip-flop, whose output goes through the latch in the same time step.
+    if ((report.delta_depth.size() != 1) || (report.delta_depth[0].first != &clk_out) ||
+        (report.delta_depth[0].second != 2)) {
+        digsim::error("Test", "Expected a delta-cycle depth of 2 for the clock");
+        return 1;
+    }
+    // The first partition sends `n1` and `q1n` without delay, the second one sends `a2` with a delay of 1.
+    if ((report.lookahead.size() != 2) || (report.lookahead[0] != 0) || (report.lookahead[1] != 1)) {
+        digsim::error("Test", "Wrong lookahead of the partitions");
+        return 1;
+    }
+    // Without partitions, nothing is sent anywhere.
+    const auto single = digsim::dependency_graph.compute_timing(1);
+    if ((single.lookahead.size() != 1) ||
+        (single.lookahead[0] != std::numeric_limits<digsim::discrete_time_t>::max())) {
+        digsim::error("Test", "A single partition has nothing to send");
+        return 1;
+    }
+    if ((single.critical_paths.size() != 1) || (single.critical_paths[0].delay != 6)) {
+        digsim::error("Test", "Expected the critical path only");
+        return 1;
+    }
+
+    digsim::info("Test", "✅ All tests passed.");
+    return 0;
+}
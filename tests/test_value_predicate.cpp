@@ -0,0 +1,100 @@
+/// @file test_value_predicate.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Tests sensitivity entries guarded by a predicate on the value of the input.
+
+#include <digsim/digsim.hpp>
+
+/// @brief Only acts when the phase reaches a given value.
+class stage_t : public digsim::module_t
+{
+public:
+    digsim::input_t<unsigned> phase;
+    digsim::input_t<bool> clk;
+    std::size_t phase_activations = 0; ///< Activations caused by the phase.
+    std::size_t clk_activations   = 0; ///< Activations caused by the clock.
+
+    stage_t(const std::string &_name, unsigned active_phase)
+        : digsim::module_t(_name)
+        , phase("phase", this)
+        , clk("clk", this)
+    {
+        ADD_SENSITIVITY_WHEN(stage_t, evaluate, phase, digsim::when_equals(active_phase));
+        ADD_SENSITIVITY_WHEN(stage_t, evaluate, clk, digsim::when_equals(true));
+    }
+
+private:
+    void evaluate()
+    {
+        phase_activations += triggered_by(phase);
+        clk_activations += triggered_by(clk);
+    }
+};
+
+/// @brief Only acts when the opcode belongs to a given class.
+class branch_unit_t : public digsim::module_t
+{
+public:
+    digsim::input_t<unsigned> opcode;
+    std::size_t activations = 0;
+
+    branch_unit_t(const std::string &_name)
+        : digsim::module_t(_name)
+        , opcode("opcode", this)
+    {
+        // Branches are the opcodes of the form 0b10xx.
+        ADD_SENSITIVITY_WHEN(branch_unit_t, evaluate, opcode, digsim::when_matches(0b1100U, 0b1000U));
+    }
+
+private:
+    void evaluate() { ++activations; }
+};
+
+int main()
+{
+    digsim::logger.set_level(digsim::log_level_t::info);
+
+    digsim::signal_t<unsigned> phase("phase");
+    digsim::signal_t<bool> clk("clk");
+    digsim::signal_t<unsigned> opcode("opcode");
+
+    stage_t decode("decode", 1);
+    decode.phase(phase);
+    decode.clk(clk);
+
+    branch_unit_t branch("branch");
+    branch.opcode(opcode);
+
+    digsim::scheduler.initialize();
+
+    // Cycle through the four phases three times, with a clock edge per phase.
+    for (unsigned cycle = 0; cycle < 3; ++cycle) {
+        for (unsigned value = 0; value < 4; ++value) {
+            phase.set(value);
+            clk.set(true);
+            digsim::scheduler.run();
+            clk.set(false);
+            digsim::scheduler.run();
+        }
+    }
+    if (decode.phase_activations != 3) {
+        digsim::error("Test", "Expected 3 activations from the phase, got {}", decode.phase_activations);
+        return 1;
+    }
+    if (decode.clk_activations != 12) {
+        digsim::error("Test", "Expected 12 activations from the clock, got {}", decode.clk_activations);
+        return 1;
+    }
+
+    // Go through all the opcodes, only 4 of them are branches.
+    for (unsigned value = 1; value < 16; ++value) {
+        opcode.set(value);
+        digsim::scheduler.run();
+    }
+    if (branch.activations != 4 + 1) {
+        digsim::error("Test", "Expected 4 branch activations, got {}", branch.activations - 1);
+        return 1;
+    }
+
+    digsim::info("Test", "✅ All tests passed.");
+    return 0;
+}
@@ -0,0 +1,116 @@
+/// @file test_wake_reason.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Tests that processes are told which of their inputs changed.
+
+#include <digsim/digsim.hpp>
+
+/// @brief A memory which only re-reads its content when the address changes.
+class memory_t : public digsim::module_t
+{
+public:
+    digsim::input_t<unsigned> addr;
+    digsim::input_t<unsigned> data_in;
+    digsim::input_t<bool> write_enable;
+    digsim::output_t<unsigned> data_out;
+
+    std::size_t reads  = 0; ///< Number of activations which only performed a read.
+    std::size_t writes = 0; ///< Number of activations which performed a write.
+    std::size_t full   = 0; ///< Number of activations which re-evaluated everything.
+
+    memory_t(const std::string &_name)
+        : digsim::module_t(_name)
+        , addr("addr", this)
+        , data_in("data_in", this)
+        , write_enable("write_enable", this)
+        , data_out("data_out", this)
+        , memory()
+    {
+        ADD_SENSITIVITY(memory_t, evaluate, addr, data_in, write_enable);
+        ADD_PRODUCER(memory_t, evaluate, data_out);
+    }
+
+private:
+    std::array<unsigned, 16> memory;
+
+    void evaluate()
+    {
+        // Not woken up by an input, re-evaluate everything.
+        if (changed_mask() == 0) {
+            ++full;
+        } else if (triggered_by(addr) && !triggered_by(data_in) && !triggered_by(write_enable)) {
+            // Only the address changed, this is a read.
+            ++reads;
+            data_out.set(memory[addr.get() % memory.size()]);
+            return;
+        }
+        if (write_enable.get()) {
+            ++writes;
+            memory[addr.get() % memory.size()] = data_in.get();
+        }
+        data_out.set(memory[addr.get() % memory.size()]);
+    }
+};
+
+int main()
+{
+    digsim::logger.set_level(digsim::log_level_t::info);
+
+    digsim::signal_t<unsigned> addr("addr");
+    digsim::signal_t<unsigned> data_in("data_in");
+    digsim::signal_t<bool> write_enable("write_enable");
+    digsim::signal_t<unsigned> data_out("data_out");
+
+    memory_t mem("mem");
+    mem.addr(addr);
+    mem.data_in(data_in);
+    mem.write_enable(write_enable);
+    mem.data_out(data_out);
+
+    digsim::scheduler.initialize();
+    if (mem.full != 1) {
+        digsim::error("Test", "The initialization must re-evaluate everything");
+        return 1;
+    }
+
+    // Write two locations, the changes of the same delta are accumulated.
+    addr.set(3);
+    data_in.set(42);
+    write_enable.set(true);
+    digsim::scheduler.run();
+    addr.set(5);
+    data_in.set(7);
+    digsim::scheduler.run();
+    write_enable.set(false);
+    digsim::scheduler.run();
+    if (mem.writes != 2 || mem.reads != 0) {
+        digsim::error("Test", "Expected 2 writes and no reads, got {} and {}", mem.writes, mem.reads);
+        return 1;
+    }
+
+    // Address-only changes take the fast path.
+    addr.set(3);
+    digsim::scheduler.run();
+    if (data_out.get() != 42) {
+        digsim::error("Test", "Expected 42, got {}", data_out.get());
+        return 1;
+    }
+    addr.set(5);
+    digsim::scheduler.run();
+    if (data_out.get() != 7) {
+        digsim::error("Test", "Expected 7, got {}", data_out.get());
+        return 1;
+    }
+    if (mem.reads != 2 || mem.writes != 2 || mem.full != 1) {
+        digsim::error("Test", "Expected 2 reads, got {}", mem.reads);
+        return 1;
+    }
+
+    // Outside of a process, nothing is reported as changed.
+    if (mem.changed_mask() != 0) {
+        digsim::error("Test", "The changed mask must be cleared after the activation");
+        return 1;
+    }
+
+    digsim::info("Test", "✅ All tests passed.");
+    return 0;
+}
@@ -0,0 +1,133 @@
+/// @file test_watchpoint.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Tests watchpoints on signals and memory words.
+
+#include "cpu/ram.hpp"
+
+/// @brief Counts the rising edges of its clock.
+class counter_t : public digsim::module_t
+{
+public:
+    digsim::input_t<bool> clk;
+    digsim::output_t<unsigned> count;
+
+    counter_t(const std::string &_name)
+        : digsim::module_t(_name)
+        , clk("clk", this)
+        , count("count", this)
+    {
+        ADD_SENSITIVITY_WHEN(counter_t, evaluate, clk, digsim::when_equals(true));
+        ADD_PRODUCER(counter_t, evaluate, count);
+    }
+
+private:
+    void evaluate()
+    {
+        if (clk.posedge()) {
+            count.set(count.get() + 1);
+        }
+    }
+};
+
+/// @brief Toggles a clock driven by the testbench, while the free-running clock keeps going.
+void toggle_clock(digsim::signal_t<bool> &clk)
+{
+    clk.set(false);
+    digsim::scheduler.run(1);
+    clk.set(true);
+    digsim::scheduler.run(1);
+}
+
+int main()
+{
+    digsim::logger.set_level(digsim::log_level_t::info);
+
+    digsim::signal_t<bool> clk_out("clk_out");
+    digsim::signal_t<unsigned> count("count");
+    digsim::clock_t clk("clk", 10);
+    clk.out(clk_out);
+    counter_t counter("counter");
+    counter.clk(clk_out);
+    counter.count(count);
+
+    // A memory, driven by the testbench.
+    digsim::signal_t<bool> mem_clk("mem_clk");
+    digsim::signal_t<bool> reset("reset");
+    digsim::signal_t<bs_address_t> addr("addr");
+    digsim::signal_t<bs_data_t> data_in("data_in");
+    digsim::signal_t<bool> write_enable("write_enable");
+    digsim::signal_t<bs_phase_t> phase("phase");
+    digsim::signal_t<bs_data_t> data_out("data_out");
+    ram_t ram("ram");
+    ram.clk(mem_clk);
+    ram.reset(reset);
+    ram.addr(addr);
+    ram.data_in(data_in);
+    ram.write_enable(write_enable);
+    ram.phase(phase);
+    ram.data_out(data_out);
+    phase.set(static_cast<uint8_t>(phase_t::WRITEBACK));
+
+    digsim::scheduler.initialize();
+
+    // Pause the simulation when the counter reaches 7.
+    auto id = count.watch(digsim::when_equals(7U));
+    digsim::scheduler.run(1000);
+    if (!digsim::scheduler.stopped() || count.get() != 7 || digsim::scheduler.time() != 65) {
+        digsim::error(
+            "Test", "Expected to stop at 65 with count 7, got {} at {}", count.get(), digsim::scheduler.time());
+        return 1;
+    }
+    count.unwatch(id);
+
+    // Count the even values through a callback, without stopping.
+    std::size_t even = 0;
+    count.watch([](unsigned value) { return (value % 2) == 0; }, [&even] { ++even; });
+    digsim::scheduler.run(100);
+    if (digsim::scheduler.stopped() || count.get() != 17 || even != 5) {
+        digsim::error("Test", "Expected count 17 and 5 even values, got {} and {}", count.get(), even);
+        return 1;
+    }
+
+    // A watchpoint disarming itself must not hide the next one, nor be triggered again.
+    std::size_t once = 0, always = 0, once_id = 0;
+    once_id        = count.watch(nullptr, [&] {
+        ++once;
+        count.unwatch(once_id);
+    });
+    auto always_id = count.watch(nullptr, [&always] { ++always; });
+    digsim::scheduler.run(20);
+    count.unwatch(always_id);
+    if ((once != 1) || (always != 2)) {
+        digsim::error("Test", "Expected 1 and 2 triggers, got {} and {}", once, always);
+        return 1;
+    }
+
+    // A stop requested while not running does not pause the next run.
+    count.watch(digsim::when_equals(0U));
+    count.set(0);
+    digsim::scheduler.run(10);
+    if (digsim::scheduler.stopped()) {
+        digsim::error("Test", "A stop requested outside run() paused the simulation");
+        return 1;
+    }
+
+    // Stop on the first write changing a memory word.
+    ram.watch(0x10);
+    addr.set(0x10);
+    write_enable.set(true);
+    toggle_clock(mem_clk);
+    if (digsim::scheduler.stopped()) {
+        digsim::error("Test", "Writing the same value must not trigger the watchpoint");
+        return 1;
+    }
+    data_in.set(0xAA);
+    toggle_clock(mem_clk);
+    if (!digsim::scheduler.stopped() || ram.debug_read(0x10) != 0xAA) {
+        digsim::error("Test", "Expected the memory watchpoint to trigger");
+        return 1;
+    }
+
+    digsim::info("Test", "✅ All tests passed.");
+    return 0;
+}